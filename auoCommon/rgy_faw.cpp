@@ -27,6 +27,7 @@
 
 #include <vector>
 #include <array>
+#include <algorithm>
 #include "rgy_faw.h"
 #include "rgy_simd.h"
 
@@ -35,14 +36,16 @@ size_t rgy_memmem_fawstart1_c(const void *data_, const size_t data_size) {
 }
 
 decltype(rgy_memmem_fawstart1_c)* get_memmem_fawstart1_func() {
+    static const RGYSimdFunc<decltype(rgy_memmem_fawstart1_c)*> FUNC_LIST[] = {
 #if defined(_M_IX86) || defined(_M_X64) || defined(__x86_64)
-    const auto simd = get_availableSIMD();
 #if defined(_M_X64) || defined(__x86_64)
-    if ((simd & RGY_SIMD::AVX512BW) == RGY_SIMD::AVX512BW) return rgy_memmem_fawstart1_avx512bw;
+        { RGY_SIMD::AVX512BW, rgy_memmem_fawstart1_avx512bw },
 #endif
-    if ((simd & RGY_SIMD::AVX2) == RGY_SIMD::AVX2) return rgy_memmem_fawstart1_avx2;
+        { RGY_SIMD::AVX2,     rgy_memmem_fawstart1_avx2 },
 #endif
-    return rgy_memmem_fawstart1_c;
+        { RGY_SIMD::NONE,     rgy_memmem_fawstart1_c },
+    };
+    return select_simd_func(FUNC_LIST);
 }
 
 static const std::array<uint8_t, 2> AACSYNC_BYTES = { 0xff, 0xf0 };
@@ -84,40 +87,46 @@ void rgy_split_audio_16to8x2(uint8_t *dst0, uint8_t *dst1, const short *src, con
 }
 
 decltype(rgy_convert_audio_16to8)* get_convert_audio_16to8_func() {
+    static const RGYSimdFunc<decltype(rgy_convert_audio_16to8)*> FUNC_LIST[] = {
 #if defined(_M_IX86) || defined(_M_X64) || defined(__x86_64)
-    const auto simd = get_availableSIMD();
-    if ((simd & RGY_SIMD::AVX2) == RGY_SIMD::AVX2) return rgy_convert_audio_16to8_avx2;
+#if defined(_M_X64) || defined(__x86_64)
+        { RGY_SIMD::AVX512BW, rgy_convert_audio_16to8_avx512bw },
+#endif
+        { RGY_SIMD::AVX2,     rgy_convert_audio_16to8_avx2 },
 #endif
-    return rgy_convert_audio_16to8;
+        { RGY_SIMD::NONE,     rgy_convert_audio_16to8 },
+    };
+    return select_simd_func(FUNC_LIST);
 }
 
 decltype(rgy_split_audio_16to8x2)* get_split_audio_16to8x2_func() {
+    static const RGYSimdFunc<decltype(rgy_split_audio_16to8x2)*> FUNC_LIST[] = {
 #if defined(_M_IX86) || defined(_M_X64) || defined(__x86_64)
-    const auto simd = get_availableSIMD();
-    if ((simd & RGY_SIMD::AVX2) == RGY_SIMD::AVX2) return rgy_split_audio_16to8x2_avx2;
+#if defined(_M_X64) || defined(__x86_64)
+        { RGY_SIMD::AVX512BW, rgy_split_audio_16to8x2_avx512bw },
 #endif
-    return rgy_split_audio_16to8x2;
-}
-
-template<bool upperhalf>
-static uint8_t faw_read_half(const uint16_t v) {
-    uint8_t i = (upperhalf) ? (v & 0xff00) >> 8 : (v & 0xff);
-    return i - 0x80;
+        { RGY_SIMD::AVX2,     rgy_split_audio_16to8x2_avx2 },
+#endif
+        { RGY_SIMD::NONE,     rgy_split_audio_16to8x2 },
+    };
+    return select_simd_func(FUNC_LIST);
 }
 
-template<bool ishalf, bool upperhalf>
-void faw_read(uint8_t *dst, const uint8_t *src, const size_t outlen) {
-    if (!ishalf) {
-        memcpy(dst, src, outlen);
-        return;
-    }
-    const uint16_t *srcPtr = (const uint16_t *)src;
-    for (size_t i = 0; i < outlen; i++) {
-        dst[i] = faw_read_half<upperhalf>(srcPtr[i]);
-    }
+decltype(rgy_faw_checksum_c)* get_faw_checksum_func() {
+    static const RGYSimdFunc<decltype(rgy_faw_checksum_c)*> FUNC_LIST[] = {
+#if defined(_M_IX86) || defined(_M_X64) || defined(__x86_64)
+#if defined(_M_X64) || defined(__x86_64)
+        { RGY_SIMD::AVX512BW, rgy_faw_checksum_avx512bw },
+#endif
+        { RGY_SIMD::AVX2,     rgy_faw_checksum_avx2 },
+#endif
+        { RGY_SIMD::NONE,     rgy_faw_checksum_c },
+    };
+    return select_simd_func(FUNC_LIST);
 }
 
-static uint32_t faw_checksum_calc(const uint8_t *buf, const size_t len) {
+// checksumは16bit単位の和(下位16bit)とxor
+uint32_t rgy_faw_checksum_c(const uint8_t *buf, const size_t len) {
     uint32_t _v4288 = 0;
     uint32_t _v48 = 0;
     const size_t fin_mod2 = (len & (~1));
@@ -282,16 +291,84 @@ static const std::array<uint8_t, 33> aac_silent6 = {
     0xE0
 };
 
+RGYFAWWorker::RGYFAWWorker() :
+    thread(),
+    mtx(),
+    cond(),
+    task(),
+    taskQueued(false),
+    taskRunning(false),
+    abort(false) {
+}
+
+RGYFAWWorker::~RGYFAWWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        abort = true;
+    }
+    cond.notify_all();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void RGYFAWWorker::threadFunc() {
+    for (;;) {
+        std::function<void()> func;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cond.wait(lock, [this]() { return taskQueued || abort; });
+            if (!taskQueued) {
+                break; //abort
+            }
+            func = std::move(task);
+            taskQueued = false;
+            taskRunning = true;
+        }
+        func();
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            taskRunning = false;
+        }
+        cond.notify_all();
+    }
+}
+
+void RGYFAWWorker::run(std::function<void()> func) {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        task = std::move(func);
+        taskQueued = true;
+        if (!thread.joinable()) {
+            thread = std::thread(&RGYFAWWorker::threadFunc, this);
+        }
+    }
+    cond.notify_all();
+}
+
+void RGYFAWWorker::wait() {
+    std::unique_lock<std::mutex> lock(mtx);
+    cond.wait(lock, [this]() { return !taskQueued && !taskRunning; });
+}
+
 RGYFAWDecoder::RGYFAWDecoder() :
     wavheader(),
     fawmode(RGYFAWMode::Unknown),
     bufferIn(),
     bufferHalf0(),
     bufferHalf1(),
-    funcMemMem(get_memmem_func()),
+    indexIn(),
+    indexHalf0(),
+    indexHalf1(),
+    splitHalf0(),
+    splitHalf1(),
+    workers(),
+    funcMemMemMulti(get_memmem_multi_func()),
     funcMemMemFAWStart1(get_memmem_fawstart1_func()),
     funcAudio16to8(get_convert_audio_16to8_func()),
-    funcSplitAudio16to8x2(get_split_audio_16to8x2_func()) {
+    funcSplitAudio16to8x2(get_split_audio_16to8x2_func()),
+    funcChecksum(get_faw_checksum_func()) {
 }
 RGYFAWDecoder::~RGYFAWDecoder() {
 
@@ -343,10 +420,20 @@ int RGYFAWDecoder::decode(RGYFAWDecoderOutput& output, const uint8_t *input, con
         bufferIn.append(input, inputLength);
         inputDataAppended = true;
 
+        // fawstart1とfawstart2を1回の走査で探索
+        const RGYMemMemNeedle needles[2] = {
+            { fawstart1.data(), fawstart1.size() },
+            { fawstart2.data(), fawstart2.size() }
+        };
+        indexIn.hitsTmp.clear();
+        funcMemMemMulti(indexIn.hitsTmp, bufferIn.data(), bufferIn.size(), needles, _countof(needles));
+        const bool foundStart1 = std::any_of(indexIn.hitsTmp.begin(), indexIn.hitsTmp.end(), [](const RGYMemMemHit& h) { return h.id == 0; });
+        const bool foundStart2 = std::any_of(indexIn.hitsTmp.begin(), indexIn.hitsTmp.end(), [](const RGYMemMemHit& h) { return h.id == 1; });
+
         int64_t ret0 = 0, ret1 = 0;
-        if ((ret0 = funcMemMemFAWStart1(bufferIn.data(), bufferIn.size())) != RGY_MEMMEM_NOT_FOUND) {
+        if (foundStart1) {
             fawmode = RGYFAWMode::Full;
-        } else if ((ret0 = funcMemMem(bufferIn.data(), bufferIn.size(), fawstart2.data(), fawstart2.size())) != RGY_MEMMEM_NOT_FOUND) {
+        } else if (foundStart2) {
             fawmode = RGYFAWMode::Half;
             appendFAWHalf(bufferIn.data(), bufferIn.size());
             bufferIn.clear();
@@ -368,29 +455,87 @@ int RGYFAWDecoder::decode(RGYFAWDecoderOutput& output, const uint8_t *input, con
     if (!inputDataAppended) {
         if (fawmode == RGYFAWMode::Full) {
             bufferIn.append(input, inputLength);
+            inputDataAppended = true;
         } else if (fawmode == RGYFAWMode::Half) {
             appendFAWHalf(input, inputLength);
-        } else if (fawmode == RGYFAWMode::Mix) {
-            appendFAWMix(input, inputLength);
+            inputDataAppended = true;
         }
-        inputDataAppended = true;
+        // Mixの場合は、decodeFAWMix内でデコードと並行して分離する
     }
 
     // デコード
     if (fawmode == RGYFAWMode::Full) {
-        decode(output[0], bufferIn);
+        decode(output[0], bufferIn, indexIn);
     } else if (fawmode == RGYFAWMode::Half) {
-        decode(output[0], bufferHalf0);
+        decode(output[0], bufferHalf0, indexHalf0);
     } else if (fawmode == RGYFAWMode::Mix) {
-        decode(output[0], bufferHalf0);
-        decode(output[1], bufferHalf1);
+        decodeFAWMix(output, (inputDataAppended) ? nullptr : input, (inputDataAppended) ? 0 : inputLength);
     }
     return 0;
 }
 
-int RGYFAWDecoder::decode(std::vector<uint8_t>& output, RGYFAWBitstream& input) {
+// Mixの2つのストリームは独立しているので、ワーカースレッドで並列にデコードする
+// また、新たな入力の分離はデコードと並行して行い、そのデコードは次回に回す
+void RGYFAWDecoder::decodeFAWMix(RGYFAWDecoderOutput& output, const uint8_t *data, const size_t dataLength) {
+    workers[0].run([this, &output]() {
+        decode(output[0], bufferHalf0, indexHalf0);
+    });
+    workers[1].run([this, &output]() {
+        decode(output[1], bufferHalf1, indexHalf1);
+    });
+    const size_t splitLength = dataLength / sizeof(short);
+    if (data != nullptr && splitLength > 0) {
+        splitHalf0.resize(splitLength);
+        splitHalf1.resize(splitLength);
+        funcSplitAudio16to8x2(splitHalf0.data(), splitHalf1.data(), (const short *)data, splitLength);
+    }
+    workers[0].wait();
+    workers[1].wait();
+
+    if (data != nullptr && splitLength > 0) {
+        bufferHalf0.append(splitHalf0.data(), splitLength);
+        bufferHalf1.append(splitHalf1.data(), splitLength);
+    }
+}
+
+void RGYFAWDecoder::updateIndex(RGYFAWMarkerIndex& index, const RGYFAWBitstream& input) {
+    const uint64_t dataStart = input.dataOffset();
+    const uint64_t dataFin = dataStart + input.size();
+    if (index.scanned > dataFin) {
+        // 入力がclearされている
+        index.clear();
+    }
+    // 出力済みの位置のマーカーを削除
+    index.markers.erase(index.markers.begin(), std::find_if(index.markers.begin(), index.markers.end(), [dataStart](const RGYFAWMarker& m) { return m.pos >= dataStart; }));
+    index.cursor = 0;
+
+    // 前回の走査の末尾にまたがるマーカーを検出できるよう、その分だけ戻って走査する
+    const uint64_t overlap = std::max(fawstart1.size(), fawfin1.size()) - 1;
+    const uint64_t scanStart = std::max(dataStart, (index.scanned > overlap) ? index.scanned - overlap : 0);
+    if (scanStart >= dataFin) {
+        return;
+    }
+    const RGYMemMemNeedle needles[2] = {
+        { fawstart1.data(), fawstart1.size() },
+        { fawfin1.data(), fawfin1.size() }
+    };
+    static_assert(RGY_FAW_MARKER_START1 == 0 && RGY_FAW_MARKER_FIN1 == 1, "needles must match RGYFAWMarkerType");
+    index.hitsTmp.clear();
+    funcMemMemMulti(index.hitsTmp, input.data() + (scanStart - dataStart), (size_t)(dataFin - scanStart), needles, _countof(needles));
+    for (const auto& hit : index.hitsTmp) {
+        const uint64_t pos = scanStart + hit.pos;
+        if (pos + needles[hit.id].size <= index.scanned) {
+            continue; // 前回の走査で検出済み
+        }
+        index.markers.push_back({ pos, hit.id });
+    }
+    index.scanned = dataFin;
+}
+
+int RGYFAWDecoder::decode(std::vector<uint8_t>& output, RGYFAWBitstream& input, RGYFAWMarkerIndex& index) {
+    updateIndex(index, input);
     while (input.size() > 0) {
-        auto ret = decodeBlock(output, input);
+        auto ret = decodeBlock(output, input, index);
         if (ret == 0) {
             break;
         }
@@ -398,27 +543,41 @@ int RGYFAWDecoder::decode(std::vector<uint8_t>& output, RGYFAWBitstream& input)
     return 0;
 }
 
-int RGYFAWDecoder::decodeBlock(std::vector<uint8_t>& output, RGYFAWBitstream& input) {
-    auto posStart = funcMemMemFAWStart1(input.data(), input.size());
-    if (posStart == RGY_MEMMEM_NOT_FOUND) {
+int RGYFAWDecoder::decodeBlock(std::vector<uint8_t>& output, RGYFAWBitstream& input, RGYFAWMarkerIndex& index) {
+    const uint64_t dataStart = input.dataOffset();
+    const auto& markers = index.markers;
+    while (index.cursor < markers.size() && markers[index.cursor].pos < dataStart) {
+        index.cursor++;
+    }
+    size_t idxStart = index.cursor;
+    while (idxStart < markers.size() && markers[idxStart].type != RGY_FAW_MARKER_START1) {
+        idxStart++;
+    }
+    if (idxStart >= markers.size()) {
         return 0;
     }
+    size_t posStart = (size_t)(markers[idxStart].pos - dataStart);
     input.parseAACHeader(input.data() + posStart + fawstart1.size());
 
-    auto posFin = funcMemMem(input.data() + posStart + fawstart1.size(), input.size() - posStart - fawstart1.size(), fawfin1.data(), fawfin1.size());
-    if (posFin == RGY_MEMMEM_NOT_FOUND) {
+    size_t idxFin = idxStart + 1;
+    while (idxFin < markers.size()
+        && (markers[idxFin].type != RGY_FAW_MARKER_FIN1 || markers[idxFin].pos < markers[idxStart].pos + fawstart1.size())) {
+        idxFin++;
+    }
+    if (idxFin >= markers.size()) {
         return 0;
     }
-    posFin += posStart + fawstart1.size(); // データの先頭からの位置に変更
+    const size_t posFin = (size_t)(markers[idxFin].pos - dataStart);
 
     // pos_start から pos_fin までの間に、別のfawstart1がないか探索する
-    while (posStart + fawstart1.size() < posFin) {
-        auto ret = funcMemMemFAWStart1(input.data() + posStart + fawstart1.size(), posFin - posStart - fawstart1.size());
-        if (ret == RGY_MEMMEM_NOT_FOUND) {
-            break;
+    for (size_t idx = idxStart + 1; idx < idxFin; idx++) {
+        const size_t pos = (size_t)(markers[idx].pos - dataStart);
+        if (markers[idx].type == RGY_FAW_MARKER_START1
+            && pos >= posStart + fawstart1.size()
+            && pos + fawstart1.size() <= posFin) {
+            posStart = pos;
+            input.parseAACHeader(input.data() + posStart + fawstart1.size());
         }
-        posStart += ret + fawstart1.size();
-        input.parseAACHeader(input.data() + posStart + fawstart1.size());
     }
 
     if (posStart + fawstart1.size() + 4 >= posFin) {
@@ -427,7 +586,7 @@ int RGYFAWDecoder::decodeBlock(std::vector<uint8_t>& output, RGYFAWBitstream& in
         return 1;
     }
     const size_t blockSize = posFin - posStart - fawstart1.size() - 4 /*checksum*/;
-    const uint32_t checksumCalc = faw_checksum_calc(input.data() + posStart + fawstart1.size(), blockSize);
+    const uint32_t checksumCalc = funcChecksum(input.data() + posStart + fawstart1.size(), blockSize);
     const uint32_t checksumRead = faw_checksum_read(input.data() + posFin - 4);
     // checksumとフレーム長が一致しない場合、そのデータは破棄
     if (checksumCalc != checksumRead || blockSize != input.aacFrameSize()) {
@@ -497,6 +656,8 @@ void RGYFAWDecoder::fin(RGYFAWDecoderOutput& output) {
     } else if (fawmode == RGYFAWMode::Half) {
         fin(output[0], bufferHalf0);
     } else if (fawmode == RGYFAWMode::Mix) {
+        // 前回分離した入力のデコードが残っている
+        decodeFAWMix(output, nullptr, 0);
         fin(output[0], bufferHalf0);
         fin(output[1], bufferHalf1);
     }
@@ -517,7 +678,8 @@ RGYFAWEncoder::RGYFAWEncoder() :
     inputAACPosByte(0),
     outputFAWPosByte(0),
     bufferIn(),
-    bufferTmp() {
+    bufferTmp(),
+    funcChecksum(get_faw_checksum_func()) {
 
 }
 
@@ -598,7 +760,7 @@ int RGYFAWEncoder::encode(std::vector<uint8_t>& output) {
 }
 
 void RGYFAWEncoder::encodeBlock(const uint8_t *data, const size_t dataLength) {
-    const uint32_t checksumCalc = faw_checksum_calc(data, dataLength);
+    const uint32_t checksumCalc = funcChecksum(data, dataLength);
 
     bufferTmp.append(fawstart1.data(), fawstart1.size());
     outputFAWPosByte += fawstart1.size();
@@ -31,6 +31,10 @@
 #include <cstdint>
 #include <array>
 #include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
 #include "rgy_wav_parser.h"
 #include "rgy_memmem.h"
 
@@ -58,8 +62,15 @@ size_t rgy_memmem_fawstart1_avx512bw(const void *data_, const size_t data_size);
 void rgy_convert_audio_16to8(uint8_t *dst, const short *src, const size_t n);
 void rgy_convert_audio_16to8_avx2(uint8_t *dst, const short *src, const size_t n);
 
+void rgy_convert_audio_16to8_avx512bw(uint8_t *dst, const short *src, const size_t n);
+
 void rgy_split_audio_16to8x2(uint8_t *dst0, uint8_t *dst1, const short *src, const size_t n);
 void rgy_split_audio_16to8x2_avx2(uint8_t *dst0, uint8_t *dst1, const short *src, const size_t n);
+void rgy_split_audio_16to8x2_avx512bw(uint8_t *dst0, uint8_t *dst1, const short *src, const size_t n);
+
+uint32_t rgy_faw_checksum_c(const uint8_t *buf, const size_t len);
+uint32_t rgy_faw_checksum_avx2(const uint8_t *buf, const size_t len);
+uint32_t rgy_faw_checksum_avx512bw(const uint8_t *buf, const size_t len);
 
 using RGYFAWDecoderOutput = std::array<std::vector<uint8_t>, 2>;
 
@@ -113,6 +124,7 @@ public:
     const uint8_t *data() const { return buffer.data() + bufferOffset; }
     size_t size() const { return bufferLength; }
     uint64_t inputLength() const { return inputLengthByte; }
+    uint64_t dataOffset() const { return inputLengthByte - bufferLength; } // data()の入力先頭からの位置
     uint64_t inputSampleStart() const { return (inputLengthByte - bufferLength) / bytePerWholeSample; }
     uint64_t inputSampleFin() const { return inputLengthByte / bytePerWholeSample; }
     uint64_t outputSamples() const { return outSamples; }
@@ -130,6 +142,55 @@ public:
     uint32_t aacFrameSize() const;
 };
 
+enum RGYFAWMarkerType {
+    RGY_FAW_MARKER_START1 = 0,
+    RGY_FAW_MARKER_FIN1,
+};
+
+struct RGYFAWMarker {
+    uint64_t pos; // 入力の先頭からの位置
+    int type;     // RGYFAWMarkerType
+};
+
+// RGYFAWBitstream中のfawstart1/fawfin1の位置の一覧
+// 追加されたデータのみを走査して更新する
+struct RGYFAWMarkerIndex {
+    std::vector<RGYFAWMarker> markers;
+    size_t cursor;
+    uint64_t scanned; // 走査済みの位置 (入力の先頭から)
+    std::vector<RGYMemMemHit> hitsTmp;
+
+    RGYFAWMarkerIndex() : markers(), cursor(0), scanned(0), hitsTmp() {};
+    void clear() {
+        markers.clear();
+        cursor = 0;
+        scanned = 0;
+    }
+};
+
+// Mixのデコードに使用するワーカースレッド
+// スレッドは最初のrun()で起動し、破棄されるまで再利用する
+class RGYFAWWorker {
+private:
+    std::thread thread;
+    std::mutex mtx;
+    std::condition_variable cond;
+    std::function<void()> task;
+    bool taskQueued;
+    bool taskRunning;
+    bool abort;
+
+    void threadFunc();
+public:
+    RGYFAWWorker();
+    ~RGYFAWWorker();
+    RGYFAWWorker(const RGYFAWWorker&) = delete;
+    RGYFAWWorker& operator=(const RGYFAWWorker&) = delete;
+
+    void run(std::function<void()> func);
+    void wait();
+};
+
 class RGYFAWDecoder {
 private:
     RGYWAVHeader wavheader;
@@ -140,10 +201,19 @@ private:
     RGYFAWBitstream bufferHalf0;
     RGYFAWBitstream bufferHalf1;
 
-    decltype(rgy_memmem_c)* funcMemMem;
+    RGYFAWMarkerIndex indexIn;
+    RGYFAWMarkerIndex indexHalf0;
+    RGYFAWMarkerIndex indexHalf1;
+
+    std::vector<uint8_t> splitHalf0; // Mix時に分離したデータの一時バッファ
+    std::vector<uint8_t> splitHalf1;
+    std::array<RGYFAWWorker, 2> workers; // Mix時に2つのストリームをデコードする
+
+    decltype(rgy_memmem_multi_c)* funcMemMemMulti;
     decltype(rgy_memmem_fawstart1_c)* funcMemMemFAWStart1;
     decltype(rgy_convert_audio_16to8)* funcAudio16to8;
     decltype(rgy_split_audio_16to8x2)* funcSplitAudio16to8x2;
+    decltype(rgy_faw_checksum_c)* funcChecksum;
 public:
     RGYFAWDecoder();
     ~RGYFAWDecoder();
@@ -156,10 +226,12 @@ public:
 private:
     void appendFAWHalf(const uint8_t *data, const size_t dataLength);
     void appendFAWMix(const uint8_t *data, const size_t dataLength);
+    void decodeFAWMix(RGYFAWDecoderOutput& output, const uint8_t *data, const size_t dataLength);
 
     void setWavInfo();
-    int decode(std::vector<uint8_t>& output, RGYFAWBitstream& input);
-    int decodeBlock(std::vector<uint8_t>& output, RGYFAWBitstream& input);
+    void updateIndex(RGYFAWMarkerIndex& index, const RGYFAWBitstream& input);
+    int decode(std::vector<uint8_t>& output, RGYFAWBitstream& input, RGYFAWMarkerIndex& index);
+    int decodeBlock(std::vector<uint8_t>& output, RGYFAWBitstream& input, RGYFAWMarkerIndex& index);
     void addSilent(std::vector<uint8_t>& output, RGYFAWBitstream& input);
     void fin(std::vector<uint8_t>& output, RGYFAWBitstream& input);
 };
@@ -174,6 +246,8 @@ private:
     int64_t outputFAWPosByte;
     RGYFAWBitstream bufferIn;
     RGYFAWBitstream bufferTmp;
+
+    decltype(rgy_faw_checksum_c)* funcChecksum;
 public:
     RGYFAWEncoder();
     ~RGYFAWEncoder();
@@ -37,9 +37,9 @@ size_t rgy_memmem_fawstart1_avx2(const void *data_, const size_t data_size) {
 void rgy_convert_audio_16to8_avx2(uint8_t *dst, const short *src, const size_t n) {
     uint8_t *byte = dst;
     const short *sh = src;
-    uint8_t * const loop_start = (uint8_t *)(((size_t)dst + 31) & ~31);
-    uint8_t * const loop_fin = (uint8_t *)(((size_t)dst + n) & ~31);
     uint8_t * const fin = dst + n;
+    uint8_t * const loop_start = std::min(fin, (uint8_t *)(((size_t)dst + 31) & ~31));
+    uint8_t * const loop_fin = std::max(loop_start, (uint8_t *)(((size_t)dst + n) & ~31));
     __m256i ySA, ySB;
     static const __m256i yConst = _mm256_set1_epi16(128);
     //アライメント調整
@@ -71,7 +71,7 @@ void rgy_convert_audio_16to8_avx2(uint8_t *dst, const short *src, const size_t n
 
 void rgy_split_audio_16to8x2_avx2(uint8_t *dst0, uint8_t *dst1, const short *src, const size_t n) {
     const short *sh = src;
-    const short *sh_fin = src + (n & ~15);
+    const short *sh_fin = src + (n & ~31);
     __m256i y0, y1, y2, y3;
     __m256i yMask = _mm256_srli_epi16(_mm256_cmpeq_epi8(_mm256_setzero_si256(), _mm256_setzero_si256()), 8);
     __m256i yConst = _mm256_set1_epi8(-128);
@@ -89,10 +89,46 @@ void rgy_split_audio_16to8x2_avx2(uint8_t *dst0, uint8_t *dst1, const short *src
         _mm256_storeu_si256((__m256i*)dst0, y0);
         _mm256_storeu_si256((__m256i*)dst1, y2);
     }
-    sh_fin = sh + (n & 15);
+    sh_fin = src + n;
     for (; sh < sh_fin; sh++, dst0++, dst1++) {
         *dst0 = (*sh >> 8) + 128;
         *dst1 = (*sh & 0xff) + 128;
     }
 }
+
+uint32_t rgy_faw_checksum_avx2(const uint8_t *buf, const size_t len) {
+    //16bit単位の加算はオーバーフローしても下位16bitは一致する
+    __m256i ySum = _mm256_setzero_si256();
+    __m256i yXor = _mm256_setzero_si256();
+    const size_t fin32 = len & ~31;
+    size_t i = 0;
+    for (; i < fin32; i += 32) {
+        const __m256i y0 = _mm256_loadu_si256((const __m256i*)(buf + i));
+        ySum = _mm256_add_epi16(ySum, y0);
+        yXor = _mm256_xor_si256(yXor, y0);
+    }
+    __m128i xSum = _mm_add_epi16(_mm256_castsi256_si128(ySum), _mm256_extracti128_si256(ySum, 1));
+    __m128i xXor = _mm_xor_si128(_mm256_castsi256_si128(yXor), _mm256_extracti128_si256(yXor, 1));
+    xSum = _mm_add_epi16(xSum, _mm_srli_si128(xSum, 8));
+    xXor = _mm_xor_si128(xXor, _mm_srli_si128(xXor, 8));
+    xSum = _mm_add_epi16(xSum, _mm_srli_si128(xSum, 4));
+    xXor = _mm_xor_si128(xXor, _mm_srli_si128(xXor, 4));
+    xSum = _mm_add_epi16(xSum, _mm_srli_si128(xSum, 2));
+    xXor = _mm_xor_si128(xXor, _mm_srli_si128(xXor, 2));
+    uint32_t sum = (uint32_t)_mm_extract_epi16(xSum, 0);
+    uint32_t xor_ = (uint32_t)_mm_extract_epi16(xXor, 0);
+    //残り
+    const size_t fin_mod2 = (len & (~1));
+    for (; i < fin_mod2; i += 2) {
+        uint32_t v = *(uint16_t *)(buf + i);
+        sum += v;
+        xor_ ^= v;
+    }
+    if ((len & 1) != 0) {
+        uint32_t v = *(uint8_t *)(buf + len - 1);
+        sum += v;
+        xor_ ^= v;
+    }
+    return (sum & 0xffff) | ((xor_ & 0xffff) << 16);
+}
 #endif
@@ -0,0 +1,113 @@
+﻿// -----------------------------------------------------------------------------------------
+// QSVEnc/NVEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2023 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#define RGY_MEMMEM_AVX512
+#include "rgy_faw.h"
+
+#if defined(_M_X64) || defined(__x86_64)
+
+size_t rgy_memmem_fawstart1_avx512bw(const void *data_, const size_t data_size) {
+    return rgy_memmem_avx512_imp(data_, data_size, fawstart1.data(), fawstart1.size());
+}
+
+void rgy_convert_audio_16to8_avx512bw(uint8_t *dst, const short *src, const size_t n) {
+    uint8_t *byte = dst;
+    const short *sh = src;
+    uint8_t * const loop_fin = dst + (n & ~63);
+    uint8_t * const fin = dst + n;
+    const __m512i zConst = _mm512_set1_epi16(128);
+    //packusの代わりにcvtepi16_epi8で並び替え不要
+    for (; byte < loop_fin; byte += 64, sh += 64) {
+        __m512i zA = _mm512_loadu_si512((const __m512i*)(sh + 0));
+        __m512i zB = _mm512_loadu_si512((const __m512i*)(sh + 32));
+        zA = _mm512_add_epi16(_mm512_srai_epi16(zA, 8), zConst);
+        zB = _mm512_add_epi16(_mm512_srai_epi16(zB, 8), zConst);
+        _mm256_storeu_si256((__m256i *)(byte + 0), _mm512_cvtepi16_epi8(zA));
+        _mm256_storeu_si256((__m256i *)(byte + 32), _mm512_cvtepi16_epi8(zB));
+    }
+    //残り
+    for (; byte < fin; byte++, sh++) {
+        *byte = (*sh >> 8) + 128;
+    }
+}
+
+void rgy_split_audio_16to8x2_avx512bw(uint8_t *dst0, uint8_t *dst1, const short *src, const size_t n) {
+    const short *sh = src;
+    const short *sh_fin = src + (n & ~31);
+    const __m512i zConst = _mm512_set1_epi8(-128);
+    for (; sh < sh_fin; sh += 32, dst0 += 32, dst1 += 32) {
+        const __m512i z0 = _mm512_add_epi8(_mm512_loadu_si512((const __m512i*)sh), zConst);
+        _mm256_storeu_si256((__m256i*)dst0, _mm512_cvtepi16_epi8(_mm512_srli_epi16(z0, 8))); //Upper8bit
+        _mm256_storeu_si256((__m256i*)dst1, _mm512_cvtepi16_epi8(z0));                       //Lower8bit
+    }
+    sh_fin = src + n;
+    for (; sh < sh_fin; sh++, dst0++, dst1++) {
+        *dst0 = (*sh >> 8) + 128;
+        *dst1 = (*sh & 0xff) + 128;
+    }
+}
+
+uint32_t rgy_faw_checksum_avx512bw(const uint8_t *buf, const size_t len) {
+    //16bit単位の加算はオーバーフローしても下位16bitは一致する
+    __m512i zSum = _mm512_setzero_si512();
+    __m512i zXor = _mm512_setzero_si512();
+    const size_t fin64 = len & ~63;
+    size_t i = 0;
+    for (; i < fin64; i += 64) {
+        const __m512i z0 = _mm512_loadu_si512((const __m512i*)(buf + i));
+        zSum = _mm512_add_epi16(zSum, z0);
+        zXor = _mm512_xor_si512(zXor, z0);
+    }
+    //残りの偶数byteはマスクロードで処理
+    const size_t fin_mod2 = (len & (~1));
+    if (i < fin_mod2) {
+        const __mmask32 mask = (__mmask32)((1ull << ((fin_mod2 - i) / 2)) - 1);
+        const __m512i z0 = _mm512_maskz_loadu_epi16(mask, (const void *)(buf + i));
+        zSum = _mm512_add_epi16(zSum, z0);
+        zXor = _mm512_xor_si512(zXor, z0);
+    }
+    __m256i ySum = _mm256_add_epi16(_mm512_castsi512_si256(zSum), _mm512_extracti64x4_epi64(zSum, 1));
+    __m256i yXor = _mm256_xor_si256(_mm512_castsi512_si256(zXor), _mm512_extracti64x4_epi64(zXor, 1));
+    __m128i xSum = _mm_add_epi16(_mm256_castsi256_si128(ySum), _mm256_extracti128_si256(ySum, 1));
+    __m128i xXor = _mm_xor_si128(_mm256_castsi256_si128(yXor), _mm256_extracti128_si256(yXor, 1));
+    xSum = _mm_add_epi16(xSum, _mm_srli_si128(xSum, 8));
+    xXor = _mm_xor_si128(xXor, _mm_srli_si128(xXor, 8));
+    xSum = _mm_add_epi16(xSum, _mm_srli_si128(xSum, 4));
+    xXor = _mm_xor_si128(xXor, _mm_srli_si128(xXor, 4));
+    xSum = _mm_add_epi16(xSum, _mm_srli_si128(xSum, 2));
+    xXor = _mm_xor_si128(xXor, _mm_srli_si128(xXor, 2));
+    uint32_t sum = (uint32_t)_mm_extract_epi16(xSum, 0);
+    uint32_t xor_ = (uint32_t)_mm_extract_epi16(xXor, 0);
+    if ((len & 1) != 0) {
+        uint32_t v = *(uint8_t *)(buf + len - 1);
+        sum += v;
+        xor_ ^= v;
+    }
+    return (sum & 0xffff) | ((xor_ & 0xffff) << 16);
+}
+
+#endif
@@ -0,0 +1,554 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <filesystem>
+#include <system_error>
+#include "rgy_osdep.h"
+#include "rgy_ini.h"
+
+static inline bool ini_is_space(char c) {
+    return c == ' ' || c == '\t';
+}
+
+static std::string ini_trim(const std::string& str) {
+    size_t start = 0, fin = str.length();
+    while (start < fin && ini_is_space(str[start])) start++;
+    while (fin > start && ini_is_space(str[fin-1])) fin--;
+    return str.substr(start, fin - start);
+}
+
+//セクション名・キー名の比較用 (マルチバイト文字は変換しない)
+static inline bool ini_is_blank(const std::string& str) {
+    return std::all_of(str.begin(), str.end(), ini_is_space);
+}
+
+static std::string ini_tolower(const char *str) {
+    std::string lower = ini_trim(str);
+    for (auto& c : lower) {
+        if ('A' <= c && c <= 'Z') c += 'a' - 'A';
+    }
+    return lower;
+}
+
+RGYIniFile::RGYIniFile() :
+    filename(),
+    loaded(false),
+    dirty(false),
+    hasBOM(false),
+    newline("\r\n"),
+    fileSize(0),
+    fileTime(0),
+    preamble(),
+    sections(),
+    sectionIndex(),
+    changes() {
+}
+
+RGYIniFile::~RGYIniFile() {
+    clear();
+}
+
+void RGYIniFile::clear() {
+    loaded = false;
+    dirty = false;
+    hasBOM = false;
+    newline = "\r\n";
+    fileSize = 0;
+    fileTime = 0;
+    preamble.clear();
+    sections.clear();
+    sectionIndex.clear();
+    changes.clear();
+}
+
+int RGYIniFile::updateFileStat(uint64_t *size, int64_t *time) const {
+    std::error_code ec;
+    const auto path = std::filesystem::path(filename);
+    if (!std::filesystem::exists(path, ec)) {
+        *size = 0;
+        *time = 0;
+        return 1;
+    }
+    *size = (uint64_t)std::filesystem::file_size(path, ec);
+    if (ec) return 1;
+    const auto ftime = std::filesystem::last_write_time(path, ec);
+    if (ec) return 1;
+    *time = (int64_t)ftime.time_since_epoch().count();
+    return 0;
+}
+
+int RGYIniFile::load(const char *path) {
+    clear();
+    filename = (path) ? path : "";
+    if (filename.length() == 0) {
+        return 1;
+    }
+    std::vector<char> data;
+    if (updateFileStat(&fileSize, &fileTime) == 0) {
+        std::ifstream ifs(std::filesystem::path(filename), std::ios::in | std::ios::binary);
+        if (!ifs) {
+            return 1;
+        }
+        data.resize((size_t)fileSize);
+        if (fileSize > 0 && !ifs.read(data.data(), data.size())) {
+            return 1;
+        }
+    }
+    //ファイルが存在しない場合は空のiniとして扱う (保存時に作成される)
+    return parse(data.data(), data.size());
+}
+
+int RGYIniFile::reloadIfModified() {
+    if (filename.length() == 0) {
+        return 1;
+    }
+    uint64_t size = 0;
+    int64_t time = 0;
+    updateFileStat(&size, &time);
+    if (loaded && size == fileSize && time == fileTime) {
+        return 0;
+    }
+    //外部で変更された場合は読み込みなおし、未保存の変更のみを反映しなおす
+    auto pending = std::move(changes);
+    const auto path = filename;
+    const int ret = load(path.c_str());
+    if (ret == 0) {
+        for (const auto& change : pending) {
+            if (change.hasKey) {
+                applyString(change.section.c_str(), change.key.c_str(), (change.hasValue) ? change.value.c_str() : nullptr);
+            } else {
+                applyRemoveSection(change.section.c_str());
+            }
+        }
+    }
+    changes = std::move(pending);
+    dirty = !changes.empty();
+    return ret;
+}
+
+int RGYIniFile::parse(const char *data, size_t dataSize) {
+    preamble.clear();
+    sections.clear();
+    sectionIndex.clear();
+    changes.clear();
+    loaded = false;
+    dirty = false;
+    hasBOM = false;
+    newline = "\r\n";
+
+    static const uint8_t UTF8_BOM[] = { 0xEF, 0xBB, 0xBF };
+    if (dataSize >= 2
+        && (((uint8_t)data[0] == 0xFF && (uint8_t)data[1] == 0xFE)
+         || ((uint8_t)data[0] == 0xFE && (uint8_t)data[1] == 0xFF))) {
+        //UTF-16は扱わない (呼び出し側でWin32 APIにフォールバックする)
+        return 1;
+    }
+    size_t pos = 0;
+    if (dataSize >= sizeof(UTF8_BOM) && memcmp(data, UTF8_BOM, sizeof(UTF8_BOM)) == 0) {
+        hasBOM = true;
+        pos = sizeof(UTF8_BOM);
+    }
+    bool newlineDetected = false;
+    bool inSection = false;
+    while (pos < dataSize) {
+        size_t fin = pos;
+        while (fin < dataSize && data[fin] != '\n' && data[fin] != '\r') fin++;
+        auto line = parseLine(std::string(data + pos, fin - pos), inSection);
+        if (line.type == RGY_INI_LINE_SECTION) {
+            inSection = true;
+            RGYIniSection section;
+            section.header = std::move(line);
+            section.insertPos = 0;
+            sections.push_back(std::move(section));
+        } else if (inSection) {
+            sections.back().lines.push_back(std::move(line));
+        } else {
+            preamble.push_back(std::move(line));
+        }
+        if (fin >= dataSize) {
+            break;
+        }
+        size_t next = fin + 1;
+        if (data[fin] == '\r' && next < dataSize && data[next] == '\n') {
+            next++;
+        }
+        if (!newlineDetected) {
+            newline = std::string(data + fin, next - fin);
+            newlineDetected = true;
+        }
+        pos = next;
+    }
+    for (auto& section : sections) {
+        buildKeyIndex(section);
+    }
+    buildSectionIndex();
+    loaded = true;
+    return 0;
+}
+
+RGYIniFile::RGYIniLine RGYIniFile::parseLine(const std::string& text, bool inSection) {
+    RGYIniLine line;
+    line.type = RGY_INI_LINE_OTHER;
+    line.text = text;
+    const auto trimmed = ini_trim(text);
+    if (trimmed.length() == 0 || trimmed[0] == ';') {
+        return line;
+    }
+    if (trimmed[0] == '[') {
+        //セクション名に']'を含められるよう、最後の']'までをセクション名とする
+        const auto end = trimmed.rfind(']');
+        line.type = RGY_INI_LINE_SECTION;
+        line.name = ini_trim(trimmed.substr(1, (end == std::string::npos) ? std::string::npos : end - 1));
+        return line;
+    }
+    const auto eq = trimmed.find('=');
+    if (inSection && eq != std::string::npos) {
+        line.type = RGY_INI_LINE_KEY;
+        line.name = ini_trim(trimmed.substr(0, eq));
+        line.value = ini_trim(trimmed.substr(eq + 1));
+    }
+    return line;
+}
+
+void RGYIniFile::buildKeyIndex(RGYIniSection& section) {
+    section.keys.clear();
+    section.insertPos = 0;
+    for (size_t i = 0; i < section.lines.size(); i++) {
+        const auto& line = section.lines[i];
+        if (!ini_is_blank(line.text)) {
+            section.insertPos = i + 1;
+        }
+        //同名のキーが複数ある場合は最初のものを使用する
+        if (line.type == RGY_INI_LINE_KEY) {
+            section.keys.emplace(ini_tolower(line.name.c_str()), i);
+        }
+    }
+}
+
+void RGYIniFile::buildSectionIndex() {
+    sectionIndex.clear();
+    for (size_t i = 0; i < sections.size(); i++) {
+        //同名のセクションが複数ある場合は最初のものを使用する
+        sectionIndex.emplace(ini_tolower(sections[i].header.name.c_str()), i);
+    }
+}
+
+bool RGYIniFile::hasSection(const char *section) const {
+    return section && sectionIndex.count(ini_tolower(section)) > 0;
+}
+
+std::vector<std::string> RGYIniFile::getSectionNames() const {
+    std::vector<std::string> names;
+    for (size_t i = 0; i < sections.size(); i++) {
+        const auto& name = sections[i].header.name;
+        //同名のセクションは最初のもののみ
+        const auto sec = sectionIndex.find(ini_tolower(name.c_str()));
+        if (sec != sectionIndex.end() && sec->second == i) {
+            names.push_back(name);
+        }
+    }
+    return names;
+}
+
+const std::string *RGYIniFile::getValue(const char *section, const char *key) const {
+    if (!section || !key) {
+        return nullptr;
+    }
+    const auto sec = sectionIndex.find(ini_tolower(section));
+    if (sec == sectionIndex.end()) {
+        return nullptr;
+    }
+    const auto& target = sections[sec->second];
+    const auto k = target.keys.find(ini_tolower(key));
+    if (k == target.keys.end()) {
+        return nullptr;
+    }
+    return &target.lines[k->second].value;
+}
+
+std::string RGYIniFile::getString(const char *section, const char *key, const char *defaultString) const {
+    const auto value = getValue(section, key);
+    if (!value) {
+        //GetPrivateProfileStringはデフォルト値の末尾の空白を除去する
+        std::string def = (defaultString) ? defaultString : "";
+        while (def.length() > 0 && ini_is_space(def.back())) def.pop_back();
+        return def;
+    }
+    //前後が同じ引用符で囲まれている場合は除去する
+    if (value->length() >= 2
+        && (value->front() == '"' || value->front() == '\'')
+        && value->front() == value->back()) {
+        return value->substr(1, value->length() - 2);
+    }
+    return *value;
+}
+
+size_t RGYIniFile::getString(const char *section, const char *key, const char *defaultString, char *buf, size_t bufSize) const {
+    if (!buf || bufSize == 0) {
+        return 0;
+    }
+    const auto str = getString(section, key, defaultString);
+    const size_t len = (std::min)(str.length(), bufSize - 1);
+    memcpy(buf, str.c_str(), len);
+    buf[len] = '\0';
+    return len;
+}
+
+int RGYIniFile::getInt(const char *section, const char *key, int defaultValue) const {
+    const auto value = getValue(section, key);
+    if (!value || value->length() == 0) {
+        return defaultValue;
+    }
+    //GetPrivateProfileIntと同様に、先頭から数値として解釈できる部分までを読む
+    const char *ptr = value->c_str();
+    bool negative = false;
+    if (*ptr == '-' || *ptr == '+') {
+        negative = *ptr == '-';
+        ptr++;
+    }
+    uint32_t base = 10;
+    if (ptr[0] == '0' && (ptr[1] == 'x' || ptr[1] == 'X')) {
+        base = 16, ptr += 2;
+    } else if (ptr[0] == '0' && (ptr[1] == 'o' || ptr[1] == 'O')) {
+        base = 8, ptr += 2;
+    } else if (ptr[0] == '0' && (ptr[1] == 'b' || ptr[1] == 'B')) {
+        base = 2, ptr += 2;
+    }
+    uint32_t result = 0;
+    for (; *ptr; ptr++) {
+        uint32_t digit = 0;
+        if ('0' <= *ptr && *ptr <= '9') {
+            digit = *ptr - '0';
+        } else if ('a' <= *ptr && *ptr <= 'f') {
+            digit = *ptr - 'a' + 10;
+        } else if ('A' <= *ptr && *ptr <= 'F') {
+            digit = *ptr - 'A' + 10;
+        } else {
+            break;
+        }
+        if (digit >= base) {
+            break;
+        }
+        result = result * base + digit;
+    }
+    return (negative) ? -(int)result : (int)result;
+}
+
+size_t RGYIniFile::getSection(const char *section, char *buf, size_t bufSize) const {
+    if (!buf || bufSize < 2) {
+        if (buf && bufSize) buf[0] = '\0';
+        return 0;
+    }
+    size_t len = 0;
+    buf[0] = buf[1] = '\0';
+    const auto sec = sectionIndex.find(ini_tolower(section));
+    if (sec == sectionIndex.end()) {
+        return 0;
+    }
+    for (const auto& line : sections[sec->second].lines) {
+        if (line.type != RGY_INI_LINE_KEY) {
+            continue;
+        }
+        const auto entry = line.name + "=" + line.value;
+        //終端の\0\0の分を残して打ち切る
+        if (len + entry.length() + 2 > bufSize) {
+            break;
+        }
+        memcpy(buf + len, entry.c_str(), entry.length() + 1);
+        len += entry.length() + 1;
+        buf[len] = '\0';
+    }
+    return len;
+}
+
+void RGYIniFile::setString(const char *section, const char *key, const char *value) {
+    if (!section) {
+        return;
+    }
+    const bool changed = (key) ? applyString(section, key, value) : applyRemoveSection(section);
+    if (changed) {
+        RGYIniChange change;
+        change.section = section;
+        change.key = (key) ? key : "";
+        change.value = (value) ? value : "";
+        change.hasKey = key != nullptr;
+        change.hasValue = value != nullptr;
+        changes.push_back(std::move(change));
+        dirty = true;
+    }
+}
+
+void RGYIniFile::removeSection(const char *section) {
+    setString(section, nullptr, nullptr);
+}
+
+//索引は変更したセクション内のみ更新する
+bool RGYIniFile::applyString(const char *section, const char *key, const char *value) {
+    const auto sec = sectionIndex.find(ini_tolower(section));
+    if (sec == sectionIndex.end()) {
+        if (!value) {
+            return false;
+        }
+        RGYIniSection newSection;
+        newSection.header.type = RGY_INI_LINE_SECTION;
+        newSection.header.name = ini_trim(section);
+        newSection.header.text = "[" + newSection.header.name + "]";
+        newSection.insertPos = 0;
+        sections.push_back(std::move(newSection));
+        sectionIndex.emplace(ini_tolower(section), sections.size() - 1);
+        return applyString(section, key, value);
+    }
+    auto& target = sections[sec->second];
+    const auto keyLower = ini_tolower(key);
+    const auto k = target.keys.find(keyLower);
+    if (k != target.keys.end()) {
+        const size_t pos = k->second;
+        auto& line = target.lines[pos];
+        if (value) {
+            if (line.value == value) {
+                return false;
+            }
+            line.value = value;
+            line.text = line.name + "=" + line.value;
+            return true;
+        }
+        target.lines.erase(target.lines.begin() + pos);
+        target.keys.erase(k);
+        for (auto& idx : target.keys) {
+            if (idx.second > pos) idx.second--;
+        }
+        //同名のキーが後ろにあれば、そちらが有効になる
+        for (size_t i = pos; i < target.lines.size(); i++) {
+            if (target.lines[i].type == RGY_INI_LINE_KEY && ini_tolower(target.lines[i].name.c_str()) == keyLower) {
+                target.keys[keyLower] = i;
+                break;
+            }
+        }
+        if (pos < target.insertPos) {
+            target.insertPos--;
+            while (target.insertPos > 0 && ini_is_blank(target.lines[target.insertPos - 1].text)) {
+                target.insertPos--;
+            }
+        }
+        return true;
+    }
+    if (!value) {
+        return false;
+    }
+    RGYIniLine line;
+    line.type = RGY_INI_LINE_KEY;
+    line.name = ini_trim(key);
+    line.value = value;
+    line.text = line.name + "=" + line.value;
+    const size_t pos = target.insertPos;
+    target.lines.insert(target.lines.begin() + pos, std::move(line));
+    for (auto& idx : target.keys) {
+        if (idx.second >= pos) idx.second++;
+    }
+    target.keys.emplace(keyLower, pos);
+    target.insertPos++;
+    return true;
+}
+
+bool RGYIniFile::applyRemoveSection(const char *section) {
+    const auto sec = sectionIndex.find(ini_tolower(section));
+    if (sec == sectionIndex.end()) {
+        return false;
+    }
+    sections.erase(sections.begin() + sec->second);
+    //同名のセクションが後ろにあれば、そちらが有効になる
+    buildSectionIndex();
+    return true;
+}
+
+std::string RGYIniFile::toString() const {
+    std::string str;
+    if (hasBOM) {
+        str += "\xEF\xBB\xBF";
+    }
+    for (const auto& line : preamble) {
+        str += line.text;
+        str += newline;
+    }
+    for (const auto& section : sections) {
+        str += section.header.text;
+        str += newline;
+        for (const auto& line : section.lines) {
+            str += line.text;
+            str += newline;
+        }
+    }
+    return str;
+}
+
+int RGYIniFile::save() {
+    if (!loaded || filename.length() == 0) {
+        return 1;
+    }
+    if (!dirty) {
+        return 0;
+    }
+    //他のプロセスが書き込んだ内容を上書きしないよう、読み込みなおしてから変更したキーのみを反映する
+    if (reloadIfModified() != 0 || !loaded) {
+        return 1;
+    }
+    const auto str = toString();
+    //書き込み途中で中断されても元のファイルが壊れないよう、一時ファイルに書き出してから置き換える
+    const auto tmpPath = std::filesystem::path(filename + "." + std::to_string(GetCurrentProcessId()) + ".tmp");
+    {
+        std::ofstream ofs(tmpPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!ofs || !ofs.write(str.c_str(), str.length()) || !ofs.flush()) {
+            ofs.close();
+            std::error_code ec;
+            std::filesystem::remove(tmpPath, ec);
+            return 1;
+        }
+    }
+    const auto dstPath = std::filesystem::path(filename);
+#if defined(_WIN32) || defined(_WIN64)
+    //ReplaceFileは置き換え先が存在しない場合は失敗するので、MoveFileExで移動する
+    const bool replaced = ReplaceFileW(dstPath.c_str(), tmpPath.c_str(), nullptr, REPLACEFILE_IGNORE_MERGE_ERRORS, nullptr, nullptr)
+        || MoveFileExW(tmpPath.c_str(), dstPath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+    std::error_code ecRename;
+    std::filesystem::rename(tmpPath, dstPath, ecRename);
+    const bool replaced = !ecRename;
+#endif
+    if (!replaced) {
+        std::error_code ec;
+        std::filesystem::remove(tmpPath, ec);
+        return 1;
+    }
+    updateFileStat(&fileSize, &fileTime);
+    changes.clear();
+    dirty = false;
+    return 0;
+}
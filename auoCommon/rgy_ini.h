@@ -0,0 +1,129 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#ifndef __RGY_INI_H__
+#define __RGY_INI_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// iniファイルを一度だけ読み込み、メモリ上で検索・更新するためのクラス
+// GetPrivateProfileString/GetPrivateProfileInt/GetPrivateProfileSection/WritePrivateProfileString
+// と同じ結果になるようにしている
+// - セクション名・キー名は大文字小文字を区別しない
+// - 同名のセクション・キーがある場合は最初のものを使用する
+// - ';'で始まる行はコメント
+// 文字列はファイルに記載されたままのバイト列として扱い、文字コードの変換は呼び出し側で行う
+class RGYIniFile {
+private:
+    enum RGYIniLineType {
+        RGY_INI_LINE_OTHER = 0, // 空行・コメント・セクション外の行
+        RGY_INI_LINE_SECTION,
+        RGY_INI_LINE_KEY,
+    };
+    struct RGYIniLine {
+        RGYIniLineType type;
+        std::string text;  // 行全体 (改行を除く)
+        std::string name;  // セクション名 or キー名
+        std::string value; // 値 (前後の空白は除去済み)
+    };
+    struct RGYIniSection {
+        RGYIniLine header;             // セクション行
+        std::vector<RGYIniLine> lines; // セクション内の行 (次のセクション行の手前まで)
+        size_t insertPos;              // 新しいキーを挿入する位置 (最後の空行以外の行の次)
+        std::unordered_map<std::string, size_t> keys; // 小文字化したキー名 -> linesの位置
+    };
+    // 未保存の変更 (保存時にファイルを読み込みなおしてから反映しなおす)
+    struct RGYIniChange {
+        std::string section;
+        std::string key;
+        std::string value;
+        bool hasKey;   // falseならセクションの削除
+        bool hasValue; // falseならキーの削除
+    };
+
+    std::string filename;
+    bool loaded;
+    bool dirty;
+    bool hasBOM;
+    std::string newline;
+    uint64_t fileSize;
+    int64_t fileTime;
+
+    std::vector<RGYIniLine> preamble; // 最初のセクションより前の行
+    std::vector<RGYIniSection> sections;
+    std::unordered_map<std::string, size_t> sectionIndex; // 小文字化したセクション名 -> sectionsの位置
+    std::vector<RGYIniChange> changes;
+public:
+    RGYIniFile();
+    ~RGYIniFile();
+
+    // ファイルを読み込む (ファイルが存在しない場合は空として扱う)
+    // UTF-16のファイルなど扱えないものは1を返し、isLoaded()はfalseになる
+    int load(const char *path);
+    // ファイルが更新されていれば読み込みなおし、未保存の変更を反映しなおす
+    int reloadIfModified();
+    // 変更があればファイルに書き戻す
+    // 他のプロセスによる変更を消さないよう、読み込みなおしてから変更したキーのみを反映し、
+    // 一時ファイルに書き出してから置き換える
+    int save();
+    int parse(const char *data, size_t dataSize);
+    void clear();
+
+    bool isLoaded() const { return loaded; }
+    bool isDirty() const { return dirty; }
+    const std::string& path() const { return filename; }
+
+    bool hasSection(const char *section) const;
+    std::vector<std::string> getSectionNames() const;
+    // 値へのポインタを返す。キーがなければnullptr
+    const std::string *getValue(const char *section, const char *key) const;
+    // GetPrivateProfileString互換 (前後の引用符を除去し、bufSize-1文字で打ち切る)
+    size_t getString(const char *section, const char *key, const char *defaultString, char *buf, size_t bufSize) const;
+    std::string getString(const char *section, const char *key, const char *defaultString) const;
+    // GetPrivateProfileInt互換
+    int getInt(const char *section, const char *key, int defaultValue) const;
+    // GetPrivateProfileSection互換 ("key=value\0key=value\0\0")、戻り値は最後の\0を除く長さ
+    size_t getSection(const char *section, char *buf, size_t bufSize) const;
+
+    // WritePrivateProfileString互換、valueがnullptrならキーを削除する
+    void setString(const char *section, const char *key, const char *value);
+    void removeSection(const char *section);
+
+    std::string toString() const;
+private:
+    void buildSectionIndex();
+    static void buildKeyIndex(RGYIniSection& section);
+    bool applyString(const char *section, const char *key, const char *value);
+    bool applyRemoveSection(const char *section);
+    int updateFileStat(uint64_t *size, int64_t *time) const;
+    static RGYIniLine parseLine(const std::string& text, bool inSection);
+};
+
+#endif //__RGY_INI_H__
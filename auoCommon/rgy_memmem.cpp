@@ -44,12 +44,32 @@ size_t rgy_memmem_c(const void *data_, const size_t data_size, const void *targe
 }
 
 decltype(rgy_memmem_c)* get_memmem_func() {
+    static const RGYSimdFunc<decltype(rgy_memmem_c)*> FUNC_LIST[] = {
 #if defined(_M_IX86) || defined(_M_X64) || defined(__x86_64)
-    const auto simd = get_availableSIMD();
 #if defined(_M_X64) || defined(__x86_64)
-    if ((simd & RGY_SIMD::AVX512BW) == RGY_SIMD::AVX512BW) return rgy_memmem_avx512bw;
+        { RGY_SIMD::AVX512BW, rgy_memmem_avx512bw },
 #endif
-    if ((simd & RGY_SIMD::AVX2) == RGY_SIMD::AVX2) return rgy_memmem_avx2;
+        { RGY_SIMD::AVX2,     rgy_memmem_avx2 },
 #endif
-    return rgy_memmem_c;
+        { RGY_SIMD::NONE,     rgy_memmem_c },
+    };
+    return select_simd_func(FUNC_LIST);
 }
+
+
+void rgy_memmem_multi_c(std::vector<RGYMemMemHit>& hits, const void *data_, const size_t data_size, const RGYMemMemNeedle *needles, const int needle_count) {
+    rgy_memmem_multi_tail(hits, (const uint8_t *)data_, data_size, 0, needles, std::min(needle_count, RGY_MEMMEM_MULTI_MAX_NEEDLES));
+}
+
+decltype(rgy_memmem_multi_c)* get_memmem_multi_func() {
+    static const RGYSimdFunc<decltype(rgy_memmem_multi_c)*> FUNC_LIST[] = {
+#if defined(_M_IX86) || defined(_M_X64) || defined(__x86_64)
+#if defined(_M_X64) || defined(__x86_64)
+        { RGY_SIMD::AVX512BW, rgy_memmem_multi_avx512bw },
+#endif
+        { RGY_SIMD::AVX2,     rgy_memmem_multi_avx2 },
+#endif
+        { RGY_SIMD::NONE,     rgy_memmem_multi_c },
+    };
+    return select_simd_func(FUNC_LIST);
+}
\ No newline at end of file
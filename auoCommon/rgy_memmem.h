@@ -32,6 +32,7 @@
 #include <cstring>
 #include <algorithm>
 #include <limits>
+#include <vector>
 #include "rgy_osdep.h"
 
 size_t rgy_memmem_c(const void *data_, const size_t data_size, const void *target_, const size_t target_size);
@@ -42,6 +43,63 @@ static const auto RGY_MEMMEM_NOT_FOUND = std::numeric_limits<decltype(rgy_memmem
 
 decltype(rgy_memmem_c)* get_memmem_func();
 
+// 複数のパターンを1回の走査で探索する
+static const int RGY_MEMMEM_MULTI_MAX_NEEDLES = 4;
+
+struct RGYMemMemNeedle {
+    const uint8_t *ptr;
+    size_t size;
+};
+
+struct RGYMemMemHit {
+    size_t pos; // データの先頭からの位置
+    int id;     // needlesのインデックス
+};
+
+// data中のすべてのneedleの出現位置(重複を含む)を、位置順(同一位置ならid順)にhitsに追加する
+void rgy_memmem_multi_c(std::vector<RGYMemMemHit>& hits, const void *data_, const size_t data_size, const RGYMemMemNeedle *needles, const int needle_count);
+void rgy_memmem_multi_avx2(std::vector<RGYMemMemHit>& hits, const void *data_, const size_t data_size, const RGYMemMemNeedle *needles, const int needle_count);
+void rgy_memmem_multi_avx512bw(std::vector<RGYMemMemHit>& hits, const void *data_, const size_t data_size, const RGYMemMemNeedle *needles, const int needle_count);
+
+decltype(rgy_memmem_multi_c)* get_memmem_multi_func();
+
+// 先頭/末尾の比較に使う2byteを選ぶ
+// 無音時に頻出する0x00/0x80を避けることで、候補の誤検出を減らす
+static RGY_FORCEINLINE void rgy_memmem_multi_anchor(const RGYMemMemNeedle& needle, size_t& anchor0, size_t& anchor1) {
+    anchor0 = 0;
+    anchor1 = needle.size - 1;
+    auto is_rare = [](const uint8_t v) { return v != 0x00 && v != 0x80; };
+    size_t i = 0;
+    for (; i < needle.size; i++) {
+        if (is_rare(needle.ptr[i])) {
+            anchor0 = i;
+            break;
+        }
+    }
+    for (size_t j = needle.size - 1; j > i; j--) {
+        if (is_rare(needle.ptr[j])) {
+            anchor1 = j;
+            break;
+        }
+    }
+    if (anchor1 <= anchor0) {
+        anchor0 = 0;
+        anchor1 = needle.size - 1;
+    }
+}
+
+// SIMDでの走査が行えない末尾部分の処理
+static RGY_FORCEINLINE void rgy_memmem_multi_tail(std::vector<RGYMemMemHit>& hits, const uint8_t *data, const size_t data_size, size_t i, const RGYMemMemNeedle *needles, const int needle_count) {
+    for (; i < data_size; i++) {
+        for (int k = 0; k < needle_count; k++) {
+            if (i + needles[k].size <= data_size
+                && memcmp(data + i, needles[k].ptr, needles[k].size) == 0) {
+                hits.push_back({ i, k });
+            }
+        }
+    }
+}
+
 #if defined(RGY_MEMMEM_AVX2)
 
 #if defined(_M_IX86) || defined(_M_X64) || defined(__x86_64)
@@ -135,6 +193,49 @@ static RGY_FORCEINLINE size_t rgy_memmem_avx2_imp(const void *data_, const size_
     }
     return RGY_MEMMEM_NOT_FOUND;
 }
+
+static RGY_FORCEINLINE void rgy_memmem_multi_avx2_imp(std::vector<RGYMemMemHit>& hits, const void *data_, const size_t data_size, const RGYMemMemNeedle *needles, const int needle_count) {
+    const uint8_t *data = (const uint8_t *)data_;
+    const int count = std::min(needle_count, RGY_MEMMEM_MULTI_MAX_NEEDLES);
+    __m256i target_first[RGY_MEMMEM_MULTI_MAX_NEEDLES], target_last[RGY_MEMMEM_MULTI_MAX_NEEDLES];
+    size_t anchor0[RGY_MEMMEM_MULTI_MAX_NEEDLES], anchor1[RGY_MEMMEM_MULTI_MAX_NEEDLES];
+    size_t max_anchor = 0;
+    for (int k = 0; k < count; k++) {
+        rgy_memmem_multi_anchor(needles[k], anchor0[k], anchor1[k]);
+        target_first[k] = _mm256_set1_epi8(needles[k].ptr[anchor0[k]]);
+        target_last[k]  = _mm256_set1_epi8(needles[k].ptr[anchor1[k]]);
+        max_anchor = std::max(max_anchor, anchor1[k]);
+    }
+    const int64_t fin64 = (int64_t)data_size - (int64_t)(max_anchor + 32); // 32byteロードが安全に行える限界
+    size_t i = 0;
+    if (fin64 > 0) {
+        const size_t fin = (size_t)fin64;
+        for (; i < fin; i += 32) {
+            uint32_t mask[RGY_MEMMEM_MULTI_MAX_NEEDLES] = { 0 };
+            uint32_t mask_all = 0;
+            for (int k = 0; k < count; k++) {
+                const __m256i r0 = _mm256_loadu_si256((const __m256i*)(data + i + anchor0[k]));
+                const __m256i r1 = _mm256_loadu_si256((const __m256i*)(data + i + anchor1[k]));
+                mask[k] = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(r0, target_first[k]), _mm256_cmpeq_epi8(r1, target_last[k])));
+                mask_all |= mask[k];
+            }
+            //位置順に確認する
+            while (mask_all != 0) {
+                const auto j = CTZ32(mask_all);
+                const size_t pos = i + j;
+                for (int k = 0; k < count; k++) {
+                    if ((mask[k] & (1u << j))
+                        && pos + needles[k].size <= data_size
+                        && memcmp(data + pos, needles[k].ptr, needles[k].size) == 0) {
+                        hits.push_back({ pos, k });
+                    }
+                }
+                mask_all = CLEAR_LEFT_BIT(mask_all);
+            }
+        }
+    }
+    rgy_memmem_multi_tail(hits, data, data_size, i, needles, count);
+}
 #endif //#if defined(_M_IX86) || defined(_M_X64) || defined(__x86_64)
 
 #elif defined(RGY_MEMMEM_AVX512) 
@@ -216,6 +317,49 @@ static RGY_FORCEINLINE size_t rgy_memmem_avx512_imp(const void *data_, const siz
     return RGY_MEMMEM_NOT_FOUND;
 }
 
+static RGY_FORCEINLINE void rgy_memmem_multi_avx512_imp(std::vector<RGYMemMemHit>& hits, const void *data_, const size_t data_size, const RGYMemMemNeedle *needles, const int needle_count) {
+    const uint8_t *data = (const uint8_t *)data_;
+    const int count = std::min(needle_count, RGY_MEMMEM_MULTI_MAX_NEEDLES);
+    __m512i target_first[RGY_MEMMEM_MULTI_MAX_NEEDLES], target_last[RGY_MEMMEM_MULTI_MAX_NEEDLES];
+    size_t anchor0[RGY_MEMMEM_MULTI_MAX_NEEDLES], anchor1[RGY_MEMMEM_MULTI_MAX_NEEDLES];
+    size_t max_anchor = 0;
+    for (int k = 0; k < count; k++) {
+        rgy_memmem_multi_anchor(needles[k], anchor0[k], anchor1[k]);
+        target_first[k] = _mm512_set1_epi8(needles[k].ptr[anchor0[k]]);
+        target_last[k]  = _mm512_set1_epi8(needles[k].ptr[anchor1[k]]);
+        max_anchor = std::max(max_anchor, anchor1[k]);
+    }
+    const int64_t fin64 = (int64_t)data_size - (int64_t)(max_anchor + 64); // 64byteロードが安全に行える限界
+    size_t i = 0;
+    if (fin64 > 0) {
+        const size_t fin = (size_t)fin64;
+        for (; i < fin; i += 64) {
+            uint64_t mask[RGY_MEMMEM_MULTI_MAX_NEEDLES] = { 0 };
+            uint64_t mask_all = 0;
+            for (int k = 0; k < count; k++) {
+                const __m512i r0 = _mm512_loadu_si512((const __m512i*)(data + i + anchor0[k]));
+                const __m512i r1 = _mm512_loadu_si512((const __m512i*)(data + i + anchor1[k]));
+                mask[k] = _mm512_mask_cmpeq_epi8_mask(_mm512_cmpeq_epi8_mask(r0, target_first[k]), r1, target_last[k]);
+                mask_all |= mask[k];
+            }
+            //位置順に確認する
+            while (mask_all != 0) {
+                const auto j = CTZ64(mask_all);
+                const size_t pos = i + j;
+                for (int k = 0; k < count; k++) {
+                    if ((mask[k] & (1ull << j))
+                        && pos + needles[k].size <= data_size
+                        && memcmp(data + pos, needles[k].ptr, needles[k].size) == 0) {
+                        hits.push_back({ pos, k });
+                    }
+                }
+                mask_all = CLEAR_LEFT_BIT(mask_all);
+            }
+        }
+    }
+    rgy_memmem_multi_tail(hits, data, data_size, i, needles, count);
+}
+
 #endif //#if defined(_M_X64) || defined(__x86_64)
 
 #endif //#if defined(RGY_MEMMEM_AVX2)
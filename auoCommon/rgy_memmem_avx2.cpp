@@ -32,4 +32,8 @@
 size_t rgy_memmem_avx2(const void *data_, const size_t data_size, const void *target_, const size_t target_size) {
     return rgy_memmem_avx2_imp(data_, data_size, target_, target_size);
 }
+
+void rgy_memmem_multi_avx2(std::vector<RGYMemMemHit>& hits, const void *data_, const size_t data_size, const RGYMemMemNeedle *needles, const int needle_count) {
+    rgy_memmem_multi_avx2_imp(hits, data_, data_size, needles, needle_count);
+}
 #endif
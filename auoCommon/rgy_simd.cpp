@@ -26,9 +26,17 @@
 // --------------------------------------------------------------------------------------------
 
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <utility>
 #include "rgy_osdep.h"
 #include "rgy_simd.h"
 #include "rgy_arch.h"
+
+//使用するSIMDの上限 (set_simd_limitで設定)
+static std::atomic<uint64_t> g_simd_limit((uint64_t)RGY_SIMD::SIMD_ALL);
+
 #if defined(_M_IX86) || defined(_M_X64) || defined(__x86_64)
 #if _MSC_VER
 #include <intrin.h>
@@ -36,7 +44,7 @@
 #include <x86intrin.h>
 #endif //_MSC_VER
 
-RGY_SIMD get_availableSIMD() {
+static RGY_SIMD detect_availableSIMD() {
     int CPUInfo[4];
     __cpuid(CPUInfo, 1);
     RGY_SIMD simd = RGY_SIMD::NONE;
@@ -82,7 +90,43 @@ RGY_SIMD get_availableSIMD() {
     return simd;
 }
 #else
-RGY_SIMD get_availableSIMD() {
+static RGY_SIMD detect_availableSIMD() {
     return RGY_SIMD::NONE;
 }
 #endif
+
+RGY_SIMD get_simd_limit_from_str(const char *str) {
+    //上位のレベルは下位のレベルを含む
+    static const std::pair<const char *, RGY_SIMD> SIMD_LEVEL[] = {
+        { "none",   RGY_SIMD::NONE },
+        { "sse2",   RGY_SIMD::SSE2 },
+        { "sse3",   RGY_SIMD::SSE2 | RGY_SIMD::SSE3 },
+        { "ssse3",  RGY_SIMD::SSE2 | RGY_SIMD::SSE3 | RGY_SIMD::SSSE3 },
+        { "sse41",  RGY_SIMD::SSE2 | RGY_SIMD::SSE3 | RGY_SIMD::SSSE3 | RGY_SIMD::SSE41 },
+        { "sse42",  RGY_SIMD::SSE2 | RGY_SIMD::SSE3 | RGY_SIMD::SSSE3 | RGY_SIMD::SSE41 | RGY_SIMD::SSE42 | RGY_SIMD::POPCNT },
+        { "avx",    RGY_SIMD::SSE2 | RGY_SIMD::SSE3 | RGY_SIMD::SSSE3 | RGY_SIMD::SSE41 | RGY_SIMD::SSE42 | RGY_SIMD::POPCNT | RGY_SIMD::AVX },
+        { "avx2",   RGY_SIMD::SSE2 | RGY_SIMD::SSE3 | RGY_SIMD::SSSE3 | RGY_SIMD::SSE41 | RGY_SIMD::SSE42 | RGY_SIMD::POPCNT | RGY_SIMD::AVX | RGY_SIMD::AVX2 | RGY_SIMD::BMI1 | RGY_SIMD::BMI2 },
+        { "avx512", RGY_SIMD::SIMD_ALL },
+        { "auto",   RGY_SIMD::SIMD_ALL },
+    };
+    if (str == nullptr || str[0] == '\0') {
+        return RGY_SIMD::SIMD_ALL;
+    }
+    for (const auto& level : SIMD_LEVEL) {
+        if (_stricmp(str, level.first) == 0) {
+            return level.second;
+        }
+    }
+    return RGY_SIMD::SIMD_ALL;
+}
+
+void set_simd_limit(RGY_SIMD limit) {
+    g_simd_limit.store((uint64_t)limit, std::memory_order_relaxed);
+}
+
+RGY_SIMD get_availableSIMD() {
+    //CPUIDによる判定は最初の1回のみ行う (初期化はスレッドセーフ)
+    //環境変数 RGY_SIMD でも上限を指定できる
+    static const RGY_SIMD simd = detect_availableSIMD() & get_simd_limit_from_str(getenv("RGY_SIMD"));
+    return simd & (RGY_SIMD)g_simd_limit.load(std::memory_order_relaxed);
+}
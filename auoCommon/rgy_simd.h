@@ -30,6 +30,7 @@
 #define __RGY_SIMD_H__
 
 #include <cstdint>
+#include <cstddef>
 #include <limits>
 
 #ifndef _MSC_VER
@@ -91,6 +92,31 @@ static RGY_SIMD operator&=(RGY_SIMD &a, RGY_SIMD b) {
     return a;
 }
 
+//使用可能なSIMDを返す (CPUの判定結果はキャッシュされ、set_simd_limit/環境変数RGY_SIMDで指定した上限が適用される)
 RGY_SIMD get_availableSIMD();
+//"none", "sse2", "sse3", "ssse3", "sse41", "sse42", "avx", "avx2", "avx512", "auto"から上限を返す
+RGY_SIMD get_simd_limit_from_str(const char *str);
+//使用するSIMDの上限を設定する (A/B比較用)
+void set_simd_limit(RGY_SIMD limit);
+
+//SIMDごとの関数の表
+//必要なSIMDの多いものから並べ、最後にRGY_SIMD::NONEの関数を置く
+template<typename Func>
+struct RGYSimdFunc {
+    RGY_SIMD simd;
+    Func func;
+};
+
+//表の先頭から、使用可能なSIMDで実行できる最初の関数を返す
+template<typename Func, size_t N>
+Func select_simd_func(const RGYSimdFunc<Func>(&list)[N]) {
+    const auto simd = get_availableSIMD();
+    for (const auto& f : list) {
+        if ((f.simd & simd) == f.simd) {
+            return f.func;
+        }
+    }
+    return nullptr;
+}
 
 #endif //__RGY_SIMD_H__
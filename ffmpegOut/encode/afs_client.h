@@ -180,6 +180,7 @@ static struct {
   DWORD format;
   void* buf[AFS_VBUF_N_MAX];
   int drop;
+  int numa_node;
 } afs_vbuf;
 
 static HANDLE hEventOn;
@@ -210,7 +211,7 @@ static unsigned __stdcall thread_func(OUTPUT_INFO *oip)
   return 0;
 }
 
-static int afs_vbuf_setup(OUTPUT_INFO *oip, int mode, int size, int buf_size, DWORD format)
+static int afs_vbuf_setup(OUTPUT_INFO *oip, int mode, int size, int buf_size, DWORD format, int numa_node)
 {
   unsigned char status;
   void* data;
@@ -226,7 +227,8 @@ static int afs_vbuf_setup(OUTPUT_INFO *oip, int mode, int size, int buf_size, DW
   afs_vbuf.mode = mode;
   afs_vbuf.size = size;
   afs_vbuf.format = format;
-  for(i=0; i<AFS_VBUF_N_MAX; i++) if((afs_vbuf.buf[i] = malloc(buf_size)) == NULL) return 0;
+  afs_vbuf.numa_node = numa_node;
+  for(i=0; i<AFS_VBUF_N_MAX; i++) if((afs_vbuf.buf[i] = numa_malloc(buf_size, 64, numa_node)) == NULL) return 0;
   afs_vbuf.drop = 0;
 
   data = oip->func_get_video_ex(0, format);
@@ -281,13 +283,18 @@ static void* afs_get_video(OUTPUT_INFO *oip, int frame, int* drop, int* next_jit
   return afs_vbuf.buf[frame & AFS_VBUF_N_MASK];
 }
 
+static HANDLE afs_vbuf_prefetch_thread()
+{
+  return hThread;
+}
+
 static void afs_vbuf_release()
 {
   int i;
 
   prefetch_frame = -1;
   SetEvent(hEventOn);
-  for(i=0; i<AFS_VBUF_N_MAX; i++) if(afs_vbuf.buf[i] != NULL) free(afs_vbuf.buf[i]);
+  for(i=0; i<AFS_VBUF_N_MAX; i++) if(afs_vbuf.buf[i] != NULL) numa_free(afs_vbuf.buf[i], afs_vbuf.numa_node);
   WaitForSingleObject(hThread, INFINITE);
   CloseHandle(hThread);
   CloseHandle(hEventOff);
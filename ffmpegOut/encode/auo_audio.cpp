@@ -29,9 +29,11 @@
 #define NOMINMAX
 #include <Windows.h>
 #include <string>
+#include <vector>
 #include <shlwapi.h>
 #pragma comment(lib, "shlwapi.lib")
 #include <process.h>
+#include <mmsystem.h>
 #pragma comment(lib, "winmm.lib")
 #pragma comment(lib, "user32.lib") //WaitforInputIdle
 #include <fcntl.h>
@@ -54,15 +56,21 @@
 #include "auo_mes.h"
 
 #include "auo_audio_parallel.h"
+#include "auo_wavwriter.h"
 #include "auo_encode.h"
 #include "exe_version.h"
 #include "cpu_info.h"
+#include "auo_thread_placement.h"
 
 const int WAVE_HEADER_SIZE = 44;
 const int DS64_SIZE        = 28;
 const int RIFF_SIZE_POS    = 4;
 const int WAVE_SIZE_POS    = WAVE_HEADER_SIZE - 4;
 
+static const DWORD AUD_STREAM_PIPE_BUF_SIZE  = 256 * 1024;  //ffmpegへの名前付きパイプのバッファサイズ
+static const DWORD AUD_STREAM_READ_BUF_SIZE  = 1024 * 1024; //音声エンコーダの出力ファイルの読み取り単位
+static const DWORD AUD_STREAM_POLL_INTERVAL  = 20;          //音声エンコーダの出力待ちの間隔 (ms)
+
 inline void *get_audio_data(const OUTPUT_INFO *oip, PRM_ENC *pe, int start, int length, int *readed) {
     if (pe->aud_parallel.th_aud) {
         pe->aud_parallel.start = start;
@@ -194,7 +202,7 @@ static bool need_r64(int sample_n, const int audio_ch, BOOL use_8bit) {
     return riff_file_length > std::numeric_limits<uint32_t>::max();
 }
 
-static uint32_t build_wave_header(BYTE *head, const int audio_ch, const int audio_rate, BOOL use_8bit, int sample_n, BOOL enable_rf64) {
+static uint32_t build_wave_header_rf64(BYTE *head, const int audio_ch, const int audio_rate, BOOL use_8bit, int sample_n, bool rf64) {
     static const char * const RIFF_HEADER = "RIFF";
     static const char * const RF64_HEADER = "RF64";
     static const char * const WAVE_HEADER = "WAVE";
@@ -205,7 +213,6 @@ static uint32_t build_wave_header(BYTE *head, const int audio_ch, const int audi
     const short FMT_ID = 1;
     const int   size = (use_8bit) ? sizeof(BYTE) : sizeof(short);
     const uint64_t riff_file_length = (uint64_t)sample_n * (size * audio_ch) + WAVE_HEADER_SIZE - 8;
-    const bool rf64 = enable_rf64 && need_r64(sample_n, audio_ch, use_8bit);
     const uint64_t file_length = riff_file_length + ((rf64) ? DS64_SIZE + 8/*DS64_HEADER*/ : 0);
 
     uint32_t offset = 0;
@@ -235,6 +242,10 @@ static uint32_t build_wave_header(BYTE *head, const int audio_ch, const int audi
     //計44byte(WAVE_HEADER_SIZE)
 }
 
+static uint32_t build_wave_header(BYTE *head, const int audio_ch, const int audio_rate, BOOL use_8bit, int sample_n, BOOL enable_rf64) {
+    return build_wave_header_rf64(head, audio_ch, audio_rate, use_8bit, sample_n, enable_rf64 && need_r64(sample_n, audio_ch, use_8bit));
+}
+
 static uint32_t build_wave_header(BYTE *head, const OUTPUT_INFO *oip, BOOL use_8bit, int sample_n, BOOL enable_rf64) {
     return build_wave_header(head, oip->audio_ch, oip->audio_rate, use_8bit, sample_n, enable_rf64);
 }
@@ -260,9 +271,20 @@ typedef struct {
     HANDLE h_aud_namedpipe;
     HANDLE he_ov_aud_namedpipe;
     FILE *fp_out;
+    AuoWavWriter *wav_writer;
+    uint32_t wav_header_size;
     PIPE_SET pipes;
     PROCESS_INFORMATION pi_aud;
+    DWORD_PTR affinity_mask;   //音声エンコーダのアフィニティ (0なら変更しない)
     LOG_CACHE log_line_cache;
+
+    //音声エンコーダの出力を映像処理と同時にffmpegに渡す場合 (PRM_ENC::aud_stream_to_videnc)
+    HANDLE h_stream_pipe;
+    HANDLE he_ov_stream_pipe;
+    HANDLE th_stream_relay;
+    const BOOL *stream_abort;  //pe->aud_parallel.abort
+    BOOL stream_stop;          //エラー時にリレーを中断させる
+    AUO_RESULT stream_ret;
 } aud_data_t;
 
 static size_t write_file(aud_data_t *aud_dat, const PRM_ENC *pe, const void *buf, size_t size) {
@@ -279,6 +301,8 @@ static size_t write_file(aud_data_t *aud_dat, const PRM_ENC *pe, const void *buf
             }
         }
         return sizeWritten;
+    } else if (aud_dat->wav_writer) {
+        return aud_dat->wav_writer->write(buf, size);
     } else {
         return _fwrite_nolock(buf, 1, size, aud_dat->fp_out);
     }
@@ -287,9 +311,22 @@ static size_t write_file(aud_data_t *aud_dat, const PRM_ENC *pe, const void *buf
 static void write_wav_header(aud_data_t *aud_dat, const OUTPUT_INFO *oip, const PRM_ENC *pe, BOOL use_8bit, BOOL enable_rf64) {
     BYTE head[WAVE_HEADER_SIZE + DS64_SIZE + 8/*DS64_HEADER*/] = { 0 };
     auto size = build_wave_header(head, oip, use_8bit, oip->audio_n, enable_rf64);
+    aud_dat->wav_header_size = size;
     write_file(aud_dat, pe, &head, size);
 }
 
+static AUO_RESULT close_wav_writer(aud_data_t *aud_dat, const OUTPUT_INFO *oip, BOOL use_8bit) {
+    //実際に書き込んだサイズでヘッダを作り直す (RF64かどうかは最初のヘッダに合わせる)
+    const int wav_sample_size = oip->audio_ch * ((use_8bit) ? sizeof(BYTE) : sizeof(short));
+    const int sample_n = (int)((aud_dat->wav_writer->size() - aud_dat->wav_header_size) / wav_sample_size);
+    BYTE head[WAVE_HEADER_SIZE + DS64_SIZE + 8/*DS64_HEADER*/] = { 0 };
+    const auto size = build_wave_header_rf64(head, oip->audio_ch, oip->audio_rate, use_8bit, sample_n, aud_dat->wav_header_size != WAVE_HEADER_SIZE);
+    AUO_RESULT ret = aud_dat->wav_writer->close(head, size);
+    delete aud_dat->wav_writer;
+    aud_dat->wav_writer = nullptr;
+    return ret;
+}
+
 static void make_wavfilename(aud_data_t *aud_dat, BOOL use_pipe, const char *tempfilename, const char *append_wav) {
     if (use_pipe)
         strcpy_s(aud_dat->wavfile, _countof(aud_dat->wavfile), PIPE_FN);
@@ -366,7 +403,7 @@ static void show_audio_delay_cut_info(int delay_cut, const PRM_ENC *pe) {
 static void show_audio_enc_info(const AUDIO_SETTINGS *aud_stg, const CONF_AUDIO_BASE *cnf_aud, const PRM_ENC *pe, const aud_data_t *aud_dat) {
     std::string ver_str = "";
     int version[4] = { 0 };
-    if (str_has_char(aud_stg->cmd_ver) && 0 == get_exe_version_from_cmd(aud_stg->fullpath, aud_stg->cmd_ver, version)) {
+    if (str_has_char(aud_stg->cmd_ver) && 0 == get_exe_version_from_cmd_cached(aud_stg->fullpath, aud_stg->cmd_ver, version)) {
         ver_str = " (" + ver_string(version) + ")";
     }
 
@@ -434,11 +471,24 @@ static AUO_RESULT wav_file_open(aud_data_t *aud_dat, const OUTPUT_INFO *oip, con
             ret |= AUO_RESULT_ERROR; error_run_process(auddispname, rp_ret);
         } else {
             aud_dat->fp_out = aud_dat->pipes.f_stdin;
+            set_process_placement(aud_dat->pi_aud.hProcess, aud_dat->affinity_mask);
             while (WaitForInputIdle(aud_dat->pi_aud.hProcess, LOG_UPDATE_INTERVAL) == WAIT_TIMEOUT)
                 log_process_events();
         }
-    } else if (fopen_s(&aud_dat->fp_out, aud_dat->wavfile, "wbS")) {
-        ret |= AUO_RESULT_ERROR; error_open_wavfile();
+    } else {
+        //出力サイズから領域を事前確保し、キャッシュを介さずに書き出す
+        const int wav_sample_size = oip->audio_ch * ((wav_8bit) ? sizeof(BYTE) : sizeof(short));
+        const uint64_t expected_size = WAVE_HEADER_SIZE + DS64_SIZE + 8/*DS64_HEADER*/
+            + (uint64_t)(oip->audio_n + std::max(pe->delay_cut_additional_aframe, 0)) * wav_sample_size;
+        aud_dat->wav_writer = new AuoWavWriter();
+        if (aud_dat->wav_writer->open(aud_dat->wavfile, expected_size) != AUO_RESULT_SUCCESS) {
+            //使用できない場合は通常の書き込みにフォールバック
+            delete aud_dat->wav_writer;
+            aud_dat->wav_writer = nullptr;
+            if (fopen_s(&aud_dat->fp_out, aud_dat->wavfile, "wbS")) {
+                ret |= AUO_RESULT_ERROR; error_open_wavfile();
+            }
+        }
     }
     //wavヘッダ出力
     if (!ret)
@@ -446,16 +496,21 @@ static AUO_RESULT wav_file_open(aud_data_t *aud_dat, const OUTPUT_INFO *oip, con
     return ret;
 }
 
-static AUO_RESULT wav_file_close(aud_data_t *aud_dat, const OUTPUT_INFO *oip, int samples_read, int wav_sample_size, BOOL use_pipe) {
+static AUO_RESULT wav_file_close(aud_data_t *aud_dat, const OUTPUT_INFO *oip, int samples_read, int wav_sample_size, BOOL use_pipe, BOOL wav_8bit) {
     AUO_RESULT ret = AUO_RESULT_SUCCESS;
     if (aud_dat->is_internal) return ret;
 
-    //終了処理
-    if (!use_pipe && oip->audio_n != samples_read)
-        correct_header(aud_dat->fp_out, samples_read * wav_sample_size);
+    if (aud_dat->wav_writer) {
+        //ヘッダの修正とファイルのクローズ
+        ret |= close_wav_writer(aud_dat, oip, wav_8bit);
+    } else {
+        //終了処理
+        if (!use_pipe && oip->audio_n != samples_read)
+            correct_header(aud_dat->fp_out, samples_read * wav_sample_size);
 
-    //ファイルを閉じる
-    (use_pipe) ? CloseStdIn(&aud_dat->pipes) : fclose(aud_dat->fp_out);
+        //ファイルを閉じる
+        (use_pipe) ? CloseStdIn(&aud_dat->pipes) : fclose(aud_dat->fp_out);
+    }
 
     //wavファイル出力が成功したか確認
     if (!use_pipe && !FileExistsAndHasSize(aud_dat->wavfile)) {
@@ -464,6 +519,163 @@ static AUO_RESULT wav_file_close(aud_data_t *aud_dat, const OUTPUT_INFO *oip, in
     return ret;
 }
 
+//音声エンコーダの出力をffmpegに渡すための名前付きパイプを作成する
+//ffmpegのコマンドライン作成前に作成しておく必要がある
+static AUO_RESULT audio_stream_relay_open(aud_data_t *aud_dat, const PRM_ENC *pe) {
+    char pipename[MAX_PATH_LEN];
+    get_audio_pipe_name(pipename, _countof(pipename), aud_dat->id);
+    aud_dat->stream_abort = &pe->aud_parallel.abort;
+    aud_dat->h_stream_pipe = CreateNamedPipeA(pipename, PIPE_ACCESS_OUTBOUND | FILE_FLAG_OVERLAPPED, PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT, 1, AUD_STREAM_PIPE_BUF_SIZE, AUD_STREAM_PIPE_BUF_SIZE, 0, NULL);
+    if (aud_dat->h_stream_pipe == INVALID_HANDLE_VALUE) {
+        aud_dat->h_stream_pipe = NULL;
+        return AUO_RESULT_ERROR;
+    }
+    if (NULL == (aud_dat->he_ov_stream_pipe = CreateEvent(NULL, TRUE, FALSE, NULL)))
+        return AUO_RESULT_ERROR;
+    return AUO_RESULT_SUCCESS;
+}
+
+static inline BOOL audio_stream_relay_aborted(const aud_data_t *aud_dat) {
+    return aud_dat->stream_stop || *aud_dat->stream_abort;
+}
+
+//overlappedの完了を待つ。中断された場合はI/Oを取り消してFALSEを返す
+static BOOL audio_stream_wait_overlapped(aud_data_t *aud_dat, OVERLAPPED *overlapped, DWORD *transferred) {
+    while (WaitForSingleObject(overlapped->hEvent, AUD_STREAM_POLL_INTERVAL) == WAIT_TIMEOUT) {
+        if (audio_stream_relay_aborted(aud_dat)) {
+            CancelIoEx(aud_dat->h_stream_pipe, overlapped);
+            GetOverlappedResult(aud_dat->h_stream_pipe, overlapped, transferred, TRUE);
+            SetLastError(ERROR_OPERATION_ABORTED);
+            return FALSE;
+        }
+    }
+    return GetOverlappedResult(aud_dat->h_stream_pipe, overlapped, transferred, FALSE);
+}
+
+static BOOL audio_stream_connect_pipe(aud_data_t *aud_dat) {
+    OVERLAPPED overlapped = { 0 };
+    overlapped.hEvent = aud_dat->he_ov_stream_pipe;
+    if (ConnectNamedPipe(aud_dat->h_stream_pipe, &overlapped))
+        return TRUE;
+    switch (GetLastError()) {
+    case ERROR_PIPE_CONNECTED: //ffmpegがすでに接続している
+        return TRUE;
+    case ERROR_IO_PENDING:
+        break;
+    default:
+        return FALSE;
+    }
+    DWORD dummy = 0;
+    return audio_stream_wait_overlapped(aud_dat, &overlapped, &dummy);
+}
+
+//すべて書き込むまで戻らない
+//ffmpegが読み取らなければパイプのバッファが埋まった時点でここで待機するので、ffmpegの処理速度に合わせて送ることになる
+static DWORD audio_stream_write_pipe(aud_data_t *aud_dat, const BYTE *buf, DWORD size) {
+    while (size > 0) {
+        OVERLAPPED overlapped = { 0 };
+        overlapped.hEvent = aud_dat->he_ov_stream_pipe;
+        DWORD written = 0;
+        if (!WriteFile(aud_dat->h_stream_pipe, buf, size, NULL, &overlapped) && GetLastError() != ERROR_IO_PENDING)
+            return GetLastError();
+        if (!audio_stream_wait_overlapped(aud_dat, &overlapped, &written))
+            return GetLastError();
+        buf  += written;
+        size -= written;
+    }
+    return ERROR_SUCCESS;
+}
+
+//音声エンコーダが書き込み中の出力ファイルを先頭から読み取り、名前付きパイプでffmpegに渡す
+//音声エンコーダの出力はファイルに一旦書かれるので、ffmpegの読み取りが遅れても音声エンコーダは止まらない
+static unsigned __stdcall audio_stream_relay_func(void *prm) {
+    aud_data_t *aud_dat = (aud_data_t *)prm;
+    AUO_RESULT ret = AUO_RESULT_SUCCESS;
+    HANDLE h_file = INVALID_HANDLE_VALUE;
+    if (!audio_stream_connect_pipe(aud_dat)) {
+        ret |= (audio_stream_relay_aborted(aud_dat)) ? AUO_RESULT_ABORT : AUO_RESULT_ERROR;
+    } else {
+        //音声エンコーダが出力ファイルを作成するまで待機
+        //書き込み中のファイルを開くので、共有モードはすべて許可しておく
+        for (;;) {
+            const BOOL enc_finished = WaitForSingleObject(aud_dat->pi_aud.hProcess, 0) != WAIT_TIMEOUT;
+            h_file = CreateFile(aud_dat->audfile, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+            if (h_file != INVALID_HANDLE_VALUE)
+                break;
+            if (audio_stream_relay_aborted(aud_dat)) {
+                ret |= AUO_RESULT_ABORT;
+                break;
+            }
+            if (enc_finished) {
+                ret |= AUO_RESULT_ERROR; //エラーはaudio_finish_encで表示される
+                break;
+            }
+            Sleep(AUD_STREAM_POLL_INTERVAL);
+        }
+    }
+    std::vector<BYTE> buffer((ret) ? 0 : AUD_STREAM_READ_BUF_SIZE);
+    while (!ret) {
+        //読み取り前に終了を確認しておき、終了後に書き込まれたデータを取りこぼさないようにする
+        const BOOL enc_finished = WaitForSingleObject(aud_dat->pi_aud.hProcess, 0) != WAIT_TIMEOUT;
+        DWORD bytes_read = 0;
+        if (!ReadFile(h_file, buffer.data(), (DWORD)buffer.size(), &bytes_read, NULL)) {
+            ret |= AUO_RESULT_ERROR;
+        } else if (bytes_read > 0) {
+            const DWORD err = audio_stream_write_pipe(aud_dat, buffer.data(), bytes_read);
+            if (err == ERROR_NO_DATA || err == ERROR_BROKEN_PIPE) {
+                break; //ffmpegが音声の読み取りを終えた (-shortestなど)
+            } else if (err == ERROR_OPERATION_ABORTED) {
+                ret |= AUO_RESULT_ABORT;
+            } else if (err != ERROR_SUCCESS) {
+                ret |= AUO_RESULT_ERROR;
+            }
+        } else if (enc_finished) {
+            break; //音声エンコーダの出力をすべて渡した
+        } else if (audio_stream_relay_aborted(aud_dat)) {
+            ret |= AUO_RESULT_ABORT;
+        } else {
+            Sleep(AUD_STREAM_POLL_INTERVAL);
+        }
+    }
+    if (h_file != INVALID_HANDLE_VALUE)
+        CloseHandle(h_file);
+    //パイプを閉じて、ffmpegに音声の終端を伝える
+    if (!ret)
+        FlushFileBuffers(aud_dat->h_stream_pipe);
+    CloseHandle(aud_dat->h_stream_pipe);
+    aud_dat->h_stream_pipe = NULL;
+    aud_dat->stream_ret = ret;
+    return 0;
+}
+
+static AUO_RESULT audio_stream_relay_start(aud_data_t *aud_dat) {
+    if (NULL == (aud_dat->th_stream_relay = (HANDLE)_beginthreadex(NULL, 0, audio_stream_relay_func, aud_dat, 0, NULL)))
+        return AUO_RESULT_ERROR;
+    return AUO_RESULT_SUCCESS;
+}
+
+//リレーの終了を待機する
+//エラー時は中断させ、パイプを閉じてffmpegが音声入力を待ち続けないようにする
+static AUO_RESULT audio_stream_relay_close(aud_data_t *aud_dat, AUO_RESULT ret) {
+    if (aud_dat->th_stream_relay) {
+        aud_dat->stream_stop |= (ret != AUO_RESULT_SUCCESS);
+        while (WaitForSingleObject(aud_dat->th_stream_relay, LOG_UPDATE_INTERVAL) == WAIT_TIMEOUT)
+            log_process_events();
+        CloseHandle(aud_dat->th_stream_relay);
+        aud_dat->th_stream_relay = NULL;
+        ret |= aud_dat->stream_ret;
+    }
+    if (aud_dat->h_stream_pipe) {
+        CloseHandle(aud_dat->h_stream_pipe);
+        aud_dat->h_stream_pipe = NULL;
+    }
+    if (aud_dat->he_ov_stream_pipe) {
+        CloseHandle(aud_dat->he_ov_stream_pipe);
+        aud_dat->he_ov_stream_pipe = NULL;
+    }
+    return ret;
+}
+
 static AUO_RESULT wav_output(aud_data_t *aud_dat, const OUTPUT_INFO *oip, PRM_ENC *pe, int wav_8bit, BOOL enable_rf64, int bufsize,
                         const wchar_t *auddispname, const char *auddir, DWORD encoder_priority, DWORD disable_log)
 {
@@ -493,6 +705,9 @@ static AUO_RESULT wav_output(aud_data_t *aud_dat, const OUTPUT_INFO *oip, PRM_EN
             aud_dat[i_aud].h_aud_namedpipe = CreateNamedPipeA(pipename, PIPE_ACCESS_OUTBOUND | FILE_FLAG_OVERLAPPED, PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT, 1, 4096, 4096, 0, NULL);
             aud_dat[i_aud].he_ov_aud_namedpipe = CreateEvent(NULL, FALSE, FALSE, NULL);
         }
+    } else if (pe->aud_stream_to_videnc) {
+        for (int i_aud = 0; !ret && i_aud < pe->aud_count; i_aud++)
+            ret |= audio_stream_relay_open(&aud_dat[i_aud], pe);
     }
 
     //確実なfcloseのために何故か一度ここで待機する必要あり
@@ -517,6 +732,9 @@ static AUO_RESULT wav_output(aud_data_t *aud_dat, const OUTPUT_INFO *oip, PRM_EN
     } else {
         for (int i_aud = 0; !ret && i_aud < pe->aud_count; i_aud++)
             ret |= wav_file_open(&aud_dat[i_aud], oip, pe, use_pipe, wav_8bit, enable_rf64, bufsize, auddispname, auddir, encoder_priority, disable_log);
+        //音声エンコーダの起動後、出力のffmpegへの受け渡しを開始
+        for (int i_aud = 0; !ret && pe->aud_stream_to_videnc && i_aud < pe->aud_count; i_aud++)
+            ret |= audio_stream_relay_start(&aud_dat[i_aud]);
     }
 
     if (!ret) {
@@ -557,7 +775,7 @@ static AUO_RESULT wav_output(aud_data_t *aud_dat, const OUTPUT_INFO *oip, PRM_EN
 
         //ファイルクローズ
         for (int i_aud = 0; i_aud < pe->aud_count; i_aud++)
-            ret |= wav_file_close(&aud_dat[i_aud], oip, samples_read, wav_sample_size, use_pipe);
+            ret |= wav_file_close(&aud_dat[i_aud], oip, samples_read, wav_sample_size, use_pipe, wav_8bit);
     } else {
         //これをやっておかないとプラグインがフリーズしてしまう
         //動画との音声との同時処理が終了
@@ -586,6 +804,7 @@ static AUO_RESULT init_aud_dat(aud_data_t *aud_dat, PRM_ENC *pe, BOOL use_pipe,
     }
 
     aud_dat->is_internal = aud_stg->is_internal;
+    aud_dat->affinity_mask = get_thread_placement_mask(THREAD_PLACEMENT_AUDENC, &sys_dat->exstg->s_local);
     const CONF_AUDIO_BASE *aud = (conf->aud.use_internal) ? &conf->aud.in : &conf->aud.ext;
 
     //wavfile名作成
@@ -617,6 +836,8 @@ static AUO_RESULT audio_run_enc_wavfile(aud_data_t *aud_dat, const AUDIO_SETTING
     int rp_ret;
     if (RP_SUCCESS != (rp_ret = RunProcess(aud_dat->args, auddir, &aud_dat->pi_aud, &aud_dat->pipes, encoder_priority, TRUE, conf->aud.ext.minimized))) {
         ret |= AUO_RESULT_ERROR; error_run_process(aud_stg->dispname, rp_ret);
+    } else {
+        set_process_placement(aud_dat->pi_aud.hProcess, aud_dat->affinity_mask);
     }
     return ret;
 }
@@ -642,6 +863,8 @@ static AUO_RESULT audio_finish_enc(AUO_RESULT ret, aud_data_t *aud_dat, const AU
             write_cached_lines(LOG_MORE, aud_stg->dispname, &aud_dat->log_line_cache);
         }
     }
+    //ffmpegへの受け渡しが残っていれば完了させる (音声エンコーダのハンドルを閉じる前に行うこと)
+    ret |= audio_stream_relay_close(aud_dat, ret);
     write_log_auo_line_fmt(LOG_MORE, L"%s %s: %.2f%%", aud_stg->dispname, g_auo_mes.get(AUO_AUDIO_CPU_USAGE), GetProcessAvgCPUUsage(aud_dat->pi_aud.hProcess));
 
     CloseHandle(aud_dat->pi_aud.hProcess);
@@ -686,6 +909,8 @@ AUO_RESULT audio_output(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *pe, c
 
     //情報表示
     show_audio_enc_info(aud_stg, cnf_aud, pe, aud_dat);
+    if (pe->aud_stream_to_videnc)
+        write_log_auo_line(LOG_INFO, g_auo_mes.get(AUO_AUDIO_STREAM_TO_VIDENC));
 
     //auddir作成
     PathGetDirectory(auddir, _countof(auddir), aud_stg->fullpath);
@@ -707,6 +932,100 @@ AUO_RESULT audio_output(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *pe, c
     return ret;
 }
 
+static const double AUD_CALIB_SEC = 10.0; //音声エンコーダの処理速度の計測に使用する音声の長さ (秒)
+
+//音声処理順の自動選択のため、音声の先頭の短い区間を実際にエンコードして音声エンコーダの処理速度を計測し、
+//音声全体を「後」で処理した場合の処理時間と、音声エンコーダの使用する論理コア数をpe->aud_timing_autoに設定する
+//計測用のwav・音声ファイルは計測後に削除する
+AUO_RESULT audio_calib_enc_speed(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *pe, const SYSTEM_DATA *sys_dat) {
+    AUO_RESULT ret = AUO_RESULT_SUCCESS;
+    AUD_TIMING_AUTO *aud_auto = &pe->aud_timing_auto;
+    aud_auto->aud_enc_ms = 0.0;
+    aud_auto->aud_enc_cores = 0.0;
+    if (!(oip->flag & OUTPUT_INFO_FLAG_AUDIO) || oip->audio_n <= 0 || conf->aud.use_internal)
+        return ret;
+
+    const CONF_AUDIO_BASE *cnf_aud = &conf->aud.ext;
+    const AUDIO_SETTINGS *aud_stg = &sys_dat->exstg->s_aud_ext[cnf_aud->encoder];
+    //faw2aacは内部処理でごく短時間で終わり、実行ファイルがなければwav出力のみなので計測しない
+    if (sys_dat->exstg->is_faw(aud_stg) || !str_has_char(aud_stg->filename) || !PathFileExists(aud_stg->fullpath))
+        return ret;
+
+    //計測用に音声の長さを短くし、ffmpegへの受け渡しや遅延補正は行わない
+    OUTPUT_INFO oip_calib = *oip;
+    oip_calib.audio_n = std::min(oip->audio_n, (int)(AUD_CALIB_SEC * oip->audio_rate));
+    PRM_ENC pe_calib = *pe;
+    ZeroMemory(&pe_calib.aud_parallel, sizeof(pe_calib.aud_parallel));
+    pe_calib.aud_stream_to_videnc = FALSE;
+    pe_calib.delay_cut_additional_aframe = 0;
+    pe_calib.aud_count = 1;
+
+    aud_data_t aud_dat[1] = { { 0, 0 } };
+    char auddir[MAX_PATH_LEN] = { 0 };
+    const BOOL use_pipe = (!cnf_aud->use_wav && !cnf_aud->use_2pass) ? TRUE : FALSE;
+    const DWORD encoder_priority = GetExePriority(cnf_aud->priority, pe->h_p_aviutl);
+    const int aud_count = (aud_stg->mode[cnf_aud->enc_mode].use_8bit == 2) ? 2 : 1;
+
+    //出力先を計測用のファイルに変更する
+    if (AUO_RESULT_SUCCESS != init_aud_dat(&aud_dat[0], &pe_calib, use_pipe, conf, &oip_calib, sys_dat, aud_stg))
+        return AUO_RESULT_ERROR;
+    char calib_file[MAX_PATH_LEN];
+    strcpy_s(calib_file, _countof(calib_file), aud_dat[0].audfile);
+    insert_before_ext(calib_file, _countof(calib_file), "_calib");
+    replace(aud_dat[0].cmd, _countof(aud_dat[0].cmd), aud_dat[0].audfile, calib_file);
+    strcpy_s(aud_dat[0].audfile, _countof(aud_dat[0].audfile), calib_file);
+    if (!use_pipe) {
+        strcpy_s(calib_file, _countof(calib_file), aud_dat[0].wavfile);
+        insert_before_ext(calib_file, _countof(calib_file), "_calib");
+        replace(aud_dat[0].cmd, _countof(aud_dat[0].cmd), aud_dat[0].wavfile, calib_file);
+        strcpy_s(aud_dat[0].wavfile, _countof(aud_dat[0].wavfile), calib_file);
+    }
+    sprintf_s(aud_dat[0].args, _countof(aud_dat[0].args), "\"%s\" %s", aud_stg->fullpath, aud_dat[0].cmd);
+    PathGetDirectory(auddir, _countof(auddir), aud_stg->fullpath);
+
+    //wavの取得から音声エンコーダの終了までの時間を計測する
+    const DWORD tm_start = timeGetTime();
+    ret |= wav_output(aud_dat, &oip_calib, &pe_calib, aud_stg->mode[cnf_aud->enc_mode].use_8bit, aud_stg->enable_rf64, sys_dat->exstg->s_local.audio_buffer_size, aud_stg->dispname, auddir, encoder_priority, aud_stg->disable_log);
+    if (!ret && !use_pipe)
+        ret |= audio_run_enc_wavfile(&aud_dat[0], aud_stg, conf, auddir, encoder_priority);
+    if (aud_dat[0].pi_aud.hProcess) {
+        while (WaitForSingleObject(aud_dat[0].pi_aud.hProcess, LOG_UPDATE_INTERVAL) == WAIT_TIMEOUT) {
+            if (0 == ReadLogExe(&aud_dat[0].pipes, nullptr, &aud_dat[0].log_line_cache))
+                log_process_events();
+        }
+        while (ReadLogExe(&aud_dat[0].pipes, nullptr, &aud_dat[0].log_line_cache) > 0);
+    }
+    const DWORD tm_calib = std::max<DWORD>(1, timeGetTime() - tm_start);
+
+    DWORD exit_code = 0;
+    if (!ret && aud_dat[0].pi_aud.hProcess
+        && GetExitCodeProcess(aud_dat[0].pi_aud.hProcess, &exit_code) && exit_code == 0
+        && FileExistsAndHasSize(aud_dat[0].audfile)) {
+        //CPU時間は100ns単位
+        PROCESS_TIME time = { 0 };
+        const double enc_cores = (GetProcessTime(aud_dat[0].pi_aud.hProcess, &time) && time.exit > time.creation)
+            ? (time.kernel + time.user) / (double)(time.exit - time.creation) : 1.0;
+        //8bitの2ストリームの場合は2つのエンコーダが同時に動作する
+        aud_auto->aud_enc_ms = tm_calib * (oip->audio_n / (double)oip_calib.audio_n);
+        aud_auto->aud_enc_cores = enc_cores * aud_count;
+        write_log_auo_line_fmt(LOG_INFO, g_auo_mes.get(AUO_AUDIO_CALIB_ENC_SPEED),
+            oip_calib.audio_n * 1000.0 / (oip->audio_rate * (double)tm_calib), aud_auto->aud_enc_cores);
+    } else {
+        //計測できなければ音声の処理時間を0とみなし、「後」のままとする (中断のみ呼び出し元に返す)
+        ret &= AUO_RESULT_ABORT;
+    }
+    if (aud_dat[0].pi_aud.hProcess) {
+        CloseHandle(aud_dat[0].pi_aud.hProcess);
+        CloseHandle(aud_dat[0].pi_aud.hThread);
+    }
+    release_log_cache(&aud_dat[0].log_line_cache);
+    remove(aud_dat[0].audfile);
+    if (!use_pipe)
+        remove(aud_dat[0].wavfile);
+    set_window_title(g_auo_mes.get(AUO_GUIEX_FULL_NAME), PROGRESSBAR_DISABLED);
+    return ret;
+}
+
 BOOL check_audenc_output(const AUDIO_SETTINGS *aud_stg, std::wstring& exe_message) {
     //実行ファイルチェック(filenameが空文字列なら実行しない)
     if (!str_has_char(aud_stg->filename)) {
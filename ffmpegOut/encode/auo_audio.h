@@ -42,6 +42,7 @@ int check_audio_length(OUTPUT_INFO *oip, double av_length_threshold);
 
 AUO_RESULT audio_output(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *pe, const SYSTEM_DATA *sys_dat); //音声処理を実行
 AUO_RESULT audio_output_parallel(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *pe, const SYSTEM_DATA *sys_dat);
+AUO_RESULT audio_calib_enc_speed(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *pe, const SYSTEM_DATA *sys_dat); //音声処理順の自動選択のため、音声エンコーダの処理速度を計測
 
 BOOL check_audenc_output(const AUDIO_SETTINGS *aud_stg, std::wstring& exe_message);
 
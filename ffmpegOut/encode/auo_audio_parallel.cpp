@@ -36,6 +36,7 @@
 #include "auo_system.h"
 #include "auo_audio.h"
 #include "auo_frm.h"
+#include "auo_thread_placement.h"
 
 typedef struct {
     CONF_GUIEX *_conf;
@@ -112,6 +113,7 @@ AUO_RESULT audio_output_parallel(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_E
         ret = AUO_RESULT_ERROR;
     }
     pe->aud_parallel.mtx_aud = new std::mutex();
+    set_thread_placement(pe->aud_parallel.th_aud, get_thread_placement_mask(THREAD_PLACEMENT_AUDIO, &sys_dat->exstg->s_local));
 
     if (ret == AUO_RESULT_ERROR) {
         if_valid_close_handle(&(pe->aud_parallel.he_aud_start));
@@ -36,23 +36,29 @@
 #include "auo_video.h"
 #include "auo_frm.h"
 #include "auo_options.h"
+#include "auo_error.h"
 #include "convert.h"
+#include "auo_thread_placement.h"
 
 //音声の16bit->8bit変換の選択
 func_audio_16to8 get_audio_16to8_func(BOOL split) {
-    static const func_audio_16to8 FUNC_CONVERT_AUDIO[][2] = {
-        { convert_audio_16to8,      split_audio_16to8x2      },
-        { convert_audio_16to8_sse2, split_audio_16to8x2_sse2 },
-        { convert_audio_16to8_avx2, split_audio_16to8x2_avx2 },
+    static const RGYSimdFunc<func_audio_16to8> FUNC_CONVERT_AUDIO[] = {
+        { RGY_SIMD::AVX2, convert_audio_16to8_avx2 },
+        { RGY_SIMD::SSE2, convert_audio_16to8_sse2 },
+        { RGY_SIMD::NONE, convert_audio_16to8      },
     };
-    int simd = 0;
-    if (0 == (simd = (!!check_avx2() * 2)))
-        simd = check_sse2();
-    return FUNC_CONVERT_AUDIO[simd][!!split];
+    static const RGYSimdFunc<func_audio_16to8> FUNC_SPLIT_AUDIO[] = {
+        { RGY_SIMD::AVX2, split_audio_16to8x2_avx2 },
+        { RGY_SIMD::SSE2, split_audio_16to8x2_sse2 },
+        { RGY_SIMD::NONE, split_audio_16to8x2      },
+    };
+    return (split) ? select_simd_func(FUNC_SPLIT_AUDIO) : select_simd_func(FUNC_CONVERT_AUDIO);
 }
 
 enum eInterlace {
     A = -1, //区別の必要なし
+            //4:2:2/4:4:4への変換は色差を縦に間引かず、行ごとに独立に変換するので、
+            //フィールドを分けずにそのままインタレ保持で出力できる (インタレース用関数は不要)
     P = 0,  //プログレッシブ用
     I = 1   //インターレース用
 };
@@ -240,14 +246,24 @@ static const COVERT_FUNC_INFO FUNC_TABLE[] = {
 #endif
 #if ENABLE_NV12
     //YUY2 -> nv16(8bit)
+    { CF_YUY2, OUT_CSP_NV16,   BIT_8, A, 64,  AVX512VBMI,           convert_yuy2_to_nv16_avx512vbmi_mod64 },
+    { CF_YUY2, OUT_CSP_NV16,   BIT_8, A,  1,  AVX512VBMI,           convert_yuy2_to_nv16_avx512vbmi },
+    { CF_YUY2, OUT_CSP_NV16,   BIT_8, A, 64,  AVX512BW,             convert_yuy2_to_nv16_avx512bw_mod64 },
+    { CF_YUY2, OUT_CSP_NV16,   BIT_8, A,  1,  AVX512BW,             convert_yuy2_to_nv16_avx512bw },
     { CF_YUY2, OUT_CSP_NV16,   BIT_8, A,  1,  AVX2|AVX,             convert_yuy2_to_nv16_avx2 },
     { CF_YUY2, OUT_CSP_NV16,   BIT_8, A,  1,  AVX|SSE2,             convert_yuy2_to_nv16_avx },
     { CF_YUY2, OUT_CSP_NV16,   BIT_8, A, 16,  SSE2,                 convert_yuy2_to_nv16_sse2_mod16 },
     { CF_YUY2, OUT_CSP_NV16,   BIT_8, A,  1,  SSE2,                 convert_yuy2_to_nv16_sse2 },
     { CF_YUY2, OUT_CSP_NV16,   BIT_8, A,  1,  NONE,                 convert_yuy2_to_nv16 },
     //YUY2 -> nv16(16bit)
+    { CF_YUY2, OUT_CSP_NV16,   BIT16, A, 32,  AVX512BW,             convert_yuy2_to_nv16_16bit_avx512bw_mod32 },
+    { CF_YUY2, OUT_CSP_NV16,   BIT16, A,  1,  AVX512BW,             convert_yuy2_to_nv16_16bit_avx512bw },
     { CF_YUY2, OUT_CSP_NV16,   BIT16, A,  1,  AVX2|AVX,             convert_yuy2_to_nv16_16bit_avx2 },
     //YC48 -> nv16(16bit)
+    { CF_YC48, OUT_CSP_NV16,   BIT16, A, 32,  AVX512VBMI,           convert_yc48_to_nv16_16bit_avx512vbmi_mod32 },
+    { CF_YC48, OUT_CSP_NV16,   BIT16, A,  1,  AVX512VBMI,           convert_yc48_to_nv16_16bit_avx512vbmi },
+    { CF_YC48, OUT_CSP_NV16,   BIT16, A, 32,  AVX512BW,             convert_yc48_to_nv16_16bit_avx512bw_mod32 },
+    { CF_YC48, OUT_CSP_NV16,   BIT16, A,  1,  AVX512BW,             convert_yc48_to_nv16_16bit_avx512bw },
     { CF_YC48, OUT_CSP_NV16,   BIT16, A,  1,  AVX2|AVX,             convert_yc48_to_nv16_16bit_avx2 },
     { CF_YC48, OUT_CSP_NV16,   BIT16, A,  1,  AVX|SSE41|SSSE3|SSE2, convert_yc48_to_nv16_16bit_avx },
     { CF_YC48, OUT_CSP_NV16,   BIT16, A,  8,  SSE41|SSSE3|SSE2,     convert_yc48_to_nv16_16bit_sse41_mod8 },
@@ -259,13 +275,25 @@ static const COVERT_FUNC_INFO FUNC_TABLE[] = {
     { CF_YC48, OUT_CSP_NV16,   BIT16, A,  1,  NONE,                 convert_yc48_to_nv16_16bit },
 #else
     //YUY2 -> yuv422(8bit)
+    { CF_YUY2, OUT_CSP_YUV422, BIT_8, A, 64,  AVX512VBMI,           convert_yuy2_to_yuv422_avx512vbmi_mod64 },
+    { CF_YUY2, OUT_CSP_YUV422, BIT_8, A,  1,  AVX512VBMI,           convert_yuy2_to_yuv422_avx512vbmi },
+    { CF_YUY2, OUT_CSP_YUV422, BIT_8, A, 64,  AVX512BW,             convert_yuy2_to_yuv422_avx512bw_mod64 },
+    { CF_YUY2, OUT_CSP_YUV422, BIT_8, A,  1,  AVX512BW,             convert_yuy2_to_yuv422_avx512bw },
     { CF_YUY2, OUT_CSP_YUV422, BIT_8, A,  1,  AVX2|AVX,             convert_yuy2_to_yuv422_avx2 },
     { CF_YUY2, OUT_CSP_YUV422, BIT_8, A,  1,  NONE,                 convert_yuy2_to_yuv422 },
     
     //YUY2 -> yuv422(16bit)
+    { CF_YUY2, OUT_CSP_YUV422, BIT16, A, 64,  AVX512VBMI,           convert_yuy2_to_yuv422_16bit_avx512vbmi_mod64 },
+    { CF_YUY2, OUT_CSP_YUV422, BIT16, A,  1,  AVX512VBMI,           convert_yuy2_to_yuv422_16bit_avx512vbmi },
+    { CF_YUY2, OUT_CSP_YUV422, BIT16, A, 64,  AVX512BW,             convert_yuy2_to_yuv422_16bit_avx512bw_mod64 },
+    { CF_YUY2, OUT_CSP_YUV422, BIT16, A,  1,  AVX512BW,             convert_yuy2_to_yuv422_16bit_avx512bw },
     { CF_YUY2, OUT_CSP_YUV422, BIT16, A,  1,  AVX2|AVX,             convert_yuy2_to_yuv422_16bit_avx2 },
 
     //YC48 -> yuv422(16bit)
+    { CF_YC48, OUT_CSP_YUV422, BIT16, A, 64,  AVX512VBMI,           convert_yc48_to_yuv422_16bit_avx512vbmi_mod64 },
+    { CF_YC48, OUT_CSP_YUV422, BIT16, A,  1,  AVX512VBMI,           convert_yc48_to_yuv422_16bit_avx512vbmi },
+    { CF_YC48, OUT_CSP_YUV422, BIT16, A, 64,  AVX512BW,             convert_yc48_to_yuv422_16bit_avx512bw_mod64 },
+    { CF_YC48, OUT_CSP_YUV422, BIT16, A,  1,  AVX512BW,             convert_yc48_to_yuv422_16bit_avx512bw },
     { CF_YC48, OUT_CSP_YUV422, BIT16, A,  1,  NONE,                 convert_yc48_to_yuv422_16bit },
 #endif
     //YC48 -> yuv444(8bit)
@@ -321,9 +349,17 @@ static const COVERT_FUNC_INFO FUNC_TABLE[] = {
     { CF_LW48, OUT_CSP_NV12,   BIT16, I,  1,  NONE,                 convert_lw48_to_nv12_i_16bit },
 
     //LW48 -> nv16 (8bit)
+    { CF_LW48, OUT_CSP_NV16,   BIT_8, A, 64,  AVX512VBMI,           convert_lw48_to_nv16_avx512vbmi_mod64 },
+    { CF_LW48, OUT_CSP_NV16,   BIT_8, A,  1,  AVX512VBMI,           convert_lw48_to_nv16_avx512vbmi },
+    { CF_LW48, OUT_CSP_NV16,   BIT_8, A, 64,  AVX512BW,             convert_lw48_to_nv16_avx512bw_mod64 },
+    { CF_LW48, OUT_CSP_NV16,   BIT_8, A,  1,  AVX512BW,             convert_lw48_to_nv16_avx512bw },
     { CF_LW48, OUT_CSP_NV16,   BIT_8, A,  1,  NONE,                 convert_lw48_to_nv16 },
 
     //LW48 -> nv16 (16bit)
+    { CF_LW48, OUT_CSP_NV16,   BIT16, A, 32,  AVX512VBMI,           convert_lw48_to_nv16_16bit_avx512vbmi_mod32 },
+    { CF_LW48, OUT_CSP_NV16,   BIT16, A,  1,  AVX512VBMI,           convert_lw48_to_nv16_16bit_avx512vbmi },
+    { CF_LW48, OUT_CSP_NV16,   BIT16, A, 32,  AVX512BW,             convert_lw48_to_nv16_16bit_avx512bw_mod32 },
+    { CF_LW48, OUT_CSP_NV16,   BIT16, A,  1,  AVX512BW,             convert_lw48_to_nv16_16bit_avx512bw },
     { CF_LW48, OUT_CSP_NV16,   BIT16, A,  1,  AVX2|AVX,             convert_lw48_to_nv16_16bit_avx2 },
     { CF_LW48, OUT_CSP_NV16,   BIT16, A,  1,  AVX|SSE41|SSSE3|SSE2, convert_lw48_to_nv16_16bit_avx },
     { CF_LW48, OUT_CSP_NV16,   BIT16, A,  8,  SSE41|SSSE3|SSE2,     convert_lw48_to_nv16_16bit_sse41_mod8 },
@@ -357,21 +393,191 @@ static const COVERT_FUNC_INFO FUNC_TABLE[] = {
     { CF_LW48, OUT_CSP_YUV444, BIT16, A,  1,  NONE,                 convert_lw48_to_yuv444_16bit },
 #if ENCODER_X264 || ENCODER_X265 || ENCODER_SVTAV1
     //Copy RGB
+    { CF_RGB,  OUT_CSP_RGB,    BIT_8, A,  1,  AVX512VBMI,           sort_to_rgb_avx512vbmi },
+    { CF_RGB,  OUT_CSP_RGB,    BIT_8, A,  1,  AVX512BW,             sort_to_rgb_avx512bw },
     { CF_RGB,  OUT_CSP_RGB,    BIT_8, A,  1,  SSSE3|SSE2,           sort_to_rgb_ssse3 },
     { CF_RGB,  OUT_CSP_RGB,    BIT_8, A,  1,  NONE,                 sort_to_rgb },
 #elif ENCODER_FFMPEG
     //Copy RGB
+    { CF_RGB,  OUT_CSP_RGB,    BIT_8, A,  1,  AVX512BW,             copy_rgb_avx512bw },
     { CF_RGB,  OUT_CSP_RGB,    BIT_8, A,  1,  SSE2,                 copy_rgb_sse2 },
     { CF_RGB,  OUT_CSP_RGB,    BIT_8, A,  1,  NONE,                 copy_rgb },
     //Copy RGBA
+    { CF_RGBA,  OUT_CSP_RGBA,  BIT_8, A,  1,  AVX512BW,             copy_rgba_avx512bw },
     { CF_RGBA,  OUT_CSP_RGBA,  BIT_8, A,  1,  SSE2,                 copy_rgba_sse2 },
     { CF_RGBA,  OUT_CSP_RGBA,  BIT_8, A,  1,  NONE,                 copy_rgba },
 #endif
     //Convert RGB to YUV444
+    { CF_RGB,  OUT_CSP_YUV444, BIT_8, A,  1,  AVX512VBMI,           convert_rgb_to_yuv444_avx512vbmi },
+    { CF_RGB,  OUT_CSP_YUV444, BIT_8, A,  1,  AVX512BW,             convert_rgb_to_yuv444_avx512bw },
     { CF_RGB,  OUT_CSP_YUV444, BIT_8, A,  1,  AVX2|AVX,             convert_rgb_to_yuv444_avx2 },
+    { CF_RGB,  OUT_CSP_YUV444, BIT_8, A,  1,  AVX|SSE41|SSSE3|SSE2, convert_rgb_to_yuv444_avx },
+    { CF_RGB,  OUT_CSP_YUV444, BIT_8, A,  1,  SSE41|SSSE3|SSE2,     convert_rgb_to_yuv444_sse41 },
     { CF_RGB,  OUT_CSP_YUV444, BIT_8, A,  1,  NONE,                 convert_rgb_to_yuv444 },
+    { CF_RGB,  OUT_CSP_YUV444, BIT16, A,  1,  AVX512VBMI,           convert_rgb_to_yuv444_16bit_avx512vbmi },
+    { CF_RGB,  OUT_CSP_YUV444, BIT16, A,  1,  AVX512BW,             convert_rgb_to_yuv444_16bit_avx512bw },
     { CF_RGB,  OUT_CSP_YUV444, BIT16, A,  1,  AVX2|AVX,             convert_rgb_to_yuv444_16bit_avx2 },
+    { CF_RGB,  OUT_CSP_YUV444, BIT16, A,  1,  AVX|SSE41|SSSE3|SSE2, convert_rgb_to_yuv444_16bit_avx },
+    { CF_RGB,  OUT_CSP_YUV444, BIT16, A,  1,  SSE41|SSSE3|SSE2,     convert_rgb_to_yuv444_16bit_sse41 },
     { CF_RGB,  OUT_CSP_YUV444, BIT16, A,  1,  NONE,                 convert_rgb_to_yuv444_16bit },
+
+    //RGBA (拡張編集) -> YUVA420/YUVA444
+    { CF_RGBA, OUT_CSP_YUVA420, BIT_8, A,  2,  AVX2|AVX,             convert_rgba_to_yuva420_avx2 },
+    { CF_RGBA, OUT_CSP_YUVA420, BIT_8, A,  2,  AVX|SSE41|SSSE3|SSE2, convert_rgba_to_yuva420_avx },
+    { CF_RGBA, OUT_CSP_YUVA420, BIT_8, A,  2,  SSE41|SSSE3|SSE2,     convert_rgba_to_yuva420_sse41 },
+    { CF_RGBA, OUT_CSP_YUVA420, BIT_8, A,  2,  NONE,                 convert_rgba_to_yuva420 },
+    { CF_RGBA, OUT_CSP_YUVA420, BIT10, A,  2,  AVX2|AVX,             convert_rgba_to_yuva420_10bit_avx2 },
+    { CF_RGBA, OUT_CSP_YUVA420, BIT10, A,  2,  AVX|SSE41|SSSE3|SSE2, convert_rgba_to_yuva420_10bit_avx },
+    { CF_RGBA, OUT_CSP_YUVA420, BIT10, A,  2,  SSE41|SSSE3|SSE2,     convert_rgba_to_yuva420_10bit_sse41 },
+    { CF_RGBA, OUT_CSP_YUVA420, BIT10, A,  2,  NONE,                 convert_rgba_to_yuva420_10bit },
+    { CF_RGBA, OUT_CSP_YUVA420, BIT16, A,  2,  AVX2|AVX,             convert_rgba_to_yuva420_16bit_avx2 },
+    { CF_RGBA, OUT_CSP_YUVA420, BIT16, A,  2,  AVX|SSE41|SSSE3|SSE2, convert_rgba_to_yuva420_16bit_avx },
+    { CF_RGBA, OUT_CSP_YUVA420, BIT16, A,  2,  SSE41|SSSE3|SSE2,     convert_rgba_to_yuva420_16bit_sse41 },
+    { CF_RGBA, OUT_CSP_YUVA420, BIT16, A,  2,  NONE,                 convert_rgba_to_yuva420_16bit },
+    { CF_RGBA, OUT_CSP_YUVA444, BIT_8, A,  1,  AVX2|AVX,             convert_rgba_to_yuva444_avx2 },
+    { CF_RGBA, OUT_CSP_YUVA444, BIT_8, A,  1,  AVX|SSE41|SSSE3|SSE2, convert_rgba_to_yuva444_avx },
+    { CF_RGBA, OUT_CSP_YUVA444, BIT_8, A,  1,  SSE41|SSSE3|SSE2,     convert_rgba_to_yuva444_sse41 },
+    { CF_RGBA, OUT_CSP_YUVA444, BIT_8, A,  1,  NONE,                 convert_rgba_to_yuva444 },
+    { CF_RGBA, OUT_CSP_YUVA444, BIT10, A,  1,  AVX2|AVX,             convert_rgba_to_yuva444_10bit_avx2 },
+    { CF_RGBA, OUT_CSP_YUVA444, BIT10, A,  1,  AVX|SSE41|SSSE3|SSE2, convert_rgba_to_yuva444_10bit_avx },
+    { CF_RGBA, OUT_CSP_YUVA444, BIT10, A,  1,  SSE41|SSSE3|SSE2,     convert_rgba_to_yuva444_10bit_sse41 },
+    { CF_RGBA, OUT_CSP_YUVA444, BIT10, A,  1,  NONE,                 convert_rgba_to_yuva444_10bit },
+    { CF_RGBA, OUT_CSP_YUVA444, BIT16, A,  1,  AVX2|AVX,             convert_rgba_to_yuva444_16bit_avx2 },
+    { CF_RGBA, OUT_CSP_YUVA444, BIT16, A,  1,  AVX|SSE41|SSSE3|SSE2, convert_rgba_to_yuva444_16bit_avx },
+    { CF_RGBA, OUT_CSP_YUVA444, BIT16, A,  1,  SSE41|SSSE3|SSE2,     convert_rgba_to_yuva444_16bit_sse41 },
+    { CF_RGBA, OUT_CSP_YUVA444, BIT16, A,  1,  NONE,                 convert_rgba_to_yuva444_16bit },
+    //YC48/YUY2 -> p012/yuv444p12/p210/y210 (convert_tmpl.hから生成)
+    { CF_YC48, OUT_CSP_P012,      BIT12, P,  1,  AVX2|AVX,             convert_yc48_to_p012_avx2 },
+    { CF_YC48, OUT_CSP_P012,      BIT12, P,  1,  SSE41|SSSE3|SSE2,     convert_yc48_to_p012_sse41 },
+    { CF_YC48, OUT_CSP_P012,      BIT12, P,  1,  NONE,                 convert_yc48_to_p012 },
+    { CF_YC48, OUT_CSP_P012,      BIT12, I,  1,  AVX2|AVX,             convert_yc48_to_p012_i_avx2 },
+    { CF_YC48, OUT_CSP_P012,      BIT12, I,  1,  SSE41|SSSE3|SSE2,     convert_yc48_to_p012_i_sse41 },
+    { CF_YC48, OUT_CSP_P012,      BIT12, I,  1,  NONE,                 convert_yc48_to_p012_i },
+    { CF_YC48, OUT_CSP_YUV444_12, BIT12, A,  1,  AVX2|AVX,             convert_yc48_to_yuv444_12bit_avx2 },
+    { CF_YC48, OUT_CSP_YUV444_12, BIT12, A,  1,  SSE41|SSSE3|SSE2,     convert_yc48_to_yuv444_12bit_sse41 },
+    { CF_YC48, OUT_CSP_YUV444_12, BIT12, A,  1,  NONE,                 convert_yc48_to_yuv444_12bit },
+    { CF_YC48, OUT_CSP_P210,      BIT10, A,  1,  AVX2|AVX,             convert_yc48_to_p210_avx2 },
+    { CF_YC48, OUT_CSP_P210,      BIT10, A,  1,  SSE41|SSSE3|SSE2,     convert_yc48_to_p210_sse41 },
+    { CF_YC48, OUT_CSP_P210,      BIT10, A,  1,  NONE,                 convert_yc48_to_p210 },
+    { CF_YC48, OUT_CSP_Y210,      BIT10, A,  1,  AVX2|AVX,             convert_yc48_to_y210_avx2 },
+    { CF_YC48, OUT_CSP_Y210,      BIT10, A,  1,  SSE41|SSSE3|SSE2,     convert_yc48_to_y210_sse41 },
+    { CF_YC48, OUT_CSP_Y210,      BIT10, A,  1,  NONE,                 convert_yc48_to_y210 },
+    { CF_YUY2, OUT_CSP_P012,      BIT12, P,  1,  AVX2|AVX,             convert_yuy2_to_p012_avx2 },
+    { CF_YUY2, OUT_CSP_P012,      BIT12, P,  1,  SSE41|SSSE3|SSE2,     convert_yuy2_to_p012_sse41 },
+    { CF_YUY2, OUT_CSP_P012,      BIT12, P,  1,  NONE,                 convert_yuy2_to_p012 },
+    { CF_YUY2, OUT_CSP_P012,      BIT12, I,  1,  AVX2|AVX,             convert_yuy2_to_p012_i_avx2 },
+    { CF_YUY2, OUT_CSP_P012,      BIT12, I,  1,  SSE41|SSSE3|SSE2,     convert_yuy2_to_p012_i_sse41 },
+    { CF_YUY2, OUT_CSP_P012,      BIT12, I,  1,  NONE,                 convert_yuy2_to_p012_i },
+    { CF_YUY2, OUT_CSP_YUV444_12, BIT12, A,  1,  AVX2|AVX,             convert_yuy2_to_yuv444_12bit_avx2 },
+    { CF_YUY2, OUT_CSP_YUV444_12, BIT12, A,  1,  SSE41|SSSE3|SSE2,     convert_yuy2_to_yuv444_12bit_sse41 },
+    { CF_YUY2, OUT_CSP_YUV444_12, BIT12, A,  1,  NONE,                 convert_yuy2_to_yuv444_12bit },
+    { CF_YUY2, OUT_CSP_P210,      BIT10, A,  1,  AVX2|AVX,             convert_yuy2_to_p210_avx2 },
+    { CF_YUY2, OUT_CSP_P210,      BIT10, A,  1,  SSE41|SSSE3|SSE2,     convert_yuy2_to_p210_sse41 },
+    { CF_YUY2, OUT_CSP_P210,      BIT10, A,  1,  NONE,                 convert_yuy2_to_p210 },
+    { CF_YUY2, OUT_CSP_Y210,      BIT10, A,  1,  AVX2|AVX,             convert_yuy2_to_y210_avx2 },
+    { CF_YUY2, OUT_CSP_Y210,      BIT10, A,  1,  SSE41|SSSE3|SSE2,     convert_yuy2_to_y210_sse41 },
+    { CF_YUY2, OUT_CSP_Y210,      BIT10, A,  1,  NONE,                 convert_yuy2_to_y210 },
+    //YC48/YUY2 -> yuv420p10le/yuv420p16le (convert_tmpl.hから生成)
+    { CF_YC48, OUT_CSP_YUV420_10, BIT10, P,  1,  AVX2|AVX,             convert_yc48_to_yuv420_10bit_avx2 },
+    { CF_YC48, OUT_CSP_YUV420_10, BIT10, P,  1,  SSE41|SSSE3|SSE2,     convert_yc48_to_yuv420_10bit_sse41 },
+    { CF_YC48, OUT_CSP_YUV420_10, BIT10, P,  1,  NONE,                 convert_yc48_to_yuv420_10bit },
+    { CF_YC48, OUT_CSP_YUV420_10, BIT10, I,  1,  AVX2|AVX,             convert_yc48_to_yuv420_i_10bit_avx2 },
+    { CF_YC48, OUT_CSP_YUV420_10, BIT10, I,  1,  SSE41|SSSE3|SSE2,     convert_yc48_to_yuv420_i_10bit_sse41 },
+    { CF_YC48, OUT_CSP_YUV420_10, BIT10, I,  1,  NONE,                 convert_yc48_to_yuv420_i_10bit },
+    { CF_YC48, OUT_CSP_YUV420_16, BIT16, P,  1,  AVX2|AVX,             convert_yc48_to_yuv420_16bit_avx2 },
+    { CF_YC48, OUT_CSP_YUV420_16, BIT16, P,  1,  SSE41|SSSE3|SSE2,     convert_yc48_to_yuv420_16bit_sse41 },
+    { CF_YC48, OUT_CSP_YUV420_16, BIT16, P,  1,  NONE,                 convert_yc48_to_yuv420_16bit },
+    { CF_YC48, OUT_CSP_YUV420_16, BIT16, I,  1,  AVX2|AVX,             convert_yc48_to_yuv420_i_16bit_avx2 },
+    { CF_YC48, OUT_CSP_YUV420_16, BIT16, I,  1,  SSE41|SSSE3|SSE2,     convert_yc48_to_yuv420_i_16bit_sse41 },
+    { CF_YC48, OUT_CSP_YUV420_16, BIT16, I,  1,  NONE,                 convert_yc48_to_yuv420_i_16bit },
+    { CF_YUY2, OUT_CSP_YUV420_10, BIT10, P,  1,  AVX2|AVX,             convert_yuy2_to_yuv420_10bit_avx2 },
+    { CF_YUY2, OUT_CSP_YUV420_10, BIT10, P,  1,  SSE41|SSSE3|SSE2,     convert_yuy2_to_yuv420_10bit_sse41 },
+    { CF_YUY2, OUT_CSP_YUV420_10, BIT10, P,  1,  NONE,                 convert_yuy2_to_yuv420_10bit },
+    { CF_YUY2, OUT_CSP_YUV420_10, BIT10, I,  1,  AVX2|AVX,             convert_yuy2_to_yuv420_i_10bit_avx2 },
+    { CF_YUY2, OUT_CSP_YUV420_10, BIT10, I,  1,  SSE41|SSSE3|SSE2,     convert_yuy2_to_yuv420_i_10bit_sse41 },
+    { CF_YUY2, OUT_CSP_YUV420_10, BIT10, I,  1,  NONE,                 convert_yuy2_to_yuv420_i_10bit },
+    { CF_YUY2, OUT_CSP_YUV420_16, BIT16, P,  1,  AVX2|AVX,             convert_yuy2_to_yuv420_16bit_avx2 },
+    { CF_YUY2, OUT_CSP_YUV420_16, BIT16, P,  1,  SSE41|SSSE3|SSE2,     convert_yuy2_to_yuv420_16bit_sse41 },
+    { CF_YUY2, OUT_CSP_YUV420_16, BIT16, P,  1,  NONE,                 convert_yuy2_to_yuv420_16bit },
+    { CF_YUY2, OUT_CSP_YUV420_16, BIT16, I,  1,  AVX2|AVX,             convert_yuy2_to_yuv420_i_16bit_avx2 },
+    { CF_YUY2, OUT_CSP_YUV420_16, BIT16, I,  1,  SSE41|SSSE3|SSE2,     convert_yuy2_to_yuv420_i_16bit_sse41 },
+    { CF_YUY2, OUT_CSP_YUV420_16, BIT16, I,  1,  NONE,                 convert_yuy2_to_yuv420_i_16bit },
+    { 0, 0, 0, A, 0, 0, NULL }
+};
+
+//ディザをかけて8bitに変換する関数のテーブル
+//YC48 (16bit精度) から直接8bitに落とすことで、YUY2での受け取りによる切り捨てを避ける
+static const COVERT_FUNC_INFO FUNC_TABLE_ORDERED_DITHER[] = {
+#if ENABLE_NV12
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, P,  1,  AVX2|AVX,             convert_yc48_to_nv12_ordered_dither_avx2 },
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, I,  1,  AVX2|AVX,             convert_yc48_to_nv12_i_ordered_dither_avx2 },
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, P,  1,  AVX|SSE41|SSSE3|SSE2, convert_yc48_to_nv12_ordered_dither_avx },
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, I,  1,  AVX|SSE41|SSSE3|SSE2, convert_yc48_to_nv12_i_ordered_dither_avx },
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, P,  1,  SSE41|SSSE3|SSE2,     convert_yc48_to_nv12_ordered_dither_sse41 },
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, I,  1,  SSE41|SSSE3|SSE2,     convert_yc48_to_nv12_i_ordered_dither_sse41 },
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, P,  1,  SSSE3|SSE2,           convert_yc48_to_nv12_ordered_dither_ssse3 },
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, I,  1,  SSSE3|SSE2,           convert_yc48_to_nv12_i_ordered_dither_ssse3 },
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, P,  1,  SSE2,                 convert_yc48_to_nv12_ordered_dither_sse2 },
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, I,  1,  SSE2,                 convert_yc48_to_nv12_i_ordered_dither_sse2 },
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, P,  1,  NONE,                 convert_yc48_to_nv12_ordered_dither },
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, I,  1,  NONE,                 convert_yc48_to_nv12_i_ordered_dither },
+    { CF_YC48, OUT_CSP_YUV444, BIT_8, A,  1,  AVX2|AVX,             convert_yc48_to_yuv444_ordered_dither_avx2 },
+    { CF_YC48, OUT_CSP_YUV444, BIT_8, A,  1,  AVX|SSE41|SSSE3|SSE2, convert_yc48_to_yuv444_ordered_dither_avx },
+    { CF_YC48, OUT_CSP_YUV444, BIT_8, A,  1,  SSE41|SSSE3|SSE2,     convert_yc48_to_yuv444_ordered_dither_sse41 },
+    { CF_YC48, OUT_CSP_YUV444, BIT_8, A,  1,  SSSE3|SSE2,           convert_yc48_to_yuv444_ordered_dither_ssse3 },
+    { CF_YC48, OUT_CSP_YUV444, BIT_8, A,  1,  SSE2,                 convert_yc48_to_yuv444_ordered_dither_sse2 },
+    { CF_YC48, OUT_CSP_YUV444, BIT_8, A,  1,  NONE,                 convert_yc48_to_yuv444_ordered_dither },
+#endif
+    { 0, 0, 0, A, 0, 0, NULL }
+};
+
+static const COVERT_FUNC_INFO FUNC_TABLE_ERR_DIFFUSION[] = {
+#if ENABLE_NV12
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, P,  1,  AVX2|AVX,             convert_yc48_to_nv12_err_diffusion_avx2 },
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, I,  1,  AVX2|AVX,             convert_yc48_to_nv12_i_err_diffusion_avx2 },
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, P,  1,  AVX|SSE41|SSSE3|SSE2, convert_yc48_to_nv12_err_diffusion_avx },
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, I,  1,  AVX|SSE41|SSSE3|SSE2, convert_yc48_to_nv12_i_err_diffusion_avx },
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, P,  1,  SSE41|SSSE3|SSE2,     convert_yc48_to_nv12_err_diffusion_sse41 },
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, I,  1,  SSE41|SSSE3|SSE2,     convert_yc48_to_nv12_i_err_diffusion_sse41 },
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, P,  1,  SSSE3|SSE2,           convert_yc48_to_nv12_err_diffusion_ssse3 },
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, I,  1,  SSSE3|SSE2,           convert_yc48_to_nv12_i_err_diffusion_ssse3 },
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, P,  1,  SSE2,                 convert_yc48_to_nv12_err_diffusion_sse2 },
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, I,  1,  SSE2,                 convert_yc48_to_nv12_i_err_diffusion_sse2 },
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, P,  1,  NONE,                 convert_yc48_to_nv12_err_diffusion },
+    { CF_YC48, OUT_CSP_NV12,   BIT_8, I,  1,  NONE,                 convert_yc48_to_nv12_i_err_diffusion },
+    { CF_YC48, OUT_CSP_YUV444, BIT_8, A,  1,  AVX2|AVX,             convert_yc48_to_yuv444_err_diffusion_avx2 },
+    { CF_YC48, OUT_CSP_YUV444, BIT_8, A,  1,  AVX|SSE41|SSSE3|SSE2, convert_yc48_to_yuv444_err_diffusion_avx },
+    { CF_YC48, OUT_CSP_YUV444, BIT_8, A,  1,  SSE41|SSSE3|SSE2,     convert_yc48_to_yuv444_err_diffusion_sse41 },
+    { CF_YC48, OUT_CSP_YUV444, BIT_8, A,  1,  SSSE3|SSE2,           convert_yc48_to_yuv444_err_diffusion_ssse3 },
+    { CF_YC48, OUT_CSP_YUV444, BIT_8, A,  1,  SSE2,                 convert_yc48_to_yuv444_err_diffusion_sse2 },
+    { CF_YC48, OUT_CSP_YUV444, BIT_8, A,  1,  NONE,                 convert_yc48_to_yuv444_err_diffusion },
+#endif
+    { 0, 0, 0, A, 0, 0, NULL }
+};
+
+//縮小 (面積平均) しながら変換する関数のテーブル
+//入力の幅・高さがちょうど2倍、4倍のときに使用する
+static const COVERT_FUNC_INFO FUNC_TABLE_RESIZE_HALF[] = {
+#if ENABLE_NV12
+    { CF_YUY2, OUT_CSP_NV12,   BIT_8, P, 32,  AVX2|AVX,             convert_yuy2_to_nv12_half_avx2 },
+    { CF_YUY2, OUT_CSP_NV12,   BIT_8, P,  4,  NONE,                 convert_yuy2_to_nv12_half },
+#if ENABLE_16BIT
+    { CF_YC48, OUT_CSP_NV12,   BIT16, P, 32,  AVX2|AVX,             convert_yc48_to_nv12_16bit_half_avx2 },
+    { CF_YC48, OUT_CSP_NV12,   BIT16, P,  4,  NONE,                 convert_yc48_to_nv12_16bit_half },
+#endif
+#endif
+    { 0, 0, 0, A, 0, 0, NULL }
+};
+
+static const COVERT_FUNC_INFO FUNC_TABLE_RESIZE_QUARTER[] = {
+#if ENABLE_NV12
+    { CF_YUY2, OUT_CSP_NV12,   BIT_8, P, 32,  AVX2|AVX,             convert_yuy2_to_nv12_quarter_avx2 },
+    { CF_YUY2, OUT_CSP_NV12,   BIT_8, P,  8,  NONE,                 convert_yuy2_to_nv12_quarter },
+#if ENABLE_16BIT
+    { CF_YC48, OUT_CSP_NV12,   BIT16, P, 32,  AVX2|AVX,             convert_yc48_to_nv12_16bit_quarter_avx2 },
+    { CF_YC48, OUT_CSP_NV12,   BIT16, P,  8,  NONE,                 convert_yc48_to_nv12_16bit_quarter },
+#endif
+#endif
     { 0, 0, 0, A, 0, 0, NULL }
 };
 
@@ -391,7 +597,7 @@ static void build_simd_info(DWORD simd, wchar_t *buf, DWORD nSize) {
     }
 }
 
-static void auo_write_func_info(const COVERT_FUNC_INFO *func_info) {
+static void auo_write_func_info(const COVERT_FUNC_INFO *func_info, int dither) {
     wchar_t simd_buf[128];
     build_simd_info(func_info->SIMD, simd_buf, _countof(simd_buf));
 
@@ -419,46 +625,88 @@ static void auo_write_func_info(const COVERT_FUNC_INFO *func_info) {
         case BIT16: bit_depth = L"(16bit)"; break;
         default: break;
     }
+    const wchar_t *dither_name = L"";
+    switch (dither) {
+        case DITHER_ORDERED:         dither_name = L" (ordered dither)"; break;
+        case DITHER_ERROR_DIFFUSION: dither_name = L" (error diffusion)"; break;
+        default: break;
+    }
 
-    write_log_auo_line_fmt(LOG_INFO, L"converting %s -> %s%s%s%s",
+    write_log_auo_line_fmt(LOG_INFO, L"converting %s -> %s%s%s%s%s",
         char_to_wstring(CF_NAME[func_info->input_from_aviutl]).c_str(),
         char_to_wstring(specify_csp[func_info->output_csp]).c_str(),
         interlaced,
         bit_depth,
+        dither_name,
         simd_buf);
 };
 
 //C4189 : ローカル変数が初期化されましたが、参照されていません。
 #pragma warning( push )
 #pragma warning( disable: 4189 )
-//使用する関数を選択する
-func_convert_frame get_convert_func(int width, int input_csp, int bit_depth, BOOL interlaced, int output_csp) {
-    const DWORD availableSIMD = get_availableSIMD();
-
-    const COVERT_FUNC_INFO *func_info = NULL;
-    for (int i = 0; FUNC_TABLE[i].func; i++) {
-        if (FUNC_TABLE[i].input_from_aviutl != input_csp)
+//テーブルから条件に合う関数を探す
+static const COVERT_FUNC_INFO *find_convert_func(const COVERT_FUNC_INFO *table, DWORD availableSIMD, int width, int input_csp, int bit_depth, BOOL interlaced, int output_csp) {
+    for (int i = 0; table[i].func; i++) {
+        if (table[i].input_from_aviutl != input_csp)
             continue;
-        if (FUNC_TABLE[i].output_csp != output_csp)
+        if (table[i].output_csp != output_csp)
             continue;
-        if (FUNC_TABLE[i].bit_depth != bit_depth)
+        if (table[i].bit_depth != bit_depth)
             continue;
-        if (FUNC_TABLE[i].for_interlaced != A &&
-            FUNC_TABLE[i].for_interlaced != (eInterlace)interlaced)
+        if (table[i].for_interlaced != A &&
+            table[i].for_interlaced != (eInterlace)interlaced)
             continue;
-        if ((width % FUNC_TABLE[i].mod) != 0)
+        if ((width % table[i].mod) != 0)
             continue;
-        if ((FUNC_TABLE[i].SIMD & availableSIMD) != FUNC_TABLE[i].SIMD)
+        if ((table[i].SIMD & availableSIMD) != table[i].SIMD)
             continue;
 
-        func_info = &FUNC_TABLE[i];
-        break;
+        return &table[i];
+    }
+    return NULL;
+}
+
+//使用する関数を選択する
+func_convert_frame get_convert_func(int width, int input_csp, int bit_depth, BOOL interlaced, int output_csp, int dither) {
+    const DWORD availableSIMD = (DWORD)get_availableSIMD();
+
+    const COVERT_FUNC_INFO *func_info = NULL;
+    switch (dither) {
+        case DITHER_ORDERED:
+            func_info = find_convert_func(FUNC_TABLE_ORDERED_DITHER, availableSIMD, width, input_csp, bit_depth, interlaced, output_csp);
+            break;
+        case DITHER_ERROR_DIFFUSION:
+            func_info = find_convert_func(FUNC_TABLE_ERR_DIFFUSION, availableSIMD, width, input_csp, bit_depth, interlaced, output_csp);
+            break;
+        default:
+            break;
+    }
+    if (func_info == NULL) {
+        dither = DITHER_NONE;
+        func_info = find_convert_func(FUNC_TABLE, availableSIMD, width, input_csp, bit_depth, interlaced, output_csp);
     }
 
     if (func_info == NULL)
         return NULL;
 
-    auo_write_func_info(func_info);
+    auo_write_func_info(func_info, dither);
+    return func_info->func;
+}
+
+//縮小しながら変換する関数を選択する (ratioは2か4)、なければNULL
+func_convert_frame get_convert_resize_func(int width, int input_csp, int bit_depth, BOOL interlaced, int output_csp, int ratio) {
+    const DWORD availableSIMD = (DWORD)get_availableSIMD();
+
+    const COVERT_FUNC_INFO *func_info = NULL;
+    switch (ratio) {
+        case 2: func_info = find_convert_func(FUNC_TABLE_RESIZE_HALF,    availableSIMD, width, input_csp, bit_depth, interlaced, output_csp); break;
+        case 4: func_info = find_convert_func(FUNC_TABLE_RESIZE_QUARTER, availableSIMD, width, input_csp, bit_depth, interlaced, output_csp); break;
+        default: break;
+    }
+    if (func_info == NULL)
+        return NULL;
+
+    auo_write_func_info(func_info, DITHER_NONE);
     return func_info->func;
 }
 #pragma warning( pop )
@@ -475,7 +723,7 @@ static uint32_t get_align_size(const DWORD simd_check, const int to_yv12) {
     }
 }
 
-BOOL malloc_pixel_data(CONVERT_CF_DATA * const pixel_data, int width, int height, int output_csp, int bit_depth) {
+BOOL malloc_pixel_data(CONVERT_CF_DATA * const pixel_data, int width, int height, int output_csp, int bit_depth, int numa_node) {
     BOOL ret = TRUE;
 #if ENABLE_NV12
     const int to_yv12 = FALSE;
@@ -483,7 +731,7 @@ BOOL malloc_pixel_data(CONVERT_CF_DATA * const pixel_data, int width, int height
     const int to_yv12 = (output_csp == OUT_CSP_YV12);
 #endif
     const DWORD pixel_size = (bit_depth > 8) ? sizeof(short) : sizeof(BYTE);
-    const DWORD simd_check = get_availableSIMD();
+    const DWORD simd_check = (DWORD)get_availableSIMD();
     const DWORD align_size = get_align_size(simd_check,to_yv12);
 #define ALIGN_NEXT(i, align) (((i) + (align-1)) & (~(align-1))) //alignは2の累乗(1,2,4,8,16,32...)
     const DWORD extra = align_size * 2;
@@ -491,51 +739,86 @@ BOOL malloc_pixel_data(CONVERT_CF_DATA * const pixel_data, int width, int height
 #undef ALIGN_NEXT
 
     ZeroMemory(pixel_data->data, sizeof(pixel_data->data));
+    pixel_data->numa_node = numa_node;
+    pixel_data->dither_err = NULL;
+    if (pixel_data->dither == DITHER_ERROR_DIFFUSION && bit_depth <= 8) {
+        if ((pixel_data->dither_err = (short *)numa_malloc(get_dither_err_buf_size(width), 32, numa_node)) == NULL)
+            ret = FALSE;
+    }
     switch (output_csp) {
         case OUT_CSP_YUY2: //YUY2であってもコピーフレーム機能をサポートするためにはコピーが必要となる
-            if ((pixel_data->data[0] = (BYTE *)_mm_malloc(frame_size * 2, std::max(align_size, 16ul))) == NULL)
+        case OUT_CSP_Y210:
+            if ((pixel_data->data[0] = (BYTE *)numa_malloc(frame_size * 2, std::max(align_size, 16ul), numa_node)) == NULL)
                 ret = FALSE;
             break;
 #if ENABLE_NV12
         case OUT_CSP_NV16:
-            if (   (pixel_data->data[0] = (BYTE *)_mm_malloc(frame_size, std::max(align_size, 16ul))) == NULL
-                || (pixel_data->data[1] = (BYTE *)_mm_malloc(frame_size, std::max(align_size, 16ul))) == NULL)
+        case OUT_CSP_P210:
+            if (   (pixel_data->data[0] = (BYTE *)numa_malloc(frame_size, std::max(align_size, 16ul), numa_node)) == NULL
+                || (pixel_data->data[1] = (BYTE *)numa_malloc(frame_size, std::max(align_size, 16ul), numa_node)) == NULL)
                 ret = FALSE;
             break;
         case OUT_CSP_NV12:
         case OUT_CSP_P010:
+        case OUT_CSP_P012:
         default:
-            if (   ((pixel_data->data[0] = (BYTE *)_mm_malloc(frame_size,             std::max(align_size, 16ul))) == NULL)
-                || ((pixel_data->data[1] = (BYTE *)_mm_malloc(frame_size / 2 + extra, std::max(align_size, 16ul))) == NULL))
+            if (   ((pixel_data->data[0] = (BYTE *)numa_malloc(frame_size,             std::max(align_size, 16ul), numa_node)) == NULL)
+                || ((pixel_data->data[1] = (BYTE *)numa_malloc(frame_size / 2 + extra, std::max(align_size, 16ul), numa_node)) == NULL))
                 ret = FALSE;
             break;
 #else
         case OUT_CSP_YUV422:
-            if (   ((pixel_data->data[0] = (BYTE *)_mm_malloc(frame_size,             std::max(align_size, 16ul))) == NULL)
-                || ((pixel_data->data[1] = (BYTE *)_mm_malloc(frame_size / 2 + extra, std::max(align_size, 16ul))) == NULL)
-                || ((pixel_data->data[2] = (BYTE *)_mm_malloc(frame_size / 2 + extra, std::max(align_size, 16ul))) == NULL))
+            if (   ((pixel_data->data[0] = (BYTE *)numa_malloc(frame_size,             std::max(align_size, 16ul), numa_node)) == NULL)
+                || ((pixel_data->data[1] = (BYTE *)numa_malloc(frame_size / 2 + extra, std::max(align_size, 16ul), numa_node)) == NULL)
+                || ((pixel_data->data[2] = (BYTE *)numa_malloc(frame_size / 2 + extra, std::max(align_size, 16ul), numa_node)) == NULL))
                 ret = FALSE;
             break;
         case OUT_CSP_YV12:
-            if (   ((pixel_data->data[0] = (BYTE *)_mm_malloc(frame_size,             std::max(align_size, 16ul))) == NULL)
-                || ((pixel_data->data[1] = (BYTE *)_mm_malloc(frame_size / 4 + extra, std::max(align_size, 16ul))) == NULL)
-                || ((pixel_data->data[2] = (BYTE *)_mm_malloc(frame_size / 4 + extra, std::max(align_size, 16ul))) == NULL))
+            if (   ((pixel_data->data[0] = (BYTE *)numa_malloc(frame_size,             std::max(align_size, 16ul), numa_node)) == NULL)
+                || ((pixel_data->data[1] = (BYTE *)numa_malloc(frame_size / 4 + extra, std::max(align_size, 16ul), numa_node)) == NULL)
+                || ((pixel_data->data[2] = (BYTE *)numa_malloc(frame_size / 4 + extra, std::max(align_size, 16ul), numa_node)) == NULL))
                 ret = FALSE;
             break;
 #endif
         case OUT_CSP_YUV444:
+        case OUT_CSP_YUV444_12:
         case OUT_CSP_YUV444_16:
-            if (   ((pixel_data->data[0] = (BYTE *)_mm_malloc(frame_size, std::max(align_size, 16ul))) == NULL)
-                || ((pixel_data->data[1] = (BYTE *)_mm_malloc(frame_size, std::max(align_size, 16ul))) == NULL)
-                || ((pixel_data->data[2] = (BYTE *)_mm_malloc(frame_size, std::max(align_size, 16ul))) == NULL))
+            if (   ((pixel_data->data[0] = (BYTE *)numa_malloc(frame_size, std::max(align_size, 16ul), numa_node)) == NULL)
+                || ((pixel_data->data[1] = (BYTE *)numa_malloc(frame_size, std::max(align_size, 16ul), numa_node)) == NULL)
+                || ((pixel_data->data[2] = (BYTE *)numa_malloc(frame_size, std::max(align_size, 16ul), numa_node)) == NULL))
+                ret = FALSE;
+            break;
+        case OUT_CSP_YUV420_10:
+        case OUT_CSP_YUV420_16:
+            if (   ((pixel_data->data[0] = (BYTE *)numa_malloc(frame_size,             std::max(align_size, 16ul), numa_node)) == NULL)
+                || ((pixel_data->data[1] = (BYTE *)numa_malloc(frame_size / 4 + extra, std::max(align_size, 16ul), numa_node)) == NULL)
+                || ((pixel_data->data[2] = (BYTE *)numa_malloc(frame_size / 4 + extra, std::max(align_size, 16ul), numa_node)) == NULL))
                 ret = FALSE;
             break;
         case OUT_CSP_RGB:
-            if ((pixel_data->data[0] = (BYTE *)_mm_malloc(frame_size * 3, std::max(align_size, 16ul))) == NULL)
+            if ((pixel_data->data[0] = (BYTE *)numa_malloc(frame_size * 3, std::max(align_size, 16ul), numa_node)) == NULL)
                 ret = FALSE;
             break;
         case OUT_CSP_RGBA:
-            if ((pixel_data->data[0] = (BYTE *)_mm_malloc(frame_size * 4, std::max(align_size, 16ul))) == NULL)
+            if ((pixel_data->data[0] = (BYTE *)numa_malloc(frame_size * 4, std::max(align_size, 16ul), numa_node)) == NULL)
+                ret = FALSE;
+            break;
+        case OUT_CSP_YUVA420:
+        case OUT_CSP_YUVA420_10:
+        case OUT_CSP_YUVA420_16:
+            if (   ((pixel_data->data[0] = (BYTE *)numa_malloc(frame_size,             std::max(align_size, 16ul), numa_node)) == NULL)
+                || ((pixel_data->data[1] = (BYTE *)numa_malloc(frame_size / 4 + extra, std::max(align_size, 16ul), numa_node)) == NULL)
+                || ((pixel_data->data[2] = (BYTE *)numa_malloc(frame_size / 4 + extra, std::max(align_size, 16ul), numa_node)) == NULL)
+                || ((pixel_data->data[3] = (BYTE *)numa_malloc(frame_size,             std::max(align_size, 16ul), numa_node)) == NULL))
+                ret = FALSE;
+            break;
+        case OUT_CSP_YUVA444:
+        case OUT_CSP_YUVA444_10:
+        case OUT_CSP_YUVA444_16:
+            if (   ((pixel_data->data[0] = (BYTE *)numa_malloc(frame_size, std::max(align_size, 16ul), numa_node)) == NULL)
+                || ((pixel_data->data[1] = (BYTE *)numa_malloc(frame_size, std::max(align_size, 16ul), numa_node)) == NULL)
+                || ((pixel_data->data[2] = (BYTE *)numa_malloc(frame_size, std::max(align_size, 16ul), numa_node)) == NULL)
+                || ((pixel_data->data[3] = (BYTE *)numa_malloc(frame_size, std::max(align_size, 16ul), numa_node)) == NULL))
                 ret = FALSE;
             break;
     }
@@ -543,9 +826,113 @@ BOOL malloc_pixel_data(CONVERT_CF_DATA * const pixel_data, int width, int height
     return ret;
 }
 
+//縮小用の重みと作業領域を確保する (失敗した場合はエラーを表示してFALSEを返す)
+//src_w, src_h, dst_w, dst_hはフレーム全体の大きさ、インタレ保持の場合はフィールドごとに縮小する
+BOOL init_resize_data(RESIZE_DATA *resize, int algo, int src_w, int src_h, int dst_w, int dst_h, int output_csp, int bit_depth, BOOL interlaced) {
+    ZeroMemory(resize, sizeof(RESIZE_DATA));
+    int filter = RESIZE_FILTER_BICUBIC;
+    switch (algo) {
+        case VIDEO_RESIZE_BOX:      filter = RESIZE_FILTER_BOX; break;
+        case VIDEO_RESIZE_BILINEAR: filter = RESIZE_FILTER_BILINEAR; break;
+        case VIDEO_RESIZE_BICUBIC:
+        default:                    filter = RESIZE_FILTER_BICUBIC; break;
+    }
+    const int fields = (interlaced) ? 2 : 1;
+    struct {
+        int div_w, div_h, ch;
+    } layout[4] = { 0 };
+    switch (output_csp) {
+        case OUT_CSP_NV12:
+        case OUT_CSP_P010:
+        case OUT_CSP_P012:
+            resize->count = 2;
+            layout[0] = { 1, 1, 1 };
+            layout[1] = { 2, 2, 2 };
+            break;
+        case OUT_CSP_NV16:
+        case OUT_CSP_P210:
+            resize->count = 2;
+            layout[0] = { 1, 1, 1 };
+            layout[1] = { 2, 1, 2 };
+            break;
+        case OUT_CSP_YUV444:
+        case OUT_CSP_YUV444_12:
+        case OUT_CSP_YUV444_16:
+            resize->count = 3;
+            layout[0] = layout[1] = layout[2] = { 1, 1, 1 };
+            break;
+        case OUT_CSP_YUV420_10:
+        case OUT_CSP_YUV420_16:
+            resize->count = 3;
+            layout[0] = { 1, 1, 1 };
+            layout[1] = layout[2] = { 2, 2, 1 };
+            break;
+        case OUT_CSP_RGB:
+            resize->count = 1;
+            layout[0] = { 1, 1, 3 };
+            break;
+        case OUT_CSP_RGBA:
+            resize->count = 1;
+            layout[0] = { 1, 1, 4 };
+            break;
+        case OUT_CSP_YUVA420:
+        case OUT_CSP_YUVA420_10:
+        case OUT_CSP_YUVA420_16:
+            resize->count = 4;
+            layout[0] = layout[3] = { 1, 1, 1 };
+            layout[1] = layout[2] = { 2, 2, 1 };
+            break;
+        case OUT_CSP_YUVA444:
+        case OUT_CSP_YUVA444_10:
+        case OUT_CSP_YUVA444_16:
+            resize->count = 4;
+            layout[0] = layout[1] = layout[2] = layout[3] = { 1, 1, 1 };
+            break;
+        case OUT_CSP_YUY2:
+        case OUT_CSP_Y210:
+        default:
+            //YUY2, Y210はpackedで輝度と色差の幅が異なるため、縮小に対応しない
+            error_resize_unsupported_csp(output_csp);
+            return FALSE;
+    }
+    resize->byte_per_pixel = (bit_depth > 8) ? sizeof(short) : sizeof(BYTE);
+    //p012, p210は上位ビットに詰めて出力しているので、16bitとして扱う
+    resize->max_value = (output_csp == OUT_CSP_P012 || output_csp == OUT_CSP_P210) ? 65535 : (1 << bit_depth) - 1;
+    resize->interlaced = interlaced;
+    resize->resize_v = (bit_depth > 8) ? resize_vertical_16bit : resize_vertical_8bit;
+    if (get_availableSIMD() & AUO_SIMD_AVX2)
+        resize->resize_v = (bit_depth > 8) ? resize_vertical_16bit_avx2 : resize_vertical_8bit_avx2;
+
+    int tmp_size = 0;
+    for (int i = 0; i < resize->count; i++) {
+        if (!init_resize_plane(&resize->plane[i], filter,
+            src_w / layout[i].div_w, src_h / layout[i].div_h / fields,
+            dst_w / layout[i].div_w, dst_h / layout[i].div_h / fields, layout[i].ch)) {
+            error_malloc_pixel_data();
+            return FALSE;
+        }
+        tmp_size = std::max(tmp_size, src_w / layout[i].div_w * layout[i].ch);
+    }
+    if ((resize->tmp = (int *)_aligned_malloc(sizeof(resize->tmp[0]) * tmp_size, 32)) == NULL) {
+        error_malloc_pixel_data();
+        return FALSE;
+    }
+    return TRUE;
+}
+
+void free_resize_data(RESIZE_DATA *resize) {
+    for (int i = 0; i < resize->count; i++)
+        free_resize_plane(&resize->plane[i]);
+    if (resize->tmp)
+        _aligned_free(resize->tmp);
+    ZeroMemory(resize, sizeof(RESIZE_DATA));
+}
+
 void free_pixel_data(CONVERT_CF_DATA *pixel_data) {
     for (size_t i = 0; i < _countof(pixel_data->data); i++)
         if (pixel_data->data[i])
-            _mm_free(pixel_data->data[i]);
+            numa_free(pixel_data->data[i], pixel_data->numa_node);
+    if (pixel_data->dither_err)
+        numa_free(pixel_data->dither_err, pixel_data->numa_node);
     ZeroMemory(pixel_data, sizeof(CONVERT_CF_DATA));
 }
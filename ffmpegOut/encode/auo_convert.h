@@ -34,9 +34,13 @@
 #include "convert.h"
 
 func_audio_16to8 get_audio_16to8_func(BOOL split); //使用する音声16bit->8bit関数の選択
-func_convert_frame get_convert_func(int width, int input_ccsp, int bit_depth, BOOL interlaced, int output_csp); //使用する関数の選択
+func_convert_frame get_convert_func(int width, int input_ccsp, int bit_depth, BOOL interlaced, int output_csp, int dither = DITHER_NONE); //使用する関数の選択 (ditherはDITHER_xxx)
+func_convert_frame get_convert_resize_func(int width, int input_csp, int bit_depth, BOOL interlaced, int output_csp, int ratio); //縮小しながら変換する関数の選択 (ratioは2か4)、なければNULL
 
-BOOL malloc_pixel_data(CONVERT_CF_DATA * const pixel_data, int width, int height, int output_csp, int bit_depth); //映像バッファ用メモリ確保
+BOOL malloc_pixel_data(CONVERT_CF_DATA * const pixel_data, int width, int height, int output_csp, int bit_depth, int numa_node = -1); //映像バッファ用メモリ確保 (numa_node >= 0 ならそのNUMAノードに確保)
 void free_pixel_data(CONVERT_CF_DATA *pixel_data); //映像バッファ用メモリ開放
 
+BOOL init_resize_data(RESIZE_DATA *resize, int algo, int src_w, int src_h, int dst_w, int dst_h, int output_csp, int bit_depth, BOOL interlaced); //縮小用の重み・作業領域の確保 (algoはVIDEO_RESIZE_xxx)
+void free_resize_data(RESIZE_DATA *resize); //縮小用の重み・作業領域の開放
+
 #endif //_AUO_CONVERT_H_
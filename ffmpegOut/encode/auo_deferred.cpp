@@ -0,0 +1,232 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <shlwapi.h>
+#pragma comment(lib, "shlwapi.lib")
+#include "auo_deferred.h"
+#include "auo_pipe.h"
+#include "auo_file_move.h"
+
+static const DWORD DEFERRED_ENC_PRIORITY      = BELOW_NORMAL_PRIORITY_CLASS;
+static const DWORD DEFERRED_ENC_POLL_INTERVAL = 100; //ms
+
+class AuoDeferredEncQueue {
+public:
+    AuoDeferredEncQueue() : jobs(), th_worker(), mtx(), cond(), running(false), current_frame(0), total_frames(0), abort_enc(false), fin(false) {};
+    ~AuoDeferredEncQueue() { close(FALSE); }
+
+    AUO_RESULT add(const DEFERRED_ENC_JOB& job) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (fin)
+            return AUO_RESULT_ERROR;
+        jobs.push_back(job);
+        if (!th_worker.joinable())
+            th_worker = std::thread(&AuoDeferredEncQueue::thread_func, this);
+        cond.notify_all();
+        return AUO_RESULT_SUCCESS;
+    }
+    int status(double *progress) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (progress)
+            *progress = (running && total_frames > 0) ? std::min(1.0, current_frame / (double)total_frames) : 0.0;
+        return (int)jobs.size() + (running ? 1 : 0);
+    }
+    void close(BOOL wait_finish) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            fin = true;
+            if (!wait_finish) {
+                abort_enc = true;
+                jobs.clear();
+            }
+            cond.notify_all();
+        }
+        if (th_worker.joinable())
+            th_worker.join();
+    }
+private:
+    void thread_func();
+    AUO_RESULT run_job(const DEFERRED_ENC_JOB& job);
+    void set_progress(int frame);
+
+    std::deque<DEFERRED_ENC_JOB> jobs;
+    std::thread th_worker;
+    std::mutex mtx;
+    std::condition_variable cond;
+    bool running;       //ジョブを実行中
+    int current_frame;  //実行中のジョブの進捗
+    int total_frames;
+    bool abort_enc;     //実行中のエンコードを中断する
+    bool fin;           //新たなジョブを受け付けない
+};
+
+void AuoDeferredEncQueue::thread_func() {
+    //Aviutlの処理を妨げないよう、スレッドの優先度も下げておく
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+    for (;;) {
+        DEFERRED_ENC_JOB job;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cond.wait(lock, [this]() { return fin || !jobs.empty(); });
+            if (jobs.empty())
+                return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+            running = true;
+            current_frame = 0;
+            total_frames = job.total_frames;
+        }
+        run_job(job);
+        std::lock_guard<std::mutex> lock(mtx);
+        running = false;
+    }
+}
+
+void AuoDeferredEncQueue::set_progress(int frame) {
+    std::lock_guard<std::mutex> lock(mtx);
+    current_frame = frame;
+}
+
+//ffmpegの進捗表示 ("frame=  123 fps=...") から、最後のフレーム数を取得する
+static int get_last_frame_from_mes(const char *mes) {
+    int frame = -1;
+    for (const char *ptr = mes; (ptr = strstr(ptr, "frame=")) != nullptr; ) {
+        ptr += strlen("frame=");
+        frame = atoi(ptr);
+    }
+    return frame;
+}
+
+AUO_RESULT AuoDeferredEncQueue::run_job(const DEFERRED_ENC_JOB& job) {
+    AUO_RESULT ret = AUO_RESULT_SUCCESS;
+    FILE *fp_log = nullptr;
+    if (fopen_s(&fp_log, job.log_file.c_str(), "ab") != 0)
+        fp_log = nullptr;
+    auto write_log = [fp_log](const char *str) {
+        if (fp_log) {
+            fprintf(fp_log, "auo: %s\n", str);
+            fflush(fp_log);
+        }
+    };
+    write_log(job.args.c_str());
+
+    PIPE_SET pipes = { 0 };
+    InitPipes(&pipes);
+    pipes.stdErr.mode = AUO_PIPE_ENABLE;
+    PROCESS_INFORMATION pi = { 0 };
+    std::vector<char> args(job.args.begin(), job.args.end());
+    args.push_back('\0');
+    if (RP_SUCCESS != RunProcess(args.data(), job.exe_dir.c_str(), &pi, &pipes, DEFERRED_ENC_PRIORITY, TRUE, FALSE)) {
+        write_log("failed to run encoder.");
+        ret |= AUO_RESULT_ERROR;
+    } else {
+        auto read_stderr = [&]() {
+            DWORD pipe_read = 0;
+            if (!PeekNamedPipe(pipes.stdErr.h_read, NULL, 0, NULL, &pipe_read, NULL) || pipe_read == 0)
+                return 0;
+            if (!ReadFile(pipes.stdErr.h_read, pipes.read_buf, sizeof(pipes.read_buf) - 1, &pipe_read, NULL))
+                return 0;
+            pipes.read_buf[pipe_read] = '\0';
+            if (fp_log)
+                fwrite(pipes.read_buf, 1, pipe_read, fp_log);
+            const int frame = get_last_frame_from_mes(pipes.read_buf);
+            if (frame >= 0)
+                set_progress(frame);
+            return (int)pipe_read;
+        };
+        while (WaitForSingleObject(pi.hProcess, DEFERRED_ENC_POLL_INTERVAL) == WAIT_TIMEOUT) {
+            while (read_stderr() > 0);
+            std::lock_guard<std::mutex> lock(mtx);
+            if (abort_enc) {
+                TerminateProcess(pi.hProcess, 1);
+                WaitForSingleObject(pi.hProcess, INFINITE);
+                ret |= AUO_RESULT_ABORT;
+                break;
+            }
+        }
+        while (read_stderr() > 0);
+        DWORD exit_code = 0;
+        if (!GetExitCodeProcess(pi.hProcess, &exit_code) || exit_code != 0) {
+            char mes[256];
+            sprintf_s(mes, "encoder exited with code %d.", (int)exit_code);
+            write_log(mes);
+            ret |= AUO_RESULT_ERROR;
+        }
+        CloseHandle(pi.hProcess);
+        CloseHandle(pi.hThread);
+        CloseHandle(pipes.stdErr.h_read);
+    }
+
+    if (!ret && !PathFileExists(job.output.c_str())) {
+        write_log("output file not found.");
+        ret |= AUO_RESULT_ERROR;
+    }
+    if (!ret) {
+        for (const auto& move : job.move_files) {
+            if (_stricmp(move.first.c_str(), move.second.c_str()) != 0
+                && auo_move_file(move.first.c_str(), move.second.c_str()) != ERROR_SUCCESS) {
+                write_log(("failed to move file: " + move.first + " -> " + move.second).c_str());
+                ret |= AUO_RESULT_ERROR;
+            }
+        }
+    }
+    if (!ret) {
+        for (const auto& file : job.remove_files)
+            DeleteFileA(file.c_str());
+        DeleteFileA(job.intermediate.c_str());
+    } else {
+        //中間ファイルは残しておき、あとからエンコードしなおせるようにする
+        write_log(("intermediate file is kept: " + job.intermediate).c_str());
+    }
+    if (fp_log)
+        fclose(fp_log);
+    if (!ret)
+        DeleteFileA(job.log_file.c_str());
+    return ret;
+}
+
+static AuoDeferredEncQueue g_deferred_enc_queue;
+
+AUO_RESULT deferred_enc_add_job(const DEFERRED_ENC_JOB& job) {
+    return g_deferred_enc_queue.add(job);
+}
+
+int deferred_enc_get_status(double *progress) {
+    return g_deferred_enc_queue.status(progress);
+}
+
+void deferred_enc_close(BOOL wait_finish) {
+    g_deferred_enc_queue.close(wait_finish);
+}
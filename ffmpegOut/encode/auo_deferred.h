@@ -0,0 +1,62 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#ifndef _AUO_DEFERRED_H_
+#define _AUO_DEFERRED_H_
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <string>
+#include <vector>
+#include <utility>
+#include "auo.h"
+
+//中間ファイルからの最終エンコード (「後でエンコード」)
+//Aviutlからの出力は可逆圧縮の中間ファイルに高速に書き出して終了し、
+//最終エンコードはバックグラウンドのキューで1つずつ、低優先度で実行する
+typedef struct DEFERRED_ENC_JOB {
+    std::string args;         //エンコーダのコマンドライン (実行ファイルのパスを含む)
+    std::string exe_dir;      //エンコーダのディレクトリ
+    std::string output;       //エンコーダの出力ファイル
+    std::string intermediate; //中間ファイル (成功したら削除)
+    std::string log_file;     //エンコーダの出力するログの保存先 (成功したら削除)
+    std::vector<std::pair<std::string, std::string>> move_files; //成功したら移動するファイル (移動元, 移動先)
+    std::vector<std::string> remove_files; //成功したら削除するファイル
+    int total_frames;         //進捗表示用のフレーム数
+} DEFERRED_ENC_JOB;
+
+AUO_RESULT deferred_enc_add_job(const DEFERRED_ENC_JOB& job);
+//実行中を含む残りのジョブ数を返す
+//実行中のジョブがあれば、その進捗 (0.0 - 1.0) をprogressに返す
+int deferred_enc_get_status(double *progress);
+//残りのジョブを終了させる
+//wait_finishがTRUEなら、すべてのジョブの完了を待つ
+//FALSEなら実行中のエンコードを中断する (中間ファイルは残す)
+void deferred_enc_close(BOOL wait_finish);
+
+#endif //_AUO_DEFERRED_H_
@@ -58,6 +58,7 @@
 #include "auo_error.h"
 #include "auo_audio.h"
 #include "auo_faw2aac.h"
+#include "auo_file_move.h"
 #include "cpu_info.h"
 #include "exe_version.h"
 
@@ -199,14 +200,17 @@ std::filesystem::path find_latest_ffmpeg(const std::vector<std::filesystem::path
     if (selectedPathList.size() == 1) {
         return selectedPathList.front();
     }
+    std::vector<std::string> exePathList;
+    for (auto& path : selectedPathList) {
+        exePathList.push_back(path.string());
+    }
+    const auto exeInfoList = probe_exe_files_cached(exePathList, "-version");
     int version[4] = { 0 };
     std::filesystem::path ret;
-    for (auto& path : selectedPathList) {
-        int value[4] = { 0 };
-        int v = get_exe_version_from_cmd(path.string().c_str(), "-version", value);
-        if (version_a_larger_than_b(value, version) > 0) {
-            memcpy(version, value, sizeof(version));
-            ret = path;
+    for (size_t i = 0; i < selectedPathList.size(); i++) {
+        if (version_a_larger_than_b(exeInfoList[i].version, version) > 0) {
+            memcpy(version, exeInfoList[i].version, sizeof(version));
+            ret = selectedPathList[i];
         }
     }
     return ret;
@@ -220,6 +224,53 @@ bool video_is_last_pass(const PRM_ENC *pe) {
     return pe->total_x264_pass == 0 || pe->current_x264_pass >= pe->total_x264_pass;
 }
 
+//外部音声エンコーダの出力を、書き込み中のままffmpegに入力できるか
+//先頭から順に読むだけで解釈できる形式に限る (m4aなど、ヘッダやインデックスを最後に書き込む形式は不可)
+static BOOL audio_can_stream_to_videnc(const CONF_GUIEX *conf, const guiEx_settings *exstg) {
+    static const char * const STREAMABLE_EXT[] = { ".aac", ".adts", ".ac3", ".eac3", ".mp2", ".mp3", ".dts", ".flac", ".ogg", ".oga", ".opus" };
+    const CONF_AUDIO_BASE *cnf_aud = &conf->aud.ext;
+    const AUDIO_SETTINGS *aud_stg = &exstg->s_aud_ext[cnf_aud->encoder];
+    if (!exstg->s_local.audio_stream_to_videnc
+        || conf->enc.use_auto_npass                        //音声は2pass目以降のみ入力するので、同時に処理できない
+        || exstg->is_faw(aud_stg)
+        || !str_has_char(aud_stg->filename)
+        || cnf_aud->use_wav || cnf_aud->use_2pass          //wavファイルを作成してからでないとエンコーダを起動できない
+        || aud_stg->mode[cnf_aud->enc_mode].use_8bit == 2) //音声ファイルが2つになる
+        return FALSE;
+    const char *appendix = (cnf_aud->delay_cut == AUDIO_DELAY_CUT_EDTS) ? aud_stg->raw_appendix : aud_stg->aud_appendix;
+    const char *ext = PathFindExtension(appendix);
+    for (int i = 0; i < _countof(STREAMABLE_EXT); i++)
+        if (_stricmp(ext, STREAMABLE_EXT[i]) == 0)
+            return TRUE;
+    return FALSE;
+}
+
+int get_audio_encode_timing(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *pe, const guiEx_settings *exstg) {
+    if (conf->aud.use_internal)
+        return AUDIO_ENC_TIMING_PARALLEL;
+
+    CONF_AUDIO_BASE *cnf_aud = &conf->aud.ext;
+    if ((oip->flag & OUTPUT_INFO_FLAG_AUDIO) && conf->enc.audio_input) {
+        if (!pe->deferred_enc && audio_can_stream_to_videnc(conf, exstg)) {
+            //音声エンコーダの出力を名前付きパイプ経由でffmpegに渡し、映像と同時に処理する
+            pe->aud_stream_to_videnc = TRUE;
+            cnf_aud->audio_encode_timing = AUDIO_ENC_TIMING_PARALLEL;
+        } else {
+            //音声をffmpegに入力する場合、映像の処理開始時に音声ファイルができていなければならない
+            //後でエンコードする場合も、最終エンコードの開始時に音声ファイルができていればよいが、音声の処理を先に済ませておく
+            cnf_aud->audio_encode_timing = AUDIO_ENC_TIMING_BEFORE;
+        }
+    } else if (cnf_aud->audio_encode_timing == AUDIO_ENC_TIMING_AUTO) {
+        //まず「後」として映像の処理を開始し、音声エンコーダと映像の処理速度を計測してから同時処理に切り替えるかを決める
+        //切り替えた場合は、ffmpeg_out内でAUDIO_ENC_TIMING_PARALLELに変更される
+        pe->aud_timing_auto.enable = TRUE;
+        cnf_aud->audio_encode_timing = AUDIO_ENC_TIMING_AFTER;
+    } else if (cnf_aud->audio_encode_timing < AUDIO_ENC_TIMING_AFTER || AUDIO_ENC_TIMING_PARALLEL < cnf_aud->audio_encode_timing) {
+        cnf_aud->audio_encode_timing = AUDIO_ENC_TIMING_BEFORE;
+    }
+    return cnf_aud->audio_encode_timing;
+}
+
 static BOOL check_muxer_exist(MUXER_SETTINGS *muxer_stg, const char *aviutl_dir, const BOOL get_relative_path, const std::vector<std::filesystem::path>& exe_files) {
     if (PathFileExists(muxer_stg->fullpath)) {
         info_use_exe_found(muxer_stg->dispname, muxer_stg->fullpath);
@@ -254,25 +305,11 @@ const MUXER_CMD_EX *get_muxer_mode(const CONF_GUIEX *conf, const SYSTEM_DATA *sy
 }
 
 static BOOL check_if_exe_is_mp4box(const char *exe_path, const char *version_arg) {
-    BOOL ret = FALSE;
-    char exe_message[8192] = { 0 };
-    if (   PathFileExists(exe_path)
-        && RP_SUCCESS == get_exe_message(exe_path, version_arg, exe_message, _countof(exe_message), AUO_PIPE_MUXED)
-        && (stristr(exe_message, "mp4box") || stristr(exe_message, "GPAC"))) {
-        ret = TRUE;
-    }
-    return ret;
+    return PathFileExists(exe_path) && get_exe_type_cached(exe_path, version_arg) == EXE_TYPE_MP4BOX;
 }
 
 static BOOL check_if_exe_is_lsmash(const char *exe_path, const char *version_arg) {
-    BOOL ret = FALSE;
-    char exe_message[8192] = { 0 };
-    if (   PathFileExists(exe_path)
-        && RP_SUCCESS == get_exe_message(exe_path, version_arg, exe_message, _countof(exe_message), AUO_PIPE_MUXED)
-        && stristr(exe_message, "L-SMASH")) {
-        ret = TRUE;
-    }
-    return ret;
+    return PathFileExists(exe_path) && get_exe_type_cached(exe_path, version_arg) == EXE_TYPE_LSMASH;
 }
 
 static BOOL check_muxer_matched_with_ini(const MUXER_SETTINGS *mux_stg) {
@@ -480,10 +517,16 @@ BOOL check_output(CONF_GUIEX *conf, OUTPUT_INFO *oip, const PRM_ENC *pe, guiEx_s
     int w_mul = 1, h_mul = 1;
     switch (conf->enc.output_csp) {
         case OUT_CSP_YUV444:
+        case OUT_CSP_YUV444_12:
         case OUT_CSP_RGB:
         case OUT_CSP_RGBA:
+        case OUT_CSP_YUVA444:
+        case OUT_CSP_YUVA444_10:
+        case OUT_CSP_YUVA444_16:
             w_mul = 1, h_mul = 1; break;
         case OUT_CSP_NV16:
+        case OUT_CSP_P210:
+        case OUT_CSP_Y210:
             w_mul = 2, h_mul = 1; break;
         case OUT_CSP_NV12:
         default:
@@ -825,6 +868,18 @@ static void set_tmpdir(PRM_ENC *pe, int tmp_dir_index, const char *savefile, con
             tmp_dir_index = TMP_DIR_OUTPUT;
         }
     }
+    if (tmp_dir_index != TMP_DIR_OUTPUT && sys_dat->exstg->s_local.tmp_dir_same_volume) {
+        //一時フォルダが出力先と別のドライブにある場合、最後にファイルのコピーが必要になる
+        //出力先のドライブの空き容量が一時フォルダのドライブ以上あれば、出力先を一時フォルダとして使用する
+        UINT64 output_free_space = 0, temp_free_space = 0;
+        if (!is_same_volume(pe->temp_filename, savefile)
+            && GetPathRootFreeSpace(savefile, &output_free_space)
+            && GetPathRootFreeSpace(pe->temp_filename, &temp_free_space)
+            && output_free_space >= temp_free_space) {
+            write_log_auo_line(LOG_INFO, g_auo_mes.get(AUO_ENCODE_TMP_FOLDER_SAME_VOLUME));
+            tmp_dir_index = TMP_DIR_OUTPUT;
+        }
+    }
     if (tmp_dir_index == TMP_DIR_OUTPUT) {
         //出力フォルダと同じ("\"なし)
         strcpy_s(pe->temp_filename, _countof(pe->temp_filename), savefile);
@@ -898,6 +953,11 @@ void set_enc_prm(CONF_GUIEX *conf, PRM_ENC *pe, const OUTPUT_INFO *oip, const SY
     //pe->amp_x264_pass_limit = pe->total_x264_pass + sys_dat->exstg->s_local.amp_retry_limit;
     pe->current_x264_pass = 1;
     pe->drop_count = 0;
+    //後でエンコードする場合は、可逆圧縮の中間ファイルに出力する (自動マルチパスは対象外)
+    pe->deferred_enc = sys_dat->exstg->s_local.deferred_encode
+        && pe->video_out_type != VIDEO_OUTPUT_DISABLED
+        && !conf->enc.use_auto_npass
+        && str_has_char(sys_dat->exstg->s_local.deferred_intermediate_cmd);
     memcpy(&pe->append, &sys_dat->exstg->s_append, sizeof(FILE_APPENDIX));
     ZeroMemory(&pe->append.aud, sizeof(pe->append.aud));
     create_aviutl_opened_file_list(pe);
@@ -1154,10 +1214,15 @@ static void remove_file(const char *target, const wchar_t *name) {
     }
 }
 
+static void warning_move_file_failed(const char *move_to, const wchar_t *name, DWORD err) {
+    auto errstr = getLastErrorStr(err);
+    write_log_auo_line_fmt(LOG_WARNING, L"%s%s: %s (\"%s\")", name, g_auo_mes.get(AUO_ENCODE_FILE_MOVE_FAILED), errstr.c_str(), char_to_wstring(move_to).c_str());
+}
+
 static void move_file(const char *move_from, const char *move_to, const wchar_t *name) {
-    if (!MoveFile(move_from, move_to)) {
-        auto errstr = getLastErrorStr(GetLastError());
-        write_log_auo_line_fmt(LOG_WARNING, L"%s%s: %s (\"%s\")", name, g_auo_mes.get(AUO_ENCODE_FILE_MOVE_FAILED), errstr.c_str(), char_to_wstring(move_to).c_str());
+    const DWORD err = auo_move_file(move_from, move_to);
+    if (err != ERROR_SUCCESS) {
+        warning_move_file_failed(move_to, name, err);
     }
 }
 
@@ -1170,7 +1235,8 @@ static void move_file(const char *move_from, const char *move_to, const wchar_t
 // ret, erase    … これまでのエラーと一時ファイルを削除するかどうか。エラーがない場合にのみ削除できる
 // name          … 一時ファイルの種類の名前
 // must_exist    … trueのとき、移動するべきファイルが存在しないとエラーを返し、ファイルが存在しないことを伝える
-static BOOL move_temp_file(const char *appendix, const char *temp_filename, const char *savefile, DWORD ret, BOOL erase, const wchar_t *name, BOOL must_exist) {
+// move_tasks    … 指定されていれば、移動はここでは行わずに追加する (auo_move_filesでまとめて行う)
+static BOOL move_temp_file(const char *appendix, const char *temp_filename, const char *savefile, DWORD ret, BOOL erase, const wchar_t *name, BOOL must_exist, std::vector<AUO_FILE_MOVE_TASK> *move_tasks = nullptr) {
     char move_from_tmp[MAX_PATH_LEN] = { 0 };
     if (appendix)
         apply_appendix(move_from_tmp, _countof(move_from_tmp), temp_filename, appendix);
@@ -1206,15 +1272,26 @@ static BOOL move_temp_file(const char *appendix, const char *temp_filename, cons
         if (PathFileExists(move_to)) {
             remove_file(move_to, name);
         }
-        move_file(move_from, move_to, name);
+        if (move_tasks) {
+            move_tasks->push_back({ move_from, move_to, name, ERROR_SUCCESS });
+        } else {
+            move_file(move_from, move_to, name);
+        }
     }
     return TRUE;
 }
 
 AUO_RESULT move_temporary_files(const CONF_GUIEX *conf, const PRM_ENC *pe, const SYSTEM_DATA *sys_dat, const OUTPUT_INFO *oip, DWORD ret) {
+    //後でエンコードする場合、動画ファイルと動画に入力する音声ファイルは、最終エンコード後に移動する
+    const BOOL deferred = pe->deferred_enc && !ret;
+    //移動は最後にまとめて行う (別のドライブへの移動は同時に行う)
+    std::vector<AUO_FILE_MOVE_TASK> move_tasks;
+    //中間ファイル (エラー時のみ、ここで削除する)
+    if (pe->deferred_enc && ret)
+        move_temp_file(DEFERRED_INTERMEDIATE_APPENDIX, pe->temp_filename, NULL, AUO_RESULT_SUCCESS, TRUE, g_auo_mes.get(AUO_ENCODE_DEFERRED_INTERMEDIATE), FALSE);
     //動画ファイル
-    if (!conf->oth.out_audio_only) {
-        if (!move_temp_file(PathFindExtension((pe->muxer_to_be_used >= 0) ? oip->savefile : pe->temp_filename), pe->temp_filename, oip->savefile, ret, FALSE, L"出力", !ret)) {
+    if (!conf->oth.out_audio_only && !deferred) {
+        if (!move_temp_file(PathFindExtension((pe->muxer_to_be_used >= 0) ? oip->savefile : pe->temp_filename), pe->temp_filename, oip->savefile, ret, FALSE, L"出力", !ret, &move_tasks)) {
             ret |= AUO_RESULT_ERROR;
         }
     }
@@ -1225,7 +1302,7 @@ AUO_RESULT move_temporary_files(const CONF_GUIEX *conf, const PRM_ENC *pe, const
     if (pe->muxer_to_be_used >= 0) {
         char muxout_appendix[MAX_APPENDIX_LEN];
         get_muxout_appendix(muxout_appendix, _countof(muxout_appendix), sys_dat, pe);
-        move_temp_file(muxout_appendix, pe->temp_filename, oip->savefile, ret, FALSE, g_auo_mes.get(AUO_ENCODE_AFTER_MUX), FALSE);
+        move_temp_file(muxout_appendix, pe->temp_filename, oip->savefile, ret, FALSE, g_auo_mes.get(AUO_ENCODE_AFTER_MUX), FALSE, &move_tasks);
     }
     /*
     //qpファイル
@@ -1254,13 +1331,19 @@ AUO_RESULT move_temporary_files(const CONF_GUIEX *conf, const PRM_ENC *pe, const
     */
     //音声ファイル(wav)
     if (strcmp(pe->append.aud[0], pe->append.wav)) //「wav出力」ならここでは処理せず下のエンコード後ファイルとして扱う
-        move_temp_file(pe->append.wav,  pe->temp_filename, oip->savefile, ret, TRUE, L"wav", FALSE);
+        move_temp_file(pe->append.wav,  pe->temp_filename, oip->savefile, ret, TRUE, L"wav", FALSE, &move_tasks);
     //音声ファイル(エンコード後ファイル)
     char aud_tempfile[MAX_PATH_LEN];
     PathCombineLong(aud_tempfile, _countof(aud_tempfile), pe->aud_temp_dir, PathFindFileName(pe->temp_filename));
-    for (int i_aud = 0; i_aud < pe->aud_count; i_aud++)
-        if (!move_temp_file(pe->append.aud[i_aud], aud_tempfile, oip->savefile, ret, !conf->oth.out_audio_only && pe->muxer_to_be_used != MUXER_DISABLED, g_auo_mes.get(AUO_ENCODE_AUDIO_FILE), conf->oth.out_audio_only))
+    for (int i_aud = 0; !(deferred && conf->enc.audio_input) && i_aud < pe->aud_count; i_aud++)
+        if (!move_temp_file(pe->append.aud[i_aud], aud_tempfile, oip->savefile, ret, !conf->oth.out_audio_only && pe->muxer_to_be_used != MUXER_DISABLED, g_auo_mes.get(AUO_ENCODE_AUDIO_FILE), conf->oth.out_audio_only, &move_tasks))
             ret |= AUO_RESULT_ERROR;
+    auo_move_files(move_tasks);
+    for (const auto& task : move_tasks) {
+        if (task.err != ERROR_SUCCESS) {
+            warning_move_file_failed(task.move_to.c_str(), task.name, task.err);
+        }
+    }
     return ret;
 }
 
@@ -1350,14 +1433,15 @@ void write_cached_lines(int log_level, const wchar_t *exename, LOG_CACHE *log_li
     const int log_level_idx = clamp(log_level, LOG_INFO, LOG_ERROR);
     const int additional_length = wcslen(exename) + wcslen(LOG_LEVEL_STR[log_level_idx]) + wcslen(MESSAGE_FORMAT) - wcslen(L"%s") * 3 + 1;
     for (int i = 0; i < log_line_cache->idx; i++) {
-        const int required_buffer_len = wcslen(log_line_cache->lines[i]) + additional_length;
+        const wchar_t *line = get_log_cache_line(log_line_cache, i);
+        const int required_buffer_len = wcslen(line) + additional_length;
         if (buffer_len < required_buffer_len) {
             if (buffer) free(buffer);
             buffer = (wchar_t *)malloc(required_buffer_len * sizeof(buffer[0]));
             buffer_len = required_buffer_len;
         }
         if (buffer) {
-            swprintf_s(buffer, buffer_len, MESSAGE_FORMAT, exename, LOG_LEVEL_STR[log_level_idx], log_line_cache->lines[i]);
+            swprintf_s(buffer, buffer_len, MESSAGE_FORMAT, exename, LOG_LEVEL_STR[log_level_idx], line);
             write_log_line(log_level, buffer);
         }
     }
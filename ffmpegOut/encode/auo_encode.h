@@ -45,6 +45,8 @@
 static const char * const PIPE_FN = "-";
 
 static const char * const VID_FILE_APPENDIX = "_vid";
+static const char * const DEFERRED_INTERMEDIATE_APPENDIX = "_intermediate.mkv"; //後でエンコードする場合の中間ファイル
+static const char * const DEFERRED_LOG_APPENDIX = "_deferred.log";                //後でエンコードする場合のエンコーダのログ
 
 static const char * const AUO_NAMED_PIPE_BASE = "\\\\.\\pipe\\Aviutl%08x_AuoAudioPipe%d";
 
@@ -55,6 +57,7 @@ void get_audio_pipe_name(char *pipename, size_t nSize, int audIdx);
 typedef AUO_RESULT (*encode_task) (CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *pe, const SYSTEM_DATA *sys_dat);
 
 bool video_is_last_pass(const PRM_ENC *pe);
+int get_audio_encode_timing(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *pe, const guiEx_settings *exstg); //音声の処理順を決定する
 
 BOOL check_if_exedit_is_used();
 BOOL check_output(CONF_GUIEX *conf, OUTPUT_INFO *oip, const PRM_ENC *pe, guiEx_settings *exstg);
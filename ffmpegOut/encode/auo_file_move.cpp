@@ -0,0 +1,284 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <shlwapi.h>
+#pragma comment(lib, "shlwapi.lib")
+#include "auo_util.h"
+#include "auo_frm.h"
+#include "auo_mes.h"
+#include "auo_version.h"
+#include "auo_file_move.h"
+
+static const DWORD FILE_MOVE_BUF_SIZE   = 8 * 1024 * 1024; //セクタサイズの倍数であること
+static const int   FILE_MOVE_BUF_COUNT  = 4;               //同時に発行する書き込みの数
+static const DWORD FILE_MOVE_ALIGN_MIN  = 4096;
+
+//パスのあるボリュームのGUIDパス (取得できない場合はボリュームのルート) を返す
+static BOOL get_volume_name(const char *path, char *volume_name, size_t nSize, DWORD *bytes_per_sector) {
+    char full_path[MAX_PATH_LEN] = { 0 };
+    char volume_path[MAX_PATH_LEN] = { 0 };
+    if (!GetFullPathNameA(path, _countof(full_path), full_path, nullptr))
+        return FALSE;
+    //ファイルはまだ存在しない場合があるので、フォルダで判定する
+    if (!PathIsDirectoryA(full_path))
+        PathRemoveFileSpecFixed(full_path);
+    if (!GetVolumePathNameA(full_path, volume_path, _countof(volume_path)))
+        return FALSE;
+    if (!GetVolumeNameForVolumeMountPointA(volume_path, volume_name, (DWORD)nSize)) {
+        //ネットワークドライブなど
+        strcpy_s(volume_name, nSize, volume_path);
+    }
+    if (bytes_per_sector) {
+        DWORD sectors_per_cluster = 0, free_clusters = 0, total_clusters = 0;
+        if (!GetDiskFreeSpaceA(volume_path, &sectors_per_cluster, bytes_per_sector, &free_clusters, &total_clusters))
+            *bytes_per_sector = 0;
+    }
+    return TRUE;
+}
+
+BOOL is_same_volume(const char *path1, const char *path2) {
+    char volume1[MAX_PATH_LEN] = { 0 };
+    char volume2[MAX_PATH_LEN] = { 0 };
+    if (!get_volume_name(path1, volume1, _countof(volume1), nullptr)
+        || !get_volume_name(path2, volume2, _countof(volume2), nullptr))
+        return FALSE;
+    return _stricmp(volume1, volume2) == 0;
+}
+
+static DWORD wait_overlapped(HANDLE h_file, OVERLAPPED *ov, DWORD *transferred) {
+    if (!GetOverlappedResult(h_file, ov, transferred, TRUE)) {
+        const DWORD err = GetLastError();
+        return (err == ERROR_HANDLE_EOF) ? ERROR_SUCCESS : err;
+    }
+    return ERROR_SUCCESS;
+}
+
+static void set_overlapped_offset(OVERLAPPED *ov, uint64_t offset) {
+    ov->Offset     = (DWORD)(offset & 0xffffffff);
+    ov->OffsetHigh = (DWORD)(offset >> 32);
+}
+
+//キャッシュを介さずにファイルをコピーする
+//読み込みは1つずつ完了を待つが、書き込みは完了を待たずに次の読み込みを行うので、
+//別のボリューム間では読み込みと書き込みが並行して進む
+static DWORD copy_file_unbuffered(const char *copy_from, const char *copy_to, volatile LONG64 *copied_bytes) {
+    DWORD sector_from = 0, sector_to = 0;
+    char volume[MAX_PATH_LEN];
+    get_volume_name(copy_from, volume, _countof(volume), &sector_from);
+    get_volume_name(copy_to,   volume, _countof(volume), &sector_to);
+    const DWORD align = std::max(FILE_MOVE_ALIGN_MIN, std::max(sector_from, sector_to));
+    if (FILE_MOVE_BUF_SIZE % align != 0)
+        return ERROR_NOT_SUPPORTED;
+
+    HANDLE h_src = CreateFileA(copy_from, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_FLAG_NO_BUFFERING | FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (h_src == INVALID_HANDLE_VALUE)
+        return GetLastError();
+    LARGE_INTEGER file_size = { 0 };
+    FILETIME ft_create = { 0 }, ft_access = { 0 }, ft_write = { 0 };
+    if (!GetFileSizeEx(h_src, &file_size) || !GetFileTime(h_src, &ft_create, &ft_access, &ft_write)) {
+        const DWORD err = GetLastError();
+        CloseHandle(h_src);
+        return err;
+    }
+    HANDLE h_dst = CreateFileA(copy_to, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_NO_BUFFERING | FILE_FLAG_OVERLAPPED, nullptr);
+    if (h_dst == INVALID_HANDLE_VALUE) {
+        const DWORD err = GetLastError();
+        CloseHandle(h_src);
+        return err;
+    }
+
+    DWORD err = ERROR_SUCCESS;
+    //事前に領域を確保 (ファイルサイズは変更しないので、0埋めは発生しない)
+    FILE_ALLOCATION_INFO alloc_info;
+    alloc_info.AllocationSize.QuadPart = (file_size.QuadPart + align - 1) / align * align;
+    if (!SetFileInformationByHandle(h_dst, FileAllocationInfo, &alloc_info, sizeof(alloc_info))) {
+        err = GetLastError();
+    }
+
+    uint8_t *buf[FILE_MOVE_BUF_COUNT] = { 0 };
+    OVERLAPPED ov_read = { 0 };
+    OVERLAPPED ov_write[FILE_MOVE_BUF_COUNT] = { 0 };
+    DWORD write_len[FILE_MOVE_BUF_COUNT] = { 0 };
+    bool write_pending[FILE_MOVE_BUF_COUNT] = { 0 };
+    ov_read.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    for (int i = 0; i < FILE_MOVE_BUF_COUNT; i++) {
+        ov_write[i].hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+        buf[i] = (uint8_t *)_aligned_malloc(FILE_MOVE_BUF_SIZE, align);
+        if (ov_write[i].hEvent == NULL || buf[i] == nullptr)
+            err = ERROR_NOT_ENOUGH_MEMORY;
+    }
+    if (ov_read.hEvent == NULL)
+        err = ERROR_NOT_ENOUGH_MEMORY;
+
+    auto finish_write = [&](int idx) {
+        DWORD written = 0;
+        const DWORD ret = wait_overlapped(h_dst, &ov_write[idx], &written);
+        write_pending[idx] = false;
+        if (ret == ERROR_SUCCESS && copied_bytes)
+            InterlockedAdd64(copied_bytes, write_len[idx]);
+        return ret;
+    };
+
+    uint64_t offset = 0;
+    for (int idx = 0; err == ERROR_SUCCESS && offset < (uint64_t)file_size.QuadPart; idx = (idx + 1) % FILE_MOVE_BUF_COUNT) {
+        //このバッファの前回の書き込みの完了を待つ
+        if (write_pending[idx] && (err = finish_write(idx)) != ERROR_SUCCESS)
+            break;
+        DWORD read_len = 0;
+        set_overlapped_offset(&ov_read, offset);
+        if (!ReadFile(h_src, buf[idx], FILE_MOVE_BUF_SIZE, nullptr, &ov_read) && GetLastError() != ERROR_IO_PENDING) {
+            err = GetLastError();
+            break;
+        }
+        if ((err = wait_overlapped(h_src, &ov_read, &read_len)) != ERROR_SUCCESS)
+            break;
+        if (read_len == 0) {
+            err = ERROR_READ_FAULT; //ファイルが途中で短くなった
+            break;
+        }
+        //書き込みはセクタサイズ単位で行い、最後にファイルサイズを設定する
+        const DWORD aligned_len = (read_len + align - 1) / align * align;
+        if (aligned_len > read_len)
+            memset(buf[idx] + read_len, 0, aligned_len - read_len);
+        set_overlapped_offset(&ov_write[idx], offset);
+        if (!WriteFile(h_dst, buf[idx], aligned_len, nullptr, &ov_write[idx]) && GetLastError() != ERROR_IO_PENDING) {
+            err = GetLastError();
+            break;
+        }
+        write_pending[idx] = true;
+        write_len[idx] = read_len;
+        offset += read_len;
+    }
+    for (int i = 0; i < FILE_MOVE_BUF_COUNT; i++) {
+        if (write_pending[i]) {
+            const DWORD ret = finish_write(i);
+            if (err == ERROR_SUCCESS)
+                err = ret;
+        }
+    }
+    if (err == ERROR_SUCCESS) {
+        FILE_END_OF_FILE_INFO eof_info;
+        eof_info.EndOfFile.QuadPart = file_size.QuadPart;
+        if (!SetFileInformationByHandle(h_dst, FileEndOfFileInfo, &eof_info, sizeof(eof_info))
+            || !SetFileTime(h_dst, &ft_create, &ft_access, &ft_write))
+            err = GetLastError();
+    }
+
+    if (ov_read.hEvent) CloseHandle(ov_read.hEvent);
+    for (int i = 0; i < FILE_MOVE_BUF_COUNT; i++) {
+        if (ov_write[i].hEvent) CloseHandle(ov_write[i].hEvent);
+        if (buf[i]) _aligned_free(buf[i]);
+    }
+    CloseHandle(h_dst);
+    CloseHandle(h_src);
+
+    //コピー後のファイルサイズを確認する
+    WIN32_FILE_ATTRIBUTE_DATA fd = { 0 };
+    if (err == ERROR_SUCCESS
+        && (!GetFileAttributesExA(copy_to, GetFileExInfoStandard, &fd)
+            || (((uint64_t)fd.nFileSizeHigh << 32) | fd.nFileSizeLow) != (uint64_t)file_size.QuadPart))
+        err = ERROR_WRITE_FAULT;
+    if (err != ERROR_SUCCESS)
+        DeleteFileA(copy_to);
+    return err;
+}
+
+static DWORD move_file_cross_volume(const char *move_from, const char *move_to, volatile LONG64 *copied_bytes) {
+    const DWORD attributes = GetFileAttributesA(move_from);
+    DWORD err = copy_file_unbuffered(move_from, move_to, copied_bytes);
+    if (err == ERROR_INVALID_PARAMETER || err == ERROR_NOT_SUPPORTED) {
+        //キャッシュを介さない読み書きに対応していない場合 (ネットワークドライブなど)
+        err = MoveFileExA(move_from, move_to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_COPY_ALLOWED) ? ERROR_SUCCESS : GetLastError();
+        if (err == ERROR_SUCCESS && copied_bytes) {
+            WIN32_FILE_ATTRIBUTE_DATA fd = { 0 };
+            if (GetFileAttributesExA(move_to, GetFileExInfoStandard, &fd))
+                InterlockedAdd64(copied_bytes, ((LONG64)fd.nFileSizeHigh << 32) | fd.nFileSizeLow);
+        }
+        return err;
+    }
+    if (err != ERROR_SUCCESS)
+        return err;
+    if (attributes != INVALID_FILE_ATTRIBUTES)
+        SetFileAttributesA(move_to, attributes);
+    return DeleteFileA(move_from) ? ERROR_SUCCESS : GetLastError();
+}
+
+DWORD auo_move_file(const char *move_from, const char *move_to, volatile LONG64 *copied_bytes) {
+    if (is_same_volume(move_from, move_to))
+        return MoveFileExA(move_from, move_to, MOVEFILE_REPLACE_EXISTING) ? ERROR_SUCCESS : GetLastError();
+    return move_file_cross_volume(move_from, move_to, copied_bytes);
+}
+
+void auo_move_files(std::vector<AUO_FILE_MOVE_TASK>& tasks) {
+    //同じボリューム内の移動はすぐに終わるので、ここで行う
+    std::vector<size_t> cross_volume;
+    uint64_t total_bytes = 0;
+    for (size_t i = 0; i < tasks.size(); i++) {
+        auto& task = tasks[i];
+        if (is_same_volume(task.move_from.c_str(), task.move_to.c_str())) {
+            task.err = MoveFileExA(task.move_from.c_str(), task.move_to.c_str(), MOVEFILE_REPLACE_EXISTING) ? ERROR_SUCCESS : GetLastError();
+        } else {
+            WIN32_FILE_ATTRIBUTE_DATA fd = { 0 };
+            if (GetFileAttributesExA(task.move_from.c_str(), GetFileExInfoStandard, &fd))
+                total_bytes += ((uint64_t)fd.nFileSizeHigh << 32) | fd.nFileSizeLow;
+            cross_volume.push_back(i);
+        }
+    }
+    if (cross_volume.empty())
+        return;
+
+    //別のボリュームへの移動は、ファイルごとにスレッドを立てて同時に行う
+    write_log_auo_line_fmt(LOG_INFO, g_auo_mes.get(AUO_ENCODE_FILE_MOVE_CROSS_VOLUME), (int)cross_volume.size(), total_bytes / (double)(1024 * 1024));
+    set_window_title(g_auo_mes.get(AUO_ENCODE_FILE_MOVE_TITLE), PROGRESSBAR_CONTINUOUS);
+    volatile LONG64 copied_bytes = 0;
+    std::atomic<int> remaining((int)cross_volume.size());
+    std::vector<std::thread> threads;
+    for (const auto idx : cross_volume) {
+        threads.push_back(std::thread([&tasks, &copied_bytes, &remaining, idx]() {
+            auto& task = tasks[idx];
+            task.err = move_file_cross_volume(task.move_from.c_str(), task.move_to.c_str(), &copied_bytes);
+            remaining--;
+        }));
+    }
+    //ログウィンドウはこのスレッドからのみ操作する
+    while (remaining > 0) {
+        Sleep(LOG_UPDATE_INTERVAL);
+        if (total_bytes > 0)
+            set_log_progress(std::min(1.0, copied_bytes / (double)total_bytes));
+        log_process_events();
+    }
+    for (auto& th : threads)
+        th.join();
+    set_window_title(AUO_FULL_NAME_W, PROGRESSBAR_DISABLED);
+}
@@ -0,0 +1,58 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#ifndef _AUO_FILE_MOVE_H_
+#define _AUO_FILE_MOVE_H_
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <string>
+#include <vector>
+#include "auo.h"
+
+//ファイルの移動
+//  - 同じボリューム内の移動はMoveFileで行う
+//  - 別のボリュームへの移動は、キャッシュを介さない非同期I/Oでコピーしてから元のファイルを削除する
+//    コピー先は事前に領域を確保し、コピー後にファイルサイズを確認する
+typedef struct AUO_FILE_MOVE_TASK {
+    std::string move_from;
+    std::string move_to;
+    const wchar_t *name; //ファイルの種類の名前 (ログ表示用)
+    DWORD err;           //結果 (ERROR_SUCCESSなら成功)
+} AUO_FILE_MOVE_TASK;
+
+//2つのパスが同じボリューム上にあるか
+BOOL is_same_volume(const char *path1, const char *path2);
+//ファイルを移動し、結果をエラーコードで返す
+//copied_bytesが指定されていれば、コピー済みのバイト数を随時加算する
+DWORD auo_move_file(const char *move_from, const char *move_to, volatile LONG64 *copied_bytes = nullptr);
+//複数のファイルを同時に移動する
+//別のボリュームへの移動がある場合は、ログウィンドウに進捗を表示しながら待機する
+void auo_move_files(std::vector<AUO_FILE_MOVE_TASK>& tasks);
+
+#endif //_AUO_FILE_MOVE_H_
@@ -57,7 +57,7 @@ static void show_mux_info(const MUXER_SETTINGS *mux_stg, BOOL vidmux, BOOL audmu
 
     std::string ver_str = "";
     int version[4] = { 0 };
-    if (str_has_char(mux_stg->ver_cmd) && 0 == get_exe_version_from_cmd(mux_stg->fullpath, mux_stg->ver_cmd, version)) {
+    if (str_has_char(mux_stg->ver_cmd) && 0 == get_exe_version_from_cmd_cached(mux_stg->fullpath, mux_stg->ver_cmd, version)) {
         ver_str = " (" + ver_string(version) + ")";
     }
 
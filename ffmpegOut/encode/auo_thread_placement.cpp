@@ -0,0 +1,198 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include "auo_util.h"
+#include "auo_frm.h"
+#include "auo_mes.h"
+#include "cpu_info.h"
+#include "rgy_thread_affinity.h"
+#include "auo_thread_placement.h"
+
+static const char *THREAD_PLACEMENT_AUTO = "auto";
+
+static int count_bits(uint64_t mask) {
+    int count = 0;
+    for (; mask; mask &= mask - 1)
+        count++;
+    return count;
+}
+
+//autoの場合の配置
+static uint64_t get_thread_placement_auto(int type, const cpu_info_t *cpu_info) {
+    const bool hybrid = cpu_info->maskCoreP && cpu_info->maskCoreE;
+    const uint64_t mask_perf = (hybrid) ? cpu_info->maskCoreP : cpu_info->maskSystem;
+    //フレーム取得・変換・書き出しは互いにデータを受け渡すので、1つのL3キャッシュのグループ(CCD)にまとめる
+    uint64_t mask_feed = mask_perf;
+    if (cpu_info->cache_count[(int)RGYCacheLevel::L3 - 1] >= 2) {
+        for (int i = 0; i < cpu_info->cache_count[(int)RGYCacheLevel::L3 - 1]; i++) {
+            const uint64_t mask_l3 = get_mask(cpu_info, RGYUnitType::Cache, (int)RGYCacheLevel::L3, i) & mask_perf;
+            if (mask_l3) {
+                mask_feed = mask_l3;
+                break;
+            }
+        }
+    }
+    switch (type) {
+    case THREAD_PLACEMENT_FEED:
+        return mask_feed;
+    case THREAD_PLACEMENT_VIDENC: {
+        //フレーム取得側を除いても3/4以上のコアが残る場合のみ、残りのコアを使う
+        const uint64_t mask_remain = mask_perf & ~mask_feed;
+        return (count_bits(mask_remain) * 4 >= count_bits(mask_perf) * 3) ? mask_remain : mask_perf;
+    }
+    case THREAD_PLACEMENT_AUDENC:
+    case THREAD_PLACEMENT_AUDIO:
+        return (hybrid) ? cpu_info->maskCoreE : cpu_info->maskSystem;
+    default:
+        return cpu_info->maskSystem;
+    }
+}
+
+//"mode#id:id:..." または "custom#mask" を解釈する
+static uint64_t parse_thread_placement(int type, const char *str, const cpu_info_t *cpu_info) {
+    char buf[THREAD_PLACEMENT_STR_LEN] = { 0 };
+    strcpy_s(buf, str);
+    _strlwr_s(buf);
+    char *sep = strchr(buf, '#');
+    if (sep)
+        *sep++ = '\0';
+    if (0 == strcmp(buf, THREAD_PLACEMENT_AUTO))
+        return get_thread_placement_auto(type, cpu_info);
+    RGYThreadAffinity affinity(rgy_str_to_thread_affnity_mode(buf));
+    if (affinity.mode == RGYThreadAffinityMode::END)
+        return cpu_info->maskSystem;
+    if (sep && *sep) {
+        if (affinity.mode == RGYThreadAffinityMode::CUSTOM) {
+            affinity.custom = strtoull(sep, nullptr, 0);
+        } else {
+            affinity.custom = 0;
+            char *ctx = nullptr;
+            for (char *tok = strtok_s(sep, ":", &ctx); tok; tok = strtok_s(nullptr, ":", &ctx)) {
+                const int id = atoi(tok);
+                if (0 <= id && id < 64)
+                    affinity.custom |= 1llu << id;
+            }
+        }
+    }
+    return affinity.getMask();
+}
+
+DWORD_PTR get_thread_placement_mask(int type, const LOCAL_SETTINGS *s_local) {
+    if (type < 0 || THREAD_PLACEMENT_COUNT <= type)
+        return 0;
+    const cpu_info_t cpu_info = get_cpu_info();
+    const uint64_t mask = parse_thread_placement(type, s_local->thread_placement[type], &cpu_info) & cpu_info.maskSystem;
+    //プロセスに許可されたコアに限定する (32bit版では先頭の32コアのみ)
+    DWORD_PTR mask_process = 0, mask_system = 0;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &mask_process, &mask_system))
+        return 0;
+    const DWORD_PTR mask_target = (DWORD_PTR)mask & mask_process;
+    //全コアなら変更しない
+    return (mask_target == mask_process) ? 0 : mask_target;
+}
+
+DWORD_PTR set_thread_placement(HANDLE thread, DWORD_PTR mask) {
+    return (thread && mask) ? SetThreadAffinityMask(thread, mask) : 0;
+}
+
+void set_process_placement(HANDLE process, DWORD_PTR mask) {
+    if (process && mask)
+        SetProcessAffinityMask(process, mask);
+}
+
+void write_log_thread_placement(const LOCAL_SETTINGS *s_local) {
+    wchar_t mask_str[THREAD_PLACEMENT_COUNT][32] = { 0 };
+    bool changed = false;
+    for (int i = 0; i < THREAD_PLACEMENT_COUNT; i++) {
+        const DWORD_PTR mask = get_thread_placement_mask(i, s_local);
+        if (mask) {
+            swprintf_s(mask_str[i], L"0x%llx", (unsigned long long)mask);
+            changed = true;
+        } else {
+            wcscpy_s(mask_str[i], L"all");
+        }
+    }
+    if (changed)
+        write_log_auo_line_fmt(LOG_MORE, g_auo_mes.get(AUO_VIDEO_THREAD_PLACEMENT), mask_str[0], mask_str[1], mask_str[2], mask_str[3]);
+}
+
+int get_thread_placement_numa_node(const LOCAL_SETTINGS *s_local) {
+    const cpu_info_t cpu_info = get_cpu_info();
+    if (cpu_info.node_count < 2)
+        return -1;
+    uint64_t mask = get_thread_placement_mask(THREAD_PLACEMENT_FEED, s_local);
+    if (!mask) {
+        //配置を変更しない場合は、いま実行しているプロセッサのノードを使う
+        mask = 1llu << GetCurrentProcessorNumber();
+    }
+    //フレーム取得側のコアを最も多く含むノード
+    int node_idx = -1, max_count = 0;
+    for (int i = 0; i < cpu_info.node_count; i++) {
+        const int count = count_bits(cpu_info.nodes[i].mask & mask);
+        if (count > max_count) {
+            max_count = count;
+            node_idx = i;
+        }
+    }
+    if (node_idx < 0)
+        return -1;
+    //cpu_infoのノードの並びとNUMAノード番号は一致するとは限らないので、プロセッサから番号を取得する
+    const uint64_t mask_node = cpu_info.nodes[node_idx].mask & mask;
+    UCHAR processor = 0;
+    while (!(mask_node & (1llu << processor)))
+        processor++;
+    UCHAR node_number = 0;
+    return (GetNumaProcessorNode(processor, &node_number)) ? (int)node_number : -1;
+}
+
+void *numa_malloc(size_t size, size_t align, int node) {
+    if (node < 0)
+        return _mm_malloc(size, align);
+    //VirtualAllocの領域はページ境界に揃っているので、alignは満たされる
+    BYTE *ptr = (BYTE *)VirtualAllocExNuma(GetCurrentProcess(), nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, (DWORD)node);
+    if (ptr) {
+        //各ページに書き込み、確保したノード上に物理ページを割り当てさせる
+        SYSTEM_INFO si = { 0 };
+        GetSystemInfo(&si);
+        for (size_t i = 0; i < size; i += si.dwPageSize)
+            ptr[i] = 0;
+    }
+    return ptr;
+}
+
+void numa_free(void *ptr, int node) {
+    if (!ptr)
+        return;
+    if (node < 0)
+        _mm_free(ptr);
+    else
+        VirtualFree(ptr, 0, MEM_RELEASE);
+}
@@ -0,0 +1,63 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#ifndef _AUO_THREAD_PLACEMENT_H_
+#define _AUO_THREAD_PLACEMENT_H_
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include "auo_settings.h"
+
+//スレッド・プロセスのCPUへの配置
+//  iniの thread_affinity_xxx で種類ごとに指定する
+//    auto              ... CPUの構成から自動で決定する (デフォルト)
+//    all               ... OSに任せる
+//    pcore, ecore, logical, physical, cachel2, cachel3 [#<id>:<id>:...] ... 指定したコア・キャッシュのグループに配置する
+//    custom#<mask>     ... アフィニティマスクを直接指定する
+//  autoの場合
+//    フレーム取得・変換・書き出し ... Pコアを含む最初のL3キャッシュのグループ (L3が1つならPコア)
+//    映像エンコーダ               ... Pコア (残りのコアが十分あれば、フレーム取得側のL3のグループを除く)
+//    音声エンコーダ・音声処理     ... Eコア
+
+//指定した種類のアフィニティマスクを返す (変更しない場合は0)
+DWORD_PTR get_thread_placement_mask(int type, const LOCAL_SETTINGS *s_local);
+//スレッドのアフィニティを設定し、変更前のマスクを返す (変更しなかった場合は0)
+DWORD_PTR set_thread_placement(HANDLE thread, DWORD_PTR mask);
+//プロセスのアフィニティを設定する
+void set_process_placement(HANDLE process, DWORD_PTR mask);
+//配置をログに表示する
+void write_log_thread_placement(const LOCAL_SETTINGS *s_local);
+
+//フレーム取得・変換・書き出しのスレッドが置かれるNUMAノード (NUMA構成でなければ-1)
+int get_thread_placement_numa_node(const LOCAL_SETTINGS *s_local);
+//指定したNUMAノードにメモリを確保し、first touchしておく (node < 0 なら_mm_mallocで確保する)
+void *numa_malloc(size_t size, size_t align, int node);
+//numa_mallocで確保したメモリを開放する (nodeは確保時と同じ値を指定する)
+void numa_free(void *ptr, int node);
+
+#endif //_AUO_THREAD_PLACEMENT_H_
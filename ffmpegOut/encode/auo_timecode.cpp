@@ -0,0 +1,68 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <algorithm>
+#include <shlwapi.h>
+#pragma comment(lib, "shlwapi.lib")
+
+#include "auo_util.h"
+#include "auo_encode.h"
+#include "auo_video.h"
+#include "auo_chapter.h"
+#include "auo_timecode.h"
+
+std::vector<int> get_keyframe_list(const CONF_GUIEX *conf, const OUTPUT_INFO *oip, const PRM_ENC *pe, const SYSTEM_DATA *sys_dat) {
+    std::vector<int> keyframes;
+    //afs使用時はドロップするフレームがエンコード中に決まるので、出力時のフレーム番号がわからない
+    if (conf->vid.afs)
+        return keyframes;
+    const int offset = pe->delay_cut_additional_vframe;
+    //先頭はもともとキーフレームなので除く
+    for (int i = 1; i < oip->n; i++)
+        if (oip->func_get_flag(i) & OUTPUT_INFO_FRAME_FLAG_KEYFRAME)
+            keyframes.push_back(i + offset);
+
+    char chap_file[MAX_PATH_LEN];
+    apply_appendix(chap_file, _countof(chap_file), oip->savefile, pe->append.chap);
+    if (PathFileExists(chap_file)) {
+        chapter_file chapter;
+        if (AUO_CHAP_ERR_NONE == chapter.read_file(chap_file, CODE_PAGE_UNSET, get_duration(conf, sys_dat, pe, oip))) {
+            for (const auto& chap : chapter.chapters) {
+                //チャプターの時刻に最も近いフレーム
+                const int frame = (int)(((int64_t)chap->get_ms() * oip->rate + (int64_t)oip->scale * 500) / ((int64_t)oip->scale * 1000));
+                if (0 < frame && frame < oip->n)
+                    keyframes.push_back(frame + offset);
+            }
+        }
+    }
+    std::sort(keyframes.begin(), keyframes.end());
+    keyframes.erase(std::unique(keyframes.begin(), keyframes.end()), keyframes.end());
+    return keyframes;
+}
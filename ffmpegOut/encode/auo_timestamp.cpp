@@ -0,0 +1,103 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#include "auo_timestamp.h"
+
+int format_fixed6(char *buf, uint64_t num, uint64_t den, bool round_down) {
+    uint64_t ipart = num / den;
+    //小数部は1e-6単位で切り捨て、または四捨五入する
+    uint64_t frac = ((num % den) * 1000000 + ((round_down) ? 0 : den / 2)) / den;
+    if (frac >= 1000000) {
+        ipart++;
+        frac -= 1000000;
+    }
+    char tmp[24];
+    int len = 0;
+    do {
+        tmp[len++] = (char)('0' + ipart % 10);
+        ipart /= 10;
+    } while (ipart);
+    int n = 0;
+    while (len)
+        buf[n++] = tmp[--len];
+    buf[n++] = '.';
+    for (int i = 5; i >= 0; i--, frac /= 10)
+        buf[n + i] = (char)('0' + frac % 10);
+    n += 6;
+    buf[n] = '\0';
+    return n;
+}
+
+std::vector<int64_t> build_frame_pts(const int *jitter, int frame_n, int additional_vframe, int additional_multi) {
+    std::vector<int64_t> pts;
+    pts.reserve(additional_vframe + frame_n);
+    for (int i = 0; i < additional_vframe; i++)
+        pts.push_back((int64_t)i * additional_multi);
+    const int64_t time_additional_frame = (int64_t)additional_vframe * additional_multi;
+    if (jitter) {
+        for (int i = 0; i < frame_n; i++)
+            if (jitter[i] != DROP_FRAME_FLAG)
+                pts.push_back((int64_t)i * 4 + jitter[i] + time_additional_frame);
+    } else {
+        for (int i = 0; i < frame_n; i++)
+            pts.push_back(i + time_additional_frame);
+    }
+    return pts;
+}
+
+std::string build_timecode_v2(const std::vector<int64_t>& pts, int rate, int scale, int tick_div) {
+    //1行あたり32byteあれば足りるので、先に確保してまとめて書き込む
+    std::string tc = "# timecode format v2\r\n";
+    const size_t header_len = tc.length();
+    tc.resize(header_len + pts.size() * 32);
+    char *ptr = &tc[header_len];
+    const uint64_t num_mul = (uint64_t)scale * 1000;
+    const uint64_t den = (uint64_t)rate * tick_div;
+    for (const auto t : pts) {
+        ptr += format_fixed6(ptr, (uint64_t)t * num_mul, den, false);
+        *ptr++ = '\r';
+        *ptr++ = '\n';
+    }
+    tc.resize(ptr - tc.data());
+    return tc;
+}
+
+std::string build_keyframe_times(const std::vector<int>& keyframes, int rate, int scale, size_t max_len, int *count) {
+    std::string times;
+    *count = 0;
+    char buf[32];
+    for (const auto frame : keyframes) {
+        const int len = format_fixed6(buf, (uint64_t)frame * scale, rate, true);
+        if (times.length() + (times.empty() ? 0 : 1) + len > max_len)
+            break;
+        if (!times.empty())
+            times += ',';
+        times.append(buf, len);
+        (*count)++;
+    }
+    return times;
+}
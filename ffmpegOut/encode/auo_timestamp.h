@@ -0,0 +1,60 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#ifndef _AUO_TIMESTAMP_H_
+#define _AUO_TIMESTAMP_H_
+
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//afsでドロップするフレームのjitterに設定する値
+static const int DROP_FRAME_FLAG = INT_MAX;
+
+//タイムスタンプの単位は scale / (rate * tick_div) 秒
+//  afs使用時は tick_div = 4 (4倍精度)、それ以外は tick_div = 1 でフレーム番号と同じになる
+
+//num / den を小数点以下6桁にして書き込み、書き込んだ文字数を返す ("%.6lf" と同じ形式、bufは32byte以上)
+//  round_down ... trueなら切り捨て、falseなら四捨五入する
+int format_fixed6(char *buf, uint64_t num, uint64_t den, bool round_down);
+
+//出力する各フレームのタイムスタンプを作成する
+//  jitter             ... afsのjitter (afsを使用しない場合はnullptr)、DROP_FRAME_FLAGのフレームは出力しない
+//  additional_vframe  ... 音声ディレイカットのために先頭に追加したフレーム数
+//  additional_multi   ... 追加したフレームの間隔
+std::vector<int64_t> build_frame_pts(const int *jitter, int frame_n, int additional_vframe, int additional_multi);
+
+//v2タイムコード (ミリ秒) を作成する
+std::string build_timecode_v2(const std::vector<int64_t>& pts, int rate, int scale, int tick_div);
+
+//ffmpegの -force_key_frames 用に、キーフレームの時刻 (秒) を "t0,t1,..." の形で作成する
+//ffmpegは時刻以降の最初のフレームをキーフレームにするので、フレームの時刻を超えないよう切り捨てる
+//max_len を超える場合はそこまでで打ち切り、count に含めた数を返す
+std::string build_keyframe_times(const std::vector<int>& keyframes, int rate, int scale, size_t max_len, int *count);
+
+#endif //_AUO_TIMESTAMP_H_
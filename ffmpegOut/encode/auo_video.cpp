@@ -38,9 +38,11 @@
 #pragma comment(lib, "shlwapi.lib")
 #include <vector>
 #include <set>
+#include <algorithm>
 
 #include "output.h"
 #include "vphelp_client.h"
+#include "auo_thread_placement.h" //afs_client.hで使用
 
 #pragma warning( push )
 #pragma warning( disable: 4127 )
@@ -57,12 +59,15 @@
 #include "auo_system.h"
 #include "auo_version.h"
 #include "auo_chapter.h"
+#include "auo_timecode.h"
 #include "auo_mes.h"
 #include "auo_options.h"
 
 #include "auo_encode.h"
 #include "auo_video.h"
+#include "auo_audio.h"
 #include "auo_audio_parallel.h"
+#include "auo_deferred.h"
 #include "cpu_info.h"
 #include "rgy_thread_affinity.h"
 
@@ -80,10 +85,81 @@ static const char * specify_input_csp(int output_csp) {
     return specify_csp[output_csp];
 }
 
-int get_aviutl_color_format(int use_highbit, int output_csp) {
+//拡張編集からアルファ付きのRGBAを受け取る出力かどうか
+static bool csp_from_exedit_rgba(int output_csp) {
+    switch (output_csp) {
+        case OUT_CSP_RGBA:
+        case OUT_CSP_YUVA420:
+        case OUT_CSP_YUVA420_10:
+        case OUT_CSP_YUVA420_16:
+        case OUT_CSP_YUVA444:
+        case OUT_CSP_YUVA444_10:
+        case OUT_CSP_YUVA444_16:
+            return true;
+        default:
+            return false;
+    }
+}
+
+//Aviutl2では拡張編集のファイルマッピングが使えないので、アルファなしの出力に置き換える
+static int csp_remove_alpha(int output_csp) {
+    switch (output_csp) {
+        case OUT_CSP_RGBA:       return OUT_CSP_RGB;
+        case OUT_CSP_YUVA420:    return OUT_CSP_NV12;
+        case OUT_CSP_YUVA420_10:
+        case OUT_CSP_YUVA420_16: return OUT_CSP_P010;
+        case OUT_CSP_YUVA444:    return OUT_CSP_YUV444;
+        case OUT_CSP_YUVA444_10:
+        case OUT_CSP_YUVA444_16: return OUT_CSP_YUV444_16;
+        default:                 return output_csp;
+    }
+}
+
+//変換関数に渡すビット深度
+static int get_output_bit_depth(const CONF_GUIEX *conf) {
+    switch (conf->enc.output_csp) {
+        case OUT_CSP_YUVA420_10:
+        case OUT_CSP_YUVA444_10:
+        case OUT_CSP_P210:
+        case OUT_CSP_Y210:
+        case OUT_CSP_YUV420_10:
+            return 10;
+        case OUT_CSP_P012:
+        case OUT_CSP_YUV444_12:
+            return 12;
+        case OUT_CSP_YUV420_16:
+            return 16;
+        default:
+            return (conf->enc.use_highbit_depth) ? 16 : 8;
+    }
+}
+
+//8bit出力時にYC48からディザをかけて変換するかどうか (DITHER_xxx)
+//Aviutl2ではYC48を受け取れないので使用しない
+static int get_output_dither(const SYSTEM_DATA *sys_dat, const CONF_GUIEX *conf) {
+    if (conf->enc.use_highbit_depth || is_aviutl2())
+        return DITHER_NONE;
+    switch (conf->enc.output_csp) {
+        case OUT_CSP_NV12:
+        case OUT_CSP_YUV444:
+            break;
+        default:
+            return DITHER_NONE;
+    }
+    const int dither = sys_dat->exstg->s_local.output_dither;
+    return (dither == DITHER_ORDERED || dither == DITHER_ERROR_DIFFUSION) ? dither : DITHER_NONE;
+}
+
+int get_aviutl_color_format(int use_highbit, int output_csp, int dither) {
     //Aviutlからの入力に使用するフォーマット
     switch (output_csp) {
         case OUT_CSP_P010:
+        case OUT_CSP_P012:
+        case OUT_CSP_P210:
+        case OUT_CSP_Y210:
+        case OUT_CSP_YUV420_10:
+        case OUT_CSP_YUV420_16:
+        case OUT_CSP_YUV444_12: //RGBからの変換はないので、Aviutl2ではYUY2から変換する
             return (is_aviutl2()) ? CF_YUY2 : CF_YC48;
         case OUT_CSP_YUV444:
         case OUT_CSP_YUV444_16:
@@ -91,8 +167,17 @@ int get_aviutl_color_format(int use_highbit, int output_csp) {
         case OUT_CSP_RGB:
             return CF_RGB;
         case OUT_CSP_RGBA:
+        case OUT_CSP_YUVA420:
+        case OUT_CSP_YUVA420_10:
+        case OUT_CSP_YUVA420_16:
+        case OUT_CSP_YUVA444:
+        case OUT_CSP_YUVA444_10:
+        case OUT_CSP_YUVA444_16:
             return (is_aviutl2()) ? CF_RGB : CF_RGBA;
         case OUT_CSP_NV12:
+            if (dither != DITHER_NONE)
+                return CF_YC48;
+            //下へフォールスルー
         case OUT_CSP_NV16:
         case OUT_CSP_YUY2:
         default:
@@ -104,7 +189,7 @@ static int calc_input_frame_size(int width, int height, int color_format, int& b
     width = (color_format == CF_RGB) ? (width+3) & ~3 : (color_format == CF_RGBA) ? width : (width+1) & ~1;
     //widthが割り切れない場合、多めにアクセスが発生するので、そのぶんを確保しておく
     const DWORD pixel_size = COLORFORMATS[color_format].size;
-    const DWORD simd_check = get_availableSIMD();
+    const DWORD simd_check = (DWORD)get_availableSIMD();
     const DWORD align_size = (simd_check & AUO_SIMD_SSE2) ? ((simd_check & AUO_SIMD_AVX2) ? 64 : 32) : 1;
 #define ALIGN_NEXT(i, align) (((i) + (align-1)) & (~(align-1))) //alignは2の累乗(1,2,4,8,16,32...)
     buf_size = ALIGN_NEXT(width * height * pixel_size + (ALIGN_NEXT(width, align_size / pixel_size) - width) * 2 * pixel_size, align_size);
@@ -117,11 +202,13 @@ BOOL setup_afsvideo(const OUTPUT_INFO *oip, const SYSTEM_DATA *sys_dat, CONF_GUI
     if (pe->afs_init || pe->video_out_type == VIDEO_OUTPUT_DISABLED || !conf->vid.afs)
         return TRUE;
 
-    const int color_format = get_aviutl_color_format(conf->enc.use_highbit_depth ? 16 : 8, conf->enc.output_csp);
+    const int color_format = get_aviutl_color_format(conf->enc.use_highbit_depth ? 16 : 8, conf->enc.output_csp, get_output_dither(sys_dat, conf));
     int buf_size;
     const int frame_size = calc_input_frame_size(oip->w, oip->h, color_format, buf_size);
     //Aviutl(自動フィールドシフト)からの映像入力
-    if (afs_vbuf_setup((OUTPUT_INFO *)oip, conf->vid.afs, frame_size, buf_size, COLORFORMATS[color_format].FOURCC)) {
+    //afsの先読みバッファは、フレーム取得側のスレッドのNUMAノードに確保する
+    const int numa_node = get_thread_placement_numa_node(&sys_dat->exstg->s_local);
+    if (afs_vbuf_setup((OUTPUT_INFO *)oip, conf->vid.afs, frame_size, buf_size, COLORFORMATS[color_format].FOURCC, numa_node)) {
         pe->afs_init = TRUE;
         return TRUE;
     } else if (conf->vid.afs && sys_dat->exstg->s_local.auto_afs_disable) {
@@ -146,14 +233,17 @@ void close_afsvideo(PRM_ENC *pe) {
     pe->afs_init = FALSE;
 }
 
-static AUO_RESULT tcfile_out(int *jitter, int frame_n, double fps, BOOL afs, const PRM_ENC *pe) {
+static AUO_RESULT tcfile_out(int *jitter, int frame_n, int rate, int scale, BOOL afs, const PRM_ENC *pe) {
     AUO_RESULT ret = AUO_RESULT_SUCCESS;
     char auotcfile[MAX_PATH_LEN];
     FILE *tcfile = NULL;
 
-    if (afs)
-        fps *= 4; //afsなら4倍精度
-    const double tm_multi = 1000.0 / fps;
+    //オーディオディレイカットのために映像フレームを追加したらその分を考慮したタイムコードを出力する
+    //afsなら4倍精度で、追加したフレームは24fpsと30fpsどちらに近いかを考慮する
+    const int tick_div = (afs) ? 4 : 1;
+    const int multi_for_additional_vframe = (afs) ? 4 + !!fps_after_afs_is_24fps(frame_n, pe) : 1;
+    const auto pts = build_frame_pts((afs) ? jitter : nullptr, frame_n, pe->delay_cut_additional_vframe, multi_for_additional_vframe);
+    const std::string tc = build_timecode_v2(pts, rate, scale, tick_div);
 
     //ファイル名作成
     apply_appendix(auotcfile, _countof(auotcfile), pe->temp_filename, pe->append.tc);
@@ -161,31 +251,35 @@ static AUO_RESULT tcfile_out(int *jitter, int frame_n, double fps, BOOL afs, con
     if (NULL != fopen_s(&tcfile, auotcfile, "wb")) {
         ret |= AUO_RESULT_ERROR; warning_auo_tcfile_failed();
     } else {
-        fprintf(tcfile, "# timecode format v2\r\n");
-        if (afs) {
-            int time_additional_frame = 0;
-            //オーディオディレイカットのために映像フレームを追加したらその分を考慮したタイムコードを出力する
-            if (pe->delay_cut_additional_vframe) {
-                //24fpsと30fpsどちらに近いかを考慮する
-                const int multi_for_additional_vframe = 4 + !!fps_after_afs_is_24fps(frame_n, pe);
-                for (int i = 0; i < pe->delay_cut_additional_vframe; i++)
-                    fprintf(tcfile, "%.6lf\r\n", i * multi_for_additional_vframe * tm_multi);
-
-                time_additional_frame = pe->delay_cut_additional_vframe * multi_for_additional_vframe;
-            }
-            for (int i = 0; i < frame_n; i++)
-                if (jitter[i] != DROP_FRAME_FLAG)
-                    fprintf(tcfile, "%.6lf\r\n", (i * 4 + jitter[i] + time_additional_frame) * tm_multi);
-        } else {
-            frame_n += pe->delay_cut_additional_vframe;
-            for (int i = 0; i < frame_n; i++)
-                fprintf(tcfile, "%.6lf\r\n", i * tm_multi);
+        if (fwrite(tc.data(), 1, tc.length(), tcfile) != tc.length()) {
+            ret |= AUO_RESULT_ERROR; warning_auo_tcfile_failed();
         }
         fclose(tcfile);
     }
     return ret;
 }
 
+//%{keyframes} をキーフレームの時刻のリストに置換する (-force_key_frames %{keyframes} のように使用する)
+static void replace_keyframes(char *cmd, size_t nSize, const CONF_GUIEX *conf, const OUTPUT_INFO *oip, const PRM_ENC *pe, const SYSTEM_DATA *sys_dat) {
+    static const char *KEYFRAMES_KEY = "%{keyframes}";
+    if (strstr(cmd, KEYFRAMES_KEY) == nullptr)
+        return;
+    if (conf->vid.afs)
+        warning_keyframes_afs();
+    const auto keyframes = get_keyframe_list(conf, oip, pe, sys_dat);
+    //コマンドラインに収まる分だけ設定する
+    const size_t max_len = nSize - strlen(cmd) - 1 + strlen(KEYFRAMES_KEY);
+    int count = 0;
+    std::string times = build_keyframe_times(keyframes, oip->rate, oip->scale, max_len, &count);
+    if (count < (int)keyframes.size())
+        warning_keyframes_truncated(count, (int)keyframes.size());
+    if (times.empty())
+        times = "0"; //先頭はもともとキーフレームなので、空の引数にしないよう先頭を指定する
+    else
+        write_log_auo_line_fmt(LOG_INFO, g_auo_mes.get(AUO_VIDEO_KEYFRAMES), count);
+    replace(cmd, nSize, KEYFRAMES_KEY, times.c_str());
+}
+
 //cmdexのうち、guiから発行されるオプションとの衝突をチェックして、読み取られなかったコマンドを追加する
 static void append_cmdex(char *cmd, size_t nSize, const char *cmdex) {
     const size_t cmd_len = strlen(cmd);
@@ -196,6 +290,66 @@ static void append_cmdex(char *cmd, size_t nSize, const char *cmdex) {
     replace_cmd_CRLF_to_Space(cmd + cmd_len + 1, nSize - cmd_len - 1);
 }
 
+//内蔵音声エンコーダのコーデック指定を追加する
+static void append_internal_audio_codec(char *cmd, size_t nSize, const CONF_GUIEX *conf, const SYSTEM_DATA *sys_dat) {
+    const CONF_AUDIO_BASE *cnf_aud = &conf->aud.in;
+    const AUDIO_SETTINGS *aud_stg = &sys_dat->exstg->s_aud_int[cnf_aud->encoder];
+    if (sys_dat->exstg->is_faw(aud_stg)) {
+        sprintf_s(cmd + strlen(cmd), nSize - strlen(cmd), " -c:a copy");
+    } else if (strcmp(aud_stg->codec, "custom") != 0) { // custom 選択時は特に何も指定しない
+        sprintf_s(cmd + strlen(cmd), nSize - strlen(cmd), " -c:a %s", aud_stg->codec);
+        if (aud_stg->mode[cnf_aud->enc_mode].bitrate) {
+            sprintf_s(cmd + strlen(cmd), nSize - strlen(cmd), " -b:a %dk", cnf_aud->bitrate);
+        }
+    }
+}
+
+static void get_deferred_intermediate_filename(char *filename, size_t nSize, const PRM_ENC *pe) {
+    apply_appendix(filename, nSize, pe->temp_filename, DEFERRED_INTERMEDIATE_APPENDIX);
+}
+
+//パイプに渡す前に縮小する場合の出力解像度を求める (縮小しない場合はFALSEを返し、元の解像度を入れる)
+//幅・高さの片方が0なら、もう一方から縦横比を保って決める
+static BOOL get_resize_target(int *dst_w, int *dst_h, const CONF_GUIEX *conf, const OUTPUT_INFO *oip) {
+    *dst_w = oip->w;
+    *dst_h = oip->h;
+    if (conf->vid.resize_algo == VIDEO_RESIZE_NONE || (conf->vid.resize_w <= 0 && conf->vid.resize_h <= 0))
+        return FALSE;
+    int w = conf->vid.resize_w;
+    int h = conf->vid.resize_h;
+    if (w <= 0) w = (int)((double)oip->w * h / oip->h + 0.5);
+    if (h <= 0) h = (int)((double)oip->h * w / oip->w + 0.5);
+    //色差の間引きに合わせて丸める
+    int mul_w = 2, mul_h = 2;
+    switch (conf->enc.output_csp) {
+        case OUT_CSP_YUV444:
+        case OUT_CSP_YUV444_12:
+        case OUT_CSP_YUV444_16:
+        case OUT_CSP_RGB:
+        case OUT_CSP_RGBA:
+        case OUT_CSP_YUVA444:
+        case OUT_CSP_YUVA444_10:
+        case OUT_CSP_YUVA444_16:
+            mul_w = 1; mul_h = 1; break;
+        case OUT_CSP_NV16:
+        case OUT_CSP_P210:
+        case OUT_CSP_YUY2:
+        case OUT_CSP_Y210:
+            mul_h = 1; break;
+        default:
+            break;
+    }
+    if (conf->enc.interlaced) mul_h *= 2;
+    w = clamp((w + mul_w / 2) / mul_w * mul_w, mul_w, oip->w);
+    h = clamp((h + mul_h / 2) / mul_h * mul_h, mul_h, oip->h);
+    //拡大はしない
+    if (w == oip->w && h == oip->h)
+        return FALSE;
+    *dst_w = w;
+    *dst_h = h;
+    return TRUE;
+}
+
 static void build_full_cmd(char *cmd, size_t nSize, const CONF_GUIEX *conf, const OUTPUT_INFO *oip, const PRM_ENC *pe, const SYSTEM_DATA *sys_dat, const char *input) {
     CONF_GUIEX prm;
     memcpy(&prm, conf, sizeof(CONF_GUIEX));
@@ -209,8 +363,11 @@ static void build_full_cmd(char *cmd, size_t nSize, const CONF_GUIEX *conf, cons
     //入力フォーマット
     strcpy_s(cmd + strlen(cmd), nSize - strlen(cmd), " -f rawvideo");
     //解像度情報追加(-s)
-    if (strcmp(input, PIPE_FN) == NULL)
-        sprintf_s(cmd + strlen(cmd), nSize - strlen(cmd), " -s %dx%d", oip->w, oip->h);
+    if (strcmp(input, PIPE_FN) == NULL) {
+        int out_w = 0, out_h = 0;
+        get_resize_target(&out_w, &out_h, conf, oip);
+        sprintf_s(cmd + strlen(cmd), nSize - strlen(cmd), " -s %dx%d", out_w, out_h);
+    }
     //rawの形式情報追加
     sprintf_s(cmd + strlen(cmd), nSize - strlen(cmd), " -pix_fmt %s", specify_input_csp(prm.enc.output_csp));
     //fps
@@ -229,17 +386,21 @@ static void build_full_cmd(char *cmd, size_t nSize, const CONF_GUIEX *conf, cons
                     sprintf_s(cmd + strlen(cmd), nSize - strlen(cmd), " -i \"%s\"", pipename);
                 }
                 if (pe->aud_count > 0) {
-                    const CONF_AUDIO_BASE *cnf_aud = &conf->aud.in;
-                    const AUDIO_SETTINGS *aud_stg = &sys_dat->exstg->s_aud_int[cnf_aud->encoder];
-                    if (sys_dat->exstg->is_faw(aud_stg)) {
+                    if (pe->deferred_enc) {
+                        //中間ファイルには音声をそのまま格納し、最終エンコードでエンコードする
                         sprintf_s(cmd + strlen(cmd), nSize - strlen(cmd), " -c:a copy");
-                    } else if (strcmp(aud_stg->codec, "custom") != 0) { // custom 選択時は特に何も指定しない
-                        sprintf_s(cmd + strlen(cmd), nSize - strlen(cmd), " -c:a %s", aud_stg->codec);
-                        if (aud_stg->mode[cnf_aud->enc_mode].bitrate) {
-                            sprintf_s(cmd + strlen(cmd), nSize - strlen(cmd), " -b:a %dk", cnf_aud->bitrate);
-                        }
+                    } else {
+                        append_internal_audio_codec(cmd, nSize, conf, sys_dat);
                     }
                 }
+            } else if (pe->deferred_enc) {
+                //外部音声エンコーダの出力は、最終エンコードで入力する
+            } else if (pe->aud_stream_to_videnc) {
+                //音声エンコーダの出力は、音声スレッドが名前付きパイプ経由で渡す
+                if_valid_wait_for_single_object(pe->aud_parallel.he_vid_start, INFINITE);
+                char pipename[MAX_PATH_LEN];
+                get_audio_pipe_name(pipename, _countof(pipename), 0);
+                sprintf_s(cmd + strlen(cmd), nSize - strlen(cmd), " -i \"%s\"", pipename);
             } else {
                 char tmp[MAX_PATH_LEN];
                 get_aud_filename(tmp, _countof(tmp), pe, 0);
@@ -247,8 +408,17 @@ static void build_full_cmd(char *cmd, size_t nSize, const CONF_GUIEX *conf, cons
             }
         }
     }
+    if (pe->deferred_enc) {
+        //中間ファイルへの出力
+        char intermediate[MAX_PATH_LEN];
+        get_deferred_intermediate_filename(intermediate, _countof(intermediate), pe);
+        append_cmdex(cmd, nSize, sys_dat->exstg->s_local.deferred_intermediate_cmd);
+        sprintf_s(cmd + strlen(cmd), nSize - strlen(cmd), " \"%s\"", intermediate);
+        return;
+    }
     //コマンドライン追加
     append_cmdex(cmd, nSize, prm.vid.cmdex);
+    replace_keyframes(cmd, nSize, conf, oip, pe, sys_dat);
     /////////  vframesを指定すると音声の最後の数秒が切れる場合があるようなので、vfrmaesは指定しない /////////
     //1pass目でafsでない、-vframesがなければ-vframesを指定
     //if ((!prm.vid.afs) && strstr(cmd, "-vframes") == NULL)
@@ -260,20 +430,48 @@ static void build_full_cmd(char *cmd, size_t nSize, const CONF_GUIEX *conf, cons
     sprintf_s(cmd + strlen(cmd), nSize - strlen(cmd), " \"%s\"", pe->temp_filename);
 }
 
+//中間ファイルから最終エンコードを行うコマンドラインを作成する
+static void build_deferred_cmd(char *cmd, size_t nSize, const CONF_GUIEX *conf, const OUTPUT_INFO *oip, const PRM_ENC *pe, const SYSTEM_DATA *sys_dat) {
+    CONF_GUIEX prm;
+    memcpy(&prm, conf, sizeof(CONF_GUIEX));
+    cmd_replace(prm.vid.cmdex, sizeof(prm.vid.cmdex), pe, sys_dat, conf, oip);
+
+    char intermediate[MAX_PATH_LEN];
+    get_deferred_intermediate_filename(intermediate, _countof(intermediate), pe);
+    sprintf_s(cmd, nSize, " -y -i \"%s\"", intermediate);
+    //音声入力
+    if ((oip->flag & OUTPUT_INFO_FLAG_AUDIO) && conf->enc.audio_input) {
+        if (conf->aud.use_internal) {
+            if (pe->aud_count > 0)
+                append_internal_audio_codec(cmd, nSize, conf, sys_dat);
+        } else {
+            char tmp[MAX_PATH_LEN];
+            get_aud_filename(tmp, _countof(tmp), pe, 0);
+            sprintf_s(cmd + strlen(cmd), nSize - strlen(cmd), " -i \"%s\"", tmp);
+        }
+    }
+    append_cmdex(cmd, nSize, prm.vid.cmdex);
+    replace_keyframes(cmd, nSize, conf, oip, pe, sys_dat);
+    sprintf_s(cmd + strlen(cmd), nSize - strlen(cmd), " \"%s\"", pe->temp_filename);
+}
+
 static void set_pixel_data(CONVERT_CF_DATA *pixel_data, const CONF_GUIEX *conf, int w, int h) {
     const int byte_per_pixel = (conf->enc.use_highbit_depth) ? sizeof(short) : sizeof(BYTE);
     ZeroMemory(pixel_data, sizeof(CONVERT_CF_DATA));
     switch (conf->enc.output_csp) {
         case OUT_CSP_NV16: //nv16 (YUV422)
+        case OUT_CSP_P210:
             pixel_data->count = 2;
             pixel_data->size[0] = w * h * byte_per_pixel;
             pixel_data->size[1] = pixel_data->size[0];
             break;
         case OUT_CSP_YUY2: //yuy2 (YUV422)
+        case OUT_CSP_Y210:
             pixel_data->count = 1;
             pixel_data->size[0] = w * h * byte_per_pixel * 2;
             break;
         case OUT_CSP_YUV444: //i444 (YUV444 planar)
+        case OUT_CSP_YUV444_12:
         case OUT_CSP_YUV444_16:
             pixel_data->count = 3;
             pixel_data->size[0] = w * h * byte_per_pixel;
@@ -288,8 +486,34 @@ static void set_pixel_data(CONVERT_CF_DATA *pixel_data, const CONF_GUIEX *conf,
             pixel_data->count = 1;
             pixel_data->size[0] = w * h * 4 * sizeof(BYTE); //8bit only
             break;
+        case OUT_CSP_YUV420_10: //yuv420p (YUV420 planar)
+        case OUT_CSP_YUV420_16:
+            pixel_data->count = 3;
+            pixel_data->size[0] = w * h * byte_per_pixel;
+            pixel_data->size[1] = pixel_data->size[0] / 4;
+            pixel_data->size[2] = pixel_data->size[0] / 4;
+            break;
+        case OUT_CSP_YUVA420: //yuva420p (YUV420 planar + alpha)
+        case OUT_CSP_YUVA420_10:
+        case OUT_CSP_YUVA420_16:
+            pixel_data->count = 4;
+            pixel_data->size[0] = w * h * byte_per_pixel;
+            pixel_data->size[1] = pixel_data->size[0] / 4;
+            pixel_data->size[2] = pixel_data->size[0] / 4;
+            pixel_data->size[3] = pixel_data->size[0];
+            break;
+        case OUT_CSP_YUVA444: //yuva444p (YUV444 planar + alpha)
+        case OUT_CSP_YUVA444_10:
+        case OUT_CSP_YUVA444_16:
+            pixel_data->count = 4;
+            pixel_data->size[0] = w * h * byte_per_pixel;
+            pixel_data->size[1] = pixel_data->size[0];
+            pixel_data->size[2] = pixel_data->size[0];
+            pixel_data->size[3] = pixel_data->size[0];
+            break;
         case OUT_CSP_NV12: //nv12 (YUV420)
         case OUT_CSP_P010:
+        case OUT_CSP_P012:
         default:
             pixel_data->count = 2;
             pixel_data->size[0] = w * h * byte_per_pixel;
@@ -301,6 +525,12 @@ static void set_pixel_data(CONVERT_CF_DATA *pixel_data, const CONF_GUIEX *conf,
         pixel_data->total_size += pixel_data->size[i];
 }
 
+//音声をパイプでffmpegに入力しているか (内蔵エンコーダ or 外部エンコーダ出力の同時入力)
+//この場合、ffmpegは音声の入力を待つので、映像側は音声を待機せずに処理を進める必要がある
+static inline BOOL audio_piped_to_videnc(const CONF_GUIEX *conf, const PRM_ENC *pe) {
+    return conf->aud.use_internal || pe->aud_stream_to_videnc;
+}
+
 static inline void check_enc_priority(HANDLE h_aviutl, HANDLE h_x264, DWORD priority) {
     if (priority == AVIUTLSYNC_PRIORITY_CLASS)
         priority = GetPriorityClass(h_aviutl);
@@ -313,7 +543,7 @@ AUO_RESULT aud_parallel_task(const OUTPUT_INFO *oip, PRM_ENC *pe, BOOL use_inter
     AUD_PARALLEL_ENC *aud_p = &pe->aud_parallel; //長いんで省略したいだけ
     if (aud_p->th_aud && video_is_last_pass(pe)) {
         //---   排他ブロック 開始  ---> 音声スレッドが止まっていなければならない
-        if (aud_p->he_vid_start && WaitForSingleObject(aud_p->he_vid_start, (use_internal) ? 0 : INFINITE) == WAIT_OBJECT_0) {
+        if (aud_p->he_vid_start && WaitForSingleObject(aud_p->he_vid_start, (use_internal || pe->aud_timing_auto.nonblocking) ? 0 : INFINITE) == WAIT_OBJECT_0) {
             if (aud_p->he_vid_start && aud_p->get_length) {
                 DWORD required_buf_size = aud_p->get_length * (DWORD)oip->audio_size;
                 if (aud_p->buf_max_size < required_buf_size) {
@@ -346,10 +576,133 @@ AUO_RESULT aud_parallel_task(const OUTPUT_INFO *oip, PRM_ENC *pe, BOOL use_inter
     return ret;
 }
 
+static const int    AUD_TIMING_AUTO_SKIP_FRAMES     = 32;    //エンコーダの立ち上がりを計測から除くためのフレーム数
+static const int    AUD_TIMING_AUTO_CALIB_FRAMES    = 120;   //映像の処理速度の計測に最低限必要なフレーム数
+static const DWORD  AUD_TIMING_AUTO_CALIB_MS        = 3000;  //映像の処理速度の計測に最低限必要な時間
+static const DWORD  AUD_TIMING_AUTO_RECHECK_MS      = 10000; //「後」のままとした場合に、再度判定を行う間隔
+static const double AUD_TIMING_AUTO_MIN_GAIN_MS     = 3000;  //同時処理に切り替えるのに必要な、予測処理時間の短縮量
+static const double AUD_TIMING_AUTO_MIN_GAIN_RATIO  = 0.05;  //同時処理に切り替えるのに必要な、予測処理時間の短縮率
+static const int    AUD_TIMING_AUTO_FEED_FRAMES     = 8;     //同時処理時に、映像1フレームごとに音声を取得するフレーム数 (wav_output参照)
+static const int    AUD_TIMING_AUTO_CALIB_CHUNKS    = 16;    //同時処理に切り替えたあと、音声の処理速度の計測に使用するブロック数
+static const double AUD_TIMING_AUTO_MAX_WAIT_RATIO  = 0.25;  //映像側が音声を待機する時間の割合がこれを超えたら、音声を待機しない
+
+static UINT64 get_process_cpu_time(HANDLE hProcess) {
+    PROCESS_TIME time = { 0 };
+    return (GetProcessTime(hProcess, &time)) ? time.kernel + time.user : 0;
+}
+
+//「後」と「同時」それぞれの、残りの処理時間(ms)を予測する
+//  vid_remain_ms ... 映像のみを処理した場合の残り時間
+//  used_cores    ... 映像の処理(エンコーダ+Aviutl)の使用する論理コア数
+//同時処理では、空きコアで足りない分を映像と音声で分け合い、双方が同じ割合で遅くなるとみなす
+//また、音声は映像1フレームごとにAUD_TIMING_AUTO_FEED_FRAMES分しか取得できないので、
+//映像の残りフレームで取得しきれない分は、映像の終了後に処理することになる
+static void predict_audio_timing(const OUTPUT_INFO *oip, const AUD_TIMING_AUTO *aud_auto, int i,
+    double vid_remain_ms, double used_cores, double *after_ms, double *parallel_ms) {
+    const double logical_cores = get_cpu_info().logical_cores;
+    const double slowdown = std::max(1.0, (used_cores + aud_auto->aud_enc_cores) / logical_cores);
+    const double feed_ratio = std::min(1.0, (oip->n - i) * AUD_TIMING_AUTO_FEED_FRAMES / (double)std::max(1, oip->n));
+    *after_ms = vid_remain_ms + aud_auto->aud_enc_ms;
+    *parallel_ms = std::max(vid_remain_ms, aud_auto->aud_enc_ms * feed_ratio) * slowdown
+                 + aud_auto->aud_enc_ms * (1.0 - feed_ratio);
+}
+
+//音声処理順の自動選択時の音声同時処理
+//映像の処理速度と空きCPUを計測し、事前に計測した音声エンコーダの処理速度と合わせて
+//「後」と「同時」の残り処理時間を予測して、同時処理のほうが十分に速ければ同時処理に切り替える
+//「後」のままとした場合も、映像の処理速度の変化に合わせて一定間隔で再判定する
+//同時処理に切り替えたら、映像側が音声を待機する時間を計測し、音声が遅すぎる場合は待機せずに映像を進める
+static AUO_RESULT aud_timing_auto_task(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *pe, const SYSTEM_DATA *sys_dat, int i, HANDLE h_p_videnc) {
+    AUO_RESULT ret = AUO_RESULT_SUCCESS;
+    AUD_TIMING_AUTO *aud_auto = &pe->aud_timing_auto; //長いんで省略したいだけ
+    if (!video_is_last_pass(pe))
+        return ret;
+
+    if (!aud_auto->decided) {
+        if (i < AUD_TIMING_AUTO_SKIP_FRAMES)
+            return ret;
+        const DWORD tm_now = timeGetTime();
+        if (aud_auto->tm_calib_start == 0) {
+            aud_auto->calib_start_frame = i;
+            aud_auto->tm_calib_start = tm_now;
+            aud_auto->videnc_cpu_time = get_process_cpu_time(h_p_videnc);
+            aud_auto->aviutl_cpu_time = get_process_cpu_time(pe->h_p_aviutl);
+            return ret;
+        }
+        const int calib_frames = i - aud_auto->calib_start_frame;
+        const DWORD calib_ms = tm_now - aud_auto->tm_calib_start;
+        if (calib_frames < AUD_TIMING_AUTO_CALIB_FRAMES || calib_ms < AUD_TIMING_AUTO_CALIB_MS)
+            return ret;
+
+        if (aud_auto->evaluated && calib_ms < AUD_TIMING_AUTO_RECHECK_MS)
+            return ret;
+
+        const double vid_fps = calib_frames * 1000.0 / calib_ms;
+        const double vid_remain_ms = (oip->n - i) * 1000.0 / vid_fps;
+        //CPU時間は100ns単位
+        const UINT64 videnc_cpu_time = get_process_cpu_time(h_p_videnc);
+        const UINT64 aviutl_cpu_time = get_process_cpu_time(pe->h_p_aviutl);
+        const double used_cores = ((videnc_cpu_time - aud_auto->videnc_cpu_time)
+                                 + (aviutl_cpu_time - aud_auto->aviutl_cpu_time)) / (calib_ms * 10000.0);
+        const double idle_cores = std::max(0.0, get_cpu_info().logical_cores - used_cores);
+        double after_ms = 0.0, parallel_ms = 0.0;
+        predict_audio_timing(oip, aud_auto, i, vid_remain_ms, used_cores, &after_ms, &parallel_ms);
+
+        const double gain_ms = after_ms - parallel_ms;
+        if (gain_ms < std::max(AUD_TIMING_AUTO_MIN_GAIN_MS, after_ms * AUD_TIMING_AUTO_MIN_GAIN_RATIO)) {
+            //「後」のまま、次の区間で再判定する
+            if (!aud_auto->evaluated) {
+                write_log_auo_line_fmt(LOG_INFO, g_auo_mes.get(AUO_VIDEO_AUDIO_TIMING_AUTO_AFTER), vid_fps, idle_cores, after_ms * 0.001, parallel_ms * 0.001);
+            }
+            aud_auto->evaluated = TRUE;
+            aud_auto->calib_start_frame = i;
+            aud_auto->tm_calib_start = tm_now;
+            aud_auto->videnc_cpu_time = videnc_cpu_time;
+            aud_auto->aviutl_cpu_time = aviutl_cpu_time;
+            return ret;
+        }
+        aud_auto->evaluated = TRUE;
+        aud_auto->decided = TRUE;
+        write_log_auo_line_fmt(LOG_INFO, g_auo_mes.get(AUO_VIDEO_AUDIO_TIMING_AUTO_PARALLEL), vid_fps, idle_cores, after_ms * 0.001, parallel_ms * 0.001);
+        conf->aud.ext.audio_encode_timing = AUDIO_ENC_TIMING_PARALLEL;
+        if (AUO_RESULT_SUCCESS != audio_output_parallel(conf, oip, pe, sys_dat)) {
+            //同時処理を開始できなければ「後」のまま
+            release_audio_parallel_events(pe);
+            ZeroMemory(&pe->aud_parallel, sizeof(pe->aud_parallel));
+            conf->aud.ext.audio_encode_timing = AUDIO_ENC_TIMING_AFTER;
+        }
+        return ret;
+    }
+
+    if (aud_auto->nonblocking || aud_auto->calib_chunks >= AUD_TIMING_AUTO_CALIB_CHUNKS)
+        return aud_parallel_task(oip, pe, conf->aud.use_internal);
+
+    const DWORD tm_wait_start = timeGetTime();
+    ret |= aud_parallel_task(oip, pe, conf->aud.use_internal);
+    const DWORD tm_wait_fin = timeGetTime();
+    if (aud_auto->tm_parallel_start == 0) {
+        //最初のブロックは音声エンコーダの起動待ちを含むので計測から除く
+        aud_auto->tm_parallel_start = tm_wait_fin;
+        return ret;
+    }
+    aud_auto->vid_wait_ms += tm_wait_fin - tm_wait_start;
+    if (++aud_auto->calib_chunks >= AUD_TIMING_AUTO_CALIB_CHUNKS) {
+        const double wait_ratio = aud_auto->vid_wait_ms / (double)std::max<DWORD>(1, tm_wait_fin - aud_auto->tm_parallel_start);
+        if (wait_ratio > AUD_TIMING_AUTO_MAX_WAIT_RATIO) {
+            //音声が映像より遅いので、映像は音声を待たずに進め、残りはfinish_aud_parallel_taskで処理する
+            aud_auto->nonblocking = TRUE;
+            write_log_auo_line_fmt(LOG_INFO, g_auo_mes.get(AUO_VIDEO_AUDIO_TIMING_AUTO_NONBLOCK), wait_ratio * 100.0);
+        }
+    }
+    return ret;
+}
+
 //音声処理をどんどん回して終了させる
 static AUO_RESULT finish_aud_parallel_task(const OUTPUT_INFO *oip, PRM_ENC *pe, BOOL use_internal, AUO_RESULT vid_ret) {
     //エラーが発生していたら音声出力ループをとめる
     pe->aud_parallel.abort |= (vid_ret != AUO_RESULT_SUCCESS);
+    //残りの音声処理は待機しながら回す
+    pe->aud_timing_auto.nonblocking = FALSE;
     if (pe->aud_parallel.th_aud && (video_is_last_pass(pe) || pe->aud_parallel.abort)) {
         write_log_auo_line(LOG_INFO, g_auo_mes.get(AUO_VIDEO_AUDIO_PROC_WAIT));
         set_window_title(g_auo_mes.get(AUO_VIDEO_AUDIO_PROC_WAIT), PROGRESSBAR_MARQUEE);
@@ -507,8 +860,16 @@ static AUO_RESULT ffmpeg_out(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *
     const bool afs = conf->vid.afs != 0;
     video_output_thread_t thread_data = { 0 };
     thread_data.repeat = pe->delay_cut_additional_vframe;
+
+    //バッファサイズを計算する前に出力形式を確定させておく
+    if (is_aviutl2() && csp_from_exedit_rgba(conf->enc.output_csp)) {
+        conf->enc.output_csp = csp_remove_alpha(conf->enc.output_csp);
+    }
+    //縮小する場合は、パイプに渡すフレームを縮小後の解像度で確保する
+    int out_w = 0, out_h = 0;
+    const BOOL resize = get_resize_target(&out_w, &out_h, conf, oip);
     CONVERT_CF_DATA pixel_data;
-    set_pixel_data(&pixel_data, conf, oip->w, oip->h);
+    set_pixel_data(&pixel_data, conf, out_w, out_h);
 
     int *jitter = NULL;
     int rp_ret;
@@ -523,41 +884,90 @@ static AUO_RESULT ffmpeg_out(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *
     }
     PathGetDirectory(enc_dir, _countof(enc_dir), enc_path);
 
-    if (is_aviutl2() && conf->enc.output_csp == OUT_CSP_RGBA) {
-        conf->enc.output_csp = OUT_CSP_RGB;
-    }
-    const int color_format = get_aviutl_color_format(conf->enc.use_highbit_depth, conf->enc.output_csp);
+    const int dither = get_output_dither(sys_dat, conf);
+    const int color_format = get_aviutl_color_format(conf->enc.use_highbit_depth, conf->enc.output_csp, dither);
     const DWORD aviutl_fourcc = COLORFORMATS[color_format].FOURCC;
 
-    //YUY2/YC48->NV12/YUV444, RGBコピー用関数
+    //YUY2/YC48->NV12/YUV444, RGBコピー, RGBA->YUVA用関数
     auto convert_func_output_csp = conf->enc.output_csp;
     if (convert_func_output_csp == OUT_CSP_P010) {
         convert_func_output_csp = OUT_CSP_NV12;
     } else if (convert_func_output_csp == OUT_CSP_YUV444_16) {
         convert_func_output_csp = OUT_CSP_YUV444;
+    } else if (convert_func_output_csp == OUT_CSP_YUVA420_10 || convert_func_output_csp == OUT_CSP_YUVA420_16) {
+        convert_func_output_csp = OUT_CSP_YUVA420;
+    } else if (convert_func_output_csp == OUT_CSP_YUVA444_10 || convert_func_output_csp == OUT_CSP_YUVA444_16) {
+        convert_func_output_csp = OUT_CSP_YUVA444;
+    }
+    const int bit_depth = get_output_bit_depth(conf);
+    //縮小する場合、面積平均でちょうど1/2, 1/4ならnv12への変換と同時に縮小する
+    //それ以外は元の解像度で変換してから縮小する
+    func_convert_frame convert_frame = NULL;
+    BOOL resize_after_convert = FALSE;
+    if (resize) {
+        const int ratio = oip->w / out_w;
+        if (conf->vid.resize_algo == VIDEO_RESIZE_BOX && dither == DITHER_NONE
+            && out_w * ratio == oip->w && out_h * ratio == oip->h)
+            convert_frame = get_convert_resize_func(oip->w, color_format, bit_depth, conf->enc.interlaced, convert_func_output_csp, ratio);
+        resize_after_convert = (convert_frame == NULL);
+        write_log_auo_line_fmt(LOG_INFO, g_auo_mes.get(AUO_VIDEO_RESIZE), oip->w, oip->h, out_w, out_h, g_auo_mes.get(VIDEO_RESIZE_ALGO[conf->vid.resize_algo].mes));
+    }
+    if (convert_frame == NULL) {
+        convert_frame = get_convert_func(oip->w, color_format, bit_depth, conf->enc.interlaced, convert_func_output_csp, dither);
     }
-    const func_convert_frame convert_frame = get_convert_func(oip->w, color_format, conf->enc.use_highbit_depth ? 16 : 8, conf->enc.interlaced, convert_func_output_csp);
     if (convert_frame == NULL) {
-        ret |= AUO_RESULT_ERROR; error_select_convert_func(oip->w, oip->h, conf->enc.use_highbit_depth ? 16 : 8, conf->enc.interlaced, conf->enc.output_csp);
+        ret |= AUO_RESULT_ERROR; error_select_convert_func(oip->w, oip->h, bit_depth, conf->enc.interlaced, conf->enc.output_csp);
         return ret;
     }
-    //映像バッファ用メモリ確保
-    if (!malloc_pixel_data(&pixel_data, oip->w, oip->h, conf->enc.output_csp, conf->enc.use_highbit_depth ? 16 : 8)) {
+    //映像バッファ用メモリ確保 (変換・書き出しのスレッドと同じNUMAノードに確保する)
+    const int numa_node = get_thread_placement_numa_node(&sys_dat->exstg->s_local);
+    if (numa_node >= 0)
+        write_log_auo_line_fmt(LOG_MORE, g_auo_mes.get(AUO_VIDEO_NUMA_NODE), numa_node);
+    pixel_data.dither = (resize_after_convert) ? DITHER_NONE : dither;
+    pixel_data.unpremultiply = sys_dat->exstg->s_local.rgba_unpremultiply;
+    if (!malloc_pixel_data(&pixel_data, out_w, out_h, conf->enc.output_csp, bit_depth, numa_node)) {
         ret |= AUO_RESULT_ERROR; error_malloc_pixel_data();
+        free_pixel_data(&pixel_data);
         return ret;
     }
+    //変換後に縮小する場合は、元の解像度の変換結果を置く中間バッファと縮小用の重みを用意する
+    CONVERT_CF_DATA pixel_data_src = { 0 };
+    RESIZE_DATA resize_data = { 0 };
+    if (resize_after_convert) {
+        pixel_data_src.dither = dither;
+        pixel_data_src.unpremultiply = pixel_data.unpremultiply;
+        if (!init_resize_data(&resize_data, conf->vid.resize_algo, oip->w, oip->h, out_w, out_h, conf->enc.output_csp, bit_depth, conf->enc.interlaced)) {
+            ret |= AUO_RESULT_ERROR;
+            free_pixel_data(&pixel_data);
+            free_resize_data(&resize_data);
+            return ret;
+        }
+        if (!malloc_pixel_data(&pixel_data_src, oip->w, oip->h, conf->enc.output_csp, bit_depth, numa_node)) {
+            ret |= AUO_RESULT_ERROR; error_malloc_pixel_data();
+            free_pixel_data(&pixel_data);
+            free_pixel_data(&pixel_data_src);
+            free_resize_data(&resize_data);
+            return ret;
+        }
+    }
 
     //拡張編集のファイルマッピングを取得
     ExeditFileMapping efm = { nullptr };
     ExeditData ed = { 0 };
-    if(conf->enc.output_csp == OUT_CSP_RGBA) {
+    if(csp_from_exedit_rgba(conf->enc.output_csp)) {
         if (get_exedit_file_mapping(&efm) == FALSE) {
             ret |= AUO_RESULT_ERROR; error_get_exedit_file_mapping();
+            free_pixel_data(&pixel_data);
+            free_pixel_data(&pixel_data_src);
+            free_resize_data(&resize_data);
             return ret;
         }
         //拡張編集の出力開始
         if (efm.output_start(&ed) == FALSE) {
             ret |= AUO_RESULT_ERROR; error_get_exedit_output_start();
+            free_pixel_data(&pixel_data);
+            free_pixel_data(&pixel_data_src);
+            free_resize_data(&resize_data);
             return ret;
         }
     }
@@ -569,6 +979,8 @@ static AUO_RESULT ffmpeg_out(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *
 
     //コマンドライン生成
     build_full_cmd(enc_cmd, _countof(enc_cmd), conf, oip, pe, sys_dat, PIPE_FN);
+    if (pe->deferred_enc)
+        write_log_auo_line(LOG_INFO, g_auo_mes.get(AUO_VIDEO_DEFERRED_INTERMEDIATE));
     write_log_auo_line(LOG_INFO, L"ffmpeg options...");
     write_args(enc_cmd);
     sprintf_s(enc_args, _countof(enc_args), "\"%s\" %s", enc_path, enc_cmd);
@@ -597,6 +1009,16 @@ static AUO_RESULT ffmpeg_out(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *
         GetProcessTime(pe->h_p_aviutl, &time_aviutl);
         pe->h_p_videnc = pi_enc.hProcess;
 
+        //フレーム取得・変換・書き出しのスレッドとffmpegをCPUの構成に合わせて配置
+        const LOCAL_SETTINGS *s_local = &sys_dat->exstg->s_local;
+        const DWORD_PTR feed_mask = get_thread_placement_mask(THREAD_PLACEMENT_FEED, s_local);
+        const DWORD_PTR aviutl_thread_mask = set_thread_placement(GetCurrentThread(), feed_mask);
+        set_thread_placement(thread_data.thread, feed_mask);
+        if (pe->afs_init)
+            set_thread_placement(afs_vbuf_prefetch_thread(), feed_mask);
+        set_process_placement(pi_enc.hProcess, get_thread_placement_mask(THREAD_PLACEMENT_VIDENC, s_local));
+        write_log_thread_placement(s_local);
+
         //Aviutlのpower throttlingを設定
         const auto thread_pthrottling_mode = (RGYThreadPowerThrottlingMode)sys_dat->exstg->s_local.thread_pthrottling_mode;
         if (thread_pthrottling_mode != RGYThreadPowerThrottlingMode::Unset) {
@@ -606,7 +1028,7 @@ static AUO_RESULT ffmpeg_out(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *
         //x264が待機に入るまでこちらも待機
         while (WaitForInputIdle(pi_enc.hProcess, LOG_UPDATE_INTERVAL) == WAIT_TIMEOUT)
             log_process_events();
-        if (video_is_last_pass(pe) && conf->aud.use_internal)
+        if (video_is_last_pass(pe) && audio_piped_to_videnc(conf, pe))
             if_valid_set_event(pe->aud_parallel.he_aud_start);
 
         //ログウィンドウ側から制御を可能に
@@ -614,7 +1036,7 @@ static AUO_RESULT ffmpeg_out(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *
         enable_enc_control(&set_priority, &enc_pause, FALSE, FALSE, tm_vid_enc_start, oip->n);
 
         //------------メインループ------------
-        for (framen = ed.frame_start, i = 0, next_jitter = jitter + 1, pe->drop_count = 0; (conf->enc.output_csp == OUT_CSP_RGBA ? (framen <= ed.frame_end) : (i < oip->n)); i++, framen++, next_jitter++) {
+        for (framen = ed.frame_start, i = 0, next_jitter = jitter + 1, pe->drop_count = 0; (csp_from_exedit_rgba(conf->enc.output_csp) ? (framen <= ed.frame_end) : (i < oip->n)); i++, framen++, next_jitter++) {
             //中断を確認
             ret |= (oip->func_is_abort()) ? AUO_RESULT_ABORT : AUO_RESULT_SUCCESS;
 
@@ -640,8 +1062,10 @@ static AUO_RESULT ffmpeg_out(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *
 
                 //音声同時処理
                 if (!conf->aud.use_internal) {
-                    //音声同時処理
-                    ret |= aud_parallel_task(oip, pe, conf->aud.use_internal);
+                    //音声同時処理 (処理順の自動選択時はその判定も行う)
+                    ret |= (pe->aud_timing_auto.enable)
+                        ? aud_timing_auto_task(conf, oip, pe, sys_dat, i, pi_enc.hProcess)
+                        : aud_parallel_task(oip, pe, audio_piped_to_videnc(conf, pe));
                 }
             }
 
@@ -664,9 +1088,9 @@ static AUO_RESULT ffmpeg_out(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *
                     }
                     log_process_events();
                 }
-                if (conf->aud.use_internal) {
+                if (audio_piped_to_videnc(conf, pe)) {
                     //音声同時処理
-                    ret |= aud_parallel_task(oip, pe, conf->aud.use_internal);
+                    ret |= aud_parallel_task(oip, pe, TRUE);
                 }
             }
 
@@ -675,7 +1099,7 @@ static AUO_RESULT ffmpeg_out(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *
                 break;
 
 
-            if(conf->enc.output_csp == OUT_CSP_RGBA) {
+            if(csp_from_exedit_rgba(conf->enc.output_csp)) {
                 //拡張編集からフレームをもらう
                 if ((frame = efm.get_image(framen)) == NULL) {
                     ret |= AUO_RESULT_ERROR; error_afs_get_frame();
@@ -696,8 +1120,14 @@ static AUO_RESULT ffmpeg_out(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *
 
             if (!drop) {
                 //コピーフレームの場合は、映像バッファの中身を更新せず、そのままパイプに流す
-                if (!copy_frame)
-                    convert_frame(frame, &pixel_data, oip->w, oip->h);  /// YUY2/YC48->NV12/YUV444変換, RGBコピー
+                if (!copy_frame) {
+                    if (resize_after_convert) {
+                        convert_frame(frame, &pixel_data_src, oip->w, oip->h);
+                        resize_frame(&resize_data, &pixel_data_src, &pixel_data);
+                    } else {
+                        convert_frame(frame, &pixel_data, oip->w, oip->h);  /// YUY2/YC48->NV12/YUV444変換, RGBコピー
+                    }
+                }
                 //標準入力への書き込みを開始
                 SetEvent(thread_data.he_out_start);
             } else {
@@ -723,17 +1153,17 @@ static AUO_RESULT ffmpeg_out(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *
         //パイプを閉じる
         CloseStdIn(&pipes);
         
-        if(conf->enc.output_csp == OUT_CSP_RGBA)
+        if(csp_from_exedit_rgba(conf->enc.output_csp))
             efm.output_end();
 
         if (!ret) oip->func_rest_time_disp(oip->n * pe->current_x264_pass, oip->n * pe->total_x264_pass);
 
         //音声の同時処理を終了させる
-        ret |= finish_aud_parallel_task(oip, pe, conf->aud.use_internal, ret);
+        ret |= finish_aud_parallel_task(oip, pe, audio_piped_to_videnc(conf, pe), ret);
 
         //タイムコード出力
         if (!ret && (afs || conf->vid.auo_tcfile_out))
-            tcfile_out(jitter, oip->n, (double)oip->rate / (double)oip->scale, afs, pe);
+            tcfile_out(jitter, oip->n, oip->rate, oip->scale, afs, pe);
 
         //エンコーダ終了待機
         while (WaitForSingleObject(pi_enc.hProcess, LOG_UPDATE_INTERVAL) == WAIT_TIMEOUT)
@@ -744,6 +1174,7 @@ static AUO_RESULT ffmpeg_out(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *
         if (thread_pthrottling_mode != RGYThreadPowerThrottlingMode::Unset) {
             SetThreadPowerThrottolingModeForModule(GetCurrentProcessId(), nullptr, RGYThreadPowerThrottlingMode::Unset);
         }
+        set_thread_placement(GetCurrentThread(), aviutl_thread_mask);
 
         //最後にメッセージを取得
         while (ReadLogEnc(&pipes, pe->drop_count, i) > 0);
@@ -760,6 +1191,8 @@ static AUO_RESULT ffmpeg_out(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *
     pe->h_p_videnc = NULL;
 
     free_pixel_data(&pixel_data);
+    free_pixel_data(&pixel_data_src);
+    free_resize_data(&resize_data);
     if (jitter) free(jitter);
 
     return ret;
@@ -792,5 +1225,56 @@ static AUO_RESULT video_output_inside(CONF_GUIEX *conf, const OUTPUT_INFO *oip,
 }
 
 AUO_RESULT video_output(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *pe, const SYSTEM_DATA *sys_dat) {
-    return exit_audio_parallel_control(oip, pe, conf->aud.use_internal, video_output_inside(conf, oip, pe, sys_dat));
+    return exit_audio_parallel_control(oip, pe, audio_piped_to_videnc(conf, pe), video_output_inside(conf, oip, pe, sys_dat));
+}
+
+AUO_RESULT deferred_video_output(const CONF_GUIEX *conf, const OUTPUT_INFO *oip, const PRM_ENC *pe, const SYSTEM_DATA *sys_dat) {
+    if (!pe->deferred_enc)
+        return AUO_RESULT_SUCCESS;
+
+    DEFERRED_ENC_JOB job;
+    char enc_cmd[MAX_CMD_LEN] = { 0 };
+    char buf[MAX_PATH_LEN] = { 0 };
+    const char *enc_path = sys_dat->exstg->s_local.ffmpeg_path;
+    build_deferred_cmd(enc_cmd, _countof(enc_cmd), conf, oip, pe, sys_dat);
+    job.args = std::string("\"") + enc_path + "\"" + enc_cmd;
+    PathGetDirectory(buf, _countof(buf), enc_path);
+    job.exe_dir = buf;
+    get_deferred_intermediate_filename(buf, _countof(buf), pe);
+    job.intermediate = buf;
+    apply_appendix(buf, _countof(buf), pe->temp_filename, DEFERRED_LOG_APPENDIX);
+    job.log_file = buf;
+    job.total_frames = oip->n + pe->delay_cut_additional_vframe - pe->drop_count;
+
+    //連番出力等の場合は、1番の出力を確認し、移動は行わない
+    sprintf_s(buf, pe->temp_filename, 1);
+    job.output = buf;
+    if (strcmp(buf, pe->temp_filename) == 0) {
+        apply_appendix(buf, _countof(buf), oip->savefile, PathFindExtension(pe->temp_filename));
+        job.move_files.push_back(std::make_pair(std::string(pe->temp_filename), std::string(buf)));
+    }
+    //動画に入力する音声ファイルは、最終エンコード後に移動・削除する
+    if ((oip->flag & OUTPUT_INFO_FLAG_AUDIO) && conf->enc.audio_input && !conf->aud.use_internal) {
+        const BOOL erase = pe->muxer_to_be_used != MUXER_DISABLED;
+        char aud_tempfile[MAX_PATH_LEN];
+        PathCombineLong(aud_tempfile, _countof(aud_tempfile), pe->aud_temp_dir, PathFindFileName(pe->temp_filename));
+        for (int i_aud = 0; i_aud < pe->aud_count; i_aud++) {
+            char aud_from[MAX_PATH_LEN], aud_to[MAX_PATH_LEN];
+            apply_appendix(aud_from, _countof(aud_from), aud_tempfile, pe->append.aud[i_aud]);
+            apply_appendix(aud_to, _countof(aud_to), oip->savefile, pe->append.aud[i_aud]);
+            if (erase)
+                job.remove_files.push_back(aud_from);
+            else
+                job.move_files.push_back(std::make_pair(std::string(aud_from), std::string(aud_to)));
+        }
+    }
+
+    double progress = 0.0;
+    const int remaining = deferred_enc_get_status(&progress);
+    if (remaining > 0)
+        write_log_auo_line_fmt(LOG_INFO, g_auo_mes.get(AUO_VIDEO_DEFERRED_STATUS), remaining, progress * 100.0);
+    if (deferred_enc_add_job(job) != AUO_RESULT_SUCCESS)
+        return AUO_RESULT_ERROR;
+    write_log_auo_line_fmt(LOG_INFO, g_auo_mes.get(AUO_VIDEO_DEFERRED_QUEUED), char_to_wstring(job.log_file).c_str());
+    return AUO_RESULT_SUCCESS;
 }
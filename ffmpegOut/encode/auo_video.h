@@ -32,12 +32,12 @@
 #include "convert.h"
 #include "auo_conf.h"
 #include "auo_system.h"
+#include "auo_timestamp.h"
 
 #ifndef MAKEFOURCC
 #define MAKEFOURCC(ch0, ch1, ch2, ch3)  ((DWORD)(BYTE)(ch0) | ((DWORD)(BYTE)(ch1) << 8) | ((DWORD)(BYTE)(ch2) << 16) | ((DWORD)(BYTE)(ch3) << 24))
 #endif
 
-static const int DROP_FRAME_FLAG = INT_MAX;
 
 typedef struct {
     DWORD FOURCC;   //FOURCC
@@ -83,6 +83,8 @@ BOOL setup_afsvideo(const OUTPUT_INFO *oip, const SYSTEM_DATA *sys_dat, CONF_GUI
 void close_afsvideo(PRM_ENC *pe);
 
 AUO_RESULT video_output(CONF_GUIEX *conf, const OUTPUT_INFO *oip, PRM_ENC *pe, const SYSTEM_DATA *sys_dat);
+//中間ファイルからの最終エンコードを、バックグラウンドのキューに登録する
+AUO_RESULT deferred_video_output(const CONF_GUIEX *conf, const OUTPUT_INFO *oip, const PRM_ENC *pe, const SYSTEM_DATA *sys_dat);
 
 static BOOL get_exedit_file_mapping(ExeditFileMapping* efm);
 
@@ -0,0 +1,233 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#include <cstring>
+#include <algorithm>
+#include <shlwapi.h>
+#pragma comment(lib, "shlwapi.lib")
+#include "auo_wavwriter.h"
+
+static const size_t WAV_WRITER_ALIGN_MIN = 4096;
+static const size_t WAV_WRITER_BUF_SIZE  = 4 * 1024 * 1024;
+
+AuoWavWriter::AuoWavWriter() :
+    filename(),
+    h_file(INVALID_HANDLE_VALUE),
+    align(WAV_WRITER_ALIGN_MIN),
+    buf_size(0),
+    buf(),
+    buf_idx(0),
+    buf_len(0),
+    file_pos(0),
+    total_size(0),
+    th_write(),
+    mtx(),
+    cond(),
+    queued_idx(-1),
+    queued_len(0),
+    writing_idx(-1),
+    fin(false),
+    error(false) {
+}
+
+AuoWavWriter::~AuoWavWriter() {
+    if (h_file != INVALID_HANDLE_VALUE) {
+        close(nullptr, 0);
+    }
+    for (int i = 0; i < _countof(buf); i++) {
+        if (buf[i]) {
+            _aligned_free(buf[i]);
+            buf[i] = nullptr;
+        }
+    }
+}
+
+AUO_RESULT AuoWavWriter::open(const char *filepath, uint64_t expected_size) {
+    strcpy_s(filename, _countof(filename), filepath);
+
+    //FILE_FLAG_NO_BUFFERINGではセクタサイズ単位で書き込む必要がある
+    char root[MAX_PATH_LEN] = { 0 };
+    DWORD sectors_per_cluster = 0, bytes_per_sector = 0, free_clusters = 0, total_clusters = 0;
+    if (GetFullPathNameA(filename, _countof(root), root, nullptr) && PathStripToRootA(root)
+        && GetDiskFreeSpaceA(root, &sectors_per_cluster, &bytes_per_sector, &free_clusters, &total_clusters)) {
+        align = std::max<size_t>(align, bytes_per_sector);
+    }
+    buf_size = (WAV_WRITER_BUF_SIZE + align - 1) / align * align;
+    for (int i = 0; i < _countof(buf); i++) {
+        if (nullptr == (buf[i] = (uint8_t *)_aligned_malloc(buf_size, align))) {
+            return AUO_RESULT_ERROR;
+        }
+    }
+
+    h_file = CreateFileA(filename, GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_NO_BUFFERING | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (h_file == INVALID_HANDLE_VALUE) {
+        return AUO_RESULT_ERROR;
+    }
+    //事前に領域を確保 (ファイルサイズは変更しないので、0埋めは発生しない)
+    if (expected_size > 0) {
+        FILE_ALLOCATION_INFO alloc_info;
+        alloc_info.AllocationSize.QuadPart = (LONGLONG)((expected_size + align - 1) / align * align);
+        SetFileInformationByHandle(h_file, FileAllocationInfo, &alloc_info, sizeof(alloc_info));
+    }
+    th_write = std::thread(&AuoWavWriter::thread_func, this);
+    return AUO_RESULT_SUCCESS;
+}
+
+bool AuoWavWriter::write_block(const uint8_t *data, size_t size) {
+    while (size > 0) {
+        OVERLAPPED overlapped;
+        memset(&overlapped, 0, sizeof(overlapped));
+        overlapped.Offset = (DWORD)(file_pos & 0xffffffff);
+        overlapped.OffsetHigh = (DWORD)(file_pos >> 32);
+        DWORD written = 0;
+        if (!WriteFile(h_file, data, (DWORD)size, &written, &overlapped) || written == 0) {
+            return false;
+        }
+        data += written;
+        size -= written;
+        file_pos += written;
+    }
+    return true;
+}
+
+void AuoWavWriter::thread_func() {
+    for (;;) {
+        int idx = -1;
+        size_t len = 0;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cond.wait(lock, [this]() { return queued_idx >= 0 || fin; });
+            if (queued_idx < 0) {
+                break; //fin
+            }
+            idx = queued_idx;
+            len = queued_len;
+            writing_idx = idx;
+            queued_idx = -1;
+        }
+        cond.notify_all();
+        //最後のバッファはセクタサイズに切り上げて書き出し、closeでファイルサイズを調整する
+        const size_t write_len = (len + align - 1) / align * align;
+        if (write_len > len) {
+            memset(buf[idx] + len, 0, write_len - len);
+        }
+        const bool ok = write_block(buf[idx], write_len);
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            writing_idx = -1;
+            if (!ok) error = true;
+        }
+        cond.notify_all();
+    }
+}
+
+void AuoWavWriter::wait_buffer_free(int idx) {
+    std::unique_lock<std::mutex> lock(mtx);
+    cond.wait(lock, [this, idx]() { return queued_idx != idx && writing_idx != idx; });
+}
+
+void AuoWavWriter::submit(int idx, size_t len) {
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        cond.wait(lock, [this]() { return queued_idx < 0; });
+        queued_idx = idx;
+        queued_len = len;
+    }
+    cond.notify_all();
+}
+
+size_t AuoWavWriter::write(const void *data, size_t size) {
+    if (h_file == INVALID_HANDLE_VALUE || error) {
+        return 0;
+    }
+    const uint8_t *ptr = (const uint8_t *)data;
+    size_t remain = size;
+    while (remain > 0) {
+        const size_t copy_len = std::min(remain, buf_size - buf_len);
+        memcpy(buf[buf_idx] + buf_len, ptr, copy_len);
+        buf_len += copy_len;
+        ptr += copy_len;
+        remain -= copy_len;
+        if (buf_len == buf_size) {
+            submit(buf_idx, buf_len);
+            buf_idx ^= 1;
+            buf_len = 0;
+            wait_buffer_free(buf_idx);
+        }
+    }
+    total_size += size;
+    return size;
+}
+
+AUO_RESULT AuoWavWriter::close(const void *header, size_t header_size) {
+    AUO_RESULT ret = AUO_RESULT_SUCCESS;
+    if (h_file == INVALID_HANDLE_VALUE) {
+        return AUO_RESULT_ERROR;
+    }
+    if (buf_len > 0) {
+        submit(buf_idx, buf_len);
+        buf_len = 0;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        fin = true;
+    }
+    cond.notify_all();
+    if (th_write.joinable()) {
+        th_write.join();
+    }
+    if (error) {
+        ret |= AUO_RESULT_ERROR;
+    }
+
+    //切り上げて書き出した分を削除
+    FILE_END_OF_FILE_INFO eof_info;
+    eof_info.EndOfFile.QuadPart = (LONGLONG)total_size;
+    if (!SetFileInformationByHandle(h_file, FileEndOfFileInfo, &eof_info, sizeof(eof_info))) {
+        ret |= AUO_RESULT_ERROR;
+    }
+    CloseHandle(h_file);
+    h_file = INVALID_HANDLE_VALUE;
+
+    //ヘッダはセクタ境界に揃わないので、キャッシュありで開き直して位置を指定して書き込む
+    if (!ret && header && header_size > 0) {
+        HANDLE h_header = CreateFileA(filename, GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (h_header == INVALID_HANDLE_VALUE) {
+            ret |= AUO_RESULT_ERROR;
+        } else {
+            OVERLAPPED overlapped;
+            memset(&overlapped, 0, sizeof(overlapped));
+            DWORD written = 0;
+            if (!WriteFile(h_header, header, (DWORD)header_size, &written, &overlapped) || written != header_size) {
+                ret |= AUO_RESULT_ERROR;
+            }
+            CloseHandle(h_header);
+        }
+    }
+    return ret;
+}
@@ -0,0 +1,82 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#ifndef _AUO_WAVWRITER_H_
+#define _AUO_WAVWRITER_H_
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <cstdint>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include "auo.h"
+
+//wavファイルをキャッシュを介さずに書き出す
+//  - 出力サイズが分かっている場合は事前に領域を確保し、断片化を防ぐ
+//  - 2つのバッファを交互に使い、書き込みは別スレッドで行う
+//  - ヘッダは最後に位置を指定して書き直す
+class AuoWavWriter {
+public:
+    AuoWavWriter();
+    ~AuoWavWriter();
+
+    AUO_RESULT open(const char *filename, uint64_t expected_size);
+    size_t write(const void *buf, size_t size);
+    //残りのデータを書き出してファイルを閉じる
+    //headerが指定されていれば、ファイルの先頭に上書きする
+    AUO_RESULT close(const void *header, size_t header_size);
+    uint64_t size() const { return total_size; }
+private:
+    void thread_func();
+    bool write_block(const uint8_t *data, size_t size);
+    void submit(int idx, size_t len);
+    void wait_buffer_free(int idx);
+
+    char filename[MAX_PATH_LEN];
+    HANDLE h_file;
+    size_t align;      //セクタサイズ
+    size_t buf_size;
+    uint8_t *buf[2];
+    int buf_idx;       //書き込み中のバッファ
+    size_t buf_len;
+    uint64_t file_pos; //書き出しスレッドの書き込み位置
+    uint64_t total_size;
+
+    std::thread th_write;
+    std::mutex mtx;
+    std::condition_variable cond;
+    int queued_idx;    //書き出し待ちのバッファ (-1なら無し)
+    size_t queued_len;
+    int writing_idx;   //書き出し中のバッファ (-1なら無し)
+    bool fin;
+    std::atomic<bool> error; //書き出しスレッドで設定し、write/closeでロックなしに参照する
+};
+
+#endif //_AUO_WAVWRITER_H_
@@ -32,6 +32,7 @@
 
 #include "convert.h"
 #include "convert_const.h"
+#include "convert_tmpl.h"
 
 #ifndef clamp
 #define clamp(x, low, high) (((x) <= (high)) ? (((x) >= (low)) ? (x) : (low)) : (high))
@@ -162,14 +163,6 @@ void convert_rgb_to_yuv444_base(void *frame, CONVERT_CF_DATA *pixel_data, const
     BYTE *ptrY = pixel_data->data[0];
     BYTE *ptrU = pixel_data->data[1];
     BYTE *ptrV = pixel_data->data[2];
-    const float COEFF_RGB2YUV[2][9] = {
-        { 0.299f,     0.587f,   0.114f,
-         -0.168736f, -0.331264f,  0.5f,
-          0.5f,      -0.418688f, -0.081312f },
-        { 0.2126f,    0.7152f,    0.0722f,
-         -0.114572f, -0.385427f,  0.5f,
-          0.5f,      -0.453596f, -0.045977f }
-    };
     const float *coeff_table = COEFF_RGB2YUV[pixel_data->colormatrix ? 1 : 0];
     int y0 = 0, y1 = height - 1;
     const int srcstep = (width*3 + 3) & ~3;
@@ -319,6 +312,89 @@ void copy_rgba_sse2(void* frame, CONVERT_CF_DATA* pixel_data, const int width, c
         *dst = *src;
 }
 
+template<typename TypeOut, int out_bit_depth, bool unpremultiply>
+static void convert_rgba_to_yuva420_base(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    BYTE *ptrY = pixel_data->data[0];
+    BYTE *ptrU = pixel_data->data[1];
+    BYTE *ptrV = pixel_data->data[2];
+    BYTE *ptrA = pixel_data->data[3];
+    const float *coeff_table = COEFF_RGB2YUV[pixel_data->colormatrix ? 1 : 0];
+    const int srcstep = width * 4;
+    //入力は下から上へ並んでいるので、2行ずつ上下反転しながら処理する
+    for (int y0 = 0; y0 < height; y0 += 2) {
+        const int y1 = height - 1 - y0;
+        TypeOut *dstY0 = (TypeOut *)(ptrY + y1*width*sizeof(TypeOut));
+        TypeOut *dstY1 = (TypeOut *)(ptrY + (y1-1)*width*sizeof(TypeOut));
+        TypeOut *dstA0 = (TypeOut *)(ptrA + y1*width*sizeof(TypeOut));
+        TypeOut *dstA1 = (TypeOut *)(ptrA + (y1-1)*width*sizeof(TypeOut));
+        TypeOut *dstU  = (TypeOut *)(ptrU + ((y1-1)>>1)*(width>>1)*sizeof(TypeOut));
+        TypeOut *dstV  = (TypeOut *)(ptrV + ((y1-1)>>1)*(width>>1)*sizeof(TypeOut));
+        BYTE *src0 = (BYTE*)frame + y0*srcstep;
+        BYTE *src1 = src0 + srcstep;
+        for (int x = 0; x < width; x += 2) {
+            convert_rgba_to_yuva420_2x2<TypeOut, out_bit_depth, unpremultiply>(dstY0, dstY1, dstU, dstV, dstA0, dstA1, src0, src1, x, coeff_table);
+        }
+    }
+}
+
+template<typename TypeOut, int out_bit_depth, bool unpremultiply>
+static void convert_rgba_to_yuva444_base(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    BYTE *ptrY = pixel_data->data[0];
+    BYTE *ptrU = pixel_data->data[1];
+    BYTE *ptrV = pixel_data->data[2];
+    BYTE *ptrA = pixel_data->data[3];
+    const float *coeff_table = COEFF_RGB2YUV[pixel_data->colormatrix ? 1 : 0];
+    int y0 = 0, y1 = height - 1;
+    const int srcstep = width * 4;
+    for (; y0 < height; y0++, y1--) {
+        TypeOut *dstY = (TypeOut *)(ptrY + y1*width*sizeof(TypeOut));
+        TypeOut *dstU = (TypeOut *)(ptrU + y1*width*sizeof(TypeOut));
+        TypeOut *dstV = (TypeOut *)(ptrV + y1*width*sizeof(TypeOut));
+        TypeOut *dstA = (TypeOut *)(ptrA + y1*width*sizeof(TypeOut));
+        BYTE *src = (BYTE*)frame + y0*srcstep;
+        for (int x = 0; x < width; x++) {
+            convert_rgba_to_yuva444_1px<TypeOut, out_bit_depth, unpremultiply>(dstY, dstU, dstV, dstA, src, x, coeff_table);
+        }
+    }
+}
+
+void convert_rgba_to_yuva420(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva420_base<BYTE, 8, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva420_base<BYTE, 8, false>(frame, pixel_data, width, height);
+}
+void convert_rgba_to_yuva420_10bit(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva420_base<USHORT, 10, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva420_base<USHORT, 10, false>(frame, pixel_data, width, height);
+}
+void convert_rgba_to_yuva420_16bit(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva420_base<USHORT, 16, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva420_base<USHORT, 16, false>(frame, pixel_data, width, height);
+}
+void convert_rgba_to_yuva444(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva444_base<BYTE, 8, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva444_base<BYTE, 8, false>(frame, pixel_data, width, height);
+}
+void convert_rgba_to_yuva444_10bit(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva444_base<USHORT, 10, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva444_base<USHORT, 10, false>(frame, pixel_data, width, height);
+}
+void convert_rgba_to_yuva444_16bit(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva444_base<USHORT, 16, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva444_base<USHORT, 16, false>(frame, pixel_data, width, height);
+}
+
 void convert_yuy2_to_yv12(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
     int x, y;
     BYTE *Y  = pixel_data->data[0];
@@ -608,6 +684,233 @@ void convert_yc48_to_yuv444_16bit(void *pixel, CONVERT_CF_DATA *pixel_data, cons
     }
 }
 
+//縮小 (面積平均) しながら変換する
+//出力の色差1組 (輝度2x2) ごとに、入力の (ratio*2)x(ratio*2) 画素をまとめて処理する
+static inline int yuy2_sum_y(const BYTE *p, int pitch, int x, int nx, int ny) {
+    int sum = 0;
+    for (int j = 0; j < ny; j++, p += pitch)
+        for (int i = 0; i < nx; i++)
+            sum += p[(x + i) * 2];
+    return sum;
+}
+static inline int yuy2_sum_c(const BYTE *p, int pitch, int x, int nx, int ny, int offset) {
+    int sum = 0;
+    for (int j = 0; j < ny; j++, p += pitch)
+        for (int i = 0; i < nx; i += 2)
+            sum += p[(x + i) * 2 + offset];
+    return sum;
+}
+template<int ratio>
+static void convert_yuy2_to_nv12_shrink(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    const int RSH_Y = (ratio == 2) ? 2 : 4; //ratio*ratio画素の平均
+    const int RSH_C = RSH_Y + 1;            //色差は横方向が半分なので、ratio*ratio*2個の平均
+    const int out_w = width / ratio;
+    const int pitch = width * 2;
+    for (int y = 0; y < height; y += ratio * 2) {
+        const BYTE *p = (BYTE *)frame + y * pitch;
+        BYTE *Y0 = pixel_data->data[0] + (y / ratio) * out_w;
+        BYTE *Y1 = Y0 + out_w;
+        BYTE *C  = pixel_data->data[1] + (y / ratio / 2) * out_w;
+        for (int x = 0; x < width; x += ratio * 2) {
+            const int ox = x / ratio;
+            Y0[ox    ] = (BYTE)((yuy2_sum_y(p,                 pitch, x,         ratio, ratio) + (1 << (RSH_Y - 1))) >> RSH_Y);
+            Y0[ox + 1] = (BYTE)((yuy2_sum_y(p,                 pitch, x + ratio, ratio, ratio) + (1 << (RSH_Y - 1))) >> RSH_Y);
+            Y1[ox    ] = (BYTE)((yuy2_sum_y(p + pitch * ratio, pitch, x,         ratio, ratio) + (1 << (RSH_Y - 1))) >> RSH_Y);
+            Y1[ox + 1] = (BYTE)((yuy2_sum_y(p + pitch * ratio, pitch, x + ratio, ratio, ratio) + (1 << (RSH_Y - 1))) >> RSH_Y);
+            C[ox    ] = (BYTE)((yuy2_sum_c(p, pitch, x, ratio * 2, ratio * 2, 1) + (1 << (RSH_C - 1))) >> RSH_C);
+            C[ox + 1] = (BYTE)((yuy2_sum_c(p, pitch, x, ratio * 2, ratio * 2, 3) + (1 << (RSH_C - 1))) >> RSH_C);
+        }
+    }
+}
+void convert_yuy2_to_nv12_half(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yuy2_to_nv12_shrink<2>(frame, pixel_data, width, height);
+}
+void convert_yuy2_to_nv12_quarter(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yuy2_to_nv12_shrink<4>(frame, pixel_data, width, height);
+}
+
+//YC48は平均をとってから変換する
+//色差は縮小しない場合 (convert_yc48_to_nv12_16bit) の縦2画素の和に合わせてから変換する
+static inline int yc48_sum(const PIXEL_YC *ycp, int width, int nx, int ny, int offset) {
+    int sum = 0;
+    for (int j = 0; j < ny; j++, ycp += width)
+        for (int i = 0; i < nx; i++)
+            sum += ((const short *)(ycp + i))[offset];
+    return sum;
+}
+template<int ratio>
+static void convert_yc48_to_nv12_16bit_shrink(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    const int RSH_Y = (ratio == 2) ? 2 : 4; //ratio*ratio画素の平均
+    const int RSH_C = RSH_Y + 1;            //(ratio*2)*(ratio*2)画素 -> 2画素分の和
+    const int out_w = width / ratio;
+    for (int y = 0; y < height; y += ratio * 2) {
+        const PIXEL_YC *ycp = (PIXEL_YC *)pixel + y * width;
+        short *Y0 = (short *)pixel_data->data[0] + (y / ratio) * out_w;
+        short *Y1 = Y0 + out_w;
+        short *C  = (short *)pixel_data->data[1] + (y / ratio / 2) * out_w;
+        for (int x = 0; x < width; x += ratio * 2, ycp += ratio * 2) {
+            const int ox = x / ratio;
+            Y0[ox    ] = (short)pixel_YC48_to_YUV((yc48_sum(ycp,                 width, ratio, ratio, 0) + (1 << (RSH_Y - 1))) >> RSH_Y, Y_L_MUL, Y_L_ADD_16, Y_L_RSH_16, Y_L_YCC_16, 0, LIMIT_16);
+            Y0[ox + 1] = (short)pixel_YC48_to_YUV((yc48_sum(ycp + ratio,         width, ratio, ratio, 0) + (1 << (RSH_Y - 1))) >> RSH_Y, Y_L_MUL, Y_L_ADD_16, Y_L_RSH_16, Y_L_YCC_16, 0, LIMIT_16);
+            Y1[ox    ] = (short)pixel_YC48_to_YUV((yc48_sum(ycp + width * ratio, width, ratio, ratio, 0) + (1 << (RSH_Y - 1))) >> RSH_Y, Y_L_MUL, Y_L_ADD_16, Y_L_RSH_16, Y_L_YCC_16, 0, LIMIT_16);
+            Y1[ox + 1] = (short)pixel_YC48_to_YUV((yc48_sum(ycp + width * ratio + ratio, width, ratio, ratio, 0) + (1 << (RSH_Y - 1))) >> RSH_Y, Y_L_MUL, Y_L_ADD_16, Y_L_RSH_16, Y_L_YCC_16, 0, LIMIT_16);
+            C[ox    ] = (short)pixel_YC48_to_YUV(((yc48_sum(ycp, width, ratio * 2, ratio * 2, 1) + (1 << (RSH_C - 1))) >> RSH_C) + UV_OFFSET_x2, UV_L_MUL, Y_L_ADD_16, UV_L_RSH_16_420P, Y_L_YCC_16, 0, LIMIT_16);
+            C[ox + 1] = (short)pixel_YC48_to_YUV(((yc48_sum(ycp, width, ratio * 2, ratio * 2, 2) + (1 << (RSH_C - 1))) >> RSH_C) + UV_OFFSET_x2, UV_L_MUL, Y_L_ADD_16, UV_L_RSH_16_420P, Y_L_YCC_16, 0, LIMIT_16);
+        }
+    }
+}
+void convert_yc48_to_nv12_16bit_half(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_16bit_shrink<2>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_nv12_16bit_quarter(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_16bit_shrink<4>(pixel, pixel_data, width, height);
+}
+
+//16bit値 -> 8bit (組織的ディザ)
+static inline BYTE pixel_16to8_ordered_dither(int x16, int threshold) {
+    return (BYTE)clamp((x16 + threshold) >> 8, 0, LIMIT_8);
+}
+//16bit値 -> 8bit (簡易誤差拡散)
+//14bit精度で計算し、上の行の誤差を 1:2:1 の重みで受け取る (どの行から受け取るかはconvert.hを参照)
+//誤差は-32～32(=±0.5)に制限し、白飛び・黒つぶれの部分で誤差がたまらないようにする
+static inline BYTE pixel_16to8_err_diffusion(int x16, short *err_cur, const short *err_prev, int x, int step) {
+    const int t = (x16 >> 2) + ((err_prev[x - step] + err_prev[x] * 2 + err_prev[x + step] + 2) >> 2);
+    const int q = clamp((t + 32) >> 6, 0, LIMIT_8);
+    err_cur[x] = (short)clamp(t - (q << 6), -32, 32);
+    return (BYTE)q;
+}
+template<int dither>
+static inline BYTE pixel_16to8_dither(int x16, int x, const USHORT *threshold, short *err_cur, const short *err_prev, int step) {
+    if (dither == DITHER_ORDERED) {
+        return pixel_16to8_ordered_dither(x16, threshold[x & 7]);
+    }
+    return pixel_16to8_err_diffusion(x16, err_cur, err_prev, x, step);
+}
+
+template<int dither>
+static void convert_yc48_to_nv12_dither(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    int x = 0, y = 0, i = 0;
+    PIXEL_YC *ycp;
+    BYTE *dst_Y = pixel_data->data[0];
+    BYTE *dst_C = pixel_data->data[1];
+    BYTE *Y = NULL, *C = NULL;
+    short *eY0 = NULL, *eY1 = NULL, *eC = NULL;
+    const short *eY0p = NULL, *eY1p = NULL, *eCp = NULL;
+    if (dither == DITHER_ERROR_DIFFUSION)
+        memset(pixel_data->dither_err, 0, get_dither_err_buf_size(width));
+    for (y = 0; y < height; y += 2) {
+        i = width * y;
+        ycp = (PIXEL_YC *)pixel + i;
+        Y = dst_Y + i;
+        C = dst_C + i / 2;
+        const USHORT *thY0 = Array_DITHER_ORDERED[0][(y + 0) & 7];
+        const USHORT *thY1 = Array_DITHER_ORDERED[0][(y + 1) & 7];
+        const USHORT *thC  = Array_DITHER_ORDERED[1][(y >> 1) & 7];
+        if (dither == DITHER_ERROR_DIFFUSION) {
+            eY0 = get_dither_err_line(pixel_data, width, 0, y);     eY0p = get_dither_err_line(pixel_data, width, 0, y - 2);
+            eY1 = get_dither_err_line(pixel_data, width, 0, y + 1); eY1p = get_dither_err_line(pixel_data, width, 0, y - 1);
+            eC  = get_dither_err_line(pixel_data, width, 1, y >> 1); eCp = get_dither_err_line(pixel_data, width, 1, (y >> 1) - 2);
+        }
+        for (x = 0; x < width; x += 2) {
+            Y[x        ] = pixel_16to8_dither<dither>(pixel_YC48_to_YUV(ycp[x        ].y, Y_L_MUL, Y_L_ADD_16, Y_L_RSH_16, Y_L_YCC_16, 0, LIMIT_16), x,   thY0, eY0, eY0p, 1);
+            Y[x+1      ] = pixel_16to8_dither<dither>(pixel_YC48_to_YUV(ycp[x+1      ].y, Y_L_MUL, Y_L_ADD_16, Y_L_RSH_16, Y_L_YCC_16, 0, LIMIT_16), x+1, thY0, eY0, eY0p, 1);
+            Y[x  +width] = pixel_16to8_dither<dither>(pixel_YC48_to_YUV(ycp[x  +width].y, Y_L_MUL, Y_L_ADD_16, Y_L_RSH_16, Y_L_YCC_16, 0, LIMIT_16), x,   thY1, eY1, eY1p, 1);
+            Y[x+1+width] = pixel_16to8_dither<dither>(pixel_YC48_to_YUV(ycp[x+1+width].y, Y_L_MUL, Y_L_ADD_16, Y_L_RSH_16, Y_L_YCC_16, 0, LIMIT_16), x+1, thY1, eY1, eY1p, 1);
+            C[x  ] = pixel_16to8_dither<dither>(pixel_YC48_to_YUV(((int)ycp[x].cb + (int)ycp[x+width].cb) + UV_OFFSET_x2, UV_L_MUL, Y_L_ADD_16, UV_L_RSH_16_420P, Y_L_YCC_16, 0, LIMIT_16), x,   thC, eC, eCp, 2);
+            C[x+1] = pixel_16to8_dither<dither>(pixel_YC48_to_YUV(((int)ycp[x].cr + (int)ycp[x+width].cr) + UV_OFFSET_x2, UV_L_MUL, Y_L_ADD_16, UV_L_RSH_16_420P, Y_L_YCC_16, 0, LIMIT_16), x+1, thC, eC, eCp, 2);
+        }
+    }
+}
+template<int dither>
+static void convert_yc48_to_nv12_i_dither(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    int x = 0, y = 0, i = 0, j = 0;
+    PIXEL_YC *ycp = NULL;
+    BYTE *dst_Y = pixel_data->data[0];
+    BYTE *dst_C = pixel_data->data[1];
+    BYTE *Y = NULL, *C = NULL;
+    short *eY[4] = { 0 }, *eC[2] = { 0 };
+    const short *eYp[4] = { 0 }, *eCp[2] = { 0 };
+    const USHORT *thY[4], *thC[2];
+    if (dither == DITHER_ERROR_DIFFUSION)
+        memset(pixel_data->dither_err, 0, get_dither_err_buf_size(width));
+    for (y = 0; y < height; y += 4) {
+        i = width * y;
+        ycp = (PIXEL_YC *)pixel + i;
+        Y = dst_Y + i;
+        C = dst_C + (i>>1);
+        for (j = 0; j < 4; j++) {
+            thY[j] = Array_DITHER_ORDERED[0][(y + j) & 7];
+            if (dither == DITHER_ERROR_DIFFUSION) {
+                eY[j]  = get_dither_err_line(pixel_data, width, 0, y + j);
+                eYp[j] = get_dither_err_line(pixel_data, width, 0, y + j - 4);
+            }
+        }
+        for (j = 0; j < 2; j++) {
+            thC[j] = Array_DITHER_ORDERED[1][((y >> 1) + j) & 7];
+            if (dither == DITHER_ERROR_DIFFUSION) {
+                eC[j]  = get_dither_err_line(pixel_data, width, 1, (y >> 1) + j);
+                eCp[j] = get_dither_err_line(pixel_data, width, 1, (y >> 1) + j - 2);
+            }
+        }
+        for (x = 0; x < width; x += 2) {
+            for (j = 0; j < 4; j++) {
+                Y[x  +width*j] = pixel_16to8_dither<dither>(pixel_YC48_to_YUV(ycp[x  +width*j].y, Y_L_MUL, Y_L_ADD_16, Y_L_RSH_16, Y_L_YCC_16, 0, LIMIT_16), x,   thY[j], eY[j], eYp[j], 1);
+                Y[x+1+width*j] = pixel_16to8_dither<dither>(pixel_YC48_to_YUV(ycp[x+1+width*j].y, Y_L_MUL, Y_L_ADD_16, Y_L_RSH_16, Y_L_YCC_16, 0, LIMIT_16), x+1, thY[j], eY[j], eYp[j], 1);
+            }
+            C[x        ] = pixel_16to8_dither<dither>(pixel_YC48_to_YUV(((int)ycp[x      ].cb * 3 + (int)ycp[x+width*2].cb * 1) + UV_OFFSET_x4, UV_L_MUL, Y_L_ADD_16, UV_L_RSH_16_420I, UV_L_YCC_16, 0, LIMIT_16), x,   thC[0], eC[0], eCp[0], 2);
+            C[x+1      ] = pixel_16to8_dither<dither>(pixel_YC48_to_YUV(((int)ycp[x      ].cr * 3 + (int)ycp[x+width*2].cr * 1) + UV_OFFSET_x4, UV_L_MUL, Y_L_ADD_16, UV_L_RSH_16_420I, UV_L_YCC_16, 0, LIMIT_16), x+1, thC[0], eC[0], eCp[0], 2);
+            C[x  +width] = pixel_16to8_dither<dither>(pixel_YC48_to_YUV(((int)ycp[x+width].cb * 1 + (int)ycp[x+width*3].cb * 3) + UV_OFFSET_x4, UV_L_MUL, Y_L_ADD_16, UV_L_RSH_16_420I, UV_L_YCC_16, 0, LIMIT_16), x,   thC[1], eC[1], eCp[1], 2);
+            C[x+1+width] = pixel_16to8_dither<dither>(pixel_YC48_to_YUV(((int)ycp[x+width].cr * 1 + (int)ycp[x+width*3].cr * 3) + UV_OFFSET_x4, UV_L_MUL, Y_L_ADD_16, UV_L_RSH_16_420I, UV_L_YCC_16, 0, LIMIT_16), x+1, thC[1], eC[1], eCp[1], 2);
+        }
+    }
+}
+template<int dither>
+static void convert_yc48_to_yuv444_dither(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    short *e[3] = { 0 };
+    const short *ep[3] = { 0 };
+    if (dither == DITHER_ERROR_DIFFUSION)
+        memset(pixel_data->dither_err, 0, get_dither_err_buf_size(width));
+    for (int y = 0; y < height; y++) {
+        PIXEL_YC *ycp = (PIXEL_YC *)pixel + width * y;
+        BYTE *Y = pixel_data->data[0] + width * y;
+        BYTE *U = pixel_data->data[1] + width * y;
+        BYTE *V = pixel_data->data[2] + width * y;
+        const USHORT *thY = Array_DITHER_ORDERED[0][y & 7];
+        const USHORT *thU = Array_DITHER_ORDERED[1][y & 7];
+        const USHORT *thV = Array_DITHER_ORDERED[2][y & 7];
+        if (dither == DITHER_ERROR_DIFFUSION) {
+            for (int j = 0; j < 3; j++) {
+                e[j]  = get_dither_err_line(pixel_data, width, j, y);
+                ep[j] = get_dither_err_line(pixel_data, width, j, y - 2);
+            }
+        }
+        for (int x = 0; x < width; x++) {
+            Y[x] = pixel_16to8_dither<dither>(pixel_YC48_to_YUV(ycp[x].y,                  Y_L_MUL,  Y_L_ADD_16,      Y_L_RSH_16,      Y_L_YCC_16, 0, LIMIT_16), x, thY, e[0], ep[0], 1);
+            U[x] = pixel_16to8_dither<dither>(pixel_YC48_to_YUV(ycp[x].cb + UV_OFFSET_x1, UV_L_MUL, UV_L_ADD_16_444, UV_L_RSH_16_444, UV_L_YCC_16, 0, LIMIT_16), x, thU, e[1], ep[1], 1);
+            V[x] = pixel_16to8_dither<dither>(pixel_YC48_to_YUV(ycp[x].cr + UV_OFFSET_x1, UV_L_MUL, UV_L_ADD_16_444, UV_L_RSH_16_444, UV_L_YCC_16, 0, LIMIT_16), x, thV, e[2], ep[2], 1);
+        }
+    }
+}
+
+void convert_yc48_to_nv12_ordered_dither(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_dither<DITHER_ORDERED>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_nv12_i_ordered_dither(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_i_dither<DITHER_ORDERED>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_yuv444_ordered_dither(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_yuv444_dither<DITHER_ORDERED>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_nv12_err_diffusion(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_dither<DITHER_ERROR_DIFFUSION>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_nv12_i_err_diffusion(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_i_dither<DITHER_ERROR_DIFFUSION>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_yuv444_err_diffusion(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_yuv444_dither<DITHER_ERROR_DIFFUSION>(pixel, pixel_data, width, height);
+}
+
 void convert_yuy2_to_nv16(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
     BYTE *dst_Y = pixel_data->data[0];
     BYTE *dst_C = pixel_data->data[1];
@@ -782,3 +1085,58 @@ void convert_lw48_to_yuv444_16bit(void *pixel, CONVERT_CF_DATA *pixel_data, cons
         dst_V[i] = ycp[i].cr;
     }
 }
+
+void convert_yc48_to_p012(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_P012::run<CONV_SIMD_C>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_p012_i(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_P012_I::run<CONV_SIMD_C>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_yuv444_12bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_YUV444_12::run<CONV_SIMD_C>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_p210(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_P210::run<CONV_SIMD_C>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_y210(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_Y210::run<CONV_SIMD_C>(pixel, pixel_data, width, height);
+}
+void convert_yuy2_to_p012(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_P012::run<CONV_SIMD_C>(pixel, pixel_data, width, height);
+}
+void convert_yuy2_to_p012_i(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_P012_I::run<CONV_SIMD_C>(pixel, pixel_data, width, height);
+}
+void convert_yuy2_to_yuv444_12bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_YUV444_12::run<CONV_SIMD_C>(pixel, pixel_data, width, height);
+}
+void convert_yuy2_to_p210(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_P210::run<CONV_SIMD_C>(pixel, pixel_data, width, height);
+}
+void convert_yuy2_to_y210(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_Y210::run<CONV_SIMD_C>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_yuv420_10bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_YUV420_10::run<CONV_SIMD_C>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_yuv420_i_10bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_YUV420_10_I::run<CONV_SIMD_C>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_yuv420_16bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_YUV420_16::run<CONV_SIMD_C>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_yuv420_i_16bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_YUV420_16_I::run<CONV_SIMD_C>(pixel, pixel_data, width, height);
+}
+void convert_yuy2_to_yuv420_10bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_YUV420_10::run<CONV_SIMD_C>(pixel, pixel_data, width, height);
+}
+void convert_yuy2_to_yuv420_i_10bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_YUV420_10_I::run<CONV_SIMD_C>(pixel, pixel_data, width, height);
+}
+void convert_yuy2_to_yuv420_16bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_YUV420_16::run<CONV_SIMD_C>(pixel, pixel_data, width, height);
+}
+void convert_yuy2_to_yuv420_i_16bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_YUV420_16_I::run<CONV_SIMD_C>(pixel, pixel_data, width, height);
+}
@@ -44,18 +44,45 @@ typedef struct {
     USHORT y, cb, cr;
 } PIXEL_LW48;
 
+//8bit出力時のディザ
+enum {
+    DITHER_NONE            = 0, //ディザなし (YUY2で受け取るので切り捨てになる)
+    DITHER_ORDERED         = 1, //組織的ディザ (Bayer 8x8)
+    DITHER_ERROR_DIFFUSION = 2, //簡易誤差拡散 (上の行の誤差のみを拡散するので、行内は並列に処理できる)
+};
+
 typedef struct {
     int   count;       //planarの枚数。packedなら1
-    BYTE *data[3];     //planarの先頭へのポインタ
-    int   size[3];     //planarのサイズ
+    BYTE *data[4];     //planarの先頭へのポインタ (YUVAではアルファが4枚目)
+    int   size[4];     //planarのサイズ
 #if ENCODER_X265
     int   w[3], h[3], pitch[3];
     int byte_per_pixel;
 #endif
     int   total_size;  //全planarのサイズの総和
     int   colormatrix; //色空間 (BT601 / BT709)
+    int   numa_node;   //バッファを確保したNUMAノード (-1なら指定なし)
+    int   dither;      //8bit出力時のディザ (DITHER_xxx)
+    short *dither_err; //誤差拡散用の誤差バッファ (DITHER_ERROR_DIFFUSION時のみ確保)
+    int   unpremultiply; //RGBA -> YUVA変換時に乗算済みアルファを元に戻す
 } CONVERT_CF_DATA;
 
+//誤差拡散用の誤差バッファ
+//plane(3) x 8行を持ち、y行目の誤差は(y & 7)行目に書く
+//誤差は2行上から受け取る (同時に処理する2行が互いに依存しないようにするため)
+//インタレースの輝度は同じフィールドの行を同時に処理するので、4行上から受け取る
+//左右の余白は隣接画素の参照とSIMDのはみ出し書き込み用
+static const int DITHER_ERR_PAD = 64;
+static inline int get_dither_err_pitch(int width) {
+    return (width + DITHER_ERR_PAD * 2 + 31) & ~31;
+}
+static inline size_t get_dither_err_buf_size(int width) {
+    return sizeof(short) * get_dither_err_pitch(width) * 3 * 8;
+}
+static inline short *get_dither_err_line(const CONVERT_CF_DATA *pixel_data, int width, int plane, int y) {
+    return pixel_data->dither_err + get_dither_err_pitch(width) * (plane * 8 + (y & 7)) + DITHER_ERR_PAD;
+}
+
 
 //音声16bit->8bit変換
 typedef void (*func_audio_16to8) (BYTE *dst, short *src, int n);
@@ -79,16 +106,54 @@ void copy_yuy2_sse2(void *frame, CONVERT_CF_DATA *pixel_data, const int width, c
 
 void copy_rgb(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 void copy_rgb_sse2(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void copy_rgb_avx512bw(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 void sort_to_rgb(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 void sort_to_rgb_ssse3(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void sort_to_rgb_avx512bw(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void sort_to_rgb_avx512vbmi(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 
 void copy_rgba(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
 void copy_rgba_sse2(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void copy_rgba_avx512bw(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
 
 void convert_rgb_to_yuv444(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
 void convert_rgb_to_yuv444_16bit(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
 void convert_rgb_to_yuv444_avx2(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
 void convert_rgb_to_yuv444_16bit_avx2(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgb_to_yuv444_sse41(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgb_to_yuv444_16bit_sse41(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgb_to_yuv444_avx(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgb_to_yuv444_16bit_avx(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgb_to_yuv444_avx512bw(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgb_to_yuv444_avx512vbmi(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgb_to_yuv444_16bit_avx512bw(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgb_to_yuv444_16bit_avx512vbmi(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+
+//RGBA (拡張編集) -> YUVA420/YUVA444
+void convert_rgba_to_yuva420(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva420_10bit(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva420_16bit(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva444(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva444_10bit(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva444_16bit(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva420_sse41(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva420_10bit_sse41(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva420_16bit_sse41(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva444_sse41(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva444_10bit_sse41(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva444_16bit_sse41(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva420_avx(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva420_10bit_avx(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva420_16bit_avx(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva444_avx(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva444_10bit_avx(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva444_16bit_avx(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva420_avx2(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva420_10bit_avx2(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva420_16bit_avx2(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva444_avx2(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva444_10bit_avx2(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
+void convert_rgba_to_yuva444_16bit_avx2(void* frame, CONVERT_CF_DATA* pixel_data, const int width, const int height);
 
 //YUY2 -> nv12 (8bit)
 void convert_yuy2_to_nv12(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height);
@@ -260,19 +325,37 @@ void convert_yuy2_to_nv16_sse2(void *pixel, CONVERT_CF_DATA *pixel_data, const i
 void convert_yuy2_to_nv16_sse2_mod16(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 void convert_yuy2_to_nv16_avx(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 void convert_yuy2_to_nv16_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_nv16_avx512bw(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_nv16_avx512vbmi(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_nv16_avx512bw_mod64(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_nv16_avx512vbmi_mod64(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 
 //YUY2 -> nv16 (16bit)
 void convert_yuy2_to_nv16_16bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_nv16_16bit_avx512bw(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_nv16_16bit_avx512bw_mod32(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 
 //YUY2 -> yuv422
 void convert_yuy2_to_yuv422_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv422_avx512bw(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv422_avx512vbmi(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv422_avx512bw_mod64(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv422_avx512vbmi_mod64(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 void convert_yuy2_to_yuv422(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 
 //YUY2 -> yuv422 (16bit)
 void convert_yuy2_to_yuv422_16bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv422_16bit_avx512bw(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv422_16bit_avx512vbmi(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv422_16bit_avx512bw_mod64(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv422_16bit_avx512vbmi_mod64(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 
 //YC48 -> yuv422
 void convert_yc48_to_yuv422_16bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv422_16bit_avx512bw(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv422_16bit_avx512vbmi(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv422_16bit_avx512bw_mod64(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv422_16bit_avx512vbmi_mod64(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 
 //YC48 -> nv16 (16bit)
 void convert_yc48_to_nv16_16bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
@@ -285,6 +368,10 @@ void convert_yc48_to_nv16_16bit_sse41(void *pixel, CONVERT_CF_DATA *pixel_data,
 void convert_yc48_to_nv16_16bit_sse41_mod8(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 void convert_yc48_to_nv16_16bit_avx(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 void convert_yc48_to_nv16_16bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv16_16bit_avx512bw(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv16_16bit_avx512vbmi(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv16_16bit_avx512bw_mod32(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv16_16bit_avx512vbmi_mod32(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 
 
 
@@ -301,6 +388,46 @@ void convert_yc48_to_yuv444_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const
 void convert_yc48_to_yuv444_avx512bw(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 void convert_yc48_to_yuv444_avx512vbmi(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 
+//YC48 -> nv12/yuv444 (8bit, ディザあり)
+void convert_yc48_to_nv12_ordered_dither(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_i_ordered_dither(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv444_ordered_dither(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_err_diffusion(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_i_err_diffusion(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv444_err_diffusion(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+
+void convert_yc48_to_nv12_ordered_dither_sse2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_i_ordered_dither_sse2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv444_ordered_dither_sse2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_err_diffusion_sse2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_i_err_diffusion_sse2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv444_err_diffusion_sse2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_ordered_dither_ssse3(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_i_ordered_dither_ssse3(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv444_ordered_dither_ssse3(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_err_diffusion_ssse3(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_i_err_diffusion_ssse3(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv444_err_diffusion_ssse3(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_ordered_dither_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_i_ordered_dither_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv444_ordered_dither_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_err_diffusion_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_i_err_diffusion_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv444_err_diffusion_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+
+void convert_yc48_to_nv12_ordered_dither_avx(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_i_ordered_dither_avx(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv444_ordered_dither_avx(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_err_diffusion_avx(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_i_err_diffusion_avx(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv444_err_diffusion_avx(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_ordered_dither_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_i_ordered_dither_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv444_ordered_dither_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_err_diffusion_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_i_err_diffusion_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv444_err_diffusion_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+
 
 //YC48 -> yuv444 (10bit)
 void convert_yc48_to_yuv444_10bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
@@ -316,6 +443,64 @@ void convert_yc48_to_yuv444_16bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data,
 void convert_yc48_to_yuv444_16bit_avx512bw(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 void convert_yc48_to_yuv444_16bit_avx512vbmi(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 
+//YC48/YUY2 -> p012 / yuv444p12 / p210 / y210, yuv420p10le / yuv420p16le (convert_tmpl.hから生成)
+void convert_yc48_to_p012(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_p012_i(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv444_12bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_p210(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_y210(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_p012(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_p012_i(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv444_12bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_p210(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_y210(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv420_10bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv420_i_10bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv420_16bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv420_i_16bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv420_10bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv420_i_10bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv420_16bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv420_i_16bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+
+void convert_yc48_to_p012_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_p012_i_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv444_12bit_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_p210_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_y210_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_p012_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_p012_i_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv444_12bit_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_p210_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_y210_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv420_10bit_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv420_i_10bit_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv420_16bit_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv420_i_16bit_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv420_10bit_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv420_i_10bit_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv420_16bit_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv420_i_16bit_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+
+void convert_yc48_to_p012_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_p012_i_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv444_12bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_p210_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_y210_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_p012_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_p012_i_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv444_12bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_p210_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_y210_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv420_10bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv420_i_10bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv420_16bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_yuv420_i_16bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv420_10bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv420_i_10bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv420_16bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_yuv420_i_16bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+
 
 
 
@@ -350,6 +535,10 @@ void convert_lw48_to_nv12_i_16bit_avx512vbmi(void *pixel, CONVERT_CF_DATA *pixel
 
 void convert_lw48_to_nv16(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 void convert_lw48_to_nv16_16bit(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_lw48_to_nv16_avx512bw(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_lw48_to_nv16_avx512vbmi(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_lw48_to_nv16_avx512bw_mod64(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_lw48_to_nv16_avx512vbmi_mod64(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 
 void convert_lw48_to_nv16_16bit_sse2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 void convert_lw48_to_nv16_16bit_sse2_mod8(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
@@ -359,6 +548,10 @@ void convert_lw48_to_nv16_16bit_sse41(void *pixel, CONVERT_CF_DATA *pixel_data,
 void convert_lw48_to_nv16_16bit_sse41_mod8(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 void convert_lw48_to_nv16_16bit_avx(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 void convert_lw48_to_nv16_16bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_lw48_to_nv16_16bit_avx512bw(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_lw48_to_nv16_16bit_avx512vbmi(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_lw48_to_nv16_16bit_avx512bw_mod32(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_lw48_to_nv16_16bit_avx512vbmi_mod32(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 
 
 void convert_lw48_to_yuv444(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
@@ -387,4 +580,63 @@ void convert_lw48_to_yuv444_16bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data,
 void convert_lw48_to_yuv444_16bit_avx512bw(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 void convert_lw48_to_yuv444_16bit_avx512vbmi(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
 
+//縮小しながら変換 (面積平均、プログレッシブのみ)
+//width, heightは入力の解像度で、pixel_dataには1/2 (half) または 1/4 (quarter) の解像度で書き込む
+void convert_yuy2_to_nv12_half(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_nv12_quarter(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_16bit_half(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_16bit_quarter(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_nv12_half_avx2(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yuy2_to_nv12_quarter_avx2(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_16bit_half_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+void convert_yc48_to_nv12_16bit_quarter_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height);
+
+//縮小 (変換後の各planeを分離型フィルタで縮小する)
+//重みは合計が1<<RESIZE_WEIGHT_BITSになる整数で持つ
+static const int RESIZE_WEIGHT_BITS = 14;
+//縦方向の処理結果は、8bitでは小数部を (RESIZE_WEIGHT_BITS - RESIZE_V_RSH_8) bit残し、横方向の積和が32bitに収まるようにする
+static const int RESIZE_V_RSH_8  = 6;
+static const int RESIZE_V_RSH_16 = RESIZE_WEIGHT_BITS;
+
+enum {
+    RESIZE_FILTER_BOX,      //面積平均
+    RESIZE_FILTER_BILINEAR, //三角窓
+    RESIZE_FILTER_BICUBIC,  //Keys (a=-0.5)
+};
+
+typedef struct {
+    int    taps;   //1出力画素あたりの参照画素数
+    int   *pos;    //出力画素ごとの参照開始位置
+    short *weight; //出力画素ごとの重み (taps個ずつ)
+} RESIZE_WEIGHT;
+
+typedef struct {
+    int src_w, src_h;  //入力の幅・高さ (インタレ時はフィールドの高さ)
+    int dst_w, dst_h;  //出力の幅・高さ (インタレ時はフィールドの高さ)
+    int ch;            //1画素あたりの要素数 (nv12の色差なら2, RGBなら3)
+    RESIZE_WEIGHT wx, wy;
+} RESIZE_PLANE;
+
+//縦方向の積和 (src[0], src[pitch], ... をweightで重み付けし、count個の要素をtmpに書き込む)
+typedef void (*func_resize_vertical) (int *tmp, const BYTE *src, int src_pitch, int count, const short *weight, int taps);
+
+void resize_vertical_8bit(int *tmp, const BYTE *src, int src_pitch, int count, const short *weight, int taps);
+void resize_vertical_16bit(int *tmp, const BYTE *src, int src_pitch, int count, const short *weight, int taps);
+void resize_vertical_8bit_avx2(int *tmp, const BYTE *src, int src_pitch, int count, const short *weight, int taps);
+void resize_vertical_16bit_avx2(int *tmp, const BYTE *src, int src_pitch, int count, const short *weight, int taps);
+
+typedef struct {
+    int   count;          //planeの数 (0なら縮小しない)
+    int   byte_per_pixel;
+    int   max_value;      //出力の最大値 ((1<<bit_depth)-1)
+    BOOL  interlaced;     //フィールドごとに縮小する
+    RESIZE_PLANE plane[4];
+    int  *tmp;            //縦方向の処理結果 (1行分)
+    func_resize_vertical resize_v;
+} RESIZE_DATA;
+
+BOOL init_resize_plane(RESIZE_PLANE *plane, int filter, int src_w, int src_h, int dst_w, int dst_h, int ch);
+void free_resize_plane(RESIZE_PLANE *plane);
+void resize_frame(const RESIZE_DATA *resize, const CONVERT_CF_DATA *src, CONVERT_CF_DATA *dst);
+
 #endif //_CONVERT_H_
@@ -105,3 +105,63 @@ void convert_lw48_to_yuv444_avx(void *frame, CONVERT_CF_DATA *pixel_data, const
 void convert_lw48_to_yuv444_16bit_avx(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
     return convert_lw48_to_yuv444_16bit_simd<FALSE>(frame, pixel_data, width, height);
 }
+void convert_rgb_to_yuv444_avx(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    return convert_rgb_to_yuv444_simd<BYTE, 8>(frame, pixel_data, width, height);
+}
+void convert_rgb_to_yuv444_16bit_avx(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    return convert_rgb_to_yuv444_simd<USHORT, 16>(frame, pixel_data, width, height);
+}
+void convert_rgba_to_yuva420_avx(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva420_simd<BYTE, 8, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva420_simd<BYTE, 8, false>(frame, pixel_data, width, height);
+}
+void convert_rgba_to_yuva420_10bit_avx(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva420_simd<USHORT, 10, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva420_simd<USHORT, 10, false>(frame, pixel_data, width, height);
+}
+void convert_rgba_to_yuva420_16bit_avx(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva420_simd<USHORT, 16, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva420_simd<USHORT, 16, false>(frame, pixel_data, width, height);
+}
+void convert_rgba_to_yuva444_avx(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva444_simd<BYTE, 8, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva444_simd<BYTE, 8, false>(frame, pixel_data, width, height);
+}
+void convert_rgba_to_yuva444_10bit_avx(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva444_simd<USHORT, 10, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva444_simd<USHORT, 10, false>(frame, pixel_data, width, height);
+}
+void convert_rgba_to_yuva444_16bit_avx(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva444_simd<USHORT, 16, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva444_simd<USHORT, 16, false>(frame, pixel_data, width, height);
+}
+void convert_yc48_to_nv12_ordered_dither_avx(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_dither_simd<DITHER_ORDERED>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_nv12_err_diffusion_avx(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_dither_simd<DITHER_ERROR_DIFFUSION>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_nv12_i_ordered_dither_avx(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_i_dither_simd<DITHER_ORDERED>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_nv12_i_err_diffusion_avx(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_i_dither_simd<DITHER_ERROR_DIFFUSION>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_yuv444_ordered_dither_avx(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_yuv444_dither_simd<DITHER_ORDERED>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_yuv444_err_diffusion_avx(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_yuv444_dither_simd<DITHER_ERROR_DIFFUSION>(pixel, pixel_data, width, height);
+}
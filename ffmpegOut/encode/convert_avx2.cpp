@@ -26,10 +26,13 @@
 // --------------------------------------------------------------------------------------------
 
 //AVX2用コード
+#define USE_AVX2 1
 #include <immintrin.h> //イントリンシック命令 AVX / AVX2
+#include <algorithm>
 
 #include "convert.h"
 #include "convert_const.h"
+#include "convert_tmpl.h"
 
 #if _MSC_VER >= 1800 && !defined(__AVX2__) && !defined(_DEBUG)
 static_assert(false, "do not forget to set /arch:AVX2 for this file.");
@@ -1115,6 +1118,229 @@ void convert_yc48_to_yuv444_16bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data,
     _mm256_zeroupper();
 }
 
+//16bit値 -> 8bit (ディザあり)、戻り値は0～255の16bit値
+template <int dither>
+static __forceinline __m256i dither_16to8_avx2(__m256i y0, const USHORT *threshold, short *err_cur, const short *err_prev, int step) {
+    if (dither == DITHER_ORDERED) {
+        y0 = _mm256_adds_epu16(y0, _mm256_loadu_si256((const __m256i *)threshold));
+        return _mm256_srli_epi16(y0, 8);
+    }
+    __m256i y1, y2;
+    y1 = _mm256_add_epi16(_mm256_loadu_si256((const __m256i *)(err_prev - step)), _mm256_loadu_si256((const __m256i *)(err_prev + step)));
+    y2 = _mm256_loadu_si256((const __m256i *)err_prev);
+    y1 = _mm256_add_epi16(y1, _mm256_add_epi16(y2, y2));
+    y1 = _mm256_srai_epi16(_mm256_add_epi16(y1, _mm256_set1_epi16(2)), 2);
+    y0 = _mm256_add_epi16(_mm256_srli_epi16(y0, 2), y1);
+    y1 = _mm256_srai_epi16(_mm256_add_epi16(y0, _mm256_set1_epi16(32)), 6);
+    y1 = _mm256_min_epi16(_mm256_max_epi16(y1, _mm256_setzero_si256()), _mm256_set1_epi16(LIMIT_8));
+    y0 = _mm256_sub_epi16(y0, _mm256_slli_epi16(y1, 6));
+    y0 = _mm256_min_epi16(_mm256_max_epi16(y0, _mm256_set1_epi16(-32)), _mm256_set1_epi16(32));
+    _mm256_storeu_si256((__m256i *)err_cur, y0);
+    return y1;
+}
+static __forceinline __m256i pack_16to8_avx2(__m256i y0, __m256i y1) {
+    return _mm256_permute4x64_epi64(_mm256_packus_epi16(y0, y1), _MM_SHUFFLE(3,1,2,0));
+}
+
+//幅が32で割り切れない場合は、最後の32画素を右端に合わせて計算しなおす
+//(はみ出して書き込むと、同じループで書いた次の行の先頭を壊してしまうため)
+template <int dither>
+static void __forceinline convert_yc48_to_nv12_dither_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (width < 32) {
+        if (dither == DITHER_ORDERED) convert_yc48_to_nv12_ordered_dither_avx(pixel, pixel_data, width, height);
+        else                          convert_yc48_to_nv12_err_diffusion_avx(pixel, pixel_data, width, height);
+        return;
+    }
+    int x, y, i;
+    BYTE *dst_Y = pixel_data->data[0];
+    BYTE *dst_C = pixel_data->data[1];
+    short *ycp, *ycpw;
+    BYTE *Y = NULL, *C = NULL;
+    short *eY0 = NULL, *eY1 = NULL, *eC = NULL;
+    const short *eY0p = NULL, *eY1p = NULL, *eCp = NULL;
+    const __m256i yC_pw_one = _mm256_set1_epi16(1);
+    const __m256i yC_max = _mm256_set1_epi16((short)LIMIT_16);
+    const __m256i yC_YCC = _mm256_set1_epi32(1<<LSFT_YCC_16);
+    __m256i y0, y1, y2, y3, yY0[2], yY1[2], yC[2];
+    if (dither == DITHER_ERROR_DIFFUSION)
+        memset(pixel_data->dither_err, 0, get_dither_err_buf_size(width));
+    for (y = 0; y < height; y += 2) {
+        Y   = dst_Y + width * y;
+        C   = dst_C + width * y / 2;
+        const USHORT *thY0 = Array_DITHER_ORDERED[0][(y + 0) & 7];
+        const USHORT *thY1 = Array_DITHER_ORDERED[0][(y + 1) & 7];
+        const USHORT *thC  = Array_DITHER_ORDERED[1][(y >> 1) & 7];
+        if (dither == DITHER_ERROR_DIFFUSION) {
+            eY0 = get_dither_err_line(pixel_data, width, 0, y);     eY0p = get_dither_err_line(pixel_data, width, 0, y - 2);
+            eY1 = get_dither_err_line(pixel_data, width, 0, y + 1); eY1p = get_dither_err_line(pixel_data, width, 0, y - 1);
+            eC  = get_dither_err_line(pixel_data, width, 1, y >> 1); eCp = get_dither_err_line(pixel_data, width, 1, (y >> 1) - 2);
+        }
+        for (int x_block = 0; x_block < width; x_block += 32) {
+            x    = (std::min)(x_block, width - 32);
+            ycp  = (short*)pixel + (width * y + x) * 3;
+            ycpw = ycp + width*3;
+            for (i = 0; i < 2; i++) {
+                const int ix = x + i * 16;
+                y1 = _mm256_loadu_si256((__m256i *)(ycp + i * 48 +  0)); // 128, 0
+                y2 = _mm256_loadu_si256((__m256i *)(ycp + i * 48 + 16)); // 384, 256
+                y3 = _mm256_loadu_si256((__m256i *)(ycp + i * 48 + 32)); // 640, 512
+                gather_y_uv_from_yc48(y1, y2, y3);
+                y0 = y2;
+                yY0[i] = dither_16to8_avx2<dither>(convert_y_range_from_yc48(y1, yC_Y_L_MA_16, Y_L_RSH_16, yC_YCC, yC_pw_one, yC_max), thY0 + (ix & 7), eY0 + ix, eY0p + ix, 1);
+
+                y1 = _mm256_loadu_si256((__m256i *)(ycpw + i * 48 +  0));
+                y2 = _mm256_loadu_si256((__m256i *)(ycpw + i * 48 + 16));
+                y3 = _mm256_loadu_si256((__m256i *)(ycpw + i * 48 + 32));
+                gather_y_uv_from_yc48(y1, y2, y3);
+                yY1[i] = dither_16to8_avx2<dither>(convert_y_range_from_yc48(y1, yC_Y_L_MA_16, Y_L_RSH_16, yC_YCC, yC_pw_one, yC_max), thY1 + (ix & 7), eY1 + ix, eY1p + ix, 1);
+
+                y0 = convert_uv_range_from_yc48_yuv420p(y0, y2, _mm256_set1_epi16(UV_OFFSET_x2), yC_UV_L_MA_16_420P, UV_L_RSH_16_420P, yC_YCC, yC_pw_one, yC_max);
+                yC[i] = dither_16to8_avx2<dither>(y0, thC + (ix & 7), eC + ix, eCp + ix, 2);
+            }
+            _mm256_storeu_si256((__m256i *)(Y + x),         pack_16to8_avx2(yY0[0], yY0[1]));
+            _mm256_storeu_si256((__m256i *)(Y + x + width), pack_16to8_avx2(yY1[0], yY1[1]));
+            _mm256_storeu_si256((__m256i *)(C + x),         pack_16to8_avx2(yC[0],  yC[1]));
+        }
+    }
+    _mm256_zeroupper();
+}
+
+template <int dither>
+static void __forceinline convert_yc48_to_nv12_i_dither_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (width < 32) {
+        if (dither == DITHER_ORDERED) convert_yc48_to_nv12_i_ordered_dither_avx(pixel, pixel_data, width, height);
+        else                          convert_yc48_to_nv12_i_err_diffusion_avx(pixel, pixel_data, width, height);
+        return;
+    }
+    int x, y, i, j;
+    BYTE *dst_Y = pixel_data->data[0];
+    BYTE *dst_C = pixel_data->data[1];
+    short *ycp, *ycpw;
+    BYTE *Y = NULL, *C = NULL;
+    short *eY0 = NULL, *eY1 = NULL, *eC = NULL;
+    const short *eY0p = NULL, *eY1p = NULL, *eCp = NULL;
+    const __m256i yC_pw_one = _mm256_set1_epi16(1);
+    const __m256i yC_max = _mm256_set1_epi16((short)LIMIT_16);
+    const __m256i yC_YCC = _mm256_set1_epi32(1<<LSFT_YCC_16);
+    const __m256i *yC_UV_L_MA_420I = (const __m256i *)Array_UV_L_MA_16_420I;
+    __m256i y0, y1, y2, y3, yY0[2], yY1[2], yC[2];
+    if (dither == DITHER_ERROR_DIFFUSION)
+        memset(pixel_data->dither_err, 0, get_dither_err_buf_size(width));
+    for (y = 0; y < height; y += 4) {
+        for (i = 0; i < 2; i++) {
+            Y   = dst_Y + width * (y + i);
+            C   = dst_C + width * (y + i*2) / 2;
+            const USHORT *thY0 = Array_DITHER_ORDERED[0][(y + i + 0) & 7];
+            const USHORT *thY1 = Array_DITHER_ORDERED[0][(y + i + 2) & 7];
+            const USHORT *thC  = Array_DITHER_ORDERED[1][((y >> 1) + i) & 7];
+            if (dither == DITHER_ERROR_DIFFUSION) {
+                eY0 = get_dither_err_line(pixel_data, width, 0, y + i);     eY0p = get_dither_err_line(pixel_data, width, 0, y + i - 4);
+                eY1 = get_dither_err_line(pixel_data, width, 0, y + i + 2); eY1p = get_dither_err_line(pixel_data, width, 0, y + i - 2);
+                eC  = get_dither_err_line(pixel_data, width, 1, (y >> 1) + i); eCp = get_dither_err_line(pixel_data, width, 1, (y >> 1) + i - 2);
+            }
+            for (int x_block = 0; x_block < width; x_block += 32) {
+                x    = (std::min)(x_block, width - 32);
+                ycp  = (short*)pixel + (width * (y + i) + x) * 3;
+                ycpw = ycp + width*2*3;
+                for (j = 0; j < 2; j++) {
+                    const int ix = x + j * 16;
+                    y1 = _mm256_loadu_si256((__m256i *)(ycp + j * 48 +  0)); // 128, 0
+                    y2 = _mm256_loadu_si256((__m256i *)(ycp + j * 48 + 16)); // 384, 256
+                    y3 = _mm256_loadu_si256((__m256i *)(ycp + j * 48 + 32)); // 640, 512
+                    gather_y_uv_from_yc48(y1, y2, y3);
+                    y0 = y2;
+                    yY0[j] = dither_16to8_avx2<dither>(convert_y_range_from_yc48(y1, yC_Y_L_MA_16, Y_L_RSH_16, yC_YCC, yC_pw_one, yC_max), thY0 + (ix & 7), eY0 + ix, eY0p + ix, 1);
+
+                    y1 = _mm256_loadu_si256((__m256i *)(ycpw + j * 48 +  0));
+                    y2 = _mm256_loadu_si256((__m256i *)(ycpw + j * 48 + 16));
+                    y3 = _mm256_loadu_si256((__m256i *)(ycpw + j * 48 + 32));
+                    gather_y_uv_from_yc48(y1, y2, y3);
+                    yY1[j] = dither_16to8_avx2<dither>(convert_y_range_from_yc48(y1, yC_Y_L_MA_16, Y_L_RSH_16, yC_YCC, yC_pw_one, yC_max), thY1 + (ix & 7), eY1 + ix, eY1p + ix, 1);
+
+                    y0 = convert_uv_range_from_yc48_420i(y0, y2, _mm256_set1_epi16(UV_OFFSET_x1), yC_UV_L_MA_420I[i], yC_UV_L_MA_420I[(i+1)&0x01], UV_L_RSH_16_420I, yC_YCC, yC_pw_one, yC_max);
+                    yC[j] = dither_16to8_avx2<dither>(y0, thC + (ix & 7), eC + ix, eCp + ix, 2);
+                }
+                _mm256_storeu_si256((__m256i *)(Y + x),           pack_16to8_avx2(yY0[0], yY0[1]));
+                _mm256_storeu_si256((__m256i *)(Y + x + width*2), pack_16to8_avx2(yY1[0], yY1[1]));
+                _mm256_storeu_si256((__m256i *)(C + x),           pack_16to8_avx2(yC[0],  yC[1]));
+            }
+        }
+    }
+    _mm256_zeroupper();
+}
+
+template <int dither>
+static void __forceinline convert_yc48_to_yuv444_dither_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (width < 32) {
+        if (dither == DITHER_ORDERED) convert_yc48_to_yuv444_ordered_dither_avx(pixel, pixel_data, width, height);
+        else                          convert_yc48_to_yuv444_err_diffusion_avx(pixel, pixel_data, width, height);
+        return;
+    }
+    short *e[3] = { 0 };
+    const short *ep[3] = { 0 };
+    const __m256i yC_pw_one = _mm256_set1_epi16(1);
+    const __m256i yC_max = _mm256_set1_epi16((short)LIMIT_16);
+    const __m256i yC_YCC = _mm256_set1_epi32(1<<LSFT_YCC_16);
+    __m256i y1, y2, y3, yY[2], yU[2], yV[2];
+    if (dither == DITHER_ERROR_DIFFUSION)
+        memset(pixel_data->dither_err, 0, get_dither_err_buf_size(width));
+    for (int y = 0; y < height; y++) {
+        BYTE *Y = pixel_data->data[0] + width * y;
+        BYTE *U = pixel_data->data[1] + width * y;
+        BYTE *V = pixel_data->data[2] + width * y;
+        const USHORT *thY = Array_DITHER_ORDERED[0][y & 7];
+        const USHORT *thU = Array_DITHER_ORDERED[1][y & 7];
+        const USHORT *thV = Array_DITHER_ORDERED[2][y & 7];
+        if (dither == DITHER_ERROR_DIFFUSION) {
+            for (int j = 0; j < 3; j++) {
+                e[j]  = get_dither_err_line(pixel_data, width, j, y);
+                ep[j] = get_dither_err_line(pixel_data, width, j, y - 2);
+            }
+        }
+        for (int x_block = 0; x_block < width; x_block += 32) {
+            const int x = (std::min)(x_block, width - 32);
+            short *ycp = (short *)pixel + (width * y + x) * 3;
+            for (int i = 0; i < 2; i++) {
+                const int ix = x + i * 16;
+                y1 = _mm256_loadu_si256((__m256i *)(ycp + i * 48 +  0));
+                y2 = _mm256_loadu_si256((__m256i *)(ycp + i * 48 + 16));
+                y3 = _mm256_loadu_si256((__m256i *)(ycp + i * 48 + 32));
+                gather_y_u_v_from_yc48(y1, y2, y3);
+
+                y1 = convert_y_range_from_yc48(y1, yC_Y_L_MA_16, Y_L_RSH_16, yC_YCC, yC_pw_one, yC_max);
+                y2 = convert_uv_range_from_yc48(y2, _mm256_set1_epi16(UV_OFFSET_x1), yC_UV_L_MA_16_444, UV_L_RSH_16_444, yC_YCC, yC_pw_one, yC_max);
+                y3 = convert_uv_range_from_yc48(y3, _mm256_set1_epi16(UV_OFFSET_x1), yC_UV_L_MA_16_444, UV_L_RSH_16_444, yC_YCC, yC_pw_one, yC_max);
+                yY[i] = dither_16to8_avx2<dither>(y1, thY + (ix & 7), e[0] + ix, ep[0] + ix, 1);
+                yU[i] = dither_16to8_avx2<dither>(y2, thU + (ix & 7), e[1] + ix, ep[1] + ix, 1);
+                yV[i] = dither_16to8_avx2<dither>(y3, thV + (ix & 7), e[2] + ix, ep[2] + ix, 1);
+            }
+            _mm256_storeu_si256((__m256i *)(Y + x), pack_16to8_avx2(yY[0], yY[1]));
+            _mm256_storeu_si256((__m256i *)(U + x), pack_16to8_avx2(yU[0], yU[1]));
+            _mm256_storeu_si256((__m256i *)(V + x), pack_16to8_avx2(yV[0], yV[1]));
+        }
+    }
+    _mm256_zeroupper();
+}
+
+void convert_yc48_to_nv12_ordered_dither_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_dither_avx2<DITHER_ORDERED>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_nv12_err_diffusion_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_dither_avx2<DITHER_ERROR_DIFFUSION>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_nv12_i_ordered_dither_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_i_dither_avx2<DITHER_ORDERED>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_nv12_i_err_diffusion_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_i_dither_avx2<DITHER_ERROR_DIFFUSION>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_yuv444_ordered_dither_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_yuv444_dither_avx2<DITHER_ORDERED>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_yuv444_err_diffusion_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_yuv444_dither_avx2<DITHER_ERROR_DIFFUSION>(pixel, pixel_data, width, height);
+}
+
 void convert_yuy2_to_nv16_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
     BYTE *p = (BYTE *)pixel;
     BYTE * const p_fin = p + width * height * 2;
@@ -1397,6 +1623,7 @@ static __forceinline void separate_8bit_packed(__m256i& yA, __m256i& yB, __m256i
     yC = _mm256_shuffle_epi8(c32_012, _mm256_load_si256((__m256i*)mask_shuffle2));
 }
 
+//C版と結果が一致するよう、FMAは使わず同じ順序で演算する
 static __forceinline void convert_rgb2yuv(__m256& y_f1, __m256& u_f1, __m256& v_f1, 
     const __m256& r_f1, const __m256& g_f1, const __m256& b_f1,
     const __m256& coeff_ry, const __m256& coeff_gy, const __m256& coeff_by,
@@ -1404,15 +1631,9 @@ static __forceinline void convert_rgb2yuv(__m256& y_f1, __m256& u_f1, __m256& v_
     const __m256& coeff_rv, const __m256& coeff_gv, const __m256& coeff_bv) {
     const __m256 offset_y = _mm256_set1_ps(16.0f);
     const __m256 offset_uv = _mm256_set1_ps(128.0f);
-    y_f1 = _mm256_fmadd_ps(coeff_ry, r_f1, 
-           _mm256_fmadd_ps(coeff_gy, g_f1, 
-           _mm256_fmadd_ps(coeff_by, b_f1, offset_y)));
-    u_f1 = _mm256_fmadd_ps(coeff_ru, r_f1,
-           _mm256_fmadd_ps(coeff_gu, g_f1,
-           _mm256_fmadd_ps(coeff_bu, b_f1, offset_uv)));
-    v_f1 = _mm256_fmadd_ps(coeff_rv, r_f1,
-           _mm256_fmadd_ps(coeff_gv, g_f1,
-           _mm256_fmadd_ps(coeff_bv, b_f1, offset_uv)));
+    y_f1 = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(coeff_ry, r_f1), _mm256_mul_ps(coeff_gy, g_f1)), _mm256_mul_ps(coeff_by, b_f1)), offset_y);
+    u_f1 = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(coeff_ru, r_f1), _mm256_mul_ps(coeff_gu, g_f1)), _mm256_mul_ps(coeff_bu, b_f1)), offset_uv);
+    v_f1 = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(coeff_rv, r_f1), _mm256_mul_ps(coeff_gv, g_f1)), _mm256_mul_ps(coeff_bv, b_f1)), offset_uv);
 }
 
 void convert_rgb_to_yuv444_avx2(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
@@ -1420,14 +1641,6 @@ void convert_rgb_to_yuv444_avx2(void *frame, CONVERT_CF_DATA *pixel_data, const
     BYTE *ptrY = pixel_data->data[0];
     BYTE *ptrU = pixel_data->data[1];
     BYTE *ptrV = pixel_data->data[2];
-    const float COEFF_RGB2YUV[2][9] = {
-        { 0.299f,     0.587f,   0.114f,
-         -0.168736f, -0.331264f,  0.5f,
-          0.5f,      -0.418688f, -0.081312f },
-        { 0.2126f,    0.7152f,    0.0722f,
-         -0.114572f, -0.385427f,  0.5f,
-          0.5f,      -0.453596f, -0.045977f }
-    };
     const float *coeff_table = COEFF_RGB2YUV[pixel_data->colormatrix ? 1 : 0];
     int y0 = 0, y1 = height - 1;
     const int srcstep = (width*3 + 3) & ~3;
@@ -1557,9 +1770,9 @@ void convert_rgb_to_yuv444_avx2(void *frame, CONVERT_CF_DATA *pixel_data, const
             const float y = (coeff_table[0] * r + coeff_table[1] * g + coeff_table[2] * b +  16.0f) * (1 << (out_bit_depth - 8));
             const float u = (coeff_table[3] * r + coeff_table[4] * g + coeff_table[5] * b + 128.0f) * (1 << (out_bit_depth - 8));
             const float v = (coeff_table[6] * r + coeff_table[7] * g + coeff_table[8] * b + 128.0f) * (1 << (out_bit_depth - 8));
-            dstY[x] = clamp((BYTE)(y + 0.5f), 0, (1 << out_bit_depth) - 1);
-            dstU[x] = clamp((BYTE)(u + 0.5f), 0, (1 << out_bit_depth) - 1);
-            dstV[x] = clamp((BYTE)(v + 0.5f), 0, (1 << out_bit_depth) - 1);
+            dstY[x] = (BYTE)clamp((int)(y + 0.5f), 0, (1 << out_bit_depth) - 1);
+            dstU[x] = (BYTE)clamp((int)(u + 0.5f), 0, (1 << out_bit_depth) - 1);
+            dstV[x] = (BYTE)clamp((int)(v + 0.5f), 0, (1 << out_bit_depth) - 1);
         }
     }
     
@@ -1571,14 +1784,6 @@ void convert_rgb_to_yuv444_16bit_avx2(void *frame, CONVERT_CF_DATA *pixel_data,
     BYTE *ptrY = pixel_data->data[0];
     BYTE *ptrU = pixel_data->data[1];
     BYTE *ptrV = pixel_data->data[2];
-    const float COEFF_RGB2YUV[2][9] = {
-        { 0.299f,     0.587f,   0.114f,
-         -0.168736f, -0.331264f,  0.5f,
-          0.5f,      -0.418688f, -0.081312f },
-        { 0.2126f,    0.7152f,    0.0722f,
-         -0.114572f, -0.385427f,  0.5f,
-          0.5f,      -0.453596f, -0.045977f }
-    };
     const float *coeff_table = COEFF_RGB2YUV[pixel_data->colormatrix ? 1 : 0];
     int y0 = 0, y1 = height - 1;
     const int srcstep = (width*3 + 3) & ~3;
@@ -1671,18 +1876,18 @@ void convert_rgb_to_yuv444_16bit_avx2(void *frame, CONVERT_CF_DATA *pixel_data,
             convert_rgb2yuv(y_f3, u_f3, v_f3, r_f3, g_f3, b_f3, coeff_ry, coeff_gy, coeff_by, coeff_ru, coeff_gu, coeff_bu, coeff_rv, coeff_gv, coeff_bv);
             
             // 四捨五入して整数に変換
-            __m256i y_i0 = _mm256_cvttps_epi32(_mm256_fmadd_ps(y_f0, limit_offset, round_offset));
-            __m256i u_i0 = _mm256_cvttps_epi32(_mm256_fmadd_ps(u_f0, limit_offset, round_offset));
-            __m256i v_i0 = _mm256_cvttps_epi32(_mm256_fmadd_ps(v_f0, limit_offset, round_offset));
-            __m256i y_i1 = _mm256_cvttps_epi32(_mm256_fmadd_ps(y_f1, limit_offset, round_offset));
-            __m256i u_i1 = _mm256_cvttps_epi32(_mm256_fmadd_ps(u_f1, limit_offset, round_offset));
-            __m256i v_i1 = _mm256_cvttps_epi32(_mm256_fmadd_ps(v_f1, limit_offset, round_offset));
-            __m256i y_i2 = _mm256_cvttps_epi32(_mm256_fmadd_ps(y_f2, limit_offset, round_offset));
-            __m256i u_i2 = _mm256_cvttps_epi32(_mm256_fmadd_ps(u_f2, limit_offset, round_offset));
-            __m256i v_i2 = _mm256_cvttps_epi32(_mm256_fmadd_ps(v_f2, limit_offset, round_offset));
-            __m256i y_i3 = _mm256_cvttps_epi32(_mm256_fmadd_ps(y_f3, limit_offset, round_offset));
-            __m256i u_i3 = _mm256_cvttps_epi32(_mm256_fmadd_ps(u_f3, limit_offset, round_offset));
-            __m256i v_i3 = _mm256_cvttps_epi32(_mm256_fmadd_ps(v_f3, limit_offset, round_offset));
+            __m256i y_i0 = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(y_f0, limit_offset), round_offset));
+            __m256i u_i0 = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(u_f0, limit_offset), round_offset));
+            __m256i v_i0 = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(v_f0, limit_offset), round_offset));
+            __m256i y_i1 = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(y_f1, limit_offset), round_offset));
+            __m256i u_i1 = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(u_f1, limit_offset), round_offset));
+            __m256i v_i1 = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(v_f1, limit_offset), round_offset));
+            __m256i y_i2 = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(y_f2, limit_offset), round_offset));
+            __m256i u_i2 = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(u_f2, limit_offset), round_offset));
+            __m256i v_i2 = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(v_f2, limit_offset), round_offset));
+            __m256i y_i3 = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(y_f3, limit_offset), round_offset));
+            __m256i u_i3 = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(u_f3, limit_offset), round_offset));
+            __m256i v_i3 = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(v_f3, limit_offset), round_offset));
 
             // 32bit -> 16bit変換
             __m256i y_16_0 = _mm256_packus_epi32(y_i0, y_i1);  // 0-15
@@ -1709,15 +1914,204 @@ void convert_rgb_to_yuv444_16bit_avx2(void *frame, CONVERT_CF_DATA *pixel_data,
             const float y = (coeff_table[0] * r + coeff_table[1] * g + coeff_table[2] * b +  16.0f) * (1 << (out_bit_depth - 8));
             const float u = (coeff_table[3] * r + coeff_table[4] * g + coeff_table[5] * b + 128.0f) * (1 << (out_bit_depth - 8));
             const float v = (coeff_table[6] * r + coeff_table[7] * g + coeff_table[8] * b + 128.0f) * (1 << (out_bit_depth - 8));
-            dstY[x] = (BYTE)clamp((int)(y + 0.5f), 0, (1 << out_bit_depth) - 1);
-            dstU[x] = (BYTE)clamp((int)(u + 0.5f), 0, (1 << out_bit_depth) - 1);
-            dstV[x] = (BYTE)clamp((int)(v + 0.5f), 0, (1 << out_bit_depth) - 1);
+            dstY[x] = (USHORT)clamp((int)(y + 0.5f), 0, (1 << out_bit_depth) - 1);
+            dstU[x] = (USHORT)clamp((int)(u + 0.5f), 0, (1 << out_bit_depth) - 1);
+            dstV[x] = (USHORT)clamp((int)(v + 0.5f), 0, (1 << out_bit_depth) - 1);
         }
     }
     
     _mm256_zeroupper();
 }
 
+//RGBA 8画素分をY, U, V (ビット深度を合わせる前の8bit相当の値) とアルファに分解する
+//C版(convert_rgba_to_yuv_1px)と結果が一致するよう、FMAは使わず同じ順序で演算する
+template<bool unpremultiply>
+static __forceinline void convert_rgba_to_yuv_8px_avx2(__m256& y, __m256& u, __m256& v, __m256i& yA, const __m256i& yBGRA, const __m256 yCoeff[9]) {
+    const __m256i yMask = _mm256_set1_epi32(0xff);
+    __m256 b = _mm256_cvtepi32_ps(_mm256_and_si256(yBGRA, yMask));
+    __m256 g = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(yBGRA,  8), yMask));
+    __m256 r = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(yBGRA, 16), yMask));
+    yA = _mm256_srli_epi32(yBGRA, 24);
+    if (unpremultiply) {
+        const __m256 y255 = _mm256_set1_ps(255.0f);
+        const __m256 a = _mm256_cvtepi32_ps(yA);
+        //a = 0 では 255/a が inf になるので、C版と同じく0にする
+        const __m256 inv = _mm256_and_ps(_mm256_div_ps(y255, a), _mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_NEQ_UQ));
+        b = _mm256_min_ps(_mm256_mul_ps(b, inv), y255);
+        g = _mm256_min_ps(_mm256_mul_ps(g, inv), y255);
+        r = _mm256_min_ps(_mm256_mul_ps(r, inv), y255);
+    }
+    y = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(yCoeff[0], r), _mm256_mul_ps(yCoeff[1], g)), _mm256_mul_ps(yCoeff[2], b)), _mm256_set1_ps(16.0f));
+    u = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(yCoeff[3], r), _mm256_mul_ps(yCoeff[4], g)), _mm256_mul_ps(yCoeff[5], b)), _mm256_set1_ps(128.0f));
+    v = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(yCoeff[6], r), _mm256_mul_ps(yCoeff[7], g)), _mm256_mul_ps(yCoeff[8], b)), _mm256_set1_ps(128.0f));
+}
+
+//8bit相当の値を出力ビット深度に合わせて丸める (上限は書き込み時のpackusで飽和させる)
+template<int out_bit_depth>
+static __forceinline __m256i yuv_ps_to_bit_depth_avx2(const __m256& y) {
+    __m256i yi = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(y, _mm256_set1_ps((float)(1 << (out_bit_depth - 8)))), _mm256_set1_ps(0.5f)));
+    if (out_bit_depth != 8 && out_bit_depth != 16) {
+        yi = _mm256_min_epi32(yi, _mm256_set1_epi32((1 << out_bit_depth) - 1));
+    }
+    return yi;
+}
+
+template<int out_bit_depth>
+static __forceinline __m256i alpha_8_to_bit_depth_avx2(const __m256i& yA) {
+    return _mm256_or_si256(_mm256_slli_epi32(yA, out_bit_depth - 8), _mm256_srli_epi32(yA, 16 - out_bit_depth));
+}
+
+//32bit整数 16画素分を飽和処理して書き込む
+template<typename TypeOut>
+static __forceinline void store_yuv_16px_avx2(TypeOut *dst, const __m256i& y0, const __m256i& y1) {
+    //packusは128bitレーンごとに行われるので並べなおす
+    const __m256i y = _mm256_permute4x64_epi64(_mm256_packus_epi32(y0, y1), _MM_SHUFFLE(3, 1, 2, 0));
+    if (sizeof(TypeOut) == 1) {
+        _mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(_mm256_castsi256_si128(y), _mm256_extracti128_si256(y, 1)));
+    } else {
+        _mm256_storeu_si256((__m256i *)dst, y);
+    }
+}
+
+//32bit整数 8画素分を飽和処理して書き込む
+template<typename TypeOut>
+static __forceinline void store_yuv_8px_avx2(TypeOut *dst, const __m256i& y0) {
+    const __m128i x = _mm_packus_epi32(_mm256_castsi256_si128(y0), _mm256_extracti128_si256(y0, 1));
+    if (sizeof(TypeOut) == 1) {
+        _mm_storel_epi64((__m128i *)dst, _mm_packus_epi16(x, x));
+    } else {
+        _mm_storeu_si128((__m128i *)dst, x);
+    }
+}
+
+template<typename TypeOut, int out_bit_depth, bool unpremultiply>
+static void convert_rgba_to_yuva420_avx2_base(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    BYTE *ptrY = pixel_data->data[0];
+    BYTE *ptrU = pixel_data->data[1];
+    BYTE *ptrV = pixel_data->data[2];
+    BYTE *ptrA = pixel_data->data[3];
+    const float *coeff_table = COEFF_RGB2YUV[pixel_data->colormatrix ? 1 : 0];
+    __m256 yCoeff[9];
+    for (int i = 0; i < 9; i++) {
+        yCoeff[i] = _mm256_set1_ps(coeff_table[i]);
+    }
+    const __m256 yQuarter = _mm256_set1_ps(0.25f);
+    const int srcstep = width * 4;
+    for (int y0 = 0; y0 < height; y0 += 2) {
+        const int y1 = height - 1 - y0;
+        TypeOut *dstY0 = (TypeOut *)(ptrY + y1*width*sizeof(TypeOut));
+        TypeOut *dstY1 = (TypeOut *)(ptrY + (y1-1)*width*sizeof(TypeOut));
+        TypeOut *dstA0 = (TypeOut *)(ptrA + y1*width*sizeof(TypeOut));
+        TypeOut *dstA1 = (TypeOut *)(ptrA + (y1-1)*width*sizeof(TypeOut));
+        TypeOut *dstU  = (TypeOut *)(ptrU + ((y1-1)>>1)*(width>>1)*sizeof(TypeOut));
+        TypeOut *dstV  = (TypeOut *)(ptrV + ((y1-1)>>1)*(width>>1)*sizeof(TypeOut));
+        BYTE *src0 = (BYTE*)frame + y0*srcstep;
+        BYTE *src1 = src0 + srcstep;
+        int x = 0;
+        //16画素 x 2行ずつ処理する
+        for (; x <= width - 16; x += 16) {
+            __m256 y0f[2], u0f[2], v0f[2], y1f[2], u1f[2], v1f[2];
+            __m256i yA0[2], yA1[2];
+            for (int i = 0; i < 2; i++) {
+                convert_rgba_to_yuv_8px_avx2<unpremultiply>(y0f[i], u0f[i], v0f[i], yA0[i], _mm256_loadu_si256((const __m256i *)(src0 + (x + i*8)*4)), yCoeff);
+                convert_rgba_to_yuv_8px_avx2<unpremultiply>(y1f[i], u1f[i], v1f[i], yA1[i], _mm256_loadu_si256((const __m256i *)(src1 + (x + i*8)*4)), yCoeff);
+            }
+            store_yuv_16px_avx2(dstY0 + x, yuv_ps_to_bit_depth_avx2<out_bit_depth>(y0f[0]), yuv_ps_to_bit_depth_avx2<out_bit_depth>(y0f[1]));
+            store_yuv_16px_avx2(dstY1 + x, yuv_ps_to_bit_depth_avx2<out_bit_depth>(y1f[0]), yuv_ps_to_bit_depth_avx2<out_bit_depth>(y1f[1]));
+            store_yuv_16px_avx2(dstA0 + x, alpha_8_to_bit_depth_avx2<out_bit_depth>(yA0[0]), alpha_8_to_bit_depth_avx2<out_bit_depth>(yA0[1]));
+            store_yuv_16px_avx2(dstA1 + x, alpha_8_to_bit_depth_avx2<out_bit_depth>(yA1[0]), alpha_8_to_bit_depth_avx2<out_bit_depth>(yA1[1]));
+            //横2画素の和をとってから上下の和をとる (C版と同じ順序)
+            //haddは128bitレーンごとに行われるので、64bit単位で並べなおす
+            const __m256 u = _mm256_mul_ps(_mm256_add_ps(_mm256_hadd_ps(u0f[0], u0f[1]), _mm256_hadd_ps(u1f[0], u1f[1])), yQuarter);
+            const __m256 v = _mm256_mul_ps(_mm256_add_ps(_mm256_hadd_ps(v0f[0], v0f[1]), _mm256_hadd_ps(v1f[0], v1f[1])), yQuarter);
+            store_yuv_8px_avx2(dstU + (x>>1), _mm256_permute4x64_epi64(yuv_ps_to_bit_depth_avx2<out_bit_depth>(u), _MM_SHUFFLE(3, 1, 2, 0)));
+            store_yuv_8px_avx2(dstV + (x>>1), _mm256_permute4x64_epi64(yuv_ps_to_bit_depth_avx2<out_bit_depth>(v), _MM_SHUFFLE(3, 1, 2, 0)));
+        }
+        //残りはC版と同じ方法で処理
+        for (; x < width; x += 2) {
+            convert_rgba_to_yuva420_2x2<TypeOut, out_bit_depth, unpremultiply>(dstY0, dstY1, dstU, dstV, dstA0, dstA1, src0, src1, x, coeff_table);
+        }
+    }
+    _mm256_zeroupper();
+}
+
+template<typename TypeOut, int out_bit_depth, bool unpremultiply>
+static void convert_rgba_to_yuva444_avx2_base(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    BYTE *ptrY = pixel_data->data[0];
+    BYTE *ptrU = pixel_data->data[1];
+    BYTE *ptrV = pixel_data->data[2];
+    BYTE *ptrA = pixel_data->data[3];
+    const float *coeff_table = COEFF_RGB2YUV[pixel_data->colormatrix ? 1 : 0];
+    __m256 yCoeff[9];
+    for (int i = 0; i < 9; i++) {
+        yCoeff[i] = _mm256_set1_ps(coeff_table[i]);
+    }
+    int y0 = 0, y1 = height - 1;
+    const int srcstep = width * 4;
+    for (; y0 < height; y0++, y1--) {
+        TypeOut *dstY = (TypeOut *)(ptrY + y1*width*sizeof(TypeOut));
+        TypeOut *dstU = (TypeOut *)(ptrU + y1*width*sizeof(TypeOut));
+        TypeOut *dstV = (TypeOut *)(ptrV + y1*width*sizeof(TypeOut));
+        TypeOut *dstA = (TypeOut *)(ptrA + y1*width*sizeof(TypeOut));
+        BYTE *src = (BYTE*)frame + y0*srcstep;
+        int x = 0;
+        //16画素 (64byte) ずつ処理する
+        for (; x <= width - 16; x += 16) {
+            __m256 yf[2], uf[2], vf[2];
+            __m256i yA[2];
+            for (int i = 0; i < 2; i++) {
+                convert_rgba_to_yuv_8px_avx2<unpremultiply>(yf[i], uf[i], vf[i], yA[i], _mm256_loadu_si256((const __m256i *)(src + (x + i*8)*4)), yCoeff);
+            }
+            store_yuv_16px_avx2(dstY + x, yuv_ps_to_bit_depth_avx2<out_bit_depth>(yf[0]), yuv_ps_to_bit_depth_avx2<out_bit_depth>(yf[1]));
+            store_yuv_16px_avx2(dstU + x, yuv_ps_to_bit_depth_avx2<out_bit_depth>(uf[0]), yuv_ps_to_bit_depth_avx2<out_bit_depth>(uf[1]));
+            store_yuv_16px_avx2(dstV + x, yuv_ps_to_bit_depth_avx2<out_bit_depth>(vf[0]), yuv_ps_to_bit_depth_avx2<out_bit_depth>(vf[1]));
+            store_yuv_16px_avx2(dstA + x, alpha_8_to_bit_depth_avx2<out_bit_depth>(yA[0]), alpha_8_to_bit_depth_avx2<out_bit_depth>(yA[1]));
+        }
+        //残りはC版と同じ方法で処理
+        for (; x < width; x++) {
+            convert_rgba_to_yuva444_1px<TypeOut, out_bit_depth, unpremultiply>(dstY, dstU, dstV, dstA, src, x, coeff_table);
+        }
+    }
+    _mm256_zeroupper();
+}
+
+void convert_rgba_to_yuva420_avx2(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva420_avx2_base<BYTE, 8, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva420_avx2_base<BYTE, 8, false>(frame, pixel_data, width, height);
+}
+void convert_rgba_to_yuva420_10bit_avx2(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva420_avx2_base<USHORT, 10, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva420_avx2_base<USHORT, 10, false>(frame, pixel_data, width, height);
+}
+void convert_rgba_to_yuva420_16bit_avx2(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva420_avx2_base<USHORT, 16, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva420_avx2_base<USHORT, 16, false>(frame, pixel_data, width, height);
+}
+void convert_rgba_to_yuva444_avx2(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva444_avx2_base<BYTE, 8, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva444_avx2_base<BYTE, 8, false>(frame, pixel_data, width, height);
+}
+void convert_rgba_to_yuva444_10bit_avx2(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva444_avx2_base<USHORT, 10, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva444_avx2_base<USHORT, 10, false>(frame, pixel_data, width, height);
+}
+void convert_rgba_to_yuva444_16bit_avx2(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva444_avx2_base<USHORT, 16, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva444_avx2_base<USHORT, 16, false>(frame, pixel_data, width, height);
+}
+
 void convert_yuy2_to_yuv422_avx2(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
     int x, y;
     BYTE *p, *Y, *U, *V;
@@ -1825,3 +2219,284 @@ void convert_yuy2_to_yuv422_16bit_avx2(void *frame, CONVERT_CF_DATA *pixel_data,
     }
     _mm256_zeroupper();
 }
+
+//縮小 (面積平均) しながら変換する
+//入力の幅は32で割り切れること
+template<int ratio>
+static void __forceinline convert_yuy2_to_nv12_shrink_avx2(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    const int RSH_Y = (ratio == 2) ? 2 : 4; //ratio*ratio画素の平均
+    const int RSH_C = RSH_Y + 1;            //色差は横方向が半分なので、ratio*ratio*2個の平均
+    const int out_w = width / ratio;
+    const int pitch = width * 2;
+    const __m256i yC_MASK_Y = _mm256_set1_epi16(0x00ff);
+    const __m256i yC_pw_one = _mm256_set1_epi16(1);
+    for (int y = 0; y < height; y += ratio * 2) {
+        const BYTE *p = (BYTE *)frame + y * pitch;
+        BYTE *Y0 = pixel_data->data[0] + (y / ratio) * out_w;
+        BYTE *Y1 = Y0 + out_w;
+        BYTE *C  = pixel_data->data[1] + (y / ratio / 2) * out_w;
+        for (int x = 0; x < width; x += 32) {
+            //A: 前半16画素, B: 後半16画素
+            __m256i yYA[2] = { _mm256_setzero_si256(), _mm256_setzero_si256() };
+            __m256i yYB[2] = { _mm256_setzero_si256(), _mm256_setzero_si256() };
+            __m256i yCA = _mm256_setzero_si256();
+            __m256i yCB = _mm256_setzero_si256();
+            for (int j = 0; j < ratio * 2; j++) {
+                const __m256i y0 = _mm256_loadu_si256((const __m256i *)(p + j * pitch + x * 2));
+                const __m256i y1 = _mm256_loadu_si256((const __m256i *)(p + j * pitch + x * 2 + 32));
+                yYA[j / ratio] = _mm256_add_epi16(yYA[j / ratio], _mm256_and_si256(y0, yC_MASK_Y));
+                yYB[j / ratio] = _mm256_add_epi16(yYB[j / ratio], _mm256_and_si256(y1, yC_MASK_Y));
+                yCA = _mm256_add_epi16(yCA, _mm256_srli_epi16(y0, 8));
+                yCB = _mm256_add_epi16(yCB, _mm256_srli_epi16(y1, 8));
+            }
+            BYTE *Y[2] = { Y0, Y1 };
+            for (int i = 0; i < 2; i++) {
+                //横2画素ずつ足す
+                __m256i y0 = _mm256_madd_epi16(yYA[i], yC_pw_one);
+                __m256i y1 = _mm256_madd_epi16(yYB[i], yC_pw_one);
+                if (ratio == 2) {
+                    y0 = _mm256_srai_epi32(_mm256_add_epi32(y0, _mm256_set1_epi32(1 << (RSH_Y - 1))), RSH_Y);
+                    y1 = _mm256_srai_epi32(_mm256_add_epi32(y1, _mm256_set1_epi32(1 << (RSH_Y - 1))), RSH_Y);
+                    y0 = _mm256_permute4x64_epi64(_mm256_packs_epi32(y0, y1), _MM_SHUFFLE(3,1,2,0));
+                    _mm_storeu_si128((__m128i *)(Y[i] + x / ratio), _mm_packus_epi16(_mm256_castsi256_si128(y0), _mm256_extracti128_si256(y0, 1)));
+                } else {
+                    y0 = _mm256_hadd_epi32(y0, y1);
+                    y0 = _mm256_srai_epi32(_mm256_add_epi32(y0, _mm256_set1_epi32(1 << (RSH_Y - 1))), RSH_Y);
+                    y0 = _mm256_permute4x64_epi64(y0, _MM_SHUFFLE(3,1,2,0));
+                    const __m128i x0 = _mm_packs_epi32(_mm256_castsi256_si128(y0), _mm256_extracti128_si256(y0, 1));
+                    _mm_storel_epi64((__m128i *)(Y[i] + x / ratio), _mm_packus_epi16(x0, x0));
+                }
+            }
+            //色差 (U, Vが交互に並んでいる) は、横に隣接するU同士、V同士を足す
+            yCA = _mm256_add_epi16(yCA, _mm256_srli_epi64(yCA, 32));
+            yCB = _mm256_add_epi16(yCB, _mm256_srli_epi64(yCB, 32));
+            if (ratio == 2) {
+                yCA = _mm256_srli_epi16(_mm256_add_epi16(yCA, _mm256_set1_epi16(1 << (RSH_C - 1))), RSH_C);
+                yCB = _mm256_srli_epi16(_mm256_add_epi16(yCB, _mm256_set1_epi16(1 << (RSH_C - 1))), RSH_C);
+                yCA = _mm256_shuffle_epi32(yCA, _MM_SHUFFLE(2,0,2,0));
+                yCB = _mm256_shuffle_epi32(yCB, _MM_SHUFFLE(2,0,2,0));
+                yCA = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(yCA, yCB), _MM_SHUFFLE(3,1,2,0));
+                _mm_storeu_si128((__m128i *)(C + x / ratio), _mm_packus_epi16(_mm256_castsi256_si128(yCA), _mm256_extracti128_si256(yCA, 1)));
+            } else {
+                yCA = _mm256_add_epi16(yCA, _mm256_srli_si256(yCA, 8));
+                yCB = _mm256_add_epi16(yCB, _mm256_srli_si256(yCB, 8));
+                yCA = _mm256_srli_epi16(_mm256_add_epi16(yCA, _mm256_set1_epi16(1 << (RSH_C - 1))), RSH_C);
+                yCB = _mm256_srli_epi16(_mm256_add_epi16(yCB, _mm256_set1_epi16(1 << (RSH_C - 1))), RSH_C);
+                yCA = _mm256_permutevar8x32_epi32(_mm256_unpacklo_epi32(yCA, yCB), _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+                const __m128i x0 = _mm256_castsi256_si128(yCA);
+                _mm_storel_epi64((__m128i *)(C + x / ratio), _mm_packus_epi16(x0, x0));
+            }
+        }
+    }
+    _mm256_zeroupper();
+}
+
+void convert_yuy2_to_nv12_half_avx2(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yuy2_to_nv12_shrink_avx2<2>(frame, pixel_data, width, height);
+}
+
+void convert_yuy2_to_nv12_quarter_avx2(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yuy2_to_nv12_shrink_avx2<4>(frame, pixel_data, width, height);
+}
+
+//YC48は平均をとってから変換する (C版と同じ)
+//入力の幅は32で割り切れること
+template<int ratio>
+static void __forceinline convert_yc48_to_nv12_16bit_shrink_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    const int RSH_Y = (ratio == 2) ? 2 : 4; //ratio*ratio画素の平均
+    const int RSH_C = RSH_Y + 1;            //(ratio*2)*(ratio*2)画素 -> 2画素分の和
+    const int out_w = width / ratio;
+    const __m256i yC_pw_one = _mm256_set1_epi16(1);
+    const __m256i yC_max = _mm256_set1_epi16((short)LIMIT_16);
+    const __m256i yC_YCC = _mm256_set1_epi32(1<<LSFT_YCC_16);
+    for (int y = 0; y < height; y += ratio * 2) {
+        short *Y[2];
+        Y[0] = (short *)pixel_data->data[0] + (y / ratio) * out_w;
+        Y[1] = Y[0] + out_w;
+        short *C = (short *)pixel_data->data[1] + (y / ratio / 2) * out_w;
+        for (int x = 0; x < width; x += 32) {
+            //横2画素ずつの和 ([出力の行][前半/後半16画素])
+            __m256i yY[2][2] = { { _mm256_setzero_si256(), _mm256_setzero_si256() }, { _mm256_setzero_si256(), _mm256_setzero_si256() } };
+            __m256i yU[2] = { _mm256_setzero_si256(), _mm256_setzero_si256() };
+            __m256i yV[2] = { _mm256_setzero_si256(), _mm256_setzero_si256() };
+            for (int j = 0; j < ratio * 2; j++) {
+                const short *ycp = (short *)pixel + ((y + j) * width + x) * 3;
+                for (int h = 0; h < 2; h++, ycp += 48) {
+                    __m256i y0 = _mm256_loadu_si256((const __m256i *)(ycp +  0));
+                    __m256i y1 = _mm256_loadu_si256((const __m256i *)(ycp + 16));
+                    __m256i y2 = _mm256_loadu_si256((const __m256i *)(ycp + 32));
+                    gather_y_u_v_from_yc48(y0, y1, y2);
+                    yY[j / ratio][h] = _mm256_add_epi32(yY[j / ratio][h], _mm256_madd_epi16(y0, yC_pw_one));
+                    yU[h] = _mm256_add_epi32(yU[h], _mm256_madd_epi16(y1, yC_pw_one));
+                    yV[h] = _mm256_add_epi32(yV[h], _mm256_madd_epi16(y2, yC_pw_one));
+                }
+            }
+            for (int i = 0; i < 2; i++) {
+                if (ratio == 2) {
+                    __m256i y0 = _mm256_srai_epi32(_mm256_add_epi32(yY[i][0], _mm256_set1_epi32(1 << (RSH_Y - 1))), RSH_Y);
+                    __m256i y1 = _mm256_srai_epi32(_mm256_add_epi32(yY[i][1], _mm256_set1_epi32(1 << (RSH_Y - 1))), RSH_Y);
+                    y0 = _mm256_permute4x64_epi64(_mm256_packs_epi32(y0, y1), _MM_SHUFFLE(3,1,2,0));
+                    _mm256_storeu_si256((__m256i *)(Y[i] + x / ratio), convert_y_range_from_yc48(y0, yC_Y_L_MA_16, Y_L_RSH_16, yC_YCC, yC_pw_one, yC_max));
+                } else {
+                    __m256i y0 = _mm256_hadd_epi32(yY[i][0], yY[i][1]);
+                    y0 = _mm256_srai_epi32(_mm256_add_epi32(y0, _mm256_set1_epi32(1 << (RSH_Y - 1))), RSH_Y);
+                    y0 = _mm256_permute4x64_epi64(y0, _MM_SHUFFLE(3,1,2,0));
+                    y0 = _mm256_broadcastsi128_si256(_mm_packs_epi32(_mm256_castsi256_si128(y0), _mm256_extracti128_si256(y0, 1)));
+                    _mm_storeu_si128((__m128i *)(Y[i] + x / ratio), _mm256_castsi256_si128(convert_y_range_from_yc48(y0, yC_Y_L_MA_16, Y_L_RSH_16, yC_YCC, yC_pw_one, yC_max)));
+                }
+            }
+            //横4画素 (ratio=4なら8画素) の和にして、U, Vを交互に並べる
+            __m256i y0 = _mm256_hadd_epi32(yU[0], yV[0]);
+            __m256i y1 = _mm256_hadd_epi32(yU[1], yV[1]);
+            if (ratio == 2) {
+                y0 = _mm256_shuffle_epi32(y0, _MM_SHUFFLE(3,1,2,0));
+                y1 = _mm256_shuffle_epi32(y1, _MM_SHUFFLE(3,1,2,0));
+                y0 = _mm256_srai_epi32(_mm256_add_epi32(y0, _mm256_set1_epi32(1 << (RSH_C - 1))), RSH_C);
+                y1 = _mm256_srai_epi32(_mm256_add_epi32(y1, _mm256_set1_epi32(1 << (RSH_C - 1))), RSH_C);
+                y0 = _mm256_permute4x64_epi64(_mm256_packs_epi32(y0, y1), _MM_SHUFFLE(3,1,2,0));
+                y0 = _mm256_add_epi16(y0, _mm256_set1_epi16(UV_OFFSET_x2));
+                _mm256_storeu_si256((__m256i *)(C + x / ratio), convert_uv_range_after_adding_offset(y0, yC_UV_L_MA_16_420P, UV_L_RSH_16_420P, yC_YCC, yC_pw_one, yC_max));
+            } else {
+                y0 = _mm256_hadd_epi32(y0, y1);
+                y0 = _mm256_srai_epi32(_mm256_add_epi32(y0, _mm256_set1_epi32(1 << (RSH_C - 1))), RSH_C);
+                y0 = _mm256_permute4x64_epi64(y0, _MM_SHUFFLE(3,1,2,0));
+                y0 = _mm256_broadcastsi128_si256(_mm_packs_epi32(_mm256_castsi256_si128(y0), _mm256_extracti128_si256(y0, 1)));
+                y0 = _mm256_add_epi16(y0, _mm256_set1_epi16(UV_OFFSET_x2));
+                _mm_storeu_si128((__m128i *)(C + x / ratio), _mm256_castsi256_si128(convert_uv_range_after_adding_offset(y0, yC_UV_L_MA_16_420P, UV_L_RSH_16_420P, yC_YCC, yC_pw_one, yC_max)));
+            }
+        }
+    }
+    _mm256_zeroupper();
+}
+
+void convert_yc48_to_nv12_16bit_half_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_16bit_shrink_avx2<2>(pixel, pixel_data, width, height);
+}
+
+void convert_yc48_to_nv12_16bit_quarter_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_16bit_shrink_avx2<4>(pixel, pixel_data, width, height);
+}
+
+//縮小の縦方向の積和
+//8bitは2行ずつunpackしてmaddで処理する
+void resize_vertical_8bit_avx2(int *tmp, const BYTE *src, int src_pitch, int count, const short *weight, int taps) {
+    const __m256i yRound = _mm256_set1_epi32(1 << (RESIZE_V_RSH_8 - 1));
+    int x = 0;
+    for (; x + 16 <= count; x += 16) {
+        const BYTE *ptr = src + x;
+        __m256i ySum0 = yRound, ySum1 = yRound;
+        int k = 0;
+        for (; k + 2 <= taps; k += 2, ptr += src_pitch * 2) {
+            const __m256i y0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(ptr)));
+            const __m256i y1 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(ptr + src_pitch)));
+            const __m256i yWeight = _mm256_set1_epi32((int)(((DWORD)(USHORT)weight[k+1] << 16) | (DWORD)(USHORT)weight[k]));
+            ySum0 = _mm256_add_epi32(ySum0, _mm256_madd_epi16(_mm256_unpacklo_epi16(y0, y1), yWeight));
+            ySum1 = _mm256_add_epi32(ySum1, _mm256_madd_epi16(_mm256_unpackhi_epi16(y0, y1), yWeight));
+        }
+        if (k < taps) {
+            const __m256i y0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(ptr)));
+            const __m256i yWeight = _mm256_set1_epi32((int)(DWORD)(USHORT)weight[k]);
+            ySum0 = _mm256_add_epi32(ySum0, _mm256_madd_epi16(_mm256_unpacklo_epi16(y0, _mm256_setzero_si256()), yWeight));
+            ySum1 = _mm256_add_epi32(ySum1, _mm256_madd_epi16(_mm256_unpackhi_epi16(y0, _mm256_setzero_si256()), yWeight));
+        }
+        ySum0 = _mm256_srai_epi32(ySum0, RESIZE_V_RSH_8);
+        ySum1 = _mm256_srai_epi32(ySum1, RESIZE_V_RSH_8);
+        _mm256_storeu_si256((__m256i *)(tmp + x + 0), _mm256_permute2x128_si256(ySum0, ySum1, (2<<4) | 0));
+        _mm256_storeu_si256((__m256i *)(tmp + x + 8), _mm256_permute2x128_si256(ySum0, ySum1, (3<<4) | 1));
+    }
+    _mm256_zeroupper();
+    if (x < count)
+        resize_vertical_8bit(tmp + x, src + x, src_pitch, count - x, weight, taps);
+}
+
+void resize_vertical_16bit_avx2(int *tmp, const BYTE *src, int src_pitch, int count, const short *weight, int taps) {
+    const __m256i yRound = _mm256_set1_epi32(1 << (RESIZE_V_RSH_16 - 1));
+    int x = 0;
+    for (; x + 16 <= count; x += 16) {
+        const BYTE *ptr = src + x * sizeof(USHORT);
+        __m256i ySum0 = yRound, ySum1 = yRound;
+        for (int k = 0; k < taps; k++, ptr += src_pitch) {
+            const __m256i yWeight = _mm256_set1_epi32(weight[k]);
+            ySum0 = _mm256_add_epi32(ySum0, _mm256_mullo_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(ptr +  0))), yWeight));
+            ySum1 = _mm256_add_epi32(ySum1, _mm256_mullo_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(ptr + 16))), yWeight));
+        }
+        _mm256_storeu_si256((__m256i *)(tmp + x + 0), _mm256_srai_epi32(ySum0, RESIZE_V_RSH_16));
+        _mm256_storeu_si256((__m256i *)(tmp + x + 8), _mm256_srai_epi32(ySum1, RESIZE_V_RSH_16));
+    }
+    _mm256_zeroupper();
+    if (x < count)
+        resize_vertical_16bit(tmp + x, src + x * sizeof(USHORT), src_pitch, count - x, weight, taps);
+}
+
+void convert_yc48_to_p012_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_P012::run<CONV_SIMD_AVX2>(pixel, pixel_data, width, height);
+    _mm256_zeroupper();
+}
+void convert_yc48_to_p012_i_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_P012_I::run<CONV_SIMD_AVX2>(pixel, pixel_data, width, height);
+    _mm256_zeroupper();
+}
+void convert_yc48_to_yuv444_12bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_YUV444_12::run<CONV_SIMD_AVX2>(pixel, pixel_data, width, height);
+    _mm256_zeroupper();
+}
+void convert_yc48_to_p210_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_P210::run<CONV_SIMD_AVX2>(pixel, pixel_data, width, height);
+    _mm256_zeroupper();
+}
+void convert_yc48_to_y210_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_Y210::run<CONV_SIMD_AVX2>(pixel, pixel_data, width, height);
+    _mm256_zeroupper();
+}
+void convert_yuy2_to_p012_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_P012::run<CONV_SIMD_AVX2>(pixel, pixel_data, width, height);
+    _mm256_zeroupper();
+}
+void convert_yuy2_to_p012_i_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_P012_I::run<CONV_SIMD_AVX2>(pixel, pixel_data, width, height);
+    _mm256_zeroupper();
+}
+void convert_yuy2_to_yuv444_12bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_YUV444_12::run<CONV_SIMD_AVX2>(pixel, pixel_data, width, height);
+    _mm256_zeroupper();
+}
+void convert_yuy2_to_p210_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_P210::run<CONV_SIMD_AVX2>(pixel, pixel_data, width, height);
+    _mm256_zeroupper();
+}
+void convert_yuy2_to_y210_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_Y210::run<CONV_SIMD_AVX2>(pixel, pixel_data, width, height);
+    _mm256_zeroupper();
+}
+void convert_yc48_to_yuv420_10bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_YUV420_10::run<CONV_SIMD_AVX2>(pixel, pixel_data, width, height);
+    _mm256_zeroupper();
+}
+void convert_yc48_to_yuv420_i_10bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_YUV420_10_I::run<CONV_SIMD_AVX2>(pixel, pixel_data, width, height);
+    _mm256_zeroupper();
+}
+void convert_yc48_to_yuv420_16bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_YUV420_16::run<CONV_SIMD_AVX2>(pixel, pixel_data, width, height);
+    _mm256_zeroupper();
+}
+void convert_yc48_to_yuv420_i_16bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_YUV420_16_I::run<CONV_SIMD_AVX2>(pixel, pixel_data, width, height);
+    _mm256_zeroupper();
+}
+void convert_yuy2_to_yuv420_10bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_YUV420_10::run<CONV_SIMD_AVX2>(pixel, pixel_data, width, height);
+    _mm256_zeroupper();
+}
+void convert_yuy2_to_yuv420_i_10bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_YUV420_10_I::run<CONV_SIMD_AVX2>(pixel, pixel_data, width, height);
+    _mm256_zeroupper();
+}
+void convert_yuy2_to_yuv420_16bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_YUV420_16::run<CONV_SIMD_AVX2>(pixel, pixel_data, width, height);
+    _mm256_zeroupper();
+}
+void convert_yuy2_to_yuv420_i_16bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_YUV420_16_I::run<CONV_SIMD_AVX2>(pixel, pixel_data, width, height);
+    _mm256_zeroupper();
+}
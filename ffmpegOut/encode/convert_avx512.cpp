@@ -1009,45 +1009,335 @@ void convert_yc48_to_yuv444_16bit_avx512vbmi(void *pixel, CONVERT_CF_DATA *pixel
     convert_yc48_to_yuv444_16bit_avx512<true>(pixel, pixel_data, width, height);
 }
 
-#if 0
-void convert_yuy2_to_nv16_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
-    BYTE *p = (BYTE *)pixel;
-    BYTE * const p_fin = p + width * height * 2;
+//4:2:2出力用の端数処理
+//  1フレーム全体を連続した配列として処理し、最後のループのみマスク付きのload/storeで端数を処理する
+//  aligned_store=trueのとき (幅が処理単位で割り切れる場合) は端数が出ないので、マスクなしのalignedなstoreを使用する
+static __forceinline __mmask64 tail_mask_epi8(int remain) {
+    return (remain >= 64) ? (__mmask64)-1 : ((remain <= 0) ? (__mmask64)0 : (__mmask64)((1ull << remain) - 1));
+}
+static __forceinline __mmask32 tail_mask_epi16(int remain) {
+    return (remain >= 32) ? (__mmask32)-1 : ((remain <= 0) ? (__mmask32)0 : (__mmask32)((1u << remain) - 1));
+}
+template<bool aligned_store>
+static __forceinline __m512i load_tail_epi8(const void *ptr, int remain) {
+    return (aligned_store) ? _mm512_loadu_si512(ptr) : _mm512_maskz_loadu_epi8(tail_mask_epi8(remain), ptr);
+}
+template<bool aligned_store>
+static __forceinline __m512i load_tail_epi16(const void *ptr, int remain) {
+    return (aligned_store) ? _mm512_loadu_si512(ptr) : _mm512_maskz_loadu_epi16(tail_mask_epi16(remain), ptr);
+}
+template<bool aligned_store>
+static __forceinline void store_tail_epi8(void *ptr, __m512i z, int remain) {
+    if (aligned_store) {
+        _mm512_store_si512(ptr, z);
+    } else {
+        _mm512_mask_storeu_epi8(ptr, tail_mask_epi8(remain), z);
+    }
+}
+//下位256bitのみを書き込む
+template<bool aligned_store>
+static __forceinline void store_tail_lower_epi8(void *ptr, __m512i z, int remain) {
+    if (aligned_store) {
+        _mm256_store_si256((__m256i *)ptr, _mm512_castsi512_si256(z));
+    } else {
+        _mm512_mask_storeu_epi8(ptr, tail_mask_epi8((remain < 32) ? remain : 32), z);
+    }
+}
+template<bool aligned_store>
+static __forceinline void store_tail_epi16(void *ptr, __m512i z, int remain) {
+    if (aligned_store) {
+        _mm512_store_si512(ptr, z);
+    } else {
+        _mm512_mask_storeu_epi16(ptr, tail_mask_epi16(remain), z);
+    }
+}
+
+alignas(64) static const char YUY2_SHUFFLE_Y_AVX512_VBMI[64] = {
+      0,   2,   4,   6,   8,  10,  12,  14,  16,  18,  20,  22,  24,  26,  28,  30,  32,  34,  36,  38,  40,  42,  44,  46,  48,  50,  52,  54,  56,  58,  60,  62,
+     64,  66,  68,  70,  72,  74,  76,  78,  80,  82,  84,  86,  88,  90,  92,  94,  96,  98, 100, 102, 104, 106, 108, 110, 112, 114, 116, 118, 120, 122, 124, 126
+};
+alignas(64) static const char YUY2_SHUFFLE_C_AVX512_VBMI[64] = {
+      1,   3,   5,   7,   9,  11,  13,  15,  17,  19,  21,  23,  25,  27,  29,  31,  33,  35,  37,  39,  41,  43,  45,  47,  49,  51,  53,  55,  57,  59,  61,  63,
+     65,  67,  69,  71,  73,  75,  77,  79,  81,  83,  85,  87,  89,  91,  93,  95,  97,  99, 101, 103, 105, 107, 109, 111, 113, 115, 117, 119, 121, 123, 125, 127
+};
+
+//YUY2 (128byte) -> Y (64byte), C (UVUV...64byte)
+template<bool avx512vbmi>
+static __forceinline void separate_y_c_from_yuy2(__m512i& z0_return_y, __m512i& z1_return_c) {
+    if (avx512vbmi) {
+        const __m512i z0 = z0_return_y;
+        const __m512i z1 = z1_return_c;
+        z0_return_y = _mm512_permutex2var_epi8(z0, _mm512_load_si512((const __m512i *)YUY2_SHUFFLE_Y_AVX512_VBMI), z1);
+        z1_return_c = _mm512_permutex2var_epi8(z0, _mm512_load_si512((const __m512i *)YUY2_SHUFFLE_C_AVX512_VBMI), z1);
+    } else {
+        separate_low_up(z0_return_y, z1_return_c);
+    }
+}
+
+template<bool avx512vbmi, bool aligned_store>
+void __forceinline convert_yuy2_to_nv16_avx512(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    const BYTE *p = (const BYTE *)pixel;
     BYTE *dst_Y = pixel_data->data[0];
     BYTE *dst_C = pixel_data->data[1];
-    __m512i z0, z1;
-    for (; p < p_fin; p += 64, dst_Y += 32, dst_C += 32) {
-        z0 = _mm512_set_m128i(_mm_loadu_si128((__m128i*)(p+32)), _mm_loadu_si128((__m128i*)(p+ 0)));
-        z1 = _mm512_set_m128i(_mm_loadu_si128((__m128i*)(p+48)), _mm_loadu_si128((__m128i*)(p+16)));
+    const int n = width * height;
+    for (int i = 0; i < n; i += 64, p += 128) {
+        const int remain = n - i;
+        __m512i z0 = load_tail_epi8<aligned_store>(p +  0, remain * 2 -  0);
+        __m512i z1 = load_tail_epi8<aligned_store>(p + 64, remain * 2 - 64);
+
+        separate_y_c_from_yuy2<avx512vbmi>(z0, z1);
+
+        store_tail_epi8<aligned_store>(dst_Y + i, z0, remain);
+        store_tail_epi8<aligned_store>(dst_C + i, z1, remain);
+    }
+}
+
+void convert_yuy2_to_nv16_avx512bw(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yuy2_to_nv16_avx512<false, false>(pixel, pixel_data, width, height);
+}
+
+void convert_yuy2_to_nv16_avx512vbmi(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yuy2_to_nv16_avx512<true, false>(pixel, pixel_data, width, height);
+}
+
+void convert_yuy2_to_nv16_avx512bw_mod64(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yuy2_to_nv16_avx512<false, true>(pixel, pixel_data, width, height);
+}
+
+void convert_yuy2_to_nv16_avx512vbmi_mod64(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yuy2_to_nv16_avx512<true, true>(pixel, pixel_data, width, height);
+}
+
+//YUY2は16bit単位で見ると Y | C<<8 となっているので、シャッフルなしに16bitへ拡張できる
+//  Y = (YUY2 << 8), C = (YUY2 & 0xff00)
+//  並べ替えが不要なので、AVX512VBMI版は用意しない
+template<bool aligned_store>
+void __forceinline convert_yuy2_to_nv16_16bit_avx512(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    const BYTE *p = (const BYTE *)pixel;
+    USHORT *dst_Y = (USHORT *)pixel_data->data[0];
+    USHORT *dst_C = (USHORT *)pixel_data->data[1];
+    const int n = width * height;
+    const __m512i zC_mask_hi = _mm512_slli_epi16(_mm512_all_one, 8);
+    for (int i = 0; i < n; i += 32, p += 64) {
+        const int remain = n - i;
+        const __m512i z0 = load_tail_epi8<aligned_store>(p, remain * 2);
+
+        store_tail_epi16<aligned_store>(dst_Y + i, _mm512_slli_epi16(z0, 8), remain);
+        store_tail_epi16<aligned_store>(dst_C + i, _mm512_and_si512(z0, zC_mask_hi), remain);
+    }
+}
+
+void convert_yuy2_to_nv16_16bit_avx512bw(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yuy2_to_nv16_16bit_avx512<false>(pixel, pixel_data, width, height);
+}
+
+void convert_yuy2_to_nv16_16bit_avx512bw_mod32(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yuy2_to_nv16_16bit_avx512<true>(pixel, pixel_data, width, height);
+}
 
-        separate_low_up(z0, z1);
+alignas(64) static const char YUY2_SHUFFLE_U_V_AVX512_VBMI[64] = {
+      1,   5,   9,  13,  17,  21,  25,  29,  33,  37,  41,  45,  49,  53,  57,  61,  65,  69,  73,  77,  81,  85,  89,  93,  97, 101, 105, 109, 113, 117, 121, 125,
+      3,   7,  11,  15,  19,  23,  27,  31,  35,  39,  43,  47,  51,  55,  59,  63,  67,  71,  75,  79,  83,  87,  91,  95,  99, 103, 107, 111, 115, 119, 123, 127
+};
+
+template<bool avx512vbmi, bool aligned_store>
+void __forceinline convert_yuy2_to_yuv422_avx512(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    const BYTE *p = (const BYTE *)pixel;
+    BYTE *dst_Y = pixel_data->data[0];
+    BYTE *dst_U = pixel_data->data[1];
+    BYTE *dst_V = pixel_data->data[2];
+    const int n = width * height;
+    for (int i = 0; i < n; i += 64, p += 128) {
+        const int remain = n - i;
+        __m512i z0 = load_tail_epi8<aligned_store>(p +  0, remain * 2 -  0);
+        __m512i z1 = load_tail_epi8<aligned_store>(p + 64, remain * 2 - 64);
+        __m512i zUV;
+        if (avx512vbmi) {
+            zUV = _mm512_permutex2var_epi8(z0, _mm512_load_si512((const __m512i *)YUY2_SHUFFLE_U_V_AVX512_VBMI), z1);
+            z0  = _mm512_permutex2var_epi8(z0, _mm512_load_si512((const __m512i *)YUY2_SHUFFLE_Y_AVX512_VBMI), z1);
+        } else {
+            separate_low_up(z0, z1);
+            //UVUV... -> UUUU...(256bit) VVVV...(256bit)
+            zUV = _mm512_packus_epi16(_mm512_and_si512(z1, _mm512_srli_epi16(_mm512_all_one, 8)), _mm512_srli_epi16(z1, 8));
+            zUV = _mm512_permutexvar_epi64(zC_packus_shuffle, zUV);
+        }
+        store_tail_epi8<aligned_store>(dst_Y + i, z0, remain);
+        store_tail_lower_epi8<aligned_store>(dst_U + (i>>1), zUV, remain>>1);
+        store_tail_lower_epi8<aligned_store>(dst_V + (i>>1), _mm512_shuffle_i64x2(zUV, zUV, _MM_SHUFFLE(3, 2, 3, 2)), remain>>1);
+    }
+}
+
+void convert_yuy2_to_yuv422_avx512bw(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yuy2_to_yuv422_avx512<false, false>(pixel, pixel_data, width, height);
+}
 
-        _mm512_storeu_si512((__m512i *)dst_Y, z0);
-        _mm512_storeu_si512((__m512i *)dst_C, z1);
+void convert_yuy2_to_yuv422_avx512vbmi(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yuy2_to_yuv422_avx512<true, false>(pixel, pixel_data, width, height);
+}
+
+void convert_yuy2_to_yuv422_avx512bw_mod64(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yuy2_to_yuv422_avx512<false, true>(pixel, pixel_data, width, height);
+}
+
+void convert_yuy2_to_yuv422_avx512vbmi_mod64(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yuy2_to_yuv422_avx512<true, true>(pixel, pixel_data, width, height);
+}
+
+//U, Vを16bitの上位8bitに配置し、下位8bitは0とする (下位8bitはマスクで0にする)
+alignas(64) static const char YUY2_SHUFFLE_U_16BIT_AVX512_VBMI[64] = {
+      0,   1,   0,   5,   0,   9,   0,  13,   0,  17,   0,  21,   0,  25,   0,  29,   0,  33,   0,  37,   0,  41,   0,  45,   0,  49,   0,  53,   0,  57,   0,  61,
+      0,  65,   0,  69,   0,  73,   0,  77,   0,  81,   0,  85,   0,  89,   0,  93,   0,  97,   0, 101,   0, 105,   0, 109,   0, 113,   0, 117,   0, 121,   0, 125
+};
+alignas(64) static const char YUY2_SHUFFLE_V_16BIT_AVX512_VBMI[64] = {
+      0,   3,   0,   7,   0,  11,   0,  15,   0,  19,   0,  23,   0,  27,   0,  31,   0,  35,   0,  39,   0,  43,   0,  47,   0,  51,   0,  55,   0,  59,   0,  63,
+      0,  67,   0,  71,   0,  75,   0,  79,   0,  83,   0,  87,   0,  91,   0,  95,   0,  99,   0, 103,   0, 107,   0, 111,   0, 115,   0, 119,   0, 123,   0, 127
+};
+
+template<bool avx512vbmi, bool aligned_store>
+void __forceinline convert_yuy2_to_yuv422_16bit_avx512(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    const BYTE *p = (const BYTE *)pixel;
+    USHORT *dst_Y = (USHORT *)pixel_data->data[0];
+    USHORT *dst_U = (USHORT *)pixel_data->data[1];
+    USHORT *dst_V = (USHORT *)pixel_data->data[2];
+    const int n = width * height;
+    for (int i = 0; i < n; i += 64, p += 128) {
+        const int remain = n - i;
+        const __m512i z0 = load_tail_epi8<aligned_store>(p +  0, remain * 2 -  0);
+        const __m512i z1 = load_tail_epi8<aligned_store>(p + 64, remain * 2 - 64);
+        __m512i zU, zV;
+        if (avx512vbmi) {
+            const __mmask64 k7 = _cvtu64_mask64(0xAAAAAAAAAAAAAAAAull);
+            zU = _mm512_maskz_permutex2var_epi8(k7, z0, _mm512_load_si512((const __m512i *)YUY2_SHUFFLE_U_16BIT_AVX512_VBMI), z1);
+            zV = _mm512_maskz_permutex2var_epi8(k7, z0, _mm512_load_si512((const __m512i *)YUY2_SHUFFLE_V_16BIT_AVX512_VBMI), z1);
+        } else {
+            //32bit単位で見ると Y0 | U<<8 | Y1<<16 | V<<24
+            const __m512i zC_mask = _mm512_set1_epi32(0xff00);
+            zU = _mm512_packus_epi32(_mm512_and_si512(z0, zC_mask), _mm512_and_si512(z1, zC_mask));
+            zV = _mm512_packus_epi32(_mm512_and_si512(_mm512_srli_epi32(z0, 16), zC_mask), _mm512_and_si512(_mm512_srli_epi32(z1, 16), zC_mask));
+            zU = _mm512_permutexvar_epi64(zC_packus_shuffle, zU);
+            zV = _mm512_permutexvar_epi64(zC_packus_shuffle, zV);
+        }
+        store_tail_epi16<aligned_store>(dst_Y + i +  0, _mm512_slli_epi16(z0, 8), remain -  0);
+        store_tail_epi16<aligned_store>(dst_Y + i + 32, _mm512_slli_epi16(z1, 8), remain - 32);
+        store_tail_epi16<aligned_store>(dst_U + (i>>1), zU, remain>>1);
+        store_tail_epi16<aligned_store>(dst_V + (i>>1), zV, remain>>1);
     }
 }
 
-void convert_yc48_to_nv16_16bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+void convert_yuy2_to_yuv422_16bit_avx512bw(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yuy2_to_yuv422_16bit_avx512<false, false>(pixel, pixel_data, width, height);
+}
+
+void convert_yuy2_to_yuv422_16bit_avx512vbmi(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yuy2_to_yuv422_16bit_avx512<true, false>(pixel, pixel_data, width, height);
+}
+
+void convert_yuy2_to_yuv422_16bit_avx512bw_mod64(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yuy2_to_yuv422_16bit_avx512<false, true>(pixel, pixel_data, width, height);
+}
+
+void convert_yuy2_to_yuv422_16bit_avx512vbmi_mod64(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yuy2_to_yuv422_16bit_avx512<true, true>(pixel, pixel_data, width, height);
+}
+
+//YC48/LW48 32画素分 (96 short) を読み込み、Y (32 short) と UV (UVUV... 32 short) に分離する
+template<bool avx512vbmi, bool aligned_store>
+static __forceinline void load_y_uv_from_yc48(__m512i& zY, __m512i& zUV, const short *ycp, int remain) {
+    __m512i z1 = load_tail_epi16<aligned_store>(ycp +  0, remain * 3 -  0);
+    __m512i z2 = load_tail_epi16<aligned_store>(ycp + 32, remain * 3 - 32);
+    __m512i z3 = load_tail_epi16<aligned_store>(ycp + 64, remain * 3 - 64);
+
+    gather_y_uv_from_yc48<avx512vbmi>(z1, z2, z3);
+
+    zY = z1;
+    zUV = z2;
+}
+
+template<bool avx512vbmi, bool aligned_store>
+void __forceinline convert_yc48_to_nv16_16bit_avx512(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
     short *dst_Y = (short *)pixel_data->data[0];
     short *dst_C = (short *)pixel_data->data[1];
-    short *ycp = (short *)pixel;
-    short * const ycp_fin = ycp + width * height * 3;
+    const short *ycp = (const short *)pixel;
+    const int n = width * height;
     const __m512i zC_pw_one = _mm512_set_epi16_one;
     const __m512i zC_max = _mm512_set1_epi16((short)LIMIT_16);
     const __m512i zC_YCC = _mm512_set1_epi32(1<<LSFT_YCC_16);
-    __m512i z1, z2, z3;
-    for (; ycp < ycp_fin; ycp += 48, dst_Y += 16, dst_C += 16) {
-        z1 = _mm512_loadu_si512((__m512i *)(ycp +  0));
-        z2 = _mm512_loadu_si512((__m512i *)(ycp + 16));
-        z3 = _mm512_loadu_si512((__m512i *)(ycp + 32));
+    const __m512i zC_UV_OFFSET_x1 = _mm512_set1_epi16(UV_OFFSET_x1);
+    for (int i = 0; i < n; i += 32, ycp += 96) {
+        const int remain = n - i;
+        __m512i zY, zUV;
+        load_y_uv_from_yc48<avx512vbmi, aligned_store>(zY, zUV, ycp, remain);
+
+        store_tail_epi16<aligned_store>(dst_Y + i, convert_z_range_from_yc48(zY, zC_Y_L_MA_16, Y_L_RSH_16, zC_YCC, zC_pw_one, zC_max), remain);
+        store_tail_epi16<aligned_store>(dst_C + i, convert_uv_range_from_yc48(zUV, zC_UV_OFFSET_x1, zC_UV_L_MA_16_444, UV_L_RSH_16_444, zC_YCC, zC_pw_one, zC_max), remain);
+    }
+}
+
+void convert_yc48_to_nv16_16bit_avx512bw(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv16_16bit_avx512<false, false>(pixel, pixel_data, width, height);
+}
+
+void convert_yc48_to_nv16_16bit_avx512vbmi(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv16_16bit_avx512<true, false>(pixel, pixel_data, width, height);
+}
 
-        gather_y_uv_from_yc48(z1, z2, z3);
+void convert_yc48_to_nv16_16bit_avx512bw_mod32(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv16_16bit_avx512<false, true>(pixel, pixel_data, width, height);
+}
+
+void convert_yc48_to_nv16_16bit_avx512vbmi_mod32(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv16_16bit_avx512<true, true>(pixel, pixel_data, width, height);
+}
+
+alignas(64) static const short UV_SHUFFLE_U_AVX512[32] = {
+     0,  2,  4,  6,  8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30, 32, 34, 36, 38, 40, 42, 44, 46, 48, 50, 52, 54, 56, 58, 60, 62
+};
+alignas(64) static const short UV_SHUFFLE_V_AVX512[32] = {
+     1,  3,  5,  7,  9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31, 33, 35, 37, 39, 41, 43, 45, 47, 49, 51, 53, 55, 57, 59, 61, 63
+};
 
-        _mm512_storeu_si512((__m512i *)dst_Y, convert_z_range_from_yc48(z1, zC_Y_L_MA_16, Y_L_RSH_16, zC_YCC, zC_pw_one, zC_max));
-        _mm512_storeu_si512((__m512i *)dst_C, convert_uv_range_from_yc48(z2, zC_UV_OFFSET_x1, zC_UV_L_MA_16_444, UV_L_RSH_16_444, zC_YCC, zC_pw_one, zC_max));
+template<bool avx512vbmi, bool aligned_store>
+void __forceinline convert_yc48_to_yuv422_16bit_avx512(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    short *dst_Y = (short *)pixel_data->data[0];
+    short *dst_U = (short *)pixel_data->data[1];
+    short *dst_V = (short *)pixel_data->data[2];
+    const short *ycp = (const short *)pixel;
+    const int n = width * height;
+    const __m512i zC_pw_one = _mm512_set_epi16_one;
+    const __m512i zC_max = _mm512_set1_epi16((short)LIMIT_16);
+    const __m512i zC_YCC = _mm512_set1_epi32(1<<LSFT_YCC_16);
+    const __m512i zC_UV_OFFSET_x1 = _mm512_set1_epi16(UV_OFFSET_x1);
+    for (int i = 0; i < n; i += 64, ycp += 192) {
+        const int remain = n - i;
+        __m512i zY0, zUV0, zY1, zUV1;
+        load_y_uv_from_yc48<avx512vbmi, aligned_store>(zY0, zUV0, ycp +  0, remain -  0);
+        load_y_uv_from_yc48<avx512vbmi, aligned_store>(zY1, zUV1, ycp + 96, remain - 32);
+
+        store_tail_epi16<aligned_store>(dst_Y + i +  0, convert_z_range_from_yc48(zY0, zC_Y_L_MA_16, Y_L_RSH_16, zC_YCC, zC_pw_one, zC_max), remain -  0);
+        store_tail_epi16<aligned_store>(dst_Y + i + 32, convert_z_range_from_yc48(zY1, zC_Y_L_MA_16, Y_L_RSH_16, zC_YCC, zC_pw_one, zC_max), remain - 32);
+
+        zUV0 = convert_uv_range_from_yc48(zUV0, zC_UV_OFFSET_x1, zC_UV_L_MA_16_444, UV_L_RSH_16_444, zC_YCC, zC_pw_one, zC_max);
+        zUV1 = convert_uv_range_from_yc48(zUV1, zC_UV_OFFSET_x1, zC_UV_L_MA_16_444, UV_L_RSH_16_444, zC_YCC, zC_pw_one, zC_max);
+        store_tail_epi16<aligned_store>(dst_U + (i>>1), _mm512_permutex2var_epi16(zUV0, _mm512_load_si512((const __m512i *)UV_SHUFFLE_U_AVX512), zUV1), remain>>1);
+        store_tail_epi16<aligned_store>(dst_V + (i>>1), _mm512_permutex2var_epi16(zUV0, _mm512_load_si512((const __m512i *)UV_SHUFFLE_V_AVX512), zUV1), remain>>1);
     }
 }
-#endif
+
+void convert_yc48_to_yuv422_16bit_avx512bw(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_yuv422_16bit_avx512<false, false>(pixel, pixel_data, width, height);
+}
+
+void convert_yc48_to_yuv422_16bit_avx512vbmi(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_yuv422_16bit_avx512<true, false>(pixel, pixel_data, width, height);
+}
+
+void convert_yc48_to_yuv422_16bit_avx512bw_mod64(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_yuv422_16bit_avx512<false, true>(pixel, pixel_data, width, height);
+}
+
+void convert_yc48_to_yuv422_16bit_avx512vbmi_mod64(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_yuv422_16bit_avx512<true, true>(pixel, pixel_data, width, height);
+}
 
 template<bool avx512vbmi>
 void __forceinline convert_lw48_to_nv12_16bit_avx512(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
@@ -1149,25 +1439,75 @@ void convert_lw48_to_nv12_i_16bit_avx512vbmi(void *pixel, CONVERT_CF_DATA *pixel
     convert_lw48_to_nv12_i_16bit_avx512<true>(pixel, pixel_data, width, height);
 }
 
-#if 0
-void convert_lw48_to_nv16_16bit_avx2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+template<bool avx512vbmi, bool aligned_store>
+void __forceinline convert_lw48_to_nv16_avx512(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    BYTE *dst_Y = pixel_data->data[0];
+    BYTE *dst_C = pixel_data->data[1];
+    const short *ycp = (const short *)pixel;
+    const int n = width * height;
+    for (int i = 0; i < n; i += 64, ycp += 192) {
+        const int remain = n - i;
+        __m512i zY0, zUV0, zY1, zUV1;
+        load_y_uv_from_yc48<avx512vbmi, aligned_store>(zY0, zUV0, ycp +  0, remain -  0);
+        load_y_uv_from_yc48<avx512vbmi, aligned_store>(zY1, zUV1, ycp + 96, remain - 32);
+
+        zY0  = _mm512_packus_epi16(_mm512_srli_epi16(zY0,  8), _mm512_srli_epi16(zY1,  8));
+        zUV0 = _mm512_packus_epi16(_mm512_srli_epi16(zUV0, 8), _mm512_srli_epi16(zUV1, 8));
+        zY0  = _mm512_permutexvar_epi64(zC_packus_shuffle, zY0);
+        zUV0 = _mm512_permutexvar_epi64(zC_packus_shuffle, zUV0);
+
+        store_tail_epi8<aligned_store>(dst_Y + i, zY0,  remain);
+        store_tail_epi8<aligned_store>(dst_C + i, zUV0, remain);
+    }
+}
+
+void convert_lw48_to_nv16_avx512bw(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_lw48_to_nv16_avx512<false, false>(pixel, pixel_data, width, height);
+}
+
+void convert_lw48_to_nv16_avx512vbmi(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_lw48_to_nv16_avx512<true, false>(pixel, pixel_data, width, height);
+}
+
+void convert_lw48_to_nv16_avx512bw_mod64(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_lw48_to_nv16_avx512<false, true>(pixel, pixel_data, width, height);
+}
+
+void convert_lw48_to_nv16_avx512vbmi_mod64(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_lw48_to_nv16_avx512<true, true>(pixel, pixel_data, width, height);
+}
+
+template<bool avx512vbmi, bool aligned_store>
+void __forceinline convert_lw48_to_nv16_16bit_avx512(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
     short *dst_Y = (short *)pixel_data->data[0];
     short *dst_C = (short *)pixel_data->data[1];
-    short *ycp = (short *)pixel;
-    short * const ycp_fin = ycp + width * height * 3;
-    __m512i z1, z2, z3;
-    for (; ycp < ycp_fin; ycp += 48, dst_Y += 16, dst_C += 16) {
-        z1 = _mm512_loadu_si512((__m512i *)(ycp +  0));
-        z2 = _mm512_loadu_si512((__m512i *)(ycp + 16));
-        z3 = _mm512_loadu_si512((__m512i *)(ycp + 32));
-
-        gather_y_uv_from_yc48(z1, z2, z3);
-
-        _mm512_storeu_si512((__m512i *)dst_Y, z1);
-        _mm512_storeu_si512((__m512i *)dst_C, z2);
+    const short *ycp = (const short *)pixel;
+    const int n = width * height;
+    for (int i = 0; i < n; i += 32, ycp += 96) {
+        const int remain = n - i;
+        __m512i zY, zUV;
+        load_y_uv_from_yc48<avx512vbmi, aligned_store>(zY, zUV, ycp, remain);
+
+        store_tail_epi16<aligned_store>(dst_Y + i, zY,  remain);
+        store_tail_epi16<aligned_store>(dst_C + i, zUV, remain);
     }
 }
-#endif
+
+void convert_lw48_to_nv16_16bit_avx512bw(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_lw48_to_nv16_16bit_avx512<false, false>(pixel, pixel_data, width, height);
+}
+
+void convert_lw48_to_nv16_16bit_avx512vbmi(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_lw48_to_nv16_16bit_avx512<true, false>(pixel, pixel_data, width, height);
+}
+
+void convert_lw48_to_nv16_16bit_avx512bw_mod32(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_lw48_to_nv16_16bit_avx512<false, true>(pixel, pixel_data, width, height);
+}
+
+void convert_lw48_to_nv16_16bit_avx512vbmi_mod32(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_lw48_to_nv16_16bit_avx512<true, true>(pixel, pixel_data, width, height);
+}
 
 template<bool avx512vbmi>
 void __forceinline convert_lw48_to_yuv444_avx512(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
@@ -1236,3 +1576,179 @@ void convert_lw48_to_yuv444_16bit_avx512bw(void *pixel, CONVERT_CF_DATA *pixel_d
 void convert_lw48_to_yuv444_16bit_avx512vbmi(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
     convert_lw48_to_yuv444_16bit_avx512<true>(pixel, pixel_data, width, height);
 }
+
+//BGR 16画素分 (48byte) を、128bitレーンごとに4画素分 (12byte) ずつ並べなおす
+alignas(64) static const int BGR_LANE_SPLIT_AVX512[16] = { 0, 1, 2, 3, 3, 4, 5, 6, 6, 7, 8, 9, 9, 10, 11, 12 };
+//各レーンの前詰めの12byteを連続した48byteに戻す
+alignas(64) static const int BGR_LANE_MERGE_AVX512[16] = { 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15 };
+//BGR 16画素分 (48byte) から各画素のB,G,Rを32bitの最下位byteに集める (それ以外のbyteはマスクで0にする)
+alignas(64) static const char BGR_TO_EPI32_B_AVX512_VBMI[64] = {
+      0,  0,  0,  0,  3,  0,  0,  0,  6,  0,  0,  0,  9,  0,  0,  0, 12,  0,  0,  0, 15,  0,  0,  0, 18,  0,  0,  0, 21,  0,  0,  0,
+     24,  0,  0,  0, 27,  0,  0,  0, 30,  0,  0,  0, 33,  0,  0,  0, 36,  0,  0,  0, 39,  0,  0,  0, 42,  0,  0,  0, 45,  0,  0,  0
+};
+alignas(64) static const char BGR_TO_EPI32_G_AVX512_VBMI[64] = {
+      1,  0,  0,  0,  4,  0,  0,  0,  7,  0,  0,  0, 10,  0,  0,  0, 13,  0,  0,  0, 16,  0,  0,  0, 19,  0,  0,  0, 22,  0,  0,  0,
+     25,  0,  0,  0, 28,  0,  0,  0, 31,  0,  0,  0, 34,  0,  0,  0, 37,  0,  0,  0, 40,  0,  0,  0, 43,  0,  0,  0, 46,  0,  0,  0
+};
+alignas(64) static const char BGR_TO_EPI32_R_AVX512_VBMI[64] = {
+      2,  0,  0,  0,  5,  0,  0,  0,  8,  0,  0,  0, 11,  0,  0,  0, 14,  0,  0,  0, 17,  0,  0,  0, 20,  0,  0,  0, 23,  0,  0,  0,
+     26,  0,  0,  0, 29,  0,  0,  0, 32,  0,  0,  0, 35,  0,  0,  0, 38,  0,  0,  0, 41,  0,  0,  0, 44,  0,  0,  0, 47,  0,  0,  0
+};
+//BGR 16画素分 (48byte) のBとRを入れ替える
+alignas(64) static const char SORT_TO_RGB_AVX512_VBMI[64] = {
+      2,  1,  0,  5,  4,  3,  8,  7,  6, 11, 10,  9, 14, 13, 12, 17, 16, 15, 20, 19, 18, 23, 22, 21, 26, 25, 24, 29, 28, 27, 32, 31,
+     30, 35, 34, 33, 38, 37, 36, 41, 40, 39, 44, 43, 42, 47, 46, 45, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63
+};
+
+//BGR 16画素分 (48byte) を各チャンネルごとの32bit整数に分離する
+template<bool avx512vbmi>
+static __forceinline void separate_bgr_to_epi32(__m512i& zB, __m512i& zG, __m512i& zR, const __m512i& zBGR) {
+    if (avx512vbmi) {
+        const __mmask64 mask = 0x1111111111111111ull;
+        zB = _mm512_maskz_permutexvar_epi8(mask, _mm512_load_si512((const __m512i *)BGR_TO_EPI32_B_AVX512_VBMI), zBGR);
+        zG = _mm512_maskz_permutexvar_epi8(mask, _mm512_load_si512((const __m512i *)BGR_TO_EPI32_G_AVX512_VBMI), zBGR);
+        zR = _mm512_maskz_permutexvar_epi8(mask, _mm512_load_si512((const __m512i *)BGR_TO_EPI32_R_AVX512_VBMI), zBGR);
+    } else {
+        const __m512i z0 = _mm512_permutexvar_epi32(_mm512_load_si512((const __m512i *)BGR_LANE_SPLIT_AVX512), zBGR);
+        zB = _mm512_shuffle_epi8(z0, _mm512_broadcast_i32x4(_mm_setr_epi8(0, -1, -1, -1, 3, -1, -1, -1, 6, -1, -1, -1,  9, -1, -1, -1)));
+        zG = _mm512_shuffle_epi8(z0, _mm512_broadcast_i32x4(_mm_setr_epi8(1, -1, -1, -1, 4, -1, -1, -1, 7, -1, -1, -1, 10, -1, -1, -1)));
+        zR = _mm512_shuffle_epi8(z0, _mm512_broadcast_i32x4(_mm_setr_epi8(2, -1, -1, -1, 5, -1, -1, -1, 8, -1, -1, -1, 11, -1, -1, -1)));
+    }
+}
+
+//RGB -> YUV444 16画素分
+//C版と結果が一致するよう、FMAは使わずC版と同じ順序で積和を行う
+static __forceinline __m512i convert_rgb_to_yuv444_channel(const __m512& r, const __m512& g, const __m512& b, const __m512& coeff_r, const __m512& coeff_g, const __m512& coeff_b, const __m512& offset, const __m512& scale) {
+    __m512 f = _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(coeff_r, r), _mm512_mul_ps(coeff_g, g)), _mm512_mul_ps(coeff_b, b)), offset);
+    f = _mm512_add_ps(_mm512_mul_ps(f, scale), _mm512_set1_ps(0.5f));
+    //負の値は0に、上限は書き込み時の飽和処理でクリップする
+    return _mm512_max_epi32(_mm512_cvttps_epi32(f), _mm512_setzero_si512());
+}
+
+template<typename TypeOut>
+static __forceinline void store_yuv444_16px(TypeOut *dst, const __m512i& z, __mmask16 mask) {
+    if (sizeof(TypeOut) == 1) {
+        _mm512_mask_cvtusepi32_storeu_epi8(dst, mask, z);
+    } else {
+        _mm512_mask_cvtusepi32_storeu_epi16(dst, mask, z);
+    }
+}
+
+template<typename TypeOut, int out_bit_depth, bool avx512vbmi>
+void __forceinline convert_rgb_to_yuv444_avx512(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    BYTE *ptrY = pixel_data->data[0];
+    BYTE *ptrU = pixel_data->data[1];
+    BYTE *ptrV = pixel_data->data[2];
+    const float *coeff_table = COEFF_RGB2YUV[pixel_data->colormatrix ? 1 : 0];
+    __m512 zCoeff[9];
+    for (int i = 0; i < 9; i++) {
+        zCoeff[i] = _mm512_set1_ps(coeff_table[i]);
+    }
+    const __m512 zOffsetY  = _mm512_set1_ps(16.0f);
+    const __m512 zOffsetUV = _mm512_set1_ps(128.0f);
+    const __m512 zScale = _mm512_set1_ps((float)(1 << (out_bit_depth - 8)));
+    int y0 = 0, y1 = height - 1;
+    const int srcstep = (width*3 + 3) & ~3;
+    for (; y0 < height; y0++, y1--) {
+        TypeOut *dstY = (TypeOut *)(ptrY + y1*width*sizeof(TypeOut));
+        TypeOut *dstU = (TypeOut *)(ptrU + y1*width*sizeof(TypeOut));
+        TypeOut *dstV = (TypeOut *)(ptrV + y1*width*sizeof(TypeOut));
+        BYTE *src = (BYTE*)frame + y0*srcstep;
+        //16画素 (48byte) ずつ処理、行末はマスクで処理する
+        for (int x = 0; x < width; x += 16) {
+            const int remain = width - x;
+            const __mmask16 mask = (remain >= 16) ? (__mmask16)0xffff : (__mmask16)((1u << remain) - 1);
+            const __m512i zBGR = _mm512_maskz_loadu_epi8(tail_mask_epi8(((remain >= 16) ? 16 : remain) * 3), src + x*3);
+            __m512i zB, zG, zR;
+            separate_bgr_to_epi32<avx512vbmi>(zB, zG, zR, zBGR);
+            const __m512 b = _mm512_cvtepi32_ps(zB);
+            const __m512 g = _mm512_cvtepi32_ps(zG);
+            const __m512 r = _mm512_cvtepi32_ps(zR);
+            store_yuv444_16px(dstY + x, convert_rgb_to_yuv444_channel(r, g, b, zCoeff[0], zCoeff[1], zCoeff[2], zOffsetY,  zScale), mask);
+            store_yuv444_16px(dstU + x, convert_rgb_to_yuv444_channel(r, g, b, zCoeff[3], zCoeff[4], zCoeff[5], zOffsetUV, zScale), mask);
+            store_yuv444_16px(dstV + x, convert_rgb_to_yuv444_channel(r, g, b, zCoeff[6], zCoeff[7], zCoeff[8], zOffsetUV, zScale), mask);
+        }
+    }
+}
+
+void convert_rgb_to_yuv444_avx512bw(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_rgb_to_yuv444_avx512<BYTE, 8, false>(frame, pixel_data, width, height);
+}
+
+void convert_rgb_to_yuv444_avx512vbmi(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_rgb_to_yuv444_avx512<BYTE, 8, true>(frame, pixel_data, width, height);
+}
+
+void convert_rgb_to_yuv444_16bit_avx512bw(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_rgb_to_yuv444_avx512<USHORT, 16, false>(frame, pixel_data, width, height);
+}
+
+void convert_rgb_to_yuv444_16bit_avx512vbmi(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_rgb_to_yuv444_avx512<USHORT, 16, true>(frame, pixel_data, width, height);
+}
+
+template<bool avx512vbmi>
+void __forceinline sort_to_rgb_avx512(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    BYTE *ptr = pixel_data->data[0];
+    int y0 = 0, y1 = height - 1;
+    const int step = (width*3 + 3) & ~3;
+    for (; y0 < height; y0++, y1--) {
+        BYTE *dst = ptr          + y0*width*3;
+        BYTE *src = (BYTE*)frame + y1*step;
+        //16画素 (48byte) ずつ処理、行末はマスクで処理する
+        for (int x = 0; x < width; x += 16) {
+            const int remain = width - x;
+            const __mmask64 mask = tail_mask_epi8(((remain >= 16) ? 16 : remain) * 3);
+            __m512i z0 = _mm512_maskz_loadu_epi8(mask, src + x*3);
+            if (avx512vbmi) {
+                z0 = _mm512_permutexvar_epi8(_mm512_load_si512((const __m512i *)SORT_TO_RGB_AVX512_VBMI), z0);
+            } else {
+                z0 = _mm512_permutexvar_epi32(_mm512_load_si512((const __m512i *)BGR_LANE_SPLIT_AVX512), z0);
+                z0 = _mm512_shuffle_epi8(z0, _mm512_broadcast_i32x4(_mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 12, 13, 14, 15)));
+                z0 = _mm512_permutexvar_epi32(_mm512_load_si512((const __m512i *)BGR_LANE_MERGE_AVX512), z0);
+            }
+            _mm512_mask_storeu_epi8(dst + x*3, mask, z0);
+        }
+    }
+}
+
+void sort_to_rgb_avx512bw(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    sort_to_rgb_avx512<false>(frame, pixel_data, width, height);
+}
+
+void sort_to_rgb_avx512vbmi(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    sort_to_rgb_avx512<true>(frame, pixel_data, width, height);
+}
+
+//上下反転しながら1行ずつコピーする
+static __forceinline void copy_flip_avx512(void *frame, CONVERT_CF_DATA *pixel_data, const int height, const int src_step, const int line_size) {
+    BYTE *ptr = pixel_data->data[0];
+    int y0 = 0, y1 = height - 1;
+    for (; y0 < height; y0++, y1--) {
+        BYTE *dst = ptr          + y0*line_size;
+        BYTE *src = (BYTE*)frame + y1*src_step;
+        int x = 0;
+        for (; x <= line_size - 256; x += 256) {
+            const __m512i z0 = _mm512_loadu_si512((const __m512i *)(src + x +   0));
+            const __m512i z1 = _mm512_loadu_si512((const __m512i *)(src + x +  64));
+            const __m512i z2 = _mm512_loadu_si512((const __m512i *)(src + x + 128));
+            const __m512i z3 = _mm512_loadu_si512((const __m512i *)(src + x + 192));
+            _mm512_storeu_si512((__m512i *)(dst + x +   0), z0);
+            _mm512_storeu_si512((__m512i *)(dst + x +  64), z1);
+            _mm512_storeu_si512((__m512i *)(dst + x + 128), z2);
+            _mm512_storeu_si512((__m512i *)(dst + x + 192), z3);
+        }
+        for (; x < line_size; x += 64) {
+            const __mmask64 mask = tail_mask_epi8(line_size - x);
+            _mm512_mask_storeu_epi8(dst + x, mask, _mm512_maskz_loadu_epi8(mask, src + x));
+        }
+    }
+}
+
+void copy_rgb_avx512bw(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    copy_flip_avx512(frame, pixel_data, height, (width*3 + 3) & ~3, width*3);
+}
+
+void copy_rgba_avx512bw(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    copy_flip_avx512(frame, pixel_data, height, width*4, width*4);
+}
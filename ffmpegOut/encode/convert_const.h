@@ -112,6 +112,79 @@ static const int UV_L_YCC_8       = 16;
 static const int UV_L_YCC_10      = UV_L_YCC_8<<2;
 static const int UV_L_YCC_16      = UV_L_YCC_8<<8;
 
+//RGB -> YUV 変換係数 (r, g, b の順に Y, U, V)
+//[0]: BT.601, [1]: BT.709 を CONVERT_CF_DATA::colormatrix で選択する
+static const float COEFF_RGB2YUV[2][9] = {
+    { 0.299f,     0.587f,   0.114f,
+     -0.168736f, -0.331264f,  0.5f,
+      0.5f,      -0.418688f, -0.081312f },
+    { 0.2126f,    0.7152f,    0.0722f,
+     -0.114572f, -0.385427f,  0.5f,
+      0.5f,      -0.453596f, -0.045977f }
+};
+
+//RGBA -> YUV 1画素分 (C版と、SIMD版の端数処理で共通に使う)
+//拡張編集からのRGBAは乗算済みアルファなので、unpremultiplyなら色を元に戻してから変換する
+//y, u, vはビット深度を合わせる前の8bit相当の値
+template<bool unpremultiply>
+static inline void convert_rgba_to_yuv_1px(float& y, float& u, float& v, const unsigned char *src, const float *coeff_table) {
+    float b = (float)src[0];
+    float g = (float)src[1];
+    float r = (float)src[2];
+    if (unpremultiply) {
+        const float inv = (src[3]) ? 255.0f / (float)src[3] : 0.0f;
+        b = b * inv; b = (b < 255.0f) ? b : 255.0f;
+        g = g * inv; g = (g < 255.0f) ? g : 255.0f;
+        r = r * inv; r = (r < 255.0f) ? r : 255.0f;
+    }
+    y = coeff_table[0] * r + coeff_table[1] * g + coeff_table[2] * b +  16.0f;
+    u = coeff_table[3] * r + coeff_table[4] * g + coeff_table[5] * b + 128.0f;
+    v = coeff_table[6] * r + coeff_table[7] * g + coeff_table[8] * b + 128.0f;
+}
+//8bit相当の値を出力ビット深度に合わせて丸める
+template<int out_bit_depth>
+static inline int yuv_float_to_bit_depth(float x) {
+    const int i = (int)(x * (1 << (out_bit_depth - 8)) + 0.5f);
+    return (i <= (1 << out_bit_depth) - 1) ? ((i >= 0) ? i : 0) : (1 << out_bit_depth) - 1;
+}
+//アルファはフルレンジなので、上位ビットを下位にも複製して最大値を合わせる (255 -> 1023, 65535)
+template<int out_bit_depth>
+static inline int alpha_8_to_bit_depth(int a) {
+    return (a << (out_bit_depth - 8)) | (a >> (16 - out_bit_depth));
+}
+//RGBA -> YUVA420 2x2画素分 (src0, src1は入力の隣接する2行、xは偶数)
+//色差は2x2画素の平均をとる
+template<typename TypeOut, int out_bit_depth, bool unpremultiply>
+static inline void convert_rgba_to_yuva420_2x2(TypeOut *dstY0, TypeOut *dstY1, TypeOut *dstU, TypeOut *dstV, TypeOut *dstA0, TypeOut *dstA1,
+    const unsigned char *src0, const unsigned char *src1, const int x, const float *coeff_table) {
+    float y00, u00, v00, y01, u01, v01, y10, u10, v10, y11, u11, v11;
+    convert_rgba_to_yuv_1px<unpremultiply>(y00, u00, v00, src0 + x*4 + 0, coeff_table);
+    convert_rgba_to_yuv_1px<unpremultiply>(y01, u01, v01, src0 + x*4 + 4, coeff_table);
+    convert_rgba_to_yuv_1px<unpremultiply>(y10, u10, v10, src1 + x*4 + 0, coeff_table);
+    convert_rgba_to_yuv_1px<unpremultiply>(y11, u11, v11, src1 + x*4 + 4, coeff_table);
+    dstY0[x+0] = (TypeOut)yuv_float_to_bit_depth<out_bit_depth>(y00);
+    dstY0[x+1] = (TypeOut)yuv_float_to_bit_depth<out_bit_depth>(y01);
+    dstY1[x+0] = (TypeOut)yuv_float_to_bit_depth<out_bit_depth>(y10);
+    dstY1[x+1] = (TypeOut)yuv_float_to_bit_depth<out_bit_depth>(y11);
+    dstU[x>>1] = (TypeOut)yuv_float_to_bit_depth<out_bit_depth>(((u00 + u01) + (u10 + u11)) * 0.25f);
+    dstV[x>>1] = (TypeOut)yuv_float_to_bit_depth<out_bit_depth>(((v00 + v01) + (v10 + v11)) * 0.25f);
+    dstA0[x+0] = (TypeOut)alpha_8_to_bit_depth<out_bit_depth>(src0[x*4 + 3]);
+    dstA0[x+1] = (TypeOut)alpha_8_to_bit_depth<out_bit_depth>(src0[x*4 + 7]);
+    dstA1[x+0] = (TypeOut)alpha_8_to_bit_depth<out_bit_depth>(src1[x*4 + 3]);
+    dstA1[x+1] = (TypeOut)alpha_8_to_bit_depth<out_bit_depth>(src1[x*4 + 7]);
+}
+//RGBA -> YUVA444 1画素分
+template<typename TypeOut, int out_bit_depth, bool unpremultiply>
+static inline void convert_rgba_to_yuva444_1px(TypeOut *dstY, TypeOut *dstU, TypeOut *dstV, TypeOut *dstA,
+    const unsigned char *src, const int x, const float *coeff_table) {
+    float y, u, v;
+    convert_rgba_to_yuv_1px<unpremultiply>(y, u, v, src + x*4, coeff_table);
+    dstY[x] = (TypeOut)yuv_float_to_bit_depth<out_bit_depth>(y);
+    dstU[x] = (TypeOut)yuv_float_to_bit_depth<out_bit_depth>(u);
+    dstV[x] = (TypeOut)yuv_float_to_bit_depth<out_bit_depth>(v);
+    dstA[x] = (TypeOut)alpha_8_to_bit_depth<out_bit_depth>(src[x*4 + 3]);
+}
+
 #define ALIGN32_CONST_ARRAY static const _declspec(align(32))
 
 ALIGN32_CONST_ARRAY short Array_Y_L_MA_8[16]        = { Y_L_MUL,  Y_L_ADD_8,       Y_L_MUL,   Y_L_ADD_8,        Y_L_MUL,  Y_L_ADD_8,        Y_L_MUL,  Y_L_ADD_8,       Y_L_MUL,  Y_L_ADD_8,       Y_L_MUL,   Y_L_ADD_8,        Y_L_MUL,  Y_L_ADD_8,        Y_L_MUL,  Y_L_ADD_8       };
@@ -159,6 +232,40 @@ ALIGN32_CONST_ARRAY BYTE  Array_INTERLACE_WEIGHT[2][32] = {
     {3, 1, 3, 1, 3, 1, 3, 1, 3, 1, 3, 1, 3, 1, 3, 1, 3, 1, 3, 1, 3, 1, 3, 1, 3, 1, 3, 1, 3, 1, 3, 1}
 };
 
+//組織的ディザの閾値 (Bayer 8x8 の 0～63 を 4倍して +2 したもの)
+//8の倍数でない位置からもAVX2で16個読めるよう、4周期分並べる
+//16bit値に加算してから上位8bitを取ると、平均が四捨五入と同じになる
+//planeごとに行列を回転・反転させ、YとUVの模様が重ならないようにする
+ALIGN32_CONST_ARRAY USHORT Array_DITHER_ORDERED[3][8][32] = {
+    { //Y
+        {   2, 130,  34, 162,  10, 138,  42, 170,   2, 130,  34, 162,  10, 138,  42, 170,   2, 130,  34, 162,  10, 138,  42, 170,   2, 130,  34, 162,  10, 138,  42, 170 },
+        { 194,  66, 226,  98, 202,  74, 234, 106, 194,  66, 226,  98, 202,  74, 234, 106, 194,  66, 226,  98, 202,  74, 234, 106, 194,  66, 226,  98, 202,  74, 234, 106 },
+        {  50, 178,  18, 146,  58, 186,  26, 154,  50, 178,  18, 146,  58, 186,  26, 154,  50, 178,  18, 146,  58, 186,  26, 154,  50, 178,  18, 146,  58, 186,  26, 154 },
+        { 242, 114, 210,  82, 250, 122, 218,  90, 242, 114, 210,  82, 250, 122, 218,  90, 242, 114, 210,  82, 250, 122, 218,  90, 242, 114, 210,  82, 250, 122, 218,  90 },
+        {  14, 142,  46, 174,   6, 134,  38, 166,  14, 142,  46, 174,   6, 134,  38, 166,  14, 142,  46, 174,   6, 134,  38, 166,  14, 142,  46, 174,   6, 134,  38, 166 },
+        { 206,  78, 238, 110, 198,  70, 230, 102, 206,  78, 238, 110, 198,  70, 230, 102, 206,  78, 238, 110, 198,  70, 230, 102, 206,  78, 238, 110, 198,  70, 230, 102 },
+        {  62, 190,  30, 158,  54, 182,  22, 150,  62, 190,  30, 158,  54, 182,  22, 150,  62, 190,  30, 158,  54, 182,  22, 150,  62, 190,  30, 158,  54, 182,  22, 150 },
+        { 254, 126, 222,  94, 246, 118, 214,  86, 254, 126, 222,  94, 246, 118, 214,  86, 254, 126, 222,  94, 246, 118, 214,  86, 254, 126, 222,  94, 246, 118, 214,  86 } },
+    { //U (90度回転)
+        { 254,  62, 206,  14, 242,  50, 194,   2, 254,  62, 206,  14, 242,  50, 194,   2, 254,  62, 206,  14, 242,  50, 194,   2, 254,  62, 206,  14, 242,  50, 194,   2 },
+        { 126, 190,  78, 142, 114, 178,  66, 130, 126, 190,  78, 142, 114, 178,  66, 130, 126, 190,  78, 142, 114, 178,  66, 130, 126, 190,  78, 142, 114, 178,  66, 130 },
+        { 222,  30, 238,  46, 210,  18, 226,  34, 222,  30, 238,  46, 210,  18, 226,  34, 222,  30, 238,  46, 210,  18, 226,  34, 222,  30, 238,  46, 210,  18, 226,  34 },
+        {  94, 158, 110, 174,  82, 146,  98, 162,  94, 158, 110, 174,  82, 146,  98, 162,  94, 158, 110, 174,  82, 146,  98, 162,  94, 158, 110, 174,  82, 146,  98, 162 },
+        { 246,  54, 198,   6, 250,  58, 202,  10, 246,  54, 198,   6, 250,  58, 202,  10, 246,  54, 198,   6, 250,  58, 202,  10, 246,  54, 198,   6, 250,  58, 202,  10 },
+        { 118, 182,  70, 134, 122, 186,  74, 138, 118, 182,  70, 134, 122, 186,  74, 138, 118, 182,  70, 134, 122, 186,  74, 138, 118, 182,  70, 134, 122, 186,  74, 138 },
+        { 214,  22, 230,  38, 218,  26, 234,  42, 214,  22, 230,  38, 218,  26, 234,  42, 214,  22, 230,  38, 218,  26, 234,  42, 214,  22, 230,  38, 218,  26, 234,  42 },
+        {  86, 150, 102, 166,  90, 154, 106, 170,  86, 150, 102, 166,  90, 154, 106, 170,  86, 150, 102, 166,  90, 154, 106, 170,  86, 150, 102, 166,  90, 154, 106, 170 } },
+    { //V (反転)
+        { 254, 126, 222,  94, 246, 118, 214,  86, 254, 126, 222,  94, 246, 118, 214,  86, 254, 126, 222,  94, 246, 118, 214,  86, 254, 126, 222,  94, 246, 118, 214,  86 },
+        {  62, 190,  30, 158,  54, 182,  22, 150,  62, 190,  30, 158,  54, 182,  22, 150,  62, 190,  30, 158,  54, 182,  22, 150,  62, 190,  30, 158,  54, 182,  22, 150 },
+        { 206,  78, 238, 110, 198,  70, 230, 102, 206,  78, 238, 110, 198,  70, 230, 102, 206,  78, 238, 110, 198,  70, 230, 102, 206,  78, 238, 110, 198,  70, 230, 102 },
+        {  14, 142,  46, 174,   6, 134,  38, 166,  14, 142,  46, 174,   6, 134,  38, 166,  14, 142,  46, 174,   6, 134,  38, 166,  14, 142,  46, 174,   6, 134,  38, 166 },
+        { 242, 114, 210,  82, 250, 122, 218,  90, 242, 114, 210,  82, 250, 122, 218,  90, 242, 114, 210,  82, 250, 122, 218,  90, 242, 114, 210,  82, 250, 122, 218,  90 },
+        {  50, 178,  18, 146,  58, 186,  26, 154,  50, 178,  18, 146,  58, 186,  26, 154,  50, 178,  18, 146,  58, 186,  26, 154,  50, 178,  18, 146,  58, 186,  26, 154 },
+        { 194,  66, 226,  98, 202,  74, 234, 106, 194,  66, 226,  98, 202,  74, 234, 106, 194,  66, 226,  98, 202,  74, 234, 106, 194,  66, 226,  98, 202,  74, 234, 106 },
+        {   2, 130,  34, 162,  10, 138,  42, 170,   2, 130,  34, 162,  10, 138,  42, 170,   2, 130,  34, 162,  10, 138,  42, 170,   2, 130,  34, 162,  10, 138,  42, 170 } }
+};
+
 #ifdef __AVX512BW__
 
 #define INT_SHORT2(i) (((unsigned int)(i) << 16) | (unsigned int)(i))
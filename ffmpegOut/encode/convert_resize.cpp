@@ -0,0 +1,201 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+//縮小 (変換後の各planeを縦→横の順に分離型フィルタで縮小する)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <cmath>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+
+#include "convert.h"
+
+#ifndef clamp
+#define clamp(x, low, high) (((x) <= (high)) ? (((x) >= (low)) ? (x) : (low)) : (high))
+#endif
+
+//Keys (a=-0.5)
+static double resize_bicubic(double x) {
+    const double a = -0.5;
+    x = std::abs(x);
+    if (x < 1.0) return ((a + 2.0) * x - (a + 3.0)) * x * x + 1.0;
+    if (x < 2.0) return ((a * x - 5.0 * a) * x + 8.0 * a) * x - 4.0 * a;
+    return 0.0;
+}
+
+//出力画素ごとの参照開始位置と重みを計算する
+//画素の中心を合わせ、縮小時は縮小率に合わせて参照範囲を広げる
+//端をはみ出す分の重みは端の画素に加える
+static BOOL init_resize_weight(RESIZE_WEIGHT *w, int filter, int src_len, int dst_len) {
+    const double scale = (double)src_len / dst_len;
+    const double filter_scale = std::max(scale, 1.0);
+    double support = 0.0; //参照範囲 (中心からの距離)
+    switch (filter) {
+        case RESIZE_FILTER_BOX:      support = 0.5 * filter_scale; break;
+        case RESIZE_FILTER_BILINEAR: support = 1.0 * filter_scale; break;
+        case RESIZE_FILTER_BICUBIC:
+        default:                     support = 2.0 * filter_scale; break;
+    }
+    w->taps = std::min((int)std::ceil(support * 2.0) + 1, src_len);
+    w->pos = (int *)malloc(sizeof(w->pos[0]) * dst_len);
+    w->weight = (short *)malloc(sizeof(w->weight[0]) * dst_len * w->taps);
+    if (w->pos == NULL || w->weight == NULL)
+        return FALSE;
+
+    std::vector<double> weight_f(w->taps);
+    for (int i = 0; i < dst_len; i++) {
+        const double center = (i + 0.5) * scale - 0.5;
+        //重みが0でない最初の画素
+        const int start = (int)std::floor(center - support - ((filter == RESIZE_FILTER_BOX) ? 0.5 : 0.0)) + 1;
+        const int pos = clamp(start, 0, src_len - w->taps);
+        std::fill(weight_f.begin(), weight_f.end(), 0.0);
+        for (int j = start; j < start + w->taps; j++) {
+            double weight = 0.0;
+            switch (filter) {
+                case RESIZE_FILTER_BOX:
+                    weight = std::max(0.0, std::min(j + 0.5, center + support) - std::max(j - 0.5, center - support));
+                    break;
+                case RESIZE_FILTER_BILINEAR:
+                    weight = std::max(0.0, 1.0 - std::abs(j - center) / filter_scale);
+                    break;
+                case RESIZE_FILTER_BICUBIC:
+                default:
+                    weight = resize_bicubic((j - center) / filter_scale);
+                    break;
+            }
+            weight_f[clamp(j, 0, src_len - 1) - pos] += weight;
+        }
+        double sum = 0.0;
+        for (int k = 0; k < w->taps; k++)
+            sum += weight_f[k];
+        //合計が1<<RESIZE_WEIGHT_BITSになるよう、丸め誤差は最も大きい重みに加える
+        short *weight = w->weight + i * w->taps;
+        int weight_sum = 0, k_max = 0;
+        for (int k = 0; k < w->taps; k++) {
+            weight[k] = (short)std::lround(weight_f[k] / sum * (1 << RESIZE_WEIGHT_BITS));
+            weight_sum += weight[k];
+            if (weight[k] > weight[k_max])
+                k_max = k;
+        }
+        weight[k_max] += (short)((1 << RESIZE_WEIGHT_BITS) - weight_sum);
+        w->pos[i] = pos;
+    }
+    return TRUE;
+}
+
+static void free_resize_weight(RESIZE_WEIGHT *w) {
+    if (w->pos) free(w->pos);
+    if (w->weight) free(w->weight);
+    ZeroMemory(w, sizeof(RESIZE_WEIGHT));
+}
+
+BOOL init_resize_plane(RESIZE_PLANE *plane, int filter, int src_w, int src_h, int dst_w, int dst_h, int ch) {
+    ZeroMemory(plane, sizeof(RESIZE_PLANE));
+    plane->src_w = src_w;
+    plane->src_h = src_h;
+    plane->dst_w = dst_w;
+    plane->dst_h = dst_h;
+    plane->ch = ch;
+    return init_resize_weight(&plane->wx, filter, src_w, dst_w)
+        && init_resize_weight(&plane->wy, filter, src_h, dst_h);
+}
+
+void free_resize_plane(RESIZE_PLANE *plane) {
+    free_resize_weight(&plane->wx);
+    free_resize_weight(&plane->wy);
+}
+
+void resize_vertical_8bit(int *tmp, const BYTE *src, int src_pitch, int count, const short *weight, int taps) {
+    for (int x = 0; x < count; x++) {
+        int sum = 1 << (RESIZE_V_RSH_8 - 1);
+        for (int k = 0; k < taps; k++)
+            sum += src[k * src_pitch + x] * weight[k];
+        tmp[x] = sum >> RESIZE_V_RSH_8;
+    }
+}
+
+void resize_vertical_16bit(int *tmp, const BYTE *src, int src_pitch, int count, const short *weight, int taps) {
+    for (int x = 0; x < count; x++) {
+        int sum = 1 << (RESIZE_V_RSH_16 - 1);
+        for (int k = 0; k < taps; k++)
+            sum += ((const USHORT *)(src + k * src_pitch))[x] * weight[k];
+        tmp[x] = sum >> RESIZE_V_RSH_16;
+    }
+}
+
+template<typename Type, int ch>
+static void resize_horizontal(Type *dst, const int *tmp, const RESIZE_WEIGHT *wx, int dst_w, int rsh, int max_value) {
+    for (int x = 0; x < dst_w; x++) {
+        const int *src = tmp + wx->pos[x] * ch;
+        const short *weight = wx->weight + x * wx->taps;
+        int sum[ch];
+        for (int c = 0; c < ch; c++)
+            sum[c] = 1 << (rsh - 1);
+        for (int k = 0; k < wx->taps; k++)
+            for (int c = 0; c < ch; c++)
+                sum[c] += src[k * ch + c] * weight[k];
+        for (int c = 0; c < ch; c++)
+            dst[x * ch + c] = (Type)clamp(sum[c] >> rsh, 0, max_value);
+    }
+}
+
+template<typename Type>
+static void resize_horizontal(Type *dst, const int *tmp, const RESIZE_PLANE *plane, int rsh, int max_value) {
+    switch (plane->ch) {
+        case 4:  resize_horizontal<Type, 4>(dst, tmp, &plane->wx, plane->dst_w, rsh, max_value); break;
+        case 3:  resize_horizontal<Type, 3>(dst, tmp, &plane->wx, plane->dst_w, rsh, max_value); break;
+        case 2:  resize_horizontal<Type, 2>(dst, tmp, &plane->wx, plane->dst_w, rsh, max_value); break;
+        case 1:
+        default: resize_horizontal<Type, 1>(dst, tmp, &plane->wx, plane->dst_w, rsh, max_value); break;
+    }
+}
+
+void resize_frame(const RESIZE_DATA *resize, const CONVERT_CF_DATA *src, CONVERT_CF_DATA *dst) {
+    const int fields = (resize->interlaced) ? 2 : 1;
+    const int rsh = RESIZE_WEIGHT_BITS * 2 - ((resize->byte_per_pixel > 1) ? RESIZE_V_RSH_16 : RESIZE_V_RSH_8);
+    for (int i = 0; i < resize->count; i++) {
+        const RESIZE_PLANE *plane = &resize->plane[i];
+        const int src_pitch = plane->src_w * plane->ch * resize->byte_per_pixel;
+        const int dst_pitch = plane->dst_w * plane->ch * resize->byte_per_pixel;
+        for (int field = 0; field < fields; field++) {
+            const BYTE *src_field = src->data[i] + src_pitch * field;
+            BYTE *dst_field = dst->data[i] + dst_pitch * field;
+            for (int y = 0; y < plane->dst_h; y++) {
+                resize->resize_v(resize->tmp, src_field + src_pitch * fields * plane->wy.pos[y], src_pitch * fields,
+                    plane->src_w * plane->ch, plane->wy.weight + y * plane->wy.taps, plane->wy.taps);
+                BYTE *dst_line = dst_field + dst_pitch * fields * y;
+                if (resize->byte_per_pixel > 1) {
+                    resize_horizontal<USHORT>((USHORT *)dst_line, resize->tmp, plane, rsh, resize->max_value);
+                } else {
+                    resize_horizontal<BYTE>(dst_line, resize->tmp, plane, rsh, resize->max_value);
+                }
+            }
+        }
+    }
+}
@@ -35,6 +35,7 @@
 #if USE_SSE41
 #include <smmintrin.h> //イントリンシック命令 SSE4.1
 #endif
+#include <algorithm>
 #include "convert.h"
 #include "convert_const.h"
 
@@ -866,6 +867,207 @@ static __forceinline void convert_yc48_to_yuv444_16bit_simd(void *pixel, CONVERT
     }
 }
 
+//16bit値 -> 8bit (ディザあり)、戻り値は0～255の16bit値
+//err_cur/err_prevは誤差拡散時のみ使用し、stepは同じ色の隣接画素までの距離
+template <int dither>
+static __forceinline __m128i dither_16to8_simd(__m128i x0, const USHORT *threshold, short *err_cur, const short *err_prev, int step) {
+    if (dither == DITHER_ORDERED) {
+        x0 = _mm_adds_epu16(x0, _mm_loadu_si128((const __m128i *)threshold));
+        return _mm_srli_epi16(x0, 8);
+    }
+    __m128i x1, x2;
+    x1 = _mm_add_epi16(_mm_loadu_si128((const __m128i *)(err_prev - step)), _mm_loadu_si128((const __m128i *)(err_prev + step)));
+    x2 = _mm_loadu_si128((const __m128i *)err_prev);
+    x1 = _mm_add_epi16(x1, _mm_add_epi16(x2, x2));
+    x1 = _mm_srai_epi16(_mm_add_epi16(x1, _mm_set1_epi16(2)), 2);
+    x0 = _mm_add_epi16(_mm_srli_epi16(x0, 2), x1);
+    x1 = _mm_srai_epi16(_mm_add_epi16(x0, _mm_set1_epi16(32)), 6);
+    x1 = _mm_min_epi16(_mm_max_epi16(x1, _mm_setzero_si128()), _mm_set1_epi16(LIMIT_8));
+    x0 = _mm_sub_epi16(x0, _mm_slli_epi16(x1, 6));
+    x0 = _mm_min_epi16(_mm_max_epi16(x0, _mm_set1_epi16(-32)), _mm_set1_epi16(32));
+    _mm_storeu_si128((__m128i *)err_cur, x0);
+    return x1;
+}
+//幅が16で割り切れない場合は、最後の16画素を右端に合わせて計算しなおす
+//(ディザは左右の画素に依存しないので、重なった部分も同じ値になる)
+//はみ出して書き込むと、同じループで書いた次の行の先頭を壊してしまうため
+template <int dither>
+static __forceinline void convert_yc48_to_nv12_dither_simd(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (width < 16) {
+        if (dither == DITHER_ORDERED) convert_yc48_to_nv12_ordered_dither(pixel, pixel_data, width, height);
+        else                          convert_yc48_to_nv12_err_diffusion(pixel, pixel_data, width, height);
+        return;
+    }
+    int x, y, i;
+    BYTE *dst_Y = pixel_data->data[0];
+    BYTE *dst_C = pixel_data->data[1];
+    short *ycp, *ycpw;
+    BYTE *Y = NULL, *C = NULL;
+    short *eY0 = NULL, *eY1 = NULL, *eC = NULL;
+    const short *eY0p = NULL, *eY1p = NULL, *eCp = NULL;
+    const __m128i xC_pw_one = _mm_set1_epi16(1);
+    const __m128i xC_max = _mm_set1_epi16((short)LIMIT_16);
+    const __m128i xC_YCC = _mm_set1_epi32(1<<LSFT_YCC_16);
+    __m128i x0, x1, x2, x3, xY0[2], xY1[2], xC[2];
+    if (dither == DITHER_ERROR_DIFFUSION)
+        memset(pixel_data->dither_err, 0, get_dither_err_buf_size(width));
+    for (y = 0; y < height; y += 2) {
+        Y   = dst_Y + width * y;
+        C   = dst_C + width * y / 2;
+        const USHORT *thY0 = Array_DITHER_ORDERED[0][(y + 0) & 7];
+        const USHORT *thY1 = Array_DITHER_ORDERED[0][(y + 1) & 7];
+        const USHORT *thC  = Array_DITHER_ORDERED[1][(y >> 1) & 7];
+        if (dither == DITHER_ERROR_DIFFUSION) {
+            eY0 = get_dither_err_line(pixel_data, width, 0, y);     eY0p = get_dither_err_line(pixel_data, width, 0, y - 2);
+            eY1 = get_dither_err_line(pixel_data, width, 0, y + 1); eY1p = get_dither_err_line(pixel_data, width, 0, y - 1);
+            eC  = get_dither_err_line(pixel_data, width, 1, y >> 1); eCp = get_dither_err_line(pixel_data, width, 1, (y >> 1) - 2);
+        }
+        for (int x_block = 0; x_block < width; x_block += 16) {
+            x    = (std::min)(x_block, width - 16);
+            ycp  = (short*)pixel + (width * y + x) * 3;
+            ycpw = ycp + width*3;
+            for (i = 0; i < 2; i++) {
+                const int ix = x + i * 8;
+                x1 = _mm_loadu_si128((__m128i *)(ycp + i * 24 +  0));
+                x2 = _mm_loadu_si128((__m128i *)(ycp + i * 24 +  8));
+                x3 = _mm_loadu_si128((__m128i *)(ycp + i * 24 + 16));
+                _mm_prefetch((const char *)(ycpw + i * 24), _MM_HINT_T1);
+                gather_y_uv_from_yc48(x1, x2, x3);
+                x0 = x2;
+                xY0[i] = dither_16to8_simd<dither>(convert_y_range_from_yc48(x1, xC_Y_L_MA_16, Y_L_RSH_16, xC_YCC, xC_pw_one, xC_max), thY0 + (ix & 7), eY0 + ix, eY0p + ix, 1);
+
+                x1 = _mm_loadu_si128((__m128i *)(ycpw + i * 24 +  0));
+                x2 = _mm_loadu_si128((__m128i *)(ycpw + i * 24 +  8));
+                x3 = _mm_loadu_si128((__m128i *)(ycpw + i * 24 + 16));
+                gather_y_uv_from_yc48(x1, x2, x3);
+                xY1[i] = dither_16to8_simd<dither>(convert_y_range_from_yc48(x1, xC_Y_L_MA_16, Y_L_RSH_16, xC_YCC, xC_pw_one, xC_max), thY1 + (ix & 7), eY1 + ix, eY1p + ix, 1);
+
+                x0 = convert_uv_range_from_yc48_yuv420p(x0, x2, _mm_set1_epi16(UV_OFFSET_x2), xC_UV_L_MA_16_420P, UV_L_RSH_16_420P, xC_YCC, xC_pw_one, xC_max);
+                xC[i] = dither_16to8_simd<dither>(x0, thC + (ix & 7), eC + ix, eCp + ix, 2);
+            }
+            _mm_storeu_si128((__m128i *)(Y + x),         _mm_packus_epi16(xY0[0], xY0[1]));
+            _mm_storeu_si128((__m128i *)(Y + x + width), _mm_packus_epi16(xY1[0], xY1[1]));
+            _mm_storeu_si128((__m128i *)(C + x),         _mm_packus_epi16(xC[0],  xC[1]));
+        }
+    }
+}
+
+template <int dither>
+static __forceinline void convert_yc48_to_nv12_i_dither_simd(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (width < 16) {
+        if (dither == DITHER_ORDERED) convert_yc48_to_nv12_i_ordered_dither(pixel, pixel_data, width, height);
+        else                          convert_yc48_to_nv12_i_err_diffusion(pixel, pixel_data, width, height);
+        return;
+    }
+    int x, y, i, j;
+    BYTE *dst_Y = pixel_data->data[0];
+    BYTE *dst_C = pixel_data->data[1];
+    short *ycp, *ycpw;
+    BYTE *Y = NULL, *C = NULL;
+    short *eY0 = NULL, *eY1 = NULL, *eC = NULL;
+    const short *eY0p = NULL, *eY1p = NULL, *eCp = NULL;
+    const __m128i xC_pw_one = _mm_set1_epi16(1);
+    const __m128i xC_max = _mm_set1_epi16((short)LIMIT_16);
+    const __m128i xC_YCC = _mm_set1_epi32(1<<LSFT_YCC_16);
+    const __m128i *xC_UV_L_MA_420I = (const __m128i *)Array_UV_L_MA_16_420I;
+    __m128i x0, x1, x2, x3, xY0[2], xY1[2], xC[2];
+    if (dither == DITHER_ERROR_DIFFUSION)
+        memset(pixel_data->dither_err, 0, get_dither_err_buf_size(width));
+    for (y = 0; y < height; y += 4) {
+        for (i = 0; i < 2; i++) {
+            Y   = dst_Y + width * (y + i);
+            C   = dst_C + width * (y + i*2) / 2;
+            const USHORT *thY0 = Array_DITHER_ORDERED[0][(y + i + 0) & 7];
+            const USHORT *thY1 = Array_DITHER_ORDERED[0][(y + i + 2) & 7];
+            const USHORT *thC  = Array_DITHER_ORDERED[1][((y >> 1) + i) & 7];
+            if (dither == DITHER_ERROR_DIFFUSION) {
+                eY0 = get_dither_err_line(pixel_data, width, 0, y + i);     eY0p = get_dither_err_line(pixel_data, width, 0, y + i - 4);
+                eY1 = get_dither_err_line(pixel_data, width, 0, y + i + 2); eY1p = get_dither_err_line(pixel_data, width, 0, y + i - 2);
+                eC  = get_dither_err_line(pixel_data, width, 1, (y >> 1) + i); eCp = get_dither_err_line(pixel_data, width, 1, (y >> 1) + i - 2);
+            }
+            for (int x_block = 0; x_block < width; x_block += 16) {
+                x    = (std::min)(x_block, width - 16);
+                ycp  = (short*)pixel + (width * (y + i) + x) * 3;
+                ycpw = ycp + width*2*3;
+                for (j = 0; j < 2; j++) {
+                    const int ix = x + j * 8;
+                    x1 = _mm_loadu_si128((__m128i *)(ycp + j * 24 +  0));
+                    x2 = _mm_loadu_si128((__m128i *)(ycp + j * 24 +  8));
+                    x3 = _mm_loadu_si128((__m128i *)(ycp + j * 24 + 16));
+                    _mm_prefetch((const char *)(ycpw + j * 24), _MM_HINT_T1);
+                    gather_y_uv_from_yc48(x1, x2, x3);
+                    x0 = x2;
+                    xY0[j] = dither_16to8_simd<dither>(convert_y_range_from_yc48(x1, xC_Y_L_MA_16, Y_L_RSH_16, xC_YCC, xC_pw_one, xC_max), thY0 + (ix & 7), eY0 + ix, eY0p + ix, 1);
+
+                    x1 = _mm_loadu_si128((__m128i *)(ycpw + j * 24 +  0));
+                    x2 = _mm_loadu_si128((__m128i *)(ycpw + j * 24 +  8));
+                    x3 = _mm_loadu_si128((__m128i *)(ycpw + j * 24 + 16));
+                    gather_y_uv_from_yc48(x1, x2, x3);
+                    xY1[j] = dither_16to8_simd<dither>(convert_y_range_from_yc48(x1, xC_Y_L_MA_16, Y_L_RSH_16, xC_YCC, xC_pw_one, xC_max), thY1 + (ix & 7), eY1 + ix, eY1p + ix, 1);
+
+                    x0 = convert_uv_range_from_yc48_420i(x0, x2, _mm_set1_epi16(UV_OFFSET_x1), xC_UV_L_MA_420I[2*i], xC_UV_L_MA_420I[((i+1)&0x01)*2], UV_L_RSH_16_420I, xC_YCC, xC_pw_one, xC_max);
+                    xC[j] = dither_16to8_simd<dither>(x0, thC + (ix & 7), eC + ix, eCp + ix, 2);
+                }
+                _mm_storeu_si128((__m128i *)(Y + x),           _mm_packus_epi16(xY0[0], xY0[1]));
+                _mm_storeu_si128((__m128i *)(Y + x + width*2), _mm_packus_epi16(xY1[0], xY1[1]));
+                _mm_storeu_si128((__m128i *)(C + x),           _mm_packus_epi16(xC[0],  xC[1]));
+            }
+        }
+    }
+}
+
+template <int dither>
+static __forceinline void convert_yc48_to_yuv444_dither_simd(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (width < 16) {
+        if (dither == DITHER_ORDERED) convert_yc48_to_yuv444_ordered_dither(pixel, pixel_data, width, height);
+        else                          convert_yc48_to_yuv444_err_diffusion(pixel, pixel_data, width, height);
+        return;
+    }
+    short *e[3] = { 0 };
+    const short *ep[3] = { 0 };
+    const __m128i xC_pw_one = _mm_set1_epi16(1);
+    const __m128i xC_max = _mm_set1_epi16((short)LIMIT_16);
+    const __m128i xC_YCC = _mm_set1_epi32(1<<LSFT_YCC_16);
+    __m128i x1, x2, x3, xY[2], xU[2], xV[2];
+    if (dither == DITHER_ERROR_DIFFUSION)
+        memset(pixel_data->dither_err, 0, get_dither_err_buf_size(width));
+    for (int y = 0; y < height; y++) {
+        BYTE *Y = pixel_data->data[0] + width * y;
+        BYTE *U = pixel_data->data[1] + width * y;
+        BYTE *V = pixel_data->data[2] + width * y;
+        const USHORT *thY = Array_DITHER_ORDERED[0][y & 7];
+        const USHORT *thU = Array_DITHER_ORDERED[1][y & 7];
+        const USHORT *thV = Array_DITHER_ORDERED[2][y & 7];
+        if (dither == DITHER_ERROR_DIFFUSION) {
+            for (int j = 0; j < 3; j++) {
+                e[j]  = get_dither_err_line(pixel_data, width, j, y);
+                ep[j] = get_dither_err_line(pixel_data, width, j, y - 2);
+            }
+        }
+        for (int x_block = 0; x_block < width; x_block += 16) {
+            const int x = (std::min)(x_block, width - 16);
+            short *ycp = (short *)pixel + (width * y + x) * 3;
+            for (int i = 0; i < 2; i++) {
+                const int ix = x + i * 8;
+                x1 = _mm_loadu_si128((__m128i *)(ycp + i * 24 +  0));
+                x2 = _mm_loadu_si128((__m128i *)(ycp + i * 24 +  8));
+                x3 = _mm_loadu_si128((__m128i *)(ycp + i * 24 + 16));
+                gather_y_u_v_from_yc48(x1, x2, x3);
+
+                x1 = convert_y_range_from_yc48( x1,                                xC_Y_L_MA_16,      Y_L_RSH_16,     xC_YCC, xC_pw_one, xC_max);
+                x2 = convert_uv_range_from_yc48(x2, _mm_set1_epi16(UV_OFFSET_x1), xC_UV_L_MA_16_444, UV_L_RSH_16_444, xC_YCC, xC_pw_one, xC_max);
+                x3 = convert_uv_range_from_yc48(x3, _mm_set1_epi16(UV_OFFSET_x1), xC_UV_L_MA_16_444, UV_L_RSH_16_444, xC_YCC, xC_pw_one, xC_max);
+                xY[i] = dither_16to8_simd<dither>(x1, thY + (ix & 7), e[0] + ix, ep[0] + ix, 1);
+                xU[i] = dither_16to8_simd<dither>(x2, thU + (ix & 7), e[1] + ix, ep[1] + ix, 1);
+                xV[i] = dither_16to8_simd<dither>(x3, thV + (ix & 7), e[2] + ix, ep[2] + ix, 1);
+            }
+            _mm_storeu_si128((__m128i *)(Y + x), _mm_packus_epi16(xY[0], xY[1]));
+            _mm_storeu_si128((__m128i *)(U + x), _mm_packus_epi16(xU[0], xU[1]));
+            _mm_storeu_si128((__m128i *)(V + x), _mm_packus_epi16(xV[0], xV[1]));
+        }
+    }
+}
+
 
 template <BOOL aligned_store>
 static __forceinline void convert_lw48_to_nv12_16bit_simd(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
@@ -1015,6 +1217,248 @@ static __forceinline void convert_lw48_to_yuv444_16bit_simd(void *pixel, CONVERT
         _mm_store_switch_si128((__m128i*)dst_v, x3);
     }
 }
+#if USE_SSE41
+#ifndef clamp
+#define clamp(x, low, high) (((x) <= (high)) ? (((x) >= (low)) ? (x) : (low)) : (high))
+#endif
+
+//BGR 4画素分 (下位12byte) を各チャンネルごとの32bit整数に分離する
+static __forceinline void separate_bgr_to_epi32(__m128i& xB, __m128i& xG, __m128i& xR, const __m128i& xBGR) {
+    xB = _mm_shuffle_epi8(xBGR, _mm_setr_epi8(0, -1, -1, -1, 3, -1, -1, -1, 6, -1, -1, -1,  9, -1, -1, -1));
+    xG = _mm_shuffle_epi8(xBGR, _mm_setr_epi8(1, -1, -1, -1, 4, -1, -1, -1, 7, -1, -1, -1, 10, -1, -1, -1));
+    xR = _mm_shuffle_epi8(xBGR, _mm_setr_epi8(2, -1, -1, -1, 5, -1, -1, -1, 8, -1, -1, -1, 11, -1, -1, -1));
+}
+
+//RGB -> YUV444 4画素分
+//C版と結果が一致するよう、FMAは使わずC版と同じ順序で積和を行う
+static __forceinline void convert_rgb_to_yuv444_4px(__m128i& xY, __m128i& xU, __m128i& xV, const __m128i& xBGR, const __m128 xCoeff[9], const __m128& xScale) {
+    __m128i xB, xG, xR;
+    separate_bgr_to_epi32(xB, xG, xR, xBGR);
+    const __m128 b = _mm_cvtepi32_ps(xB);
+    const __m128 g = _mm_cvtepi32_ps(xG);
+    const __m128 r = _mm_cvtepi32_ps(xR);
+    const __m128 xOffsetY  = _mm_set1_ps(16.0f);
+    const __m128 xOffsetUV = _mm_set1_ps(128.0f);
+    const __m128 xRound    = _mm_set1_ps(0.5f);
+    __m128 y = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(xCoeff[0], r), _mm_mul_ps(xCoeff[1], g)), _mm_mul_ps(xCoeff[2], b)), xOffsetY);
+    __m128 u = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(xCoeff[3], r), _mm_mul_ps(xCoeff[4], g)), _mm_mul_ps(xCoeff[5], b)), xOffsetUV);
+    __m128 v = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(xCoeff[6], r), _mm_mul_ps(xCoeff[7], g)), _mm_mul_ps(xCoeff[8], b)), xOffsetUV);
+    xY = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(y, xScale), xRound));
+    xU = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(u, xScale), xRound));
+    xV = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, xScale), xRound));
+}
+
+//32bit整数 16画素分を飽和処理して書き込む
+template<typename TypeOut>
+static __forceinline void store_yuv444_16px(TypeOut *dst, const __m128i& x0, const __m128i& x1, const __m128i& x2, const __m128i& x3) {
+    const __m128i xLo = _mm_packus_epi32(x0, x1);
+    const __m128i xHi = _mm_packus_epi32(x2, x3);
+    if (sizeof(TypeOut) == 1) {
+        _mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(xLo, xHi));
+    } else {
+        _mm_storeu_si128((__m128i *)dst + 0, xLo);
+        _mm_storeu_si128((__m128i *)dst + 1, xHi);
+    }
+}
+
+template<typename TypeOut, int out_bit_depth>
+static __forceinline void convert_rgb_to_yuv444_simd(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    BYTE *ptrY = pixel_data->data[0];
+    BYTE *ptrU = pixel_data->data[1];
+    BYTE *ptrV = pixel_data->data[2];
+    const float *coeff_table = COEFF_RGB2YUV[pixel_data->colormatrix ? 1 : 0];
+    __m128 xCoeff[9];
+    for (int i = 0; i < 9; i++) {
+        xCoeff[i] = _mm_set1_ps(coeff_table[i]);
+    }
+    const __m128 xScale = _mm_set1_ps((float)(1 << (out_bit_depth - 8)));
+    int y0 = 0, y1 = height - 1;
+    const int srcstep = (width*3 + 3) & ~3;
+    for (; y0 < height; y0++, y1--) {
+        TypeOut *dstY = (TypeOut *)(ptrY + y1*width*sizeof(TypeOut));
+        TypeOut *dstU = (TypeOut *)(ptrU + y1*width*sizeof(TypeOut));
+        TypeOut *dstV = (TypeOut *)(ptrV + y1*width*sizeof(TypeOut));
+        BYTE *src = (BYTE*)frame + y0*srcstep;
+        int x = 0;
+        //16画素 (48byte) ずつ処理、4画素(12byte)ごとに切り出して変換する
+        for (; x <= width - 16; x += 16) {
+            const __m128i x0 = _mm_loadu_si128((const __m128i *)(src + x*3 +  0));
+            const __m128i x1 = _mm_loadu_si128((const __m128i *)(src + x*3 + 16));
+            const __m128i x2 = _mm_loadu_si128((const __m128i *)(src + x*3 + 32));
+            __m128i xY0, xY1, xY2, xY3, xU0, xU1, xU2, xU3, xV0, xV1, xV2, xV3;
+            convert_rgb_to_yuv444_4px(xY0, xU0, xV0, x0,                         xCoeff, xScale);
+            convert_rgb_to_yuv444_4px(xY1, xU1, xV1, _mm_alignr_epi8(x1, x0, 12), xCoeff, xScale);
+            convert_rgb_to_yuv444_4px(xY2, xU2, xV2, _mm_alignr_epi8(x2, x1,  8), xCoeff, xScale);
+            convert_rgb_to_yuv444_4px(xY3, xU3, xV3, _mm_srli_si128(x2, 4),       xCoeff, xScale);
+            store_yuv444_16px(dstY + x, xY0, xY1, xY2, xY3);
+            store_yuv444_16px(dstU + x, xU0, xU1, xU2, xU3);
+            store_yuv444_16px(dstV + x, xV0, xV1, xV2, xV3);
+        }
+        //残りはC版と同じ方法で処理
+        for (; x < width; x++) {
+            const float b = (float)src[x*3 + 0];
+            const float g = (float)src[x*3 + 1];
+            const float r = (float)src[x*3 + 2];
+            const float y = (coeff_table[0] * r + coeff_table[1] * g + coeff_table[2] * b +  16.0f) * (1 << (out_bit_depth - 8));
+            const float u = (coeff_table[3] * r + coeff_table[4] * g + coeff_table[5] * b + 128.0f) * (1 << (out_bit_depth - 8));
+            const float v = (coeff_table[6] * r + coeff_table[7] * g + coeff_table[8] * b + 128.0f) * (1 << (out_bit_depth - 8));
+            dstY[x] = (TypeOut)clamp((int)(y + 0.5f), 0, (1 << out_bit_depth) - 1);
+            dstU[x] = (TypeOut)clamp((int)(u + 0.5f), 0, (1 << out_bit_depth) - 1);
+            dstV[x] = (TypeOut)clamp((int)(v + 0.5f), 0, (1 << out_bit_depth) - 1);
+        }
+    }
+}
+
+//RGBA 4画素分をY, U, V (ビット深度を合わせる前の8bit相当の値) とアルファに分解する
+//C版(convert_rgba_to_yuv_1px)と結果が一致するよう、FMAは使わず同じ順序で演算する
+template<bool unpremultiply>
+static __forceinline void convert_rgba_to_yuv_4px(__m128& y, __m128& u, __m128& v, __m128i& xA, const __m128i& xBGRA, const __m128 xCoeff[9]) {
+    const __m128i xMask = _mm_set1_epi32(0xff);
+    __m128 b = _mm_cvtepi32_ps(_mm_and_si128(xBGRA, xMask));
+    __m128 g = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(xBGRA,  8), xMask));
+    __m128 r = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(xBGRA, 16), xMask));
+    xA = _mm_srli_epi32(xBGRA, 24);
+    if (unpremultiply) {
+        const __m128 x255 = _mm_set1_ps(255.0f);
+        const __m128 a = _mm_cvtepi32_ps(xA);
+        //a = 0 では 255/a が inf になるので、C版と同じく0にする
+        const __m128 inv = _mm_and_ps(_mm_div_ps(x255, a), _mm_cmpneq_ps(a, _mm_setzero_ps()));
+        b = _mm_min_ps(_mm_mul_ps(b, inv), x255);
+        g = _mm_min_ps(_mm_mul_ps(g, inv), x255);
+        r = _mm_min_ps(_mm_mul_ps(r, inv), x255);
+    }
+    y = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(xCoeff[0], r), _mm_mul_ps(xCoeff[1], g)), _mm_mul_ps(xCoeff[2], b)), _mm_set1_ps(16.0f));
+    u = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(xCoeff[3], r), _mm_mul_ps(xCoeff[4], g)), _mm_mul_ps(xCoeff[5], b)), _mm_set1_ps(128.0f));
+    v = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(xCoeff[6], r), _mm_mul_ps(xCoeff[7], g)), _mm_mul_ps(xCoeff[8], b)), _mm_set1_ps(128.0f));
+}
+
+//8bit相当の値を出力ビット深度に合わせて丸める (上限は書き込み時のpackusで飽和させる)
+template<int out_bit_depth>
+static __forceinline __m128i yuv_ps_to_bit_depth(const __m128& x) {
+    __m128i xi = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps((float)(1 << (out_bit_depth - 8)))), _mm_set1_ps(0.5f)));
+    if (out_bit_depth != 8 && out_bit_depth != 16) {
+        xi = _mm_min_epi32(xi, _mm_set1_epi32((1 << out_bit_depth) - 1));
+    }
+    return xi;
+}
+
+template<int out_bit_depth>
+static __forceinline __m128i alpha_8_to_bit_depth_simd(const __m128i& xA) {
+    return _mm_or_si128(_mm_slli_epi32(xA, out_bit_depth - 8), _mm_srli_epi32(xA, 16 - out_bit_depth));
+}
+
+//32bit整数 8画素分を飽和処理して書き込む
+template<typename TypeOut>
+static __forceinline void store_yuv_8px(TypeOut *dst, const __m128i& x0, const __m128i& x1) {
+    const __m128i x = _mm_packus_epi32(x0, x1);
+    if (sizeof(TypeOut) == 1) {
+        _mm_storel_epi64((__m128i *)dst, _mm_packus_epi16(x, x));
+    } else {
+        _mm_storeu_si128((__m128i *)dst, x);
+    }
+}
+
+template<typename TypeOut, int out_bit_depth, bool unpremultiply>
+static __forceinline void convert_rgba_to_yuva420_simd(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    BYTE *ptrY = pixel_data->data[0];
+    BYTE *ptrU = pixel_data->data[1];
+    BYTE *ptrV = pixel_data->data[2];
+    BYTE *ptrA = pixel_data->data[3];
+    const float *coeff_table = COEFF_RGB2YUV[pixel_data->colormatrix ? 1 : 0];
+    __m128 xCoeff[9];
+    for (int i = 0; i < 9; i++) {
+        xCoeff[i] = _mm_set1_ps(coeff_table[i]);
+    }
+    const __m128 xQuarter = _mm_set1_ps(0.25f);
+    const int srcstep = width * 4;
+    for (int y0 = 0; y0 < height; y0 += 2) {
+        const int y1 = height - 1 - y0;
+        TypeOut *dstY0 = (TypeOut *)(ptrY + y1*width*sizeof(TypeOut));
+        TypeOut *dstY1 = (TypeOut *)(ptrY + (y1-1)*width*sizeof(TypeOut));
+        TypeOut *dstA0 = (TypeOut *)(ptrA + y1*width*sizeof(TypeOut));
+        TypeOut *dstA1 = (TypeOut *)(ptrA + (y1-1)*width*sizeof(TypeOut));
+        TypeOut *dstU  = (TypeOut *)(ptrU + ((y1-1)>>1)*(width>>1)*sizeof(TypeOut));
+        TypeOut *dstV  = (TypeOut *)(ptrV + ((y1-1)>>1)*(width>>1)*sizeof(TypeOut));
+        BYTE *src0 = (BYTE*)frame + y0*srcstep;
+        BYTE *src1 = src0 + srcstep;
+        int x = 0;
+        //16画素 x 2行ずつ処理する
+        for (; x <= width - 16; x += 16) {
+            __m128 y0f[4], u0f[4], v0f[4], y1f[4], u1f[4], v1f[4];
+            __m128i xY0[4], xY1[4], xA0[4], xA1[4];
+            for (int i = 0; i < 4; i++) {
+                convert_rgba_to_yuv_4px<unpremultiply>(y0f[i], u0f[i], v0f[i], xA0[i], _mm_loadu_si128((const __m128i *)(src0 + (x + i*4)*4)), xCoeff);
+                convert_rgba_to_yuv_4px<unpremultiply>(y1f[i], u1f[i], v1f[i], xA1[i], _mm_loadu_si128((const __m128i *)(src1 + (x + i*4)*4)), xCoeff);
+                xY0[i] = yuv_ps_to_bit_depth<out_bit_depth>(y0f[i]);
+                xY1[i] = yuv_ps_to_bit_depth<out_bit_depth>(y1f[i]);
+                xA0[i] = alpha_8_to_bit_depth_simd<out_bit_depth>(xA0[i]);
+                xA1[i] = alpha_8_to_bit_depth_simd<out_bit_depth>(xA1[i]);
+            }
+            store_yuv444_16px(dstY0 + x, xY0[0], xY0[1], xY0[2], xY0[3]);
+            store_yuv444_16px(dstY1 + x, xY1[0], xY1[1], xY1[2], xY1[3]);
+            store_yuv444_16px(dstA0 + x, xA0[0], xA0[1], xA0[2], xA0[3]);
+            store_yuv444_16px(dstA1 + x, xA1[0], xA1[1], xA1[2], xA1[3]);
+            //横2画素の和をとってから上下の和をとる (C版と同じ順序)
+            __m128i xU[2], xV[2];
+            for (int i = 0; i < 2; i++) {
+                const __m128 u = _mm_add_ps(_mm_hadd_ps(u0f[i*2], u0f[i*2+1]), _mm_hadd_ps(u1f[i*2], u1f[i*2+1]));
+                const __m128 v = _mm_add_ps(_mm_hadd_ps(v0f[i*2], v0f[i*2+1]), _mm_hadd_ps(v1f[i*2], v1f[i*2+1]));
+                xU[i] = yuv_ps_to_bit_depth<out_bit_depth>(_mm_mul_ps(u, xQuarter));
+                xV[i] = yuv_ps_to_bit_depth<out_bit_depth>(_mm_mul_ps(v, xQuarter));
+            }
+            store_yuv_8px(dstU + (x>>1), xU[0], xU[1]);
+            store_yuv_8px(dstV + (x>>1), xV[0], xV[1]);
+        }
+        //残りはC版と同じ方法で処理
+        for (; x < width; x += 2) {
+            convert_rgba_to_yuva420_2x2<TypeOut, out_bit_depth, unpremultiply>(dstY0, dstY1, dstU, dstV, dstA0, dstA1, src0, src1, x, coeff_table);
+        }
+    }
+}
+
+template<typename TypeOut, int out_bit_depth, bool unpremultiply>
+static __forceinline void convert_rgba_to_yuva444_simd(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    BYTE *ptrY = pixel_data->data[0];
+    BYTE *ptrU = pixel_data->data[1];
+    BYTE *ptrV = pixel_data->data[2];
+    BYTE *ptrA = pixel_data->data[3];
+    const float *coeff_table = COEFF_RGB2YUV[pixel_data->colormatrix ? 1 : 0];
+    __m128 xCoeff[9];
+    for (int i = 0; i < 9; i++) {
+        xCoeff[i] = _mm_set1_ps(coeff_table[i]);
+    }
+    int y0 = 0, y1 = height - 1;
+    const int srcstep = width * 4;
+    for (; y0 < height; y0++, y1--) {
+        TypeOut *dstY = (TypeOut *)(ptrY + y1*width*sizeof(TypeOut));
+        TypeOut *dstU = (TypeOut *)(ptrU + y1*width*sizeof(TypeOut));
+        TypeOut *dstV = (TypeOut *)(ptrV + y1*width*sizeof(TypeOut));
+        TypeOut *dstA = (TypeOut *)(ptrA + y1*width*sizeof(TypeOut));
+        BYTE *src = (BYTE*)frame + y0*srcstep;
+        int x = 0;
+        //16画素 (64byte) ずつ処理する
+        for (; x <= width - 16; x += 16) {
+            __m128i xY[4], xU[4], xV[4], xA[4];
+            for (int i = 0; i < 4; i++) {
+                __m128 y, u, v;
+                convert_rgba_to_yuv_4px<unpremultiply>(y, u, v, xA[i], _mm_loadu_si128((const __m128i *)(src + (x + i*4)*4)), xCoeff);
+                xY[i] = yuv_ps_to_bit_depth<out_bit_depth>(y);
+                xU[i] = yuv_ps_to_bit_depth<out_bit_depth>(u);
+                xV[i] = yuv_ps_to_bit_depth<out_bit_depth>(v);
+                xA[i] = alpha_8_to_bit_depth_simd<out_bit_depth>(xA[i]);
+            }
+            store_yuv444_16px(dstY + x, xY[0], xY[1], xY[2], xY[3]);
+            store_yuv444_16px(dstU + x, xU[0], xU[1], xU[2], xU[3]);
+            store_yuv444_16px(dstV + x, xV[0], xV[1], xV[2], xV[3]);
+            store_yuv444_16px(dstA + x, xA[0], xA[1], xA[2], xA[3]);
+        }
+        //残りはC版と同じ方法で処理
+        for (; x < width; x++) {
+            convert_rgba_to_yuva444_1px<TypeOut, out_bit_depth, unpremultiply>(dstY, dstU, dstV, dstA, src, x, coeff_table);
+        }
+    }
+}
+#endif
 #if USE_SSSE3
 static __forceinline void sort_to_rgb_simd(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
     static const __m128i xC_SHUF = _mm_set_epi8(16, 12, 13, 14, 9, 10,  11,  6,  7,  8,  3,  4,  5,  0,  1,  2);
@@ -160,3 +160,21 @@ void convert_lw48_to_yuv444_16bit_sse2_mod8(void *frame, CONVERT_CF_DATA *pixel_
 void convert_lw48_to_yuv444_16bit_sse2(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
     return convert_lw48_to_yuv444_16bit_simd<FALSE>(frame, pixel_data, width, height);
 }
+void convert_yc48_to_nv12_ordered_dither_sse2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_dither_simd<DITHER_ORDERED>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_nv12_err_diffusion_sse2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_dither_simd<DITHER_ERROR_DIFFUSION>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_nv12_i_ordered_dither_sse2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_i_dither_simd<DITHER_ORDERED>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_nv12_i_err_diffusion_sse2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_i_dither_simd<DITHER_ERROR_DIFFUSION>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_yuv444_ordered_dither_sse2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_yuv444_dither_simd<DITHER_ORDERED>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_yuv444_err_diffusion_sse2(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_yuv444_dither_simd<DITHER_ERROR_DIFFUSION>(pixel, pixel_data, width, height);
+}
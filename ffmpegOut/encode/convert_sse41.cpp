@@ -30,6 +30,7 @@
 #define USE_SSE41 1
 
 #include "convert_simd.h"
+#include "convert_tmpl.h"
 
 void convert_yc48_to_nv12_10bit_sse41_mod8(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
     return convert_yc48_to_nv12_10bit_simd<TRUE>(frame, pixel_data, width, height);
@@ -129,3 +130,118 @@ void convert_lw48_to_yuv444_16bit_sse41_mod8(void *frame, CONVERT_CF_DATA *pixel
 void convert_lw48_to_yuv444_16bit_sse41(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
     return convert_lw48_to_yuv444_16bit_simd<FALSE>(frame, pixel_data, width, height);
 }
+void convert_rgb_to_yuv444_sse41(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    return convert_rgb_to_yuv444_simd<BYTE, 8>(frame, pixel_data, width, height);
+}
+void convert_rgb_to_yuv444_16bit_sse41(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    return convert_rgb_to_yuv444_simd<USHORT, 16>(frame, pixel_data, width, height);
+}
+void convert_rgba_to_yuva420_sse41(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva420_simd<BYTE, 8, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva420_simd<BYTE, 8, false>(frame, pixel_data, width, height);
+}
+void convert_rgba_to_yuva420_10bit_sse41(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva420_simd<USHORT, 10, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva420_simd<USHORT, 10, false>(frame, pixel_data, width, height);
+}
+void convert_rgba_to_yuva420_16bit_sse41(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva420_simd<USHORT, 16, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva420_simd<USHORT, 16, false>(frame, pixel_data, width, height);
+}
+void convert_rgba_to_yuva444_sse41(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva444_simd<BYTE, 8, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva444_simd<BYTE, 8, false>(frame, pixel_data, width, height);
+}
+void convert_rgba_to_yuva444_10bit_sse41(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva444_simd<USHORT, 10, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva444_simd<USHORT, 10, false>(frame, pixel_data, width, height);
+}
+void convert_rgba_to_yuva444_16bit_sse41(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    if (pixel_data->unpremultiply)
+        convert_rgba_to_yuva444_simd<USHORT, 16, true>(frame, pixel_data, width, height);
+    else
+        convert_rgba_to_yuva444_simd<USHORT, 16, false>(frame, pixel_data, width, height);
+}
+void convert_yc48_to_nv12_ordered_dither_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_dither_simd<DITHER_ORDERED>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_nv12_err_diffusion_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_dither_simd<DITHER_ERROR_DIFFUSION>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_nv12_i_ordered_dither_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_i_dither_simd<DITHER_ORDERED>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_nv12_i_err_diffusion_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_nv12_i_dither_simd<DITHER_ERROR_DIFFUSION>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_yuv444_ordered_dither_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_yuv444_dither_simd<DITHER_ORDERED>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_yuv444_err_diffusion_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    convert_yc48_to_yuv444_dither_simd<DITHER_ERROR_DIFFUSION>(pixel, pixel_data, width, height);
+}
+
+void convert_yc48_to_p012_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_P012::run<CONV_SIMD_SSE41>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_p012_i_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_P012_I::run<CONV_SIMD_SSE41>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_yuv444_12bit_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_YUV444_12::run<CONV_SIMD_SSE41>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_p210_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_P210::run<CONV_SIMD_SSE41>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_y210_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_Y210::run<CONV_SIMD_SSE41>(pixel, pixel_data, width, height);
+}
+void convert_yuy2_to_p012_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_P012::run<CONV_SIMD_SSE41>(pixel, pixel_data, width, height);
+}
+void convert_yuy2_to_p012_i_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_P012_I::run<CONV_SIMD_SSE41>(pixel, pixel_data, width, height);
+}
+void convert_yuy2_to_yuv444_12bit_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_YUV444_12::run<CONV_SIMD_SSE41>(pixel, pixel_data, width, height);
+}
+void convert_yuy2_to_p210_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_P210::run<CONV_SIMD_SSE41>(pixel, pixel_data, width, height);
+}
+void convert_yuy2_to_y210_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_Y210::run<CONV_SIMD_SSE41>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_yuv420_10bit_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_YUV420_10::run<CONV_SIMD_SSE41>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_yuv420_i_10bit_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_YUV420_10_I::run<CONV_SIMD_SSE41>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_yuv420_16bit_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_YUV420_16::run<CONV_SIMD_SSE41>(pixel, pixel_data, width, height);
+}
+void convert_yc48_to_yuv420_i_16bit_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YC48_TO_YUV420_16_I::run<CONV_SIMD_SSE41>(pixel, pixel_data, width, height);
+}
+void convert_yuy2_to_yuv420_10bit_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_YUV420_10::run<CONV_SIMD_SSE41>(pixel, pixel_data, width, height);
+}
+void convert_yuy2_to_yuv420_i_10bit_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_YUV420_10_I::run<CONV_SIMD_SSE41>(pixel, pixel_data, width, height);
+}
+void convert_yuy2_to_yuv420_16bit_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_YUV420_16::run<CONV_SIMD_SSE41>(pixel, pixel_data, width, height);
+}
+void convert_yuy2_to_yuv420_i_16bit_sse41(void *pixel, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+    CONV_YUY2_TO_YUV420_16_I::run<CONV_SIMD_SSE41>(pixel, pixel_data, width, height);
+}
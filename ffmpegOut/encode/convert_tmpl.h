@@ -0,0 +1,416 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#pragma once
+#ifndef _CONVERT_TMPL_H_
+#define _CONVERT_TMPL_H_
+
+//入力の展開 × 色変換 × 色差の配置 × 出力の詰め方 × SIMD幅 の組み合わせから変換関数を生成する
+//
+//  In     : 入力の展開   CONV_IN_YC48 / CONV_IN_YUY2
+//  Mat    : 色変換       CONV_MATRIX_YC48 (YC48 -> 圧縮レンジのYUV) / CONV_MATRIX_SHIFT<in_bits> (ビット深度を合わせるだけ)
+//  siting : 色差の配置   CONV_CHROMA_420P / CONV_CHROMA_420I / CONV_CHROMA_422 / CONV_CHROMA_444
+//  pack   : 出力の詰め方 CONV_PACK_SEMI_PLANAR (p0xx, p2xx) / CONV_PACK_PLANAR (yuv4xxp) / CONV_PACK_YUYV (y210)
+//  V      : SIMD幅       CONV_SIMD_C (1画素) / CONV_SIMD_SSE41 (4画素) / CONV_SIMD_AVX2 (8画素)
+//
+//計算はすべて32bit整数で行うので、C版とSIMD版の結果は一致する
+//SIMD版で処理しきれない右端はC版で処理する
+//USE_SSE41, USE_AVX2 を定義してからincludeすると、それぞれのSIMD版が使えるようになる (USE_AVX2ではSSE4.1版も使える)
+
+#include <algorithm>
+#if USE_SSE41 || USE_AVX2
+#include <smmintrin.h> //イントリンシック命令 SSE4.1
+#endif
+#if USE_AVX2
+#include <immintrin.h> //イントリンシック命令 AVX / AVX2
+#endif
+#include "convert.h"
+#include "convert_const.h"
+
+enum {
+    CONV_CHROMA_420P, //縦2行の平均
+    CONV_CHROMA_420I, //同じフィールドの2行を3:1で補間
+    CONV_CHROMA_422,  //偶数画素の色差をそのまま使う
+    CONV_CHROMA_444,
+};
+
+enum {
+    CONV_PACK_SEMI_PLANAR, //Y + UV (p010, p012, p210...)
+    CONV_PACK_PLANAR,      //Y + U + V (yuv444p12...)
+    CONV_PACK_YUYV,        //Y0 U Y1 V (y210) 4:2:2のみ
+};
+
+//---------------------------------------------------------------------
+// SIMD幅
+//   vec            : 32bit整数 x N
+//   pick_even      : a, bを並べたうち偶数番目だけを取り出す
+//   interleave     : a, bを交互に並べ、前半をlo、後半をhiに返す
+//   store_u16      : a, bを並べて16bitで書き込む (2N個)
+//   store_u16_half : aを16bitで書き込む (N個)
+//---------------------------------------------------------------------
+struct CONV_SIMD_C {
+    typedef int vec;
+    static const int N = 1;
+    static __forceinline vec set1(int a) { return a; }
+    static __forceinline vec add(vec a, vec b) { return a + b; }
+    static __forceinline vec mul(vec a, int m) { return a * m; }
+    template<int s> static __forceinline vec srai(vec a) { return a >> s; }
+    template<int s> static __forceinline vec slli(vec a) { return a << s; }
+    static __forceinline vec clip(vec a, int low, int high) { return std::min(std::max(a, low), high); }
+    static __forceinline vec pick_even(vec a, vec b) { return a; }
+    static __forceinline void interleave(vec a, vec b, vec& lo, vec& hi) { lo = a; hi = b; }
+    static __forceinline void store_u16(USHORT *dst, vec a, vec b) { dst[0] = (USHORT)a; dst[1] = (USHORT)b; }
+    static __forceinline void store_u16_half(USHORT *dst, vec a) { dst[0] = (USHORT)a; }
+};
+
+#if USE_SSE41 || USE_AVX2
+struct CONV_SIMD_SSE41 {
+    typedef __m128i vec;
+    static const int N = 4;
+    static __forceinline vec set1(int a) { return _mm_set1_epi32(a); }
+    static __forceinline vec add(vec a, vec b) { return _mm_add_epi32(a, b); }
+    static __forceinline vec mul(vec a, int m) { return _mm_mullo_epi32(a, _mm_set1_epi32(m)); }
+    template<int s> static __forceinline vec srai(vec a) { return _mm_srai_epi32(a, s); }
+    template<int s> static __forceinline vec slli(vec a) { return _mm_slli_epi32(a, s); }
+    static __forceinline vec clip(vec a, int low, int high) { return _mm_min_epi32(_mm_max_epi32(a, _mm_set1_epi32(low)), _mm_set1_epi32(high)); }
+    static __forceinline vec pick_even(vec a, vec b) {
+        return _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(2,0,2,0)));
+    }
+    static __forceinline void interleave(vec a, vec b, vec& lo, vec& hi) {
+        lo = _mm_unpacklo_epi32(a, b);
+        hi = _mm_unpackhi_epi32(a, b);
+    }
+    static __forceinline void store_u16(USHORT *dst, vec a, vec b) { _mm_storeu_si128((__m128i *)dst, _mm_packus_epi32(a, b)); }
+    static __forceinline void store_u16_half(USHORT *dst, vec a) { _mm_storel_epi64((__m128i *)dst, _mm_packus_epi32(a, a)); }
+};
+#endif //USE_SSE41 || USE_AVX2
+
+#if USE_AVX2
+struct CONV_SIMD_AVX2 {
+    typedef __m256i vec;
+    static const int N = 8;
+    static __forceinline vec set1(int a) { return _mm256_set1_epi32(a); }
+    static __forceinline vec add(vec a, vec b) { return _mm256_add_epi32(a, b); }
+    static __forceinline vec mul(vec a, int m) { return _mm256_mullo_epi32(a, _mm256_set1_epi32(m)); }
+    template<int s> static __forceinline vec srai(vec a) { return _mm256_srai_epi32(a, s); }
+    template<int s> static __forceinline vec slli(vec a) { return _mm256_slli_epi32(a, s); }
+    static __forceinline vec clip(vec a, int low, int high) { return _mm256_min_epi32(_mm256_max_epi32(a, _mm256_set1_epi32(low)), _mm256_set1_epi32(high)); }
+    static __forceinline vec pick_even(vec a, vec b) {
+        const __m256i y0 = _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _MM_SHUFFLE(2,0,2,0)));
+        return _mm256_permute4x64_epi64(y0, _MM_SHUFFLE(3,1,2,0));
+    }
+    static __forceinline void interleave(vec a, vec b, vec& lo, vec& hi) {
+        const __m256i y0 = _mm256_unpacklo_epi32(a, b);
+        const __m256i y1 = _mm256_unpackhi_epi32(a, b);
+        lo = _mm256_permute2x128_si256(y0, y1, (2<<4) | 0);
+        hi = _mm256_permute2x128_si256(y0, y1, (3<<4) | 1);
+    }
+    static __forceinline void store_u16(USHORT *dst, vec a, vec b) {
+        _mm256_storeu_si256((__m256i *)dst, _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), _MM_SHUFFLE(3,1,2,0)));
+    }
+    static __forceinline void store_u16_half(USHORT *dst, vec a) {
+        _mm_storeu_si128((__m128i *)dst, _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packus_epi32(a, a), _MM_SHUFFLE(3,1,2,0))));
+    }
+};
+#endif //USE_AVX2
+
+//---------------------------------------------------------------------
+// 入力の展開
+//   load : x から N画素分の y, cb, cr を32bit整数に展開する
+//          YUY2の色差は、その画素を含む2画素組のものを返す
+//---------------------------------------------------------------------
+struct CONV_IN_YC48 { static const int PIXEL_SIZE = sizeof(PIXEL_YC); };
+struct CONV_IN_YUY2 { static const int PIXEL_SIZE = 2; };
+
+template<class In, class V> struct CONV_LOAD;
+
+template<> struct CONV_LOAD<CONV_IN_YC48, CONV_SIMD_C> {
+    static __forceinline void load(const BYTE *line, int x, int& y, int& cb, int& cr) {
+        const PIXEL_YC *ycp = (const PIXEL_YC *)line + x;
+        y = ycp->y; cb = ycp->cb; cr = ycp->cr;
+    }
+};
+template<> struct CONV_LOAD<CONV_IN_YUY2, CONV_SIMD_C> {
+    static __forceinline void load(const BYTE *line, int x, int& y, int& cb, int& cr) {
+        const BYTE *p = line + (x & ~1) * 2;
+        y = line[x * 2]; cb = p[1]; cr = p[3];
+    }
+};
+
+#if USE_SSE41 || USE_AVX2
+//YC48 4画素 (short x 12) を y, cb, cr (short x 4) に分ける
+static __forceinline void conv_gather_yc48_4px(const BYTE *ptr, __m128i& y, __m128i& cb, __m128i& cr) {
+    const __m128i x0 = _mm_loadu_si128((const __m128i *)ptr);        //s0 - s7
+    const __m128i x1 = _mm_loadl_epi64((const __m128i *)(ptr + 16)); //s8 - s11
+    y  = _mm_or_si128(_mm_shuffle_epi8(x0, _mm_setr_epi8(0, 1, 6, 7, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+                      _mm_shuffle_epi8(x1, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 3, -1, -1, -1, -1, -1, -1, -1, -1)));
+    cb = _mm_or_si128(_mm_shuffle_epi8(x0, _mm_setr_epi8(2, 3, 8, 9, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+                      _mm_shuffle_epi8(x1, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 4, 5, -1, -1, -1, -1, -1, -1, -1, -1)));
+    cr = _mm_or_si128(_mm_shuffle_epi8(x0, _mm_setr_epi8(4, 5, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+                      _mm_shuffle_epi8(x1, _mm_setr_epi8(-1, -1, -1, -1, 0, 1, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1)));
+}
+template<> struct CONV_LOAD<CONV_IN_YC48, CONV_SIMD_SSE41> {
+    static __forceinline void load(const BYTE *line, int x, __m128i& y, __m128i& cb, __m128i& cr) {
+        conv_gather_yc48_4px(line + x * sizeof(PIXEL_YC), y, cb, cr);
+        y  = _mm_cvtepi16_epi32(y);
+        cb = _mm_cvtepi16_epi32(cb);
+        cr = _mm_cvtepi16_epi32(cr);
+    }
+};
+template<> struct CONV_LOAD<CONV_IN_YUY2, CONV_SIMD_SSE41> {
+    static __forceinline void load(const BYTE *line, int x, __m128i& y, __m128i& cb, __m128i& cr) {
+        const __m128i x0 = _mm_loadl_epi64((const __m128i *)(line + x * 2));
+        y  = _mm_shuffle_epi8(x0, _mm_setr_epi8(0, -1, -1, -1, 2, -1, -1, -1, 4, -1, -1, -1, 6, -1, -1, -1));
+        cb = _mm_shuffle_epi8(x0, _mm_setr_epi8(1, -1, -1, -1, 1, -1, -1, -1, 5, -1, -1, -1, 5, -1, -1, -1));
+        cr = _mm_shuffle_epi8(x0, _mm_setr_epi8(3, -1, -1, -1, 3, -1, -1, -1, 7, -1, -1, -1, 7, -1, -1, -1));
+    }
+};
+#endif //USE_SSE41 || USE_AVX2
+
+#if USE_AVX2
+template<> struct CONV_LOAD<CONV_IN_YC48, CONV_SIMD_AVX2> {
+    static __forceinline void load(const BYTE *line, int x, __m256i& y, __m256i& cb, __m256i& cr) {
+        __m128i y0, cb0, cr0, y1, cb1, cr1;
+        conv_gather_yc48_4px(line + x * sizeof(PIXEL_YC), y0, cb0, cr0);
+        conv_gather_yc48_4px(line + (x + 4) * sizeof(PIXEL_YC), y1, cb1, cr1);
+        y  = _mm256_cvtepi16_epi32(_mm_unpacklo_epi64(y0, y1));
+        cb = _mm256_cvtepi16_epi32(_mm_unpacklo_epi64(cb0, cb1));
+        cr = _mm256_cvtepi16_epi32(_mm_unpacklo_epi64(cr0, cr1));
+    }
+};
+template<> struct CONV_LOAD<CONV_IN_YUY2, CONV_SIMD_AVX2> {
+    static __forceinline void load(const BYTE *line, int x, __m256i& y, __m256i& cb, __m256i& cr) {
+        const __m256i y0 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(line + x * 2)));
+        y  = _mm256_shuffle_epi8(y0, _mm256_setr_epi8(0, -1, -1, -1, 2, -1, -1, -1, 4, -1, -1, -1, 6, -1, -1, -1, 8, -1, -1, -1, 10, -1, -1, -1, 12, -1, -1, -1, 14, -1, -1, -1));
+        cb = _mm256_shuffle_epi8(y0, _mm256_setr_epi8(1, -1, -1, -1, 1, -1, -1, -1, 5, -1, -1, -1, 5, -1, -1, -1, 9, -1, -1, -1, 9, -1, -1, -1, 13, -1, -1, -1, 13, -1, -1, -1));
+        cr = _mm256_shuffle_epi8(y0, _mm256_setr_epi8(3, -1, -1, -1, 3, -1, -1, -1, 7, -1, -1, -1, 7, -1, -1, -1, 11, -1, -1, -1, 11, -1, -1, -1, 15, -1, -1, -1, 15, -1, -1, -1));
+    }
+};
+#endif //USE_AVX2
+
+//---------------------------------------------------------------------
+// 色変換 (out_bitsのビット深度、LSB詰めの値を返す)
+//   luma   : 輝度
+//   chroma : 重みの合計が 1<<lw になるよう足し合わせた色差
+//---------------------------------------------------------------------
+//YC48 -> YUV (convert_const.hの8bitの式をout_bitsに合わせてシフトする)
+struct CONV_MATRIX_YC48 {
+    template<class V, int out_bits>
+    static __forceinline typename V::vec luma(typename V::vec y) {
+        const int lsft = out_bits - 8;
+        typename V::vec t = V::add(V::mul(y, Y_L_MUL), V::set1(Y_L_ADD_8 >> lsft));
+        t = V::template srai<Y_L_RSH_8 - lsft>(t);
+        return V::clip(V::add(t, V::set1(Y_L_YCC_8 << lsft)), 0, (1 << out_bits) - 1);
+    }
+    template<class V, int out_bits, int lw>
+    static __forceinline typename V::vec chroma(typename V::vec c) {
+        const int lsft = out_bits - 8;
+        typename V::vec t = V::add(V::mul(V::add(c, V::set1(UV_OFFSET_x1 << lw)), UV_L_MUL), V::set1((UV_L_ADD_8_444 >> lsft) << lw));
+        t = V::template srai<UV_L_RSH_8_444 - lsft + lw>(t);
+        return V::clip(V::add(t, V::set1(UV_L_YCC_8 << lsft)), 0, (1 << out_bits) - 1);
+    }
+};
+
+//sが正なら左シフト、負なら四捨五入して右シフト
+template<class V, int s, bool left = (s >= 0)> struct CONV_SHIFT;
+template<class V, int s> struct CONV_SHIFT<V, s, true> {
+    static __forceinline typename V::vec shift(typename V::vec a) { return V::template slli<s>(a); }
+};
+template<class V, int s> struct CONV_SHIFT<V, s, false> {
+    static __forceinline typename V::vec shift(typename V::vec a) { return V::template srai<-s>(V::add(a, V::set1(1 << (-s - 1)))); }
+};
+
+//すでにYUVの入力 (in_bitsのビット深度) -> ビット深度を合わせる
+template<int in_bits>
+struct CONV_MATRIX_SHIFT {
+    template<class V, int out_bits>
+    static __forceinline typename V::vec luma(typename V::vec y) {
+        return V::clip(CONV_SHIFT<V, out_bits - in_bits>::shift(y), 0, (1 << out_bits) - 1);
+    }
+    template<class V, int out_bits, int lw>
+    static __forceinline typename V::vec chroma(typename V::vec c) {
+        return V::clip(CONV_SHIFT<V, out_bits - in_bits - lw>::shift(c), 0, (1 << out_bits) - 1);
+    }
+};
+
+//---------------------------------------------------------------------
+// 変換関数本体
+//   msb : 16bitの上位に詰めて出力する (p012, p210, y210)
+//---------------------------------------------------------------------
+template<class In, class Mat, int siting, int pack, int out_bits, bool msb>
+struct CONV_KERNEL {
+    //一度に処理する入力の行数
+    static const int ROWS = (siting == CONV_CHROMA_420I) ? 4 : ((siting == CONV_CHROMA_420P) ? 2 : 1);
+    //出力する色差の行数
+    static const int C_ROWS = (siting == CONV_CHROMA_420I) ? 2 : 1;
+    static const int SHIFT_OUT = (msb) ? 16 - out_bits : 0;
+    static_assert(pack != CONV_PACK_YUYV || siting == CONV_CHROMA_422, "yuyv is 4:2:2 only.");
+
+    template<class V>
+    static __forceinline typename V::vec out(typename V::vec a) {
+        return V::template slli<SHIFT_OUT>(a);
+    }
+
+    //xから (2*V::N画素) を処理する、halvesが1ならV::N画素 (444の右端の1画素用)
+    template<class V, int halves>
+    static __forceinline void block(const BYTE *src, int src_pitch, USHORT *const *dst, const int *dst_pitch, int x) {
+        typedef typename V::vec vec;
+        vec y[ROWS][2], cb[ROWS][2], cr[ROWS][2];
+        for (int j = 0; j < ROWS; j++)
+            for (int i = 0; i < halves; i++)
+                CONV_LOAD<In, V>::load(src + j * src_pitch, x + i * V::N, y[j][i], cb[j][i], cr[j][i]);
+        for (int j = 0; j < ROWS; j++)
+            for (int i = 0; i < halves; i++)
+                y[j][i] = out<V>(Mat::template luma<V, out_bits>(y[j][i]));
+
+        if (siting == CONV_CHROMA_444) {
+            vec u[2], v[2];
+            for (int i = 0; i < halves; i++) {
+                u[i] = out<V>(Mat::template chroma<V, out_bits, 0>(cb[0][i]));
+                v[i] = out<V>(Mat::template chroma<V, out_bits, 0>(cr[0][i]));
+            }
+            if (halves == 1) {
+                V::store_u16_half(dst[0] + x, y[0][0]);
+                if (pack == CONV_PACK_PLANAR) {
+                    V::store_u16_half(dst[1] + x, u[0]);
+                    V::store_u16_half(dst[2] + x, v[0]);
+                } else {
+                    V::store_u16(dst[1] + x * 2, u[0], v[0]);
+                }
+                return;
+            }
+            V::store_u16(dst[0] + x, y[0][0], y[0][1]);
+            if (pack == CONV_PACK_PLANAR) {
+                V::store_u16(dst[1] + x, u[0], u[1]);
+                V::store_u16(dst[2] + x, v[0], v[1]);
+            } else {
+                for (int i = 0; i < 2; i++) {
+                    vec lo, hi;
+                    V::interleave(u[i], v[i], lo, hi);
+                    V::store_u16(dst[1] + (x + i * V::N) * 2, lo, hi);
+                }
+            }
+            return;
+        }
+
+        //色差は偶数画素の位置で求める
+        vec u[C_ROWS], v[C_ROWS];
+        if (siting == CONV_CHROMA_422) {
+            u[0] = Mat::template chroma<V, out_bits, 0>(V::pick_even(cb[0][0], cb[0][1]));
+            v[0] = Mat::template chroma<V, out_bits, 0>(V::pick_even(cr[0][0], cr[0][1]));
+        } else if (siting == CONV_CHROMA_420P) {
+            u[0] = Mat::template chroma<V, out_bits, 1>(V::pick_even(V::add(cb[0][0], cb[1][0]), V::add(cb[0][1], cb[1][1])));
+            v[0] = Mat::template chroma<V, out_bits, 1>(V::pick_even(V::add(cr[0][0], cr[1][0]), V::add(cr[0][1], cr[1][1])));
+        } else {
+            //上のフィールドは0行目と2行目、下のフィールドは1行目と3行目から
+            u[0]          = Mat::template chroma<V, out_bits, 2>(V::pick_even(V::add(V::mul(cb[0][0], 3), cb[2][0]), V::add(V::mul(cb[0][1], 3), cb[2][1])));
+            v[0]          = Mat::template chroma<V, out_bits, 2>(V::pick_even(V::add(V::mul(cr[0][0], 3), cr[2][0]), V::add(V::mul(cr[0][1], 3), cr[2][1])));
+            u[C_ROWS - 1] = Mat::template chroma<V, out_bits, 2>(V::pick_even(V::add(cb[1][0], V::mul(cb[3][0], 3)), V::add(cb[1][1], V::mul(cb[3][1], 3))));
+            v[C_ROWS - 1] = Mat::template chroma<V, out_bits, 2>(V::pick_even(V::add(cr[1][0], V::mul(cr[3][0], 3)), V::add(cr[1][1], V::mul(cr[3][1], 3))));
+        }
+        for (int k = 0; k < C_ROWS; k++) {
+            u[k] = out<V>(u[k]);
+            v[k] = out<V>(v[k]);
+        }
+
+        if (pack == CONV_PACK_YUYV) {
+            vec uv0, uv1, lo, hi;
+            V::interleave(u[0], v[0], uv0, uv1);
+            USHORT *ptr = dst[0] + x * 2;
+            V::interleave(y[0][0], uv0, lo, hi);
+            V::store_u16(ptr, lo, hi);
+            V::interleave(y[0][1], uv1, lo, hi);
+            V::store_u16(ptr + V::N * 2, lo, hi);
+            return;
+        }
+        for (int j = 0; j < ROWS; j++)
+            V::store_u16(dst[0] + j * dst_pitch[0] + x, y[j][0], y[j][1]);
+        for (int k = 0; k < C_ROWS; k++) {
+            if (pack == CONV_PACK_PLANAR) {
+                V::store_u16_half(dst[1] + k * dst_pitch[1] + x / 2, u[k]);
+                V::store_u16_half(dst[2] + k * dst_pitch[2] + x / 2, v[k]);
+            } else {
+                vec lo, hi;
+                V::interleave(u[k], v[k], lo, hi);
+                V::store_u16(dst[1] + k * dst_pitch[1] + x, lo, hi);
+            }
+        }
+    }
+
+    template<class V>
+    static void run(void *frame, CONVERT_CF_DATA *pixel_data, const int width, const int height) {
+        const int src_pitch = width * In::PIXEL_SIZE;
+        int dst_pitch[3];
+        dst_pitch[0] = (pack == CONV_PACK_YUYV) ? width * 2 : width;
+        if (siting == CONV_CHROMA_444) {
+            dst_pitch[1] = (pack == CONV_PACK_PLANAR) ? width : width * 2;
+        } else {
+            dst_pitch[1] = (pack == CONV_PACK_PLANAR) ? width / 2 : width;
+        }
+        dst_pitch[2] = dst_pitch[1];
+        const int c_div = (siting == CONV_CHROMA_420P || siting == CONV_CHROMA_420I) ? 2 : 1;
+        for (int y = 0; y < height; y += ROWS) {
+            const BYTE *src = (const BYTE *)frame + y * src_pitch;
+            USHORT *dst[3] = { 0 };
+            dst[0] = (USHORT *)pixel_data->data[0] + y * dst_pitch[0];
+            if (pack != CONV_PACK_YUYV) {
+                dst[1] = (USHORT *)pixel_data->data[1] + (y / c_div) * dst_pitch[1];
+                if (pack == CONV_PACK_PLANAR)
+                    dst[2] = (USHORT *)pixel_data->data[2] + (y / c_div) * dst_pitch[2];
+            }
+            int x = 0;
+            for (; x + V::N * 2 <= width; x += V::N * 2)
+                block<V, 2>(src, src_pitch, dst, dst_pitch, x);
+            for (; x + 2 <= width; x += 2)
+                block<CONV_SIMD_C, 2>(src, src_pitch, dst, dst_pitch, x);
+            if (x < width)
+                block<CONV_SIMD_C, 1>(src, src_pitch, dst, dst_pitch, x);
+        }
+    }
+};
+
+//出力形式ごとの組み合わせ
+typedef CONV_KERNEL<CONV_IN_YC48, CONV_MATRIX_YC48,     CONV_CHROMA_420P, CONV_PACK_SEMI_PLANAR, 12, true>  CONV_YC48_TO_P012;
+typedef CONV_KERNEL<CONV_IN_YC48, CONV_MATRIX_YC48,     CONV_CHROMA_420I, CONV_PACK_SEMI_PLANAR, 12, true>  CONV_YC48_TO_P012_I;
+typedef CONV_KERNEL<CONV_IN_YC48, CONV_MATRIX_YC48,     CONV_CHROMA_444,  CONV_PACK_PLANAR,      12, false> CONV_YC48_TO_YUV444_12;
+typedef CONV_KERNEL<CONV_IN_YC48, CONV_MATRIX_YC48,     CONV_CHROMA_422,  CONV_PACK_SEMI_PLANAR, 10, true>  CONV_YC48_TO_P210;
+typedef CONV_KERNEL<CONV_IN_YC48, CONV_MATRIX_YC48,     CONV_CHROMA_422,  CONV_PACK_YUYV,        10, true>  CONV_YC48_TO_Y210;
+typedef CONV_KERNEL<CONV_IN_YUY2, CONV_MATRIX_SHIFT<8>, CONV_CHROMA_420P, CONV_PACK_SEMI_PLANAR, 12, true>  CONV_YUY2_TO_P012;
+typedef CONV_KERNEL<CONV_IN_YUY2, CONV_MATRIX_SHIFT<8>, CONV_CHROMA_420I, CONV_PACK_SEMI_PLANAR, 12, true>  CONV_YUY2_TO_P012_I;
+typedef CONV_KERNEL<CONV_IN_YUY2, CONV_MATRIX_SHIFT<8>, CONV_CHROMA_444,  CONV_PACK_PLANAR,      12, false> CONV_YUY2_TO_YUV444_12;
+typedef CONV_KERNEL<CONV_IN_YUY2, CONV_MATRIX_SHIFT<8>, CONV_CHROMA_422,  CONV_PACK_SEMI_PLANAR, 10, true>  CONV_YUY2_TO_P210;
+typedef CONV_KERNEL<CONV_IN_YUY2, CONV_MATRIX_SHIFT<8>, CONV_CHROMA_422,  CONV_PACK_YUYV,        10, true>  CONV_YUY2_TO_Y210;
+typedef CONV_KERNEL<CONV_IN_YC48, CONV_MATRIX_YC48,     CONV_CHROMA_420P, CONV_PACK_PLANAR,      10, false> CONV_YC48_TO_YUV420_10;
+typedef CONV_KERNEL<CONV_IN_YC48, CONV_MATRIX_YC48,     CONV_CHROMA_420I, CONV_PACK_PLANAR,      10, false> CONV_YC48_TO_YUV420_10_I;
+typedef CONV_KERNEL<CONV_IN_YC48, CONV_MATRIX_YC48,     CONV_CHROMA_420P, CONV_PACK_PLANAR,      16, false> CONV_YC48_TO_YUV420_16;
+typedef CONV_KERNEL<CONV_IN_YC48, CONV_MATRIX_YC48,     CONV_CHROMA_420I, CONV_PACK_PLANAR,      16, false> CONV_YC48_TO_YUV420_16_I;
+typedef CONV_KERNEL<CONV_IN_YUY2, CONV_MATRIX_SHIFT<8>, CONV_CHROMA_420P, CONV_PACK_PLANAR,      10, false> CONV_YUY2_TO_YUV420_10;
+typedef CONV_KERNEL<CONV_IN_YUY2, CONV_MATRIX_SHIFT<8>, CONV_CHROMA_420I, CONV_PACK_PLANAR,      10, false> CONV_YUY2_TO_YUV420_10_I;
+typedef CONV_KERNEL<CONV_IN_YUY2, CONV_MATRIX_SHIFT<8>, CONV_CHROMA_420P, CONV_PACK_PLANAR,      16, false> CONV_YUY2_TO_YUV420_16;
+typedef CONV_KERNEL<CONV_IN_YUY2, CONV_MATRIX_SHIFT<8>, CONV_CHROMA_420I, CONV_PACK_PLANAR,      16, false> CONV_YUY2_TO_YUV420_16_I;
+
+#endif //_CONVERT_TMPL_H_
@@ -29,11 +29,16 @@
 #define NOMINMAX
 #include <Windows.h>
 #include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <algorithm>
 #include <shlwapi.h>
 #pragma comment(lib, "shlwapi.lib")
 #include "auo_pipe.h"
 #include "auo_util.h"
 #include "exe_version.h"
+#include "rgy_ini.h"
 #if ENCODER_X265
 #include <regex>
 #endif
@@ -281,90 +286,261 @@ int get_exe_version_info(const char *exe_path, int version[4]) {
     return ret;
 }
 
-int get_exe_version_from_cmd(const char *exe_path, const char *cmd_ver, int version[4]) {
+//実行ファイルの出力からバージョンを取得する (bufferは書き換えられる)
+static int get_exe_version_from_message(char *buffer, int version[4]) {
     int ret = -1;
-    if (nullptr == version || nullptr == exe_path || !PathFileExists(exe_path))
-        return ret;
-
-    memset(version, 0, sizeof(int) * 4);
-    const int BUFFER_LEN = 128 * 1024;
-    char *buffer = (char *)malloc(BUFFER_LEN);
-    if (nullptr == buffer)
-        return ret;
-    if (nullptr == cmd_ver)
-        cmd_ver = "-h";
-    if (get_exe_message(exe_path, cmd_ver, buffer, BUFFER_LEN / sizeof(buffer[0]), AUO_PIPE_MUXED) == RP_SUCCESS) {
-        char *str = nullptr;
-        int core = 0;
+    char *str = nullptr;
+    int core = 0;
 #if ENCODER_X264
-        if (1 == sscanf_s(buffer, "x264 core:%d", &core)) {
-            str = buffer + (strlen("x264 core:") + get_intlen(core));
-        } else
+    if (1 == sscanf_s(buffer, "x264 core:%d", &core)) {
+        str = buffer + (strlen("x264 core:") + get_intlen(core));
+    } else
 #endif
 #if ENCODER_SVTAV1
-        if (strstr(buffer, "SVT-AV1 Encoder Lib v") != nullptr) {
-            str = strstr(buffer, "SVT-AV1 Encoder Lib v") + strlen("SVT-AV1 Encoder Lib v");
-        } else
+    if (strstr(buffer, "SVT-AV1 Encoder Lib v") != nullptr) {
+        str = strstr(buffer, "SVT-AV1 Encoder Lib v") + strlen("SVT-AV1 Encoder Lib v");
+    } else
 #endif
-        {
-            str = buffer;
-        }
-        for (char *rtr = nullptr; 0 != ret && nullptr != (str = strtok_s(str, "\n", &rtr)); ) {
-            char *ptr = str;
-            static const char *PREFIX[] = { "fdkaac", "flac", "qaac", "refalac", "opus-tools", "version", "revision.", "revision", "rev.", "rev", " r.", " r", " v" };
-            for (int i = 0; i < _countof(PREFIX); i++) {
-                char *qtr = NULL;
-                if (NULL != (qtr = stristr(ptr, PREFIX[i]))) {
-                    ptr = qtr + strlen(PREFIX[i]);
-
-                    char *const ptr_fin = ptr + strlen(ptr);
-                    while (!isdigit(*ptr) && ptr < ptr_fin)
-                        ptr++;
+    {
+        str = buffer;
+    }
+    for (char *rtr = nullptr; 0 != ret && nullptr != (str = strtok_s(str, "\n", &rtr)); ) {
+        char *ptr = str;
+        static const char *PREFIX[] = { "fdkaac", "flac", "qaac", "refalac", "opus-tools", "version", "revision.", "revision", "rev.", "rev", " r.", " r", " v" };
+        for (int i = 0; i < _countof(PREFIX); i++) {
+            char *qtr = NULL;
+            if (NULL != (qtr = stristr(ptr, PREFIX[i]))) {
+                ptr = qtr + strlen(PREFIX[i]);
+
+                char *const ptr_fin = ptr + strlen(ptr);
+                while (!isdigit(*ptr) && ptr < ptr_fin)
+                    ptr++;
 
-                    int ver[4] = { 0 };
-                    int value4 = 0;
-                    if (   5 == sscanf_s(ptr, "%d.%d.%d-rc%d-%d", &ver[0], &ver[1], &ver[2], &ver[3], &value4)
-                        || 5 == sscanf_s(ptr, "%d.%d.%d-rc%d+%d", &ver[0], &ver[1], &ver[2], &ver[3], &value4)
-                        || 4 == sscanf_s(ptr, "%d.%d.%d-rc%d",    &ver[0], &ver[1], &ver[2], &ver[3])) {
-                        ver[3] *= RC_VER_MUL;
-                        ver[3] += RC_VER_ADD;
-                        ver[3] += value4;
-                        memcpy(version, ver, sizeof(int) * 4);
-                        ret = 0;
-                        break;
-                    }
-                    if (   4 == sscanf_s(ptr, "%d.%d.%d.%d", &ver[0], &ver[1], &ver[2], &ver[3])
-                        || 4 == sscanf_s(ptr, "%d.%d.%d-%d", &ver[0], &ver[1], &ver[2], &ver[3])
-                        || 4 == sscanf_s(ptr, "%d.%d.%d+%d", &ver[0], &ver[1], &ver[2], &ver[3])
-                        || 3 == sscanf_s(ptr, "%d.%d.%d",    &ver[0], &ver[1], &ver[2]         )
-                        || 3 == sscanf_s(ptr, "%d.%d+%d",    &ver[0], &ver[1],          &ver[3])
-                        || 2 == sscanf_s(ptr, "%d.%d",       &ver[0], &ver[1]                  )
-                        || 2 == sscanf_s(ptr, "%d+%d",       &ver[0],                   &ver[3])
-                        || 1 == sscanf_s(ptr, "%d",          &ver[0]                           )) {
-                        memcpy(version, ver, sizeof(int) * 4);
-                        ret = 0;
-#if ENCODER_X265
-                        if (ver[3] == 0 && get_x265ver_regex(ptr, ver) == 0) {
-                            memcpy(version, ver, sizeof(int) * 4);
-                        }
-#endif
-                        break;
-                    }
+                int ver[4] = { 0 };
+                int value4 = 0;
+                if (   5 == sscanf_s(ptr, "%d.%d.%d-rc%d-%d", &ver[0], &ver[1], &ver[2], &ver[3], &value4)
+                    || 5 == sscanf_s(ptr, "%d.%d.%d-rc%d+%d", &ver[0], &ver[1], &ver[2], &ver[3], &value4)
+                    || 4 == sscanf_s(ptr, "%d.%d.%d-rc%d",    &ver[0], &ver[1], &ver[2], &ver[3])) {
+                    ver[3] *= RC_VER_MUL;
+                    ver[3] += RC_VER_ADD;
+                    ver[3] += value4;
+                    memcpy(version, ver, sizeof(int) * 4);
+                    ret = 0;
+                    break;
+                }
+                if (   4 == sscanf_s(ptr, "%d.%d.%d.%d", &ver[0], &ver[1], &ver[2], &ver[3])
+                    || 4 == sscanf_s(ptr, "%d.%d.%d-%d", &ver[0], &ver[1], &ver[2], &ver[3])
+                    || 4 == sscanf_s(ptr, "%d.%d.%d+%d", &ver[0], &ver[1], &ver[2], &ver[3])
+                    || 3 == sscanf_s(ptr, "%d.%d.%d",    &ver[0], &ver[1], &ver[2]         )
+                    || 3 == sscanf_s(ptr, "%d.%d+%d",    &ver[0], &ver[1],          &ver[3])
+                    || 2 == sscanf_s(ptr, "%d.%d",       &ver[0], &ver[1]                  )
+                    || 2 == sscanf_s(ptr, "%d+%d",       &ver[0],                   &ver[3])
+                    || 1 == sscanf_s(ptr, "%d",          &ver[0]                           )) {
+                    memcpy(version, ver, sizeof(int) * 4);
+                    ret = 0;
 #if ENCODER_X265
-                    if ((ret = get_x265ver_regex(ptr, ver)) == 0) {
+                    if (ver[3] == 0 && get_x265ver_regex(ptr, ver) == 0) {
                         memcpy(version, ver, sizeof(int) * 4);
-                        break;
                     }
 #endif
+                    break;
                 }
+#if ENCODER_X265
+                if ((ret = get_x265ver_regex(ptr, ver)) == 0) {
+                    memcpy(version, ver, sizeof(int) * 4);
+                    break;
+                }
+#endif
             }
-            str = nullptr;
         }
+        str = nullptr;
+    }
+    return ret;
+}
+
+static const int EXE_MESSAGE_BUFFER_LEN = 128 * 1024;
+
+int get_exe_version_from_cmd(const char *exe_path, const char *cmd_ver, int version[4]) {
+    int ret = -1;
+    if (nullptr == version || nullptr == exe_path || !PathFileExists(exe_path))
+        return ret;
+
+    memset(version, 0, sizeof(int) * 4);
+    char *buffer = (char *)malloc(EXE_MESSAGE_BUFFER_LEN);
+    if (nullptr == buffer)
+        return ret;
+    if (nullptr == cmd_ver)
+        cmd_ver = "-h";
+    if (get_exe_message(exe_path, cmd_ver, buffer, EXE_MESSAGE_BUFFER_LEN / sizeof(buffer[0]), AUO_PIPE_MUXED) == RP_SUCCESS) {
+        ret = get_exe_version_from_message(buffer, version);
     }
     free(buffer);
     return ret;
 }
 
+//----    実行ファイルの情報のキャッシュ    -------------------------------------
+//実行ファイルのフルパス・サイズ・更新日時が一致する場合は、実行ファイルを起動せずに前回の結果を使用する
+//キャッシュは"<auo名>.exe_cache.ini"に保存し、セクション名は実行ファイルのフルパスとする
+
+static const char *EXE_CACHE_APPENDIX = ".exe_cache.ini";
+static const char *EXE_CACHE_KEY_SIZE = "size";
+static const char *EXE_CACHE_KEY_TIME = "time";
+
+static std::mutex g_exe_cache_mtx;
+static RGYIniFile g_exe_cache;
+
+typedef struct EXE_FILE_STAT {
+    std::string fullpath;
+    std::string size;
+    std::string time;
+} EXE_FILE_STAT;
+
+static bool get_exe_file_stat(const char *exe_path, EXE_FILE_STAT *stat) {
+    char fullpath[MAX_PATH_LEN];
+    WIN32_FILE_ATTRIBUTE_DATA fd = { 0 };
+    if (   0 == GetFullPathName(exe_path, _countof(fullpath), fullpath, nullptr)
+        || !GetFileAttributesEx(fullpath, GetFileExInfoStandard, &fd)
+        || (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+        return false;
+    stat->fullpath = fullpath;
+    stat->size = std::to_string(((UINT64)fd.nFileSizeHigh << 32) | fd.nFileSizeLow);
+    stat->time = std::to_string(((UINT64)fd.ftLastWriteTime.dwHighDateTime << 32) | fd.ftLastWriteTime.dwLowDateTime);
+    return true;
+}
+
+static std::string exe_cache_key(const char *cmd_ver) {
+    return std::string("cmd ") + cmd_ver;
+}
+
+//以下、g_exe_cache_mtxをロックした状態で呼ぶこと
+static void exe_cache_open() {
+    if (g_exe_cache.path().length() == 0) {
+        char auo_path[MAX_PATH_LEN];
+        char cache_file[MAX_PATH_LEN];
+        get_auo_path(auo_path, _countof(auo_path));
+        apply_appendix(cache_file, _countof(cache_file), auo_path, EXE_CACHE_APPENDIX);
+        g_exe_cache.load(cache_file);
+    } else {
+        g_exe_cache.reloadIfModified();
+    }
+}
+
+static bool exe_cache_get(const EXE_FILE_STAT *stat, const char *cmd_ver, EXE_PROBE_RESULT *result) {
+    const char *section = stat->fullpath.c_str();
+    if (   g_exe_cache.getString(section, EXE_CACHE_KEY_SIZE, "") != stat->size
+        || g_exe_cache.getString(section, EXE_CACHE_KEY_TIME, "") != stat->time)
+        return false;
+    const auto value = g_exe_cache.getString(section, exe_cache_key(cmd_ver).c_str(), "");
+    EXE_PROBE_RESULT tmp = { 0 };
+    if (6 != sscanf_s(value.c_str(), "%d,%d,%d,%d,%d,%d", &tmp.ret, &tmp.version[0], &tmp.version[1], &tmp.version[2], &tmp.version[3], &tmp.type))
+        return false;
+    *result = tmp;
+    return true;
+}
+
+static void exe_cache_set(const EXE_FILE_STAT *stat, const char *cmd_ver, const EXE_PROBE_RESULT *result) {
+    const char *section = stat->fullpath.c_str();
+    if (   g_exe_cache.getString(section, EXE_CACHE_KEY_SIZE, "") != stat->size
+        || g_exe_cache.getString(section, EXE_CACHE_KEY_TIME, "") != stat->time) {
+        //実行ファイルが更新されていれば、古い情報はすべて破棄する
+        g_exe_cache.removeSection(section);
+        g_exe_cache.setString(section, EXE_CACHE_KEY_SIZE, stat->size.c_str());
+        g_exe_cache.setString(section, EXE_CACHE_KEY_TIME, stat->time.c_str());
+    }
+    char value[256];
+    sprintf_s(value, "%d,%d,%d,%d,%d,%d", result->ret, result->version[0], result->version[1], result->version[2], result->version[3], result->type);
+    g_exe_cache.setString(section, exe_cache_key(cmd_ver).c_str(), value);
+}
+
+//実行ファイルを起動してバージョンと種類を取得する
+static bool probe_exe(const char *exe_path, const char *cmd_ver, EXE_PROBE_RESULT *result) {
+    bool success = false;
+    memset(result, 0, sizeof(result[0]));
+    result->ret = -1;
+    result->type = EXE_TYPE_UNKNOWN;
+    char *buffer = (char *)malloc(EXE_MESSAGE_BUFFER_LEN);
+    if (nullptr == buffer)
+        return success;
+    if (get_exe_message(exe_path, cmd_ver, buffer, EXE_MESSAGE_BUFFER_LEN / sizeof(buffer[0]), AUO_PIPE_MUXED) == RP_SUCCESS) {
+        //get_exe_version_from_messageはbufferを書き換えるので、種類の判定を先に行う
+        if (stristr(buffer, "mp4box") || stristr(buffer, "GPAC")) {
+            result->type = EXE_TYPE_MP4BOX;
+        } else if (stristr(buffer, "L-SMASH")) {
+            result->type = EXE_TYPE_LSMASH;
+        }
+        result->ret = get_exe_version_from_message(buffer, result->version);
+        success = true;
+    }
+    free(buffer);
+    return success;
+}
+
+std::vector<EXE_PROBE_RESULT> probe_exe_files_cached(const std::vector<std::string>& exe_paths, const char *cmd_ver) {
+    if (nullptr == cmd_ver)
+        cmd_ver = "-h";
+
+    EXE_PROBE_RESULT result_init = { 0 };
+    result_init.ret = -1;
+    result_init.type = EXE_TYPE_UNKNOWN;
+    std::vector<EXE_PROBE_RESULT> results(exe_paths.size(), result_init);
+    std::vector<EXE_FILE_STAT> stats(exe_paths.size());
+    std::vector<size_t> cache_miss;
+    {
+        std::lock_guard<std::mutex> lock(g_exe_cache_mtx);
+        exe_cache_open();
+        for (size_t i = 0; i < exe_paths.size(); i++) {
+            if (get_exe_file_stat(exe_paths[i].c_str(), &stats[i])
+                && !exe_cache_get(&stats[i], cmd_ver, &results[i])) {
+                cache_miss.push_back(i);
+            }
+        }
+    }
+    if (cache_miss.size() == 0) {
+        return results;
+    }
+
+    //キャッシュにないものは並列に実行ファイルを起動して取得する
+    std::vector<char> probed(exe_paths.size(), 0);
+    const size_t max_threads = (std::max)(1u, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < cache_miss.size(); i += max_threads) {
+        std::vector<std::thread> threads;
+        for (size_t j = i; j < (std::min)(i + max_threads, cache_miss.size()); j++) {
+            const size_t idx = cache_miss[j];
+            threads.push_back(std::thread([&, idx]() {
+                probed[idx] = probe_exe(stats[idx].fullpath.c_str(), cmd_ver, &results[idx]);
+            }));
+        }
+        for (auto& th : threads) {
+            th.join();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(g_exe_cache_mtx);
+    exe_cache_open();
+    for (const auto idx : cache_miss) {
+        //起動に失敗した場合は次回また試す
+        if (probed[idx]) {
+            exe_cache_set(&stats[idx], cmd_ver, &results[idx]);
+        }
+    }
+    g_exe_cache.save();
+    return results;
+}
+
+int get_exe_version_from_cmd_cached(const char *exe_path, const char *cmd_ver, int version[4]) {
+    if (nullptr == version || nullptr == exe_path)
+        return -1;
+    const auto result = probe_exe_files_cached({ exe_path }, cmd_ver).front();
+    memcpy(version, result.version, sizeof(result.version));
+    return result.ret;
+}
+
+EXE_TYPE get_exe_type_cached(const char *exe_path, const char *cmd_ver) {
+    if (nullptr == exe_path)
+        return EXE_TYPE_UNKNOWN;
+    return (EXE_TYPE)probe_exe_files_cached({ exe_path }, cmd_ver).front().type;
+}
+
 #if ENCODER_X264
 int get_x264_rev(const char *x264fullpath) {
     int ret = -1;
@@ -29,6 +29,7 @@
 #define _EXE_VERSION_H_
 
 #include <string>
+#include <vector>
 
 int version_a_larger_than_b(const int a[4], const int b[4]);
 std::string ver_string(int ver[4]);
@@ -36,6 +37,24 @@ std::string ver_string(int ver[4]);
 int get_exe_version_info(const char *exe_path, int version[4]);
 int get_exe_version_from_cmd(const char *exe_path, const char *cmd_ver, int version[4]);
 
+enum EXE_TYPE {
+    EXE_TYPE_UNKNOWN = 0,
+    EXE_TYPE_MP4BOX,
+    EXE_TYPE_LSMASH,
+};
+
+typedef struct EXE_PROBE_RESULT {
+    int ret;        //get_exe_version_from_cmdの戻り値
+    int version[4];
+    int type;       //EXE_TYPE
+} EXE_PROBE_RESULT;
+
+//実行ファイルのパス・サイズ・更新日時をキーとしたキャッシュを使用して情報を取得する
+//キャッシュにないものは並列に実行ファイルを起動して取得し、キャッシュファイルに保存する
+std::vector<EXE_PROBE_RESULT> probe_exe_files_cached(const std::vector<std::string>& exe_paths, const char *cmd_ver);
+int get_exe_version_from_cmd_cached(const char *exe_path, const char *cmd_ver, int version[4]);
+EXE_TYPE get_exe_type_cached(const char *exe_path, const char *cmd_ver);
+
 int get_x264_rev(const char *x264fullpath);
 int get_x265_rev(const char *x265fullpath, int version[4]);
 int get_svtav1_rev(const char *svtav1fullpath, int version[4]);
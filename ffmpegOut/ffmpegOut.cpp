@@ -39,9 +39,11 @@
 #include "auo_error.h"
 #include "auo_version.h"
 #include "auo_conf.h"
+#include "auo_stg_index.h"
 #include "auo_system.h"
 
 #include "auo_video.h"
+#include "auo_deferred.h"
 #include "auo_audio.h"
 #include "auo_faw2aac.h"
 #include "auo_mux.h"
@@ -159,6 +161,16 @@ BOOL func_init() {
 }
 
 BOOL func_exit() {
+    //後でエンコードのジョブが残っていれば、完了を待つか確認する
+    double progress = 0.0;
+    const int deferred_jobs = deferred_enc_get_status(&progress);
+    BOOL wait_deferred = FALSE;
+    if (deferred_jobs > 0) {
+        wchar_t mes[1024];
+        swprintf_s(mes, g_auo_mes.get(AUO_GUIEX_DEFERRED_ENC_WAIT), deferred_jobs, progress * 100.0);
+        wait_deferred = MessageBoxW(NULL, mes, AUO_FULL_NAME_W, MB_YESNO | MB_ICONQUESTION) == IDYES;
+    }
+    deferred_enc_close(wait_deferred);
     delete_SYSTEM_DATA(&g_sys_dat);
     return TRUE;
 }
@@ -179,7 +191,8 @@ BOOL func_output( OUTPUT_INFO *oip )
     const bool conf_not_initialized = memcmp(&conf_out, &g_conf, sizeof(g_conf)) == 0;
     if (conf_not_initialized) {
         PathCombine(default_stg_file, g_sys_dat.exstg->s_local.stg_dir, CONF_LAST_OUT);
-        if (!PathFileExists(default_stg_file)
+        guiEx_stg_index stg_index;
+        if (!stg_index.check_stg_file(g_sys_dat.exstg->s_local.stg_dir, CONF_LAST_OUT)
             || guiEx_config::load_guiEx_conf(&g_conf, default_stg_file) != CONF_ERROR_NONE) {
             //前回出力した設定ファイルがない場合は、デフォルト設定をロード
             init_CONF_GUIEX(&g_conf, FALSE);
@@ -209,12 +222,21 @@ BOOL func_output( OUTPUT_INFO *oip )
 
         //ret |= run_bat_file(&conf_out, oip, &pe, &sys_dat, RUN_BAT_BEFORE);
 
-        const auto audio_encode_timing = (conf_out.aud.use_internal) ? 2 : conf_out.aud.ext.audio_encode_timing;
-        for (int i = 0; !ret && i < 2; i++)
+        const int audio_encode_timing = get_audio_encode_timing(&conf_out, oip, &pe, g_sys_dat.exstg);
+        //処理順の自動選択時は、映像の処理の開始前に音声エンコーダの処理速度を計測しておく
+        if (pe.aud_timing_auto.enable)
+            ret |= audio_calib_enc_speed(&conf_out, oip, &pe, &g_sys_dat);
+        for (int i = 0; !ret && i < 2; i++) {
+            //自動選択により映像処理中に同時処理へ切り替えた場合、音声は処理済み
+            if (task[audio_encode_timing][i] == audio_output && conf_out.aud.ext.audio_encode_timing == AUDIO_ENC_TIMING_PARALLEL)
+                continue;
             ret |= task[audio_encode_timing][i](&conf_out, oip, &pe, &g_sys_dat);
+        }
 
         //if (!ret) ret |= mux(&conf_out, oip, &pe, &sys_dat);
 
+        if (!ret) ret |= deferred_video_output(&conf_out, oip, &pe, &g_sys_dat);
+
         ret |= move_temporary_files(&conf_out, &pe, &g_sys_dat, oip, ret);
 
         write_log_auo_enc_time(g_auo_mes.get(AUO_GUIEX_TOTAL_TIME), timeGetTime() - tm_start_enc);
@@ -256,7 +278,9 @@ BOOL func_output( OUTPUT_INFO *oip )
     if (ret == AUO_RESULT_SUCCESS) {
         memset(default_stg_file, 0, sizeof(default_stg_file));
         PathCombine(default_stg_file, g_sys_dat.exstg->s_local.stg_dir, CONF_LAST_OUT);
-        guiEx_config::save_guiEx_conf(&conf_out, default_stg_file);
+        if (guiEx_config::save_guiEx_conf(&conf_out, default_stg_file) == CONF_ERROR_NONE) {
+            guiEx_stg_index().set_stg_file(g_sys_dat.exstg->s_local.stg_dir, CONF_LAST_OUT, &conf_out);
+        }
     }
     free_enc_prm(&pe);
 
@@ -307,6 +331,8 @@ void init_SYSTEM_DATA(SYSTEM_DATA *_sys_dat) {
     get_aviutl_dir(_sys_dat->aviutl_dir, _countof(_sys_dat->aviutl_dir));
     _sys_dat->exstg = new guiEx_settings();
     load_lng(g_sys_dat.exstg->get_lang());
+    //iniで指定があれば、使用するSIMDを制限する (環境変数RGY_SIMDでも指定可能)
+    set_simd_limit(get_simd_limit_from_str(_sys_dat->exstg->s_local.simd_limit));
     _sys_dat->init = TRUE;
 }
 void delete_SYSTEM_DATA(SYSTEM_DATA *_sys_dat) {
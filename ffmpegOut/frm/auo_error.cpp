@@ -647,6 +647,18 @@ void error_select_convert_func(int width, int height, int bit_depth, BOOL interl
         );
 }
 
+void error_resize_unsupported_csp(int output_csp) {
+    write_log_auo_line_fmt(LOG_ERROR, g_auo_mes.get(AUO_ERR_RESIZE_UNSUPPORTED_CSP), char_to_wstring(specify_csp[output_csp]).c_str());
+}
+
+void warning_keyframes_afs() {
+    write_log_auo_line(LOG_WARNING, g_auo_mes.get(AUO_ERR_KEYFRAMES_AFS));
+}
+
+void warning_keyframes_truncated(int count, int total) {
+    write_log_auo_line_fmt(LOG_WARNING, g_auo_mes.get(AUO_ERR_KEYFRAMES_TRUNCATED), total, count);
+}
+
 void warning_no_batfile(const char *batfile) {
     write_log_auo_line_fmt(LOG_WARNING, L"%s: %s", g_auo_mes.get(AUO_ERR_NO_BAT_FILE), char_to_wstring(batfile).c_str());
 }
@@ -120,6 +120,9 @@ void warning_mux_chapter(int sts);
 void warning_chapter_convert_to_utf8(int sts);
 
 void error_select_convert_func(int width, int height, int bit_depth, BOOL interlaced, int output_csp);
+void error_resize_unsupported_csp(int output_csp);
+void warning_keyframes_afs();
+void warning_keyframes_truncated(int count, int total);
 
 void warning_no_batfile(const char *batfile);
 void warning_malloc_batfile_tmp();
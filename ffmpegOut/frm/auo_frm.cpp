@@ -28,8 +28,13 @@
 #include <stdlib.h>
 #include <string.h>
 #include <chrono>
+#include <cstdint>
+#include <atomic>
+#include <string>
 #include "auo_frm.h"
 #include "auo_util.h"
+#include <mmsystem.h>
+#pragma comment(lib, "winmm.lib")
 
 const int NEW_LINE_THRESHOLD = 125;
 const int MAKE_NEW_LINE_THRESHOLD = 140;
@@ -41,29 +46,44 @@ static inline int check_log_type(char *mes) {
 }
 
 static inline void add_line_to_cache(LOG_CACHE *cache_line, const char *mes) {
+    if (cache_line->line_offset == NULL || cache_line->arena == NULL)
+        return;
     if (cache_line->idx >= cache_line->max_line) {
         //メモリ不足なら再確保
-        if (NULL != (cache_line->lines = (wchar_t **)realloc(cache_line->lines, sizeof(cache_line->lines[0]) * cache_line->max_line * 2))) {
-            memset(&cache_line->lines[cache_line->max_line], 0, sizeof(cache_line->lines[0]) * cache_line->max_line);
-            cache_line->max_line *= 2;
-        }
+        size_t *new_offset = (size_t *)realloc(cache_line->line_offset, sizeof(cache_line->line_offset[0]) * cache_line->max_line * 2);
+        if (new_offset == NULL)
+            return;
+        cache_line->line_offset = new_offset;
+        cache_line->max_line *= 2;
     }
-    if (cache_line->lines) {
-        //一行のデータを格納
-        const auto wmes = char_to_wstring(mes, CP_UTF8);
-        wchar_t *line_ptr = (wchar_t *)malloc((wmes.length() + 1) * sizeof(line_ptr[0]));
-        wcscpy_s(line_ptr, wmes.length() + 1, wmes.c_str());
-        cache_line->lines[cache_line->idx] = line_ptr;
-        cache_line->idx++;
+    //一行のデータをarenaの末尾に直接変換して格納する
+    const int wlen = MultiByteToWideChar(CP_UTF8, 0, mes, -1, NULL, 0); //'\0'を含む
+    if (wlen <= 0)
+        return;
+    if (cache_line->arena_used + wlen > cache_line->arena_size) {
+        size_t new_size = cache_line->arena_size * 2;
+        while (cache_line->arena_used + wlen > new_size)
+            new_size *= 2;
+        wchar_t *new_arena = (wchar_t *)realloc(cache_line->arena, sizeof(cache_line->arena[0]) * new_size);
+        if (new_arena == NULL)
+            return;
+        cache_line->arena = new_arena;
+        cache_line->arena_size = new_size;
     }
+    MultiByteToWideChar(CP_UTF8, 0, mes, -1, cache_line->arena + cache_line->arena_used, wlen);
+    cache_line->line_offset[cache_line->idx] = cache_line->arena_used;
+    cache_line->arena_used += wlen;
+    cache_line->idx++;
 }
 
 void release_log_cache(LOG_CACHE *log_cache) {
-    if (log_cache && log_cache->lines) {
-        for (int i = 0; i < log_cache->idx; i++)
-            if (log_cache->lines[i]) free(log_cache->lines[i]);
-        free(log_cache->lines);
-        log_cache->lines = NULL;
+    if (log_cache) {
+        if (log_cache->line_offset) free(log_cache->line_offset);
+        if (log_cache->arena) free(log_cache->arena);
+        log_cache->line_offset = NULL;
+        log_cache->arena = NULL;
+        log_cache->arena_size = 0;
+        log_cache->arena_used = 0;
         log_cache->idx = 0;
     }
 }
@@ -73,7 +93,126 @@ int init_log_cache(LOG_CACHE *log_cache) {
     release_log_cache(log_cache);
     log_cache->idx = 0;
     log_cache->max_line = 64;
-    return NULL == (log_cache->lines = (wchar_t **)calloc(log_cache->max_line, sizeof(log_cache->lines[0])));
+    log_cache->arena_size = 16 * 1024;
+    log_cache->line_offset = (size_t *)calloc(log_cache->max_line, sizeof(log_cache->line_offset[0]));
+    log_cache->arena = (wchar_t *)malloc(log_cache->arena_size * sizeof(log_cache->arena[0]));
+    return NULL == log_cache->line_offset || NULL == log_cache->arena;
+}
+
+//ffmpegの詳細なログなどで大量の行が出力される場合、一行ずつログウィンドウに追加すると重いため、
+//いったんリングバッファに格納し、一定間隔で同じ種類の行をまとめて書き出す
+static const size_t LOG_BUFFER_LINES          = 1024; //2のべき乗であること
+static const size_t LOG_BUFFER_LINE_LEN       = 512;  //一行の最大長 (UTF-8、折り返し後の行が収まればよい)
+static const DWORD  LOG_BUFFER_FLUSH_INTERVAL = 100;  //ms
+
+//書き込み側は複数、読み出し側は1つ (ログウィンドウのスレッド) のロックフリーのリングバッファ
+class AuoLogLineBuffer {
+public:
+    AuoLogLineBuffer() : enqueue_pos(0), dequeue_pos(0), window_thread_id(0), last_flush(0), flushing(false) {
+        for (size_t i = 0; i < LOG_BUFFER_LINES; i++)
+            slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+    //バッファがいっぱいならfalseを返す
+    bool push(int log_type_index, const char *mes) {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot *slot = &slots[pos & (LOG_BUFFER_LINES - 1)];
+            const size_t seq = slot->seq.load(std::memory_order_acquire);
+            const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot->log_type_index = log_type_index;
+                    strncpy_s(slot->line, mes, _TRUNCATE);
+                    slot->seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    //読み出した行をfuncに渡す、行がなければfalseを返す
+    template<typename Func>
+    bool pop(Func func) {
+        Slot *slot = &slots[dequeue_pos & (LOG_BUFFER_LINES - 1)];
+        if (slot->seq.load(std::memory_order_acquire) != dequeue_pos + 1)
+            return false;
+        func(slot->log_type_index, slot->line);
+        slot->seq.store(dequeue_pos + LOG_BUFFER_LINES, std::memory_order_release);
+        dequeue_pos++;
+        return true;
+    }
+    DWORD window_thread_id; //読み出し側のスレッド
+    DWORD last_flush;
+    bool flushing;
+private:
+    struct Slot {
+        std::atomic<size_t> seq;
+        int log_type_index;
+        char line[LOG_BUFFER_LINE_LEN];
+    };
+    Slot slots[LOG_BUFFER_LINES];
+    std::atomic<size_t> enqueue_pos;
+    size_t dequeue_pos;
+};
+
+static AuoLogLineBuffer g_log_line_buffer;
+
+void init_log_line_buffer() {
+    g_log_line_buffer.window_thread_id = GetCurrentThreadId();
+}
+
+void write_log_line_buffered(int log_type_index, const char *mes_utf8) {
+    while (!g_log_line_buffer.push(log_type_index, mes_utf8)) {
+        //バッファがいっぱいの場合、ログウィンドウのスレッドならここで書き出し、それ以外は書き出しを待つ
+        if (GetCurrentThreadId() == g_log_line_buffer.window_thread_id) {
+            flush_log_line_buffer(true);
+        } else {
+            Sleep(1);
+        }
+    }
+}
+
+static void append_utf8_to_wstring(std::wstring& str, const char *mes) {
+    const int wlen = MultiByteToWideChar(CP_UTF8, 0, mes, -1, NULL, 0); //'\0'を含む
+    if (wlen <= 1)
+        return;
+    const size_t orig_len = str.length();
+    str.resize(orig_len + wlen);
+    MultiByteToWideChar(CP_UTF8, 0, mes, -1, &str[orig_len], wlen);
+    str.resize(orig_len + wlen - 1);
+}
+
+void flush_log_line_buffer(bool force) {
+    //書き出し中にwrite_log_lineから呼ばれた場合は何もしない
+    if (g_log_line_buffer.flushing)
+        return;
+    const DWORD now = timeGetTime();
+    if (!force && now - g_log_line_buffer.last_flush < LOG_BUFFER_FLUSH_INTERVAL)
+        return;
+    g_log_line_buffer.flushing = true;
+    g_log_line_buffer.last_flush = now;
+    std::wstring batch;
+    int batch_log_type = LOG_INFO;
+    bool batch_empty = true;
+    while (g_log_line_buffer.pop([&](int log_type_index, const char *line) {
+        //ログの種類が変わるところで区切って書き出す
+        if (!batch_empty && log_type_index != batch_log_type) {
+            write_log_line(batch_log_type, batch.c_str());
+            batch.clear();
+            batch_empty = true;
+        }
+        if (!batch_empty)
+            batch += L'\n';
+        append_utf8_to_wstring(batch, line);
+        batch_log_type = log_type_index;
+        batch_empty = false;
+    }));
+    if (!batch_empty)
+        write_log_line(batch_log_type, batch.c_str());
+    g_log_line_buffer.flushing = false;
 }
 
 //長すぎたら適当に折り返す
@@ -94,7 +233,7 @@ static int write_log_enc_mes_line(char *const mes, LOG_CACHE *cache_line) {
         if (p != mes)
             for (char *const prefix_adjust = p - prefix_len; p > prefix_adjust; p--)
                 *(p-1) = ' ';
-        (cache_line) ? add_line_to_cache(cache_line, p) : write_log_line(mes_type, char_to_wstring(p, CP_UTF8).c_str());
+        (cache_line) ? add_line_to_cache(cache_line, p) : write_log_line_buffered(mes_type, p);
         p=q+1;
     } while (flag_continue);
     return mes_len;
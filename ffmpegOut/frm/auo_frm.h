@@ -54,9 +54,16 @@ enum {
 typedef struct {
     int max_line; //格納できる最大の行数
     int idx;      //現在の行数
-    wchar_t **lines; //格納している一行
+    size_t *line_offset; //各行のarena内の位置
+    wchar_t *arena;      //行データをまとめて格納する領域 (行ごとにメモリ確保しない)
+    size_t arena_size;   //arenaの大きさ (文字数)
+    size_t arena_used;   //arenaの使用済みの大きさ (文字数)
 } LOG_CACHE;
 
+static inline const wchar_t *get_log_cache_line(const LOG_CACHE *log_cache, int i) {
+    return log_cache->arena + log_cache->line_offset[i];
+}
+
 //設定ウィンドウ
 void ShowfrmConfig(CONF_GUIEX *conf, const SYSTEM_DATA *sys_dat);
 
@@ -80,11 +87,20 @@ void log_reload_settings();
 void close_log_window();
 bool is_log_window_closed();
 
-int init_log_cache(LOG_CACHE *log_cache); //LOG_CACHEの初期化、linesのメモリ確保、成功->0, 失敗->1
+int init_log_cache(LOG_CACHE *log_cache); //LOG_CACHEの初期化、line_offset/arenaのメモリ確保、成功->0, 失敗->1
 void release_log_cache(LOG_CACHE *log_cache); //LOG_CACHEで使用しているメモリの開放
 
 void write_log_enc_mes(char * const mes, DWORD *log_len, int total_drop, int current_frames, int total_frames, LOG_CACHE *cache_line = nullptr);
 void write_log_exe_mes(char *const msg, DWORD *log_len, const wchar_t *exename, LOG_CACHE *cache_line);
 void write_args(const char *args);
 
+//ログウィンドウのスレッドから呼び、バッファの読み出し側のスレッドとして登録する
+void init_log_line_buffer();
+//エンコーダ等の出力の行をバッファに追加する (どのスレッドからでも呼べる)
+//バッファの内容はflush_log_line_bufferでまとめてログウィンドウに書き出す
+void write_log_line_buffered(int log_type_index, const char *mes_utf8);
+//バッファの内容をログウィンドウに書き出す (ログウィンドウのスレッドから呼ぶこと)
+//forceがfalseなら、前回の書き出しから一定時間経過している場合のみ書き出す
+void flush_log_line_buffer(bool force);
+
 #endif //_AUO_FRM_H_
\ No newline at end of file
@@ -69,6 +69,7 @@ static const char * AUO_MES_ID_NAME_STR[] = {
 "AUO_GUIEX_LANG",
 "AUO_GUIEX_FULL_NAME",
 "AUO_GUIEX_TOTAL_TIME",
+"AUO_GUIEX_DEFERRED_ENC_WAIT",
 "AUO_GUIEX_TIME_HOUR",
 "AUO_GUIEX_TIME_MIN",
 "AUO_GUIEX_TIME_SEC",
@@ -279,6 +280,9 @@ static const char * AUO_MES_ID_NAME_STR[] = {
 "AUO_ERR_MUX_CHPATER_UNKNOWN",
 "AUO_ERR_CHPATER_CONVERT",
 "AUO_ERR_SEL_CONVERT_FUNC",
+"AUO_ERR_RESIZE_UNSUPPORTED_CSP",
+"AUO_ERR_KEYFRAMES_AFS",
+"AUO_ERR_KEYFRAMES_TRUNCATED",
 "AUO_ERR_NO_BAT_FILE",
 "AUO_ERR_MALLOC_BAT_FILE_TMP",
 "AUO_ERR_OPEN_BAT_ORG",
@@ -296,14 +300,19 @@ static const char * AUO_MES_ID_NAME_STR[] = {
 "AUO_AUDIO_DELAY_CUT",
 "AUO_AUDIO_START_ENCODE",
 "AUO_AUDIO_CPU_USAGE",
+"AUO_AUDIO_STREAM_TO_VIDENC",
+"AUO_AUDIO_CALIB_ENC_SPEED",
 "AUO_ENCODE_SECTION_START",
 "AUO_ENCODE_AUDIO_ONLY",
 "AUO_ENCODE_AUDIO_ENCODER",
 "AUO_ENCODE_TMP_FOLDER",
 "AUO_ENCODE_TMP_FOLDER_AUDIO",
+"AUO_ENCODE_TMP_FOLDER_SAME_VOLUME",
 "AUO_ENCODE_ERROR_MOVE_CHAPTER_FILE",
 "AUO_ENCODE_FILE_NOT_FOUND",
 "AUO_ENCODE_FILE_MOVE_FAILED",
+"AUO_ENCODE_FILE_MOVE_CROSS_VOLUME",
+"AUO_ENCODE_FILE_MOVE_TITLE",
 "AUO_ENCODE_FILE_REMOVE_FAILED",
 "AUO_ENCODE_AFTER_MUX",
 "AUO_ENCODE_TC_FILE",
@@ -311,6 +320,7 @@ static const char * AUO_MES_ID_NAME_STR[] = {
 "AUO_ENCODE_CHAPTER_APPLE_FILE",
 "AUO_ENCODE_STATUS_FILE",
 "AUO_ENCODE_AUDIO_FILE",
+"AUO_ENCODE_DEFERRED_INTERMEDIATE",
 "AUO_ENCODE_AMP_ADJUST_LOW_BITRATE_PRESET_KEY",
 "AUO_ENCODE_AMP_ADJUST_LOW_BITRATE_PRESET",
 "AUO_ENCODE_AMP_ADJUST_LOW_BITRATE_KEY",
@@ -341,6 +351,10 @@ static const char * AUO_MES_ID_NAME_STR[] = {
 "AUO_CONF_AUDIO_DELAY_CUT_AUDIO",
 "AUO_CONF_AUDIO_DELAY_ADD_VIDEO",
 "AUO_CONF_AUDIO_DELAY_EDTS",
+"AUO_CONF_RESIZE_NONE",
+"AUO_CONF_RESIZE_BOX",
+"AUO_CONF_RESIZE_BILINEAR",
+"AUO_CONF_RESIZE_BICUBIC",
 "AUO_CONF_LAST_OUT_STG",
 "AUO_BAT_SECTION_START",
 "AUO_BAT_RUN",
@@ -359,6 +373,16 @@ static const char * AUO_MES_ID_NAME_STR[] = {
 "AUO_VIDEO_AFS_AVIUTL_AND_VPP_CONFLICT1",
 "AUO_VIDEO_AFS_AVIUTL_AND_VPP_CONFLICT2",
 "AUO_VIDEO_AUDIO_PROC_WAIT",
+"AUO_VIDEO_AUDIO_TIMING_AUTO_PARALLEL",
+"AUO_VIDEO_AUDIO_TIMING_AUTO_AFTER",
+"AUO_VIDEO_AUDIO_TIMING_AUTO_NONBLOCK",
+"AUO_VIDEO_DEFERRED_INTERMEDIATE",
+"AUO_VIDEO_DEFERRED_QUEUED",
+"AUO_VIDEO_DEFERRED_STATUS",
+"AUO_VIDEO_THREAD_PLACEMENT",
+"AUO_VIDEO_NUMA_NODE",
+"AUO_VIDEO_RESIZE",
+"AUO_VIDEO_KEYFRAMES",
 "AUO_VIDEO_CPU_USAGE",
 "AUO_VIDEO_AVIUTL_PROC_AVG_TIME",
 "AUO_VIDEO_ENCODE_TIME",
@@ -428,6 +452,7 @@ static const char * AUO_MES_ID_NAME_STR[] = {
 "AuofcggroupBoxCmdEx",
 "AuofcgLBInCmd",
 "AuofcgLBffmpegOutPriority",
+"AuofcgLBResize",
 "AuofcggroupBoxAudio",
 "AuofcgCBAudioUseInternal",
 "AuofcgCBFAWCheck",
@@ -521,6 +546,7 @@ static const char * AUO_MES_ID_NAME_STR[] = {
 "AUO_CONFIG_CX_AUD_ENC_ORDER_AFTER",
 "AUO_CONFIG_CX_AUD_ENC_ORDER_BEFORE",
 "AUO_CONFIG_CX_AUD_ENC_ORDER_PARALLEL",
+"AUO_CONFIG_CX_AUD_ENC_ORDER_AUTO",
 "AUO_CONFIG_CX_USE_DEFAULT_EXE_PATH",
 "AUO_CONFIG_CX_LOG_LEVEL_INFO",
 "AUO_CONFIG_CX_LOG_LEVEL_MORE",
@@ -577,6 +603,7 @@ static const char * AUO_MES_ID_NAME_STR[] = {
 "AUO_CONFIG_CX_REPLACE_FPS_SCALE",
 "AUO_CONFIG_CX_REPLACE_FPS_RATE",
 "AUO_CONFIG_CX_REPLACE_FPS_RATE_TIMES_4",
+"AUO_CONFIG_CX_REPLACE_KEYFRAMES",
 "AUO_CONFIG_CX_REPLACE_SAR_X",
 "AUO_CONFIG_CX_REPLACE_SAR_Y",
 "AUO_CONFIG_CX_REPLACE_DAR_X",
@@ -592,6 +619,9 @@ static const char * AUO_MES_ID_NAME_STR[] = {
 "AuofrmTTfcgTXCmdEx",
 "AuofrmTTfcgTXInCmd",
 "AuofrmTTfcgCXffmpegOutPriority",
+"AuofrmTTfcgCXResizeAlgo",
+"AuofrmTTfcgNUResizeW",
+"AuofrmTTfcgNUResizeH",
 "AuofrmTTfcgCXTempDir",
 "AuofrmTTfcgBTCustomTempDir",
 "AuofrmTTfcgCXAudioEncoder",
@@ -86,6 +86,7 @@ enum AuoMes {
     AUO_GUIEX_LANG,
     AUO_GUIEX_FULL_NAME,
     AUO_GUIEX_TOTAL_TIME,
+    AUO_GUIEX_DEFERRED_ENC_WAIT,
     AUO_GUIEX_TIME_HOUR,
     AUO_GUIEX_TIME_MIN,
     AUO_GUIEX_TIME_SEC,
@@ -327,6 +328,9 @@ enum AuoMes {
     AUO_ERR_CHPATER_CONVERT,
 
     AUO_ERR_SEL_CONVERT_FUNC,
+    AUO_ERR_RESIZE_UNSUPPORTED_CSP,
+    AUO_ERR_KEYFRAMES_AFS,
+    AUO_ERR_KEYFRAMES_TRUNCATED,
     AUO_ERR_NO_BAT_FILE,
     AUO_ERR_MALLOC_BAT_FILE_TMP,
     AUO_ERR_OPEN_BAT_ORG,
@@ -349,6 +353,8 @@ enum AuoMes {
     AUO_AUDIO_DELAY_CUT,
     AUO_AUDIO_START_ENCODE,
     AUO_AUDIO_CPU_USAGE,
+    AUO_AUDIO_STREAM_TO_VIDENC,
+    AUO_AUDIO_CALIB_ENC_SPEED,
 
     AUO_AUDIO_SECTION_FIN,
 
@@ -358,9 +364,12 @@ enum AuoMes {
     AUO_ENCODE_AUDIO_ENCODER,
     AUO_ENCODE_TMP_FOLDER,
     AUO_ENCODE_TMP_FOLDER_AUDIO,
+    AUO_ENCODE_TMP_FOLDER_SAME_VOLUME,
     AUO_ENCODE_ERROR_MOVE_CHAPTER_FILE,
     AUO_ENCODE_FILE_NOT_FOUND,
     AUO_ENCODE_FILE_MOVE_FAILED,
+    AUO_ENCODE_FILE_MOVE_CROSS_VOLUME,
+    AUO_ENCODE_FILE_MOVE_TITLE,
     AUO_ENCODE_FILE_REMOVE_FAILED,
     AUO_ENCODE_AFTER_MUX,
     AUO_ENCODE_TC_FILE,
@@ -368,6 +377,7 @@ enum AuoMes {
     AUO_ENCODE_CHAPTER_APPLE_FILE,
     AUO_ENCODE_STATUS_FILE,
     AUO_ENCODE_AUDIO_FILE,
+    AUO_ENCODE_DEFERRED_INTERMEDIATE,
     AUO_ENCODE_AMP_ADJUST_LOW_BITRATE_PRESET_KEY,
     AUO_ENCODE_AMP_ADJUST_LOW_BITRATE_PRESET,
     AUO_ENCODE_AMP_ADJUST_LOW_BITRATE_KEY,
@@ -408,6 +418,10 @@ enum AuoMes {
     AUO_CONF_AUDIO_DELAY_CUT_AUDIO,
     AUO_CONF_AUDIO_DELAY_ADD_VIDEO,
     AUO_CONF_AUDIO_DELAY_EDTS,
+    AUO_CONF_RESIZE_NONE,
+    AUO_CONF_RESIZE_BOX,
+    AUO_CONF_RESIZE_BILINEAR,
+    AUO_CONF_RESIZE_BICUBIC,
     AUO_CONF_LAST_OUT_STG,
     AUO_CONF_SECTION_FIN,
 
@@ -432,6 +446,16 @@ enum AuoMes {
     AUO_VIDEO_AFS_AVIUTL_AND_VPP_CONFLICT1,
     AUO_VIDEO_AFS_AVIUTL_AND_VPP_CONFLICT2,
     AUO_VIDEO_AUDIO_PROC_WAIT,
+    AUO_VIDEO_AUDIO_TIMING_AUTO_PARALLEL,
+    AUO_VIDEO_AUDIO_TIMING_AUTO_AFTER,
+    AUO_VIDEO_AUDIO_TIMING_AUTO_NONBLOCK,
+    AUO_VIDEO_DEFERRED_INTERMEDIATE,
+    AUO_VIDEO_DEFERRED_QUEUED,
+    AUO_VIDEO_DEFERRED_STATUS,
+    AUO_VIDEO_THREAD_PLACEMENT,
+    AUO_VIDEO_NUMA_NODE,
+    AUO_VIDEO_RESIZE,
+    AUO_VIDEO_KEYFRAMES,
     AUO_VIDEO_CPU_USAGE,
     AUO_VIDEO_AVIUTL_PROC_AVG_TIME,
     AUO_VIDEO_ENCODE_TIME,
@@ -510,6 +534,7 @@ enum AuoMes {
         AuofcggroupBoxCmdEx,
         AuofcgLBInCmd,
         AuofcgLBffmpegOutPriority,
+        AuofcgLBResize,
         AuofcggroupBoxAudio,
         AuofcgCBAudioUseInternal,
         AuofcgCBFAWCheck,
@@ -606,6 +631,7 @@ enum AuoMes {
         AUO_CONFIG_CX_AUD_ENC_ORDER_AFTER,
         AUO_CONFIG_CX_AUD_ENC_ORDER_BEFORE,
         AUO_CONFIG_CX_AUD_ENC_ORDER_PARALLEL,
+        AUO_CONFIG_CX_AUD_ENC_ORDER_AUTO,
         AUO_CONFIG_CX_USE_DEFAULT_EXE_PATH,
         AUO_CONFIG_CX_LOG_LEVEL_INFO,
         AUO_CONFIG_CX_LOG_LEVEL_MORE,
@@ -665,6 +691,7 @@ enum AuoMes {
         AUO_CONFIG_CX_REPLACE_FPS_SCALE,
         AUO_CONFIG_CX_REPLACE_FPS_RATE,
         AUO_CONFIG_CX_REPLACE_FPS_RATE_TIMES_4,
+        AUO_CONFIG_CX_REPLACE_KEYFRAMES,
         AUO_CONFIG_CX_REPLACE_SAR_X,
         AUO_CONFIG_CX_REPLACE_SAR_Y,
         AUO_CONFIG_CX_REPLACE_DAR_X,
@@ -683,6 +710,9 @@ enum AuoMes {
         AuofrmTTfcgTXCmdEx,
         AuofrmTTfcgTXInCmd,
         AuofrmTTfcgCXffmpegOutPriority,
+        AuofrmTTfcgCXResizeAlgo,
+        AuofrmTTfcgNUResizeW,
+        AuofrmTTfcgNUResizeH,
         AuofrmTTfcgCXTempDir,
         AuofrmTTfcgBTCustomTempDir,
         AuofrmTTfcgCXAudioEncoder,
@@ -34,6 +34,7 @@
 #include "auo_frm.h"
 #include "auo_faw2aac.h"
 #include "frmConfig.h"
+#include "auo_stg_index.h"
 #include "frmSaveNewStg.h"
 #include "frmOtherSettings.h"
 #include "frmBitrateCalculator.h"
@@ -743,20 +744,31 @@ System::Void frmConfig::fcgTSSettings_DropDownItemClicked(System::Object^  sende
 }
 
 System::Void frmConfig::RebuildStgFileDropDown(ToolStripDropDownItem^ TS, String^ dir) {
-    array<String^>^ subDirs = Directory::GetDirectories(dir);
-    for (int i = 0; i < subDirs->Length; i++) {
-        ToolStripMenuItem^ DDItem = gcnew ToolStripMenuItem(L"[ " + subDirs[i]->Substring(dir->Length+1) + L" ]");
-        DDItem->DropDownItemClicked += gcnew System::Windows::Forms::ToolStripItemClickedEventHandler(this, &frmConfig::fcgTSSettings_DropDownItemClicked);
-        DDItem->ForeColor = Color::Blue;
-        DDItem->Tag = nullptr;
-        RebuildStgFileDropDown(DDItem, subDirs[i]);
-        TS->DropDownItems->Add(DDItem);
-    }
-    array<String^>^ stgList = Directory::GetFiles(dir, L"*.stg");
-    for (int i = 0; i < stgList->Length; i++) {
-        ToolStripMenuItem^ mItem = gcnew ToolStripMenuItem(Path::GetFileNameWithoutExtension(stgList[i]));
-        mItem->Tag = stgList[i];
-        TS->DropDownItems->Add(mItem);
+    //stgフォルダのインデックスから一覧を作成する (変更のあったstgファイルのみ読み込まれる)
+    char stg_dir[MAX_PATH_LEN];
+    GetCHARfromString(stg_dir, sizeof(stg_dir), dir);
+    guiEx_stg_index stg_index;
+    stg_index.update(stg_dir);
+    auto dirItems = gcnew System::Collections::Generic::Dictionary<String^, ToolStripDropDownItem^>(StringComparer::OrdinalIgnoreCase);
+    for (const auto& entry : stg_index.get_entries()) {
+        String^ relPath = String(entry.path.c_str()).ToString();
+        String^ parentDir = Path::GetDirectoryName(relPath);
+        ToolStripDropDownItem^ parentItem = (parentDir->Length > 0 && dirItems->ContainsKey(parentDir)) ? dirItems[parentDir] : TS;
+        if (entry.is_dir) {
+            ToolStripMenuItem^ DDItem = gcnew ToolStripMenuItem(L"[ " + Path::GetFileName(relPath) + L" ]");
+            DDItem->DropDownItemClicked += gcnew System::Windows::Forms::ToolStripItemClickedEventHandler(this, &frmConfig::fcgTSSettings_DropDownItemClicked);
+            DDItem->ForeColor = Color::Blue;
+            DDItem->Tag = nullptr;
+            dirItems[relPath] = DDItem;
+            parentItem->DropDownItems->Add(DDItem);
+        } else {
+            ToolStripMenuItem^ mItem = gcnew ToolStripMenuItem(Path::GetFileNameWithoutExtension(relPath));
+            mItem->Tag = Path::Combine(dir, relPath);
+            if (entry.valid && (entry.codec.length() > 0 || entry.outext.length() > 0)) {
+                mItem->ToolTipText = String(entry.codec.c_str()).ToString() + L" " + String(entry.outext.c_str()).ToString();
+            }
+            parentItem->DropDownItems->Add(mItem);
+        }
     }
 }
 
@@ -860,6 +872,7 @@ System::Void frmConfig::InitComboBox() {
     setComboBox(fcgCXOutputCsp,      list_output_csp);
     setComboBox(fcgCXTempDir,        tempdir_desc);
     setComboBox(fcgCXInterlaced,     interlaced_desc);
+    setComboBox(fcgCXResizeAlgo,     VIDEO_RESIZE_ALGO);
 
     setComboBox(fcgCXAudioEncTiming, audio_enc_timing_desc);
     setComboBox(fcgCXAudioDelayCut,  AUDIO_DELAY_CUT_MODE);
@@ -1025,6 +1038,7 @@ System::Void frmConfig::LoadLangText() {
     LOAD_CLI_TEXT(fcggroupBoxCmdEx);
     LOAD_CLI_TEXT(fcgLBInCmd);
     LOAD_CLI_TEXT(fcgLBffmpegOutPriority);
+    LOAD_CLI_TEXT(fcgLBResize);
     LOAD_CLI_TEXT(fcggroupBoxAudio);
     LOAD_CLI_TEXT(fcgCBAudioUseInternal);
     LOAD_CLI_TEXT(fcgCBFAWCheck);
@@ -1127,6 +1141,9 @@ System::Void frmConfig::ConfToFrm(CONF_GUIEX *cnf) {
     SetCXIndex(fcgCXInterlaced,          cnf->enc.interlaced);
     SetCXIndex(fcgCXOutputCsp,           cnf->enc.output_csp);
     SetCXIndex(fcgCXffmpegOutPriority,    cnf->vid.priority);
+    SetCXIndex(fcgCXResizeAlgo,          cnf->vid.resize_algo);
+    SetNUValue(fcgNUResizeW,             cnf->vid.resize_w);
+    SetNUValue(fcgNUResizeH,             cnf->vid.resize_h);
     SetCXIndex(fcgCXTempDir,             cnf->oth.temp_dir);
     fcgCB2passEnc->Checked             = cnf->enc.use_auto_npass != 0;
     fcgCBAudioInput->Checked           = cnf->enc.audio_input != 0;
@@ -1147,7 +1164,7 @@ System::Void frmConfig::ConfToFrm(CONF_GUIEX *cnf) {
     SetNUValue(fcgNUAudioBitrate,       (cnf->aud.ext.bitrate != 0) ? cnf->aud.ext.bitrate : GetCurrentAudioDefaultBitrate());
     SetCXIndex(fcgCXAudioPriority,       cnf->aud.ext.priority);
     SetCXIndex(fcgCXAudioTempDir,        cnf->aud.ext.aud_temp_dir);
-    SetCXIndex(fcgCXAudioEncTiming,      1);
+    SetCXIndex(fcgCXAudioEncTiming,      cnf->aud.ext.audio_encode_timing);
     SetCXIndex(fcgCXAudioEncoderInternal, cnf->aud.in.encoder);
     SetCXIndex(fcgCXAudioEncModeInternal, cnf->aud.in.enc_mode);
     SetNUValue(fcgNUAudioBitrateInternal, (cnf->aud.in.bitrate != 0) ? cnf->aud.in.bitrate : GetCurrentAudioDefaultBitrate());
@@ -1195,6 +1212,9 @@ System::Void frmConfig::FrmToConf(CONF_GUIEX *cnf) {
     cnf->vid.afs_bitrate_correction = FALSE;
     cnf->vid.check_keyframe         = FALSE;
     cnf->vid.priority               = fcgCXffmpegOutPriority->SelectedIndex;
+    cnf->vid.resize_algo            = fcgCXResizeAlgo->SelectedIndex;
+    cnf->vid.resize_w               = (int)fcgNUResizeW->Value;
+    cnf->vid.resize_h               = (int)fcgNUResizeH->Value;
     cnf->oth.temp_dir               = fcgCXTempDir->SelectedIndex;
     GetCHARfromString(cnf->vid.cmdex, sizeof(cnf->vid.cmdex), fcgTXCmdEx->Text);
     GetCHARfromString(cnf->vid.incmd, sizeof(cnf->vid.incmd), fcgTXInCmd->Text);
@@ -1209,7 +1229,7 @@ System::Void frmConfig::FrmToConf(CONF_GUIEX *cnf) {
     cnf->aud.ext.use_wav                = !fcgCBAudioUsePipe->Checked;
     cnf->aud.ext.delay_cut              = fcgCXAudioDelayCut->SelectedIndex;
     cnf->aud.ext.priority               = fcgCXAudioPriority->SelectedIndex;
-    cnf->aud.ext.audio_encode_timing    = 1;
+    cnf->aud.ext.audio_encode_timing    = fcgCXAudioEncTiming->SelectedIndex;
     cnf->aud.ext.aud_temp_dir           = fcgCXAudioTempDir->SelectedIndex;
     cnf->aud.in.encoder                 = fcgCXAudioEncoderInternal->SelectedIndex;
     cnf->aud.in.faw_check               = fcgCBFAWCheck->Checked;
@@ -1418,6 +1438,9 @@ System::Void frmConfig::SetHelpToolTips() {
     SET_TOOL_TIP_EX(fcgTXCmdEx);
     SET_TOOL_TIP_EX(fcgTXInCmd);
     SET_TOOL_TIP_EX(fcgCXffmpegOutPriority);
+    SET_TOOL_TIP_EX(fcgCXResizeAlgo);
+    SET_TOOL_TIP_EX(fcgNUResizeW);
+    SET_TOOL_TIP_EX(fcgNUResizeH);
 
     //拡張
     SET_TOOL_TIP_EX(fcgCXTempDir);
@@ -369,6 +369,10 @@ namespace AUO_NAME_R {
     private: System::Windows::Forms::TextBox^  fcgTXCustomTempDir;
     private: System::Windows::Forms::ComboBox^  fcgCXTempDir;
 private: System::Windows::Forms::ComboBox^  fcgCXffmpegOutPriority;
+private: System::Windows::Forms::Label^  fcgLBResize;
+private: System::Windows::Forms::ComboBox^  fcgCXResizeAlgo;
+private: System::Windows::Forms::NumericUpDown^  fcgNUResizeW;
+private: System::Windows::Forms::NumericUpDown^  fcgNUResizeH;
 
     private: System::Windows::Forms::GroupBox^  fcggroupBoxCmdEx;
 
@@ -875,6 +879,10 @@ private: System::Windows::Forms::LinkLabel^  fcgLBguiExBlog;
             this->fcgCXTempDir = (gcnew System::Windows::Forms::ComboBox());
             this->fcgCXffmpegOutPriority = (gcnew System::Windows::Forms::ComboBox());
             this->fcgLBffmpegOutPriority = (gcnew System::Windows::Forms::Label());
+            this->fcgLBResize = (gcnew System::Windows::Forms::Label());
+            this->fcgCXResizeAlgo = (gcnew System::Windows::Forms::ComboBox());
+            this->fcgNUResizeW = (gcnew System::Windows::Forms::NumericUpDown());
+            this->fcgNUResizeH = (gcnew System::Windows::Forms::NumericUpDown());
             this->fcgCSExeFiles = (gcnew System::Windows::Forms::ContextMenuStrip(this->components));
             this->fcgTSExeFileshelp = (gcnew System::Windows::Forms::ToolStripMenuItem());
             this->fcgtoolStripSettings = (gcnew System::Windows::Forms::ToolStrip());
@@ -997,6 +1005,8 @@ private: System::Windows::Forms::LinkLabel^  fcgLBguiExBlog;
             (cli::safe_cast<System::ComponentModel::ISupportInitialize^>(this->fcgNUAudioBitrate))->BeginInit();
             this->fcgPNAudioInternal->SuspendLayout();
             (cli::safe_cast<System::ComponentModel::ISupportInitialize^>(this->fcgNUAudioBitrateInternal))->BeginInit();
+            (cli::safe_cast<System::ComponentModel::ISupportInitialize^>(this->fcgNUResizeW))->BeginInit();
+            (cli::safe_cast<System::ComponentModel::ISupportInitialize^>(this->fcgNUResizeH))->BeginInit();
             this->fcgtabControlMux->SuspendLayout();
             this->fcgtabPageMP4->SuspendLayout();
             this->fcgtabPageMKV->SuspendLayout();
@@ -1038,6 +1048,10 @@ private: System::Windows::Forms::LinkLabel^  fcgLBguiExBlog;
             this->fcgtabPageExSettings->Controls->Add(this->fcgCXTempDir);
             this->fcgtabPageExSettings->Controls->Add(this->fcgCXffmpegOutPriority);
             this->fcgtabPageExSettings->Controls->Add(this->fcgLBffmpegOutPriority);
+            this->fcgtabPageExSettings->Controls->Add(this->fcgLBResize);
+            this->fcgtabPageExSettings->Controls->Add(this->fcgCXResizeAlgo);
+            this->fcgtabPageExSettings->Controls->Add(this->fcgNUResizeW);
+            this->fcgtabPageExSettings->Controls->Add(this->fcgNUResizeH);
             this->fcgtabPageExSettings->Location = System::Drawing::Point(4, 23);
             this->fcgtabPageExSettings->Name = L"fcgtabPageExSettings";
             this->fcgtabPageExSettings->Size = System::Drawing::Size(608, 440);
@@ -1278,6 +1292,45 @@ private: System::Windows::Forms::LinkLabel^  fcgLBguiExBlog;
             this->fcgLBffmpegOutPriority->TabIndex = 1;
             this->fcgLBffmpegOutPriority->Text = L"エンコーダ優先度";
             // 
+            // fcgLBResize
+            // 
+            this->fcgLBResize->AutoSize = true;
+            this->fcgLBResize->Location = System::Drawing::Point(362, 74);
+            this->fcgLBResize->Name = L"fcgLBResize";
+            this->fcgLBResize->Size = System::Drawing::Size(49, 14);
+            this->fcgLBResize->TabIndex = 20;
+            this->fcgLBResize->Text = L"縮小出力";
+            // 
+            // fcgCXResizeAlgo
+            // 
+            this->fcgCXResizeAlgo->DropDownStyle = System::Windows::Forms::ComboBoxStyle::DropDownList;
+            this->fcgCXResizeAlgo->FormattingEnabled = true;
+            this->fcgCXResizeAlgo->Location = System::Drawing::Point(420, 71);
+            this->fcgCXResizeAlgo->Name = L"fcgCXResizeAlgo";
+            this->fcgCXResizeAlgo->Size = System::Drawing::Size(70, 22);
+            this->fcgCXResizeAlgo->TabIndex = 21;
+            this->fcgCXResizeAlgo->Tag = L"chValue";
+            // 
+            // fcgNUResizeW
+            // 
+            this->fcgNUResizeW->Location = System::Drawing::Point(494, 71);
+            this->fcgNUResizeW->Maximum = System::Decimal(gcnew cli::array< System::Int32 >(4) { 16384, 0, 0, 0 });
+            this->fcgNUResizeW->Name = L"fcgNUResizeW";
+            this->fcgNUResizeW->Size = System::Drawing::Size(52, 21);
+            this->fcgNUResizeW->TabIndex = 22;
+            this->fcgNUResizeW->Tag = L"chValue";
+            this->fcgNUResizeW->TextAlign = System::Windows::Forms::HorizontalAlignment::Right;
+            // 
+            // fcgNUResizeH
+            // 
+            this->fcgNUResizeH->Location = System::Drawing::Point(551, 71);
+            this->fcgNUResizeH->Maximum = System::Decimal(gcnew cli::array< System::Int32 >(4) { 16384, 0, 0, 0 });
+            this->fcgNUResizeH->Name = L"fcgNUResizeH";
+            this->fcgNUResizeH->Size = System::Drawing::Size(52, 21);
+            this->fcgNUResizeH->TabIndex = 23;
+            this->fcgNUResizeH->Tag = L"chValue";
+            this->fcgNUResizeH->TextAlign = System::Windows::Forms::HorizontalAlignment::Right;
+            // 
             // fcgCSExeFiles
             // 
             this->fcgCSExeFiles->Items->AddRange(gcnew cli::array< System::Windows::Forms::ToolStripItem^  >(1) { this->fcgTSExeFileshelp });
@@ -1518,7 +1571,6 @@ private: System::Windows::Forms::LinkLabel^  fcgLBguiExBlog;
             this->fcgCXAudioEncTiming->Size = System::Drawing::Size(68, 22);
             this->fcgCXAudioEncTiming->TabIndex = 27;
             this->fcgCXAudioEncTiming->Tag = L"chValue";
-            this->fcgCXAudioEncTiming->Visible = false;
             // 
             // fcgCXAudioTempDir
             // 
@@ -1685,7 +1737,6 @@ private: System::Windows::Forms::LinkLabel^  fcgLBguiExBlog;
             this->fcgCBAudioEncTiming->Size = System::Drawing::Size(40, 14);
             this->fcgCBAudioEncTiming->TabIndex = 28;
             this->fcgCBAudioEncTiming->Text = L"処理順";
-            this->fcgCBAudioEncTiming->Visible = false;
             // 
             // fcgTXAudioEncoderPath
             // 
@@ -2505,6 +2556,8 @@ private: System::Windows::Forms::LinkLabel^  fcgLBguiExBlog;
             this->fcgPNAudioInternal->ResumeLayout(false);
             this->fcgPNAudioInternal->PerformLayout();
             (cli::safe_cast<System::ComponentModel::ISupportInitialize^>(this->fcgNUAudioBitrateInternal))->EndInit();
+            (cli::safe_cast<System::ComponentModel::ISupportInitialize^>(this->fcgNUResizeW))->EndInit();
+            (cli::safe_cast<System::ComponentModel::ISupportInitialize^>(this->fcgNUResizeH))->EndInit();
             this->fcgtabControlMux->ResumeLayout(false);
             this->fcgtabPageMP4->ResumeLayout(false);
             this->fcgtabPageMP4->PerformLayout();
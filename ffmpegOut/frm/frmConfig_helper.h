@@ -285,6 +285,7 @@ static const ENC_OPTION_STR audio_enc_timing_desc[] = {
     { NULL, AUO_CONFIG_CX_AUD_ENC_ORDER_AFTER,    L"後"   },
     { NULL, AUO_CONFIG_CX_AUD_ENC_ORDER_BEFORE,   L"前"   },
     { NULL, AUO_CONFIG_CX_AUD_ENC_ORDER_PARALLEL, L"同時" },
+    { NULL, AUO_CONFIG_CX_AUD_ENC_ORDER_AUTO,     L"自動" },
     { NULL, AUO_MES_UNKNOWN, NULL }
 };
 
@@ -327,6 +328,7 @@ const REPLACE_STRINGS REPLACE_STRINGS_LIST[] = {
     { L"%{fps_scale}",         AUO_CONFIG_CX_REPLACE_FPS_SCALE,        L"フレームレート(分母)" },
     { L"%{fps_rate}",          AUO_CONFIG_CX_REPLACE_FPS_RATE,         L"フレームレート(分子)" },
     { L"%{fps_rate_times_4}",  AUO_CONFIG_CX_REPLACE_FPS_RATE_TIMES_4, L"フレームレート(分子)×4" },
+    { L"%{keyframes}",         AUO_CONFIG_CX_REPLACE_KEYFRAMES,        L"キーフレームの時刻(秒)のリスト" },
     //{ L"%{sar_x}",             AUO_CONFIG_CX_REPLACE_SAR_X,            L"サンプルアスペクト比 (横)" },
     //{ L"%{sar_y}",             AUO_CONFIG_CX_REPLACE_SAR_Y,            L"サンプルアスペクト比 (縦)" },
     //{ L"%{dar_x}",             AUO_CONFIG_CX_REPLACE_DAR_X,            L"画面アスペクト比 (横)" },
@@ -43,6 +43,7 @@ void show_log_window(const char *aviutl_dir, BOOL disable_visual_styles) {
     System::IO::Directory::SetCurrentDirectory(String(aviutl_dir).ToString());
     frmLog::Instance::get()->Show();
     frmLog::Instance::get()->SetWindowTitle(g_auo_mes.get(AUO_GUIEX_FULL_NAME), PROGRESSBAR_DISABLED);
+    init_log_line_buffer();
 }
 //ログウィンドウのタイトルを設定
 [STAThreadAttribute]
@@ -63,6 +64,9 @@ void set_window_title_enc_mes(const wchar_t *chr, int total_drop, int frame_n) {
 //メッセージをログウィンドウに表示
 [STAThreadAttribute]
 void write_log_auo_line(int log_type_index, const wchar_t *chr) {
+    //バッファに残っている行を先に書き出し、順序を保つ
+    if (!frmLog::Instance::get()->InvokeRequired)
+        flush_log_line_buffer(true);
     frmLog::Instance::get()->WriteLogAuoLine(String(chr).ToString(), log_type_index);
 }
 //現在実行中の内容の設定
@@ -80,6 +84,8 @@ void set_log_progress(double progress) {
 //メッセージを直接ログウィンドウに表示
 [STAThreadAttribute]
 void write_log_line(int log_type_index, const wchar_t *chr) {
+    if (!frmLog::Instance::get()->InvokeRequired)
+        flush_log_line_buffer(true);
     frmLog::Instance::get()->WriteLogLine(String(chr).ToString(), log_type_index);
 }
 //音声を並列に処理する際に、蓄えた音声のログを表示
@@ -105,6 +111,8 @@ void set_prevent_log_close(BOOL prevent) {
 //自動ログ保存を実行
 [STAThreadAttribute]
 void auto_save_log_file(const char *log_filepath) {
+    if (!frmLog::Instance::get()->InvokeRequired)
+        flush_log_line_buffer(true);
     frmLog::Instance::get()->AutoSaveLogFile(log_filepath);
 }
 //ログウィンドウに設定を再ロードさせる
@@ -113,19 +121,32 @@ void log_reload_settings() {
     frmLog::Instance::get()->ReloadLogWindowSettings();
 }
 //ログウィンドウにイベントを実行させる
+//エンコードのループなどから頻繁に呼ばれるので、DoEventsは一定間隔でのみ行う
 [STAThreadAttribute]
 void log_process_events() {
-    if (!frmLog::Instance::get()->InvokeRequired)
-        System::Windows::Forms::Application::DoEvents();
+    static const DWORD PROCESS_EVENTS_INTERVAL = 10; //ms
+    static DWORD last_process_events = 0;
+    if (!frmLog::Instance::get()->InvokeRequired) {
+        flush_log_line_buffer(false);
+        const DWORD now = timeGetTime();
+        if (now - last_process_events >= PROCESS_EVENTS_INTERVAL) {
+            last_process_events = now;
+            System::Windows::Forms::Application::DoEvents();
+        }
+    }
 }
 //現在のログの長さを返す
 [STAThreadAttribute]
 int get_current_log_len(bool first_pass) {
+    if (!frmLog::Instance::get()->InvokeRequired)
+        flush_log_line_buffer(true);
     return frmLog::Instance::get()->GetLogStringLen(first_pass);
 }
 
 [STAThreadAttribute]
 void close_log_window() {
+    if (!frmLog::Instance::get()->InvokeRequired)
+        flush_log_line_buffer(true);
     frmLog::Instance::get()->CloseLogWindow();
 }
 
@@ -44,6 +44,13 @@ enum {
     TMP_DIR_CUSTOM = 2,
 };
 
+enum {
+    AUDIO_ENC_TIMING_AFTER    = 0, //映像→音声の順で処理
+    AUDIO_ENC_TIMING_BEFORE   = 1, //音声→映像の順で処理
+    AUDIO_ENC_TIMING_PARALLEL = 2, //映像と音声を同時に処理
+    AUDIO_ENC_TIMING_AUTO     = 3, //処理速度を計測し、後/同時を自動選択
+};
+
 enum : DWORD {
     RUN_BAT_NONE           = 0x00,
     RUN_BAT_BEFORE_PROCESS = 0x01,
@@ -114,6 +121,21 @@ enum {
     AUDIO_DELAY_CUT_EDTS         = 3, //音声エンコード遅延の削除をedtsを用いて行う
 };
 
+enum {
+    VIDEO_RESIZE_NONE     = 0, //縮小しない
+    VIDEO_RESIZE_BOX      = 1, //面積平均 (2:1, 4:1はYUY2/YC48 -> nv12変換と同時に処理する)
+    VIDEO_RESIZE_BILINEAR = 2, //バイリニア (縮小率に合わせて参照範囲を広げる)
+    VIDEO_RESIZE_BICUBIC  = 3, //バイキュービック (a=-0.5、縮小率に合わせて参照範囲を広げる)
+};
+
+static const ENC_OPTION_STR VIDEO_RESIZE_ALGO[] = {
+    { NULL, AUO_CONF_RESIZE_NONE,     L"縮小しない"     },
+    { NULL, AUO_CONF_RESIZE_BOX,      L"面積平均"       },
+    { NULL, AUO_CONF_RESIZE_BILINEAR, L"バイリニア"     },
+    { NULL, AUO_CONF_RESIZE_BICUBIC,  L"バイキュービック" },
+    { NULL, AUO_MES_UNKNOWN,          NULL             },
+};
+
 static const ENC_OPTION_STR AUDIO_DELAY_CUT_MODE[] = {
     { NULL, AUO_CONF_AUDIO_DELAY_NONE,      L"補正なし"   },
     { NULL, AUO_CONF_AUDIO_DELAY_CUT_AUDIO, L"音声カット" },
@@ -145,6 +167,9 @@ typedef struct CONF_VIDEO {
     char   cmdex[CMDEX_MAX_LEN];       //追加コマンドライン
     char   outext[MAX_APPENDIX_LEN];   //出力拡張子
     char   incmd[256];                 //入力オプション
+    int    resize_algo;                //パイプに渡す前に縮小する場合のアルゴリズム (VIDEO_RESIZE_xxx)
+    int    resize_w;                   //縮小後の幅 (0なら高さから縦横比を維持して決める)
+    int    resize_h;                   //縮小後の高さ (0なら幅から縦横比を維持して決める)
     //int    __yc48_colormatrix_conv;  //YC48の色変換 (使用されていません)
     //DWORD  amp_check;                //自動マルチパス時のチェックの種類(AMPLIMIT_FILE_SIZE/AMPLIMIT_BITRATE)
     //double amp_limit_file_size;      //自動マルチパス時のファイルサイズ制限(MB)
@@ -161,7 +186,7 @@ typedef struct {
     int  priority;            //音声エンコーダのCPU優先度(インデックス)
     BOOL minimized;           //音声エンコーダを最小化で実行
     int  aud_temp_dir;        //音声専用一時フォルダ
-    int  audio_encode_timing; //音声を先にエンコード
+    int  audio_encode_timing; //音声の処理順 (AUDIO_ENC_TIMING_xxx)
     int  delay_cut;           //エンコード遅延の削除
 } CONF_AUDIO_BASE; //音声用設定
 
@@ -69,6 +69,18 @@ enum {
     OUT_CSP_YUV444_16,
     OUT_CSP_RGB,
     OUT_CSP_RGBA,
+    OUT_CSP_YUVA420,
+    OUT_CSP_YUVA420_10,
+    OUT_CSP_YUVA420_16,
+    OUT_CSP_YUVA444,
+    OUT_CSP_YUVA444_10,
+    OUT_CSP_YUVA444_16,
+    OUT_CSP_P012,
+    OUT_CSP_YUV444_12,
+    OUT_CSP_P210,
+    OUT_CSP_Y210,
+    OUT_CSP_YUV420_10,
+    OUT_CSP_YUV420_16,
     OUT_CSP_NV16,
 };
 
@@ -87,19 +99,43 @@ static const char * const specify_csp[] = {
     "p010le",
     "yuv444p16le",
     "bgr24",   //OUT_CSP_RGB
-    "bgra"     //OUT_CSP_RGBA
+    "bgra",    //OUT_CSP_RGBA
+    "yuva420p",
+    "yuva420p10le",
+    "yuva420p16le",
+    "yuva444p",
+    "yuva444p10le",
+    "yuva444p16le",
+    "p012le",
+    "yuv444p12le",
+    "p210le",
+    "y210le",
+    "yuv420p10le",
+    "yuv420p16le"
 };
 //文字列を引数にとるオプションの引数リスト
 //OUT_CSP_NV12, OUT_CSP_YUV444, OUT_CSP_RGB に合わせる
 const ENC_OPTION_STR list_output_csp[] = {
-    { "nv12",        AUO_MES_UNKNOWN, L"yuv420" },
-    { "yuyv422",     AUO_MES_UNKNOWN, L"yuv422" },
-    { "yuv444p",     AUO_MES_UNKNOWN, L"yuv444" },
-    { "p010le",      AUO_MES_UNKNOWN, L"yuv420(16bit)" },
-    { "yuv444p16le", AUO_MES_UNKNOWN, L"yuv444(16bit)" },
-    { "bgr24",       AUO_MES_UNKNOWN, L"rgb"  },
-    { "bgra",        AUO_MES_UNKNOWN, L"rgba"  },
-    { NULL,          AUO_MES_UNKNOWN, NULL }
+    { "nv12",         AUO_MES_UNKNOWN, L"yuv420" },
+    { "yuyv422",      AUO_MES_UNKNOWN, L"yuv422" },
+    { "yuv444p",      AUO_MES_UNKNOWN, L"yuv444" },
+    { "p010le",       AUO_MES_UNKNOWN, L"yuv420(16bit)" },
+    { "yuv444p16le",  AUO_MES_UNKNOWN, L"yuv444(16bit)" },
+    { "bgr24",        AUO_MES_UNKNOWN, L"rgb"  },
+    { "bgra",         AUO_MES_UNKNOWN, L"rgba"  },
+    { "yuva420p",     AUO_MES_UNKNOWN, L"yuva420" },
+    { "yuva420p10le", AUO_MES_UNKNOWN, L"yuva420(10bit)" },
+    { "yuva420p16le", AUO_MES_UNKNOWN, L"yuva420(16bit)" },
+    { "yuva444p",     AUO_MES_UNKNOWN, L"yuva444" },
+    { "yuva444p10le", AUO_MES_UNKNOWN, L"yuva444(10bit)" },
+    { "yuva444p16le", AUO_MES_UNKNOWN, L"yuva444(16bit)" },
+    { "p012le",       AUO_MES_UNKNOWN, L"yuv420(12bit)" },
+    { "yuv444p12le",  AUO_MES_UNKNOWN, L"yuv444(12bit)" },
+    { "p210le",       AUO_MES_UNKNOWN, L"yuv422(10bit)" },
+    { "y210le",       AUO_MES_UNKNOWN, L"yuv422 packed(10bit)" },
+    { "yuv420p10le",  AUO_MES_UNKNOWN, L"yuv420 planar(10bit)" },
+    { "yuv420p16le",  AUO_MES_UNKNOWN, L"yuv420 planar(16bit)" },
+    { NULL,           AUO_MES_UNKNOWN, NULL }
 };
 
 static bool csp_highbit_depth(int output_csp) {
@@ -108,6 +144,11 @@ static bool csp_highbit_depth(int output_csp) {
         true, true,
         false,
         false,
+        false, true, true,
+        false, true, true,
+        true, true,
+        true, true,
+        true, true,
         false /*dummy*/
     };
     static_assert(_countof(list) == _countof(list_output_csp), "list size does not match.");
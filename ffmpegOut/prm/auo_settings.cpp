@@ -41,6 +41,7 @@
 #include "auo_util.h"
 #include "auo_settings.h"
 #include "auo_version.h"
+#include "rgy_ini.h"
 
 static const int INI_SECTION_BUFSIZE = 32768;
 static const int INI_KEY_MAX_LEN = 256;
@@ -66,11 +67,60 @@ static const char * const INI_SECTION_MODE         = "MODE_";
 static const char * const INI_SECTION_FBC          = "BITRATE_CALC";
 static const char * const INI_SECTION_AMP          = "AUTO_MULTI_PASS";
 
+//----    iniファイルのキャッシュ    -------------------------------------------
+
+//ini(読み込み用)とconf(読み書き用)は一度だけ読み込んで、以降はメモリ上で検索する
+//confへの書き込みはメモリ上で行い、save_*の最後にまとめて書き戻す
+//書き戻す際はconfを読み込みなおして変更したキーのみを反映するので、複数のプロセスから保存しても互いの変更は消えない
+static RGYIniFile g_ini_cache;
+static RGYIniFile g_cnf_cache;
+
+static RGYIniFile *get_ini_cache(const char *ini_file) {
+    if (ini_file == nullptr) {
+        return nullptr;
+    }
+    for (auto cache : { &g_ini_cache, &g_cnf_cache }) {
+        if (cache->isLoaded() && _stricmp(cache->path().c_str(), ini_file) == 0) {
+            return cache;
+        }
+    }
+    return nullptr;
+}
+
+size_t GetPrivateProfileStringIni(const char *section, const char *keyname, const char *defaultString, char *buf, size_t bufSize, const char *ini_file) {
+    if (auto cache = get_ini_cache(ini_file)) {
+        return cache->getString(section, keyname, defaultString, buf, bufSize);
+    }
+    return GetPrivateProfileString(section, keyname, defaultString, buf, (DWORD)bufSize, ini_file);
+}
+
+UINT GetPrivateProfileIntIni(const char *section, const char *keyname, int defaultValue, const char *ini_file) {
+    if (auto cache = get_ini_cache(ini_file)) {
+        return (UINT)cache->getInt(section, keyname, defaultValue);
+    }
+    return GetPrivateProfileInt(section, keyname, defaultValue, ini_file);
+}
+
+size_t GetPrivateProfileSectionIni(const char *section, char *buf, size_t bufSize, const char *ini_file) {
+    if (auto cache = get_ini_cache(ini_file)) {
+        return cache->getSection(section, buf, bufSize);
+    }
+    return GetPrivateProfileSection(section, buf, (DWORD)bufSize, ini_file);
+}
+
+BOOL WritePrivateProfileStringIni(const char *section, const char *keyname, const char *value, const char *ini_file) {
+    if (auto cache = get_ini_cache(ini_file)) {
+        cache->setString(section, keyname, value);
+        return TRUE;
+    }
+    return WritePrivateProfileString(section, keyname, value, ini_file);
+}
+
 static inline double GetPrivateProfileDouble(const char *section, const char *keyname, double defaultValue, const char *ini_file) {
     char buf[INI_KEY_MAX_LEN], str_default[64], *eptr;
     double d;
     sprintf_s(str_default, _countof(str_default), "%f", defaultValue);
-    GetPrivateProfileString(section, keyname, str_default, buf, _countof(buf), ini_file);
+    GetPrivateProfileStringIni(section, keyname, str_default, buf, _countof(buf), ini_file);
     d = strtod(buf, &eptr);
     if (*eptr == '\0') return d;
     return defaultValue;
@@ -83,17 +133,17 @@ static inline void GetFontInfo(const char *section, const char *keyname_base, AU
     char key[INI_KEY_MAX_LEN];
     memcpy(key, keyname_base, sizeof(key[0]) * (keyname_base_len + 1));
     strcpy_s(key + keyname_base_len, _countof(key) - keyname_base_len, "_name");
-    GetPrivateProfileString(section, key, "", font_info->name, sizeof(font_info->name), ini_file);
+    GetPrivateProfileStringIni(section, key, "", font_info->name, sizeof(font_info->name), ini_file);
     strcpy_s(key + keyname_base_len, _countof(key) - keyname_base_len, "_size");
     font_info->size = GetPrivateProfileDouble(section, key, 0.0, ini_file);
     strcpy_s(key + keyname_base_len, _countof(key) - keyname_base_len, "_style");
-    font_info->style = GetPrivateProfileInt(section, key, 0, ini_file);
+    font_info->style = GetPrivateProfileIntIni(section, key, 0, ini_file);
 }
 
 static inline void GetColorInfo(const char *section, const char *keyname, int *color_rgb, const int *default_color_rgb, const char *ini_file) {
     char buf[INI_KEY_MAX_LEN], str_default[64];
     sprintf_s(str_default, _countof(str_default), "%d,%d,%d", default_color_rgb[0], default_color_rgb[1], default_color_rgb[2]);
-    GetPrivateProfileString(section, keyname, str_default, buf, _countof(buf), ini_file);
+    GetPrivateProfileStringIni(section, keyname, str_default, buf, _countof(buf), ini_file);
     if (3 != sscanf_s(buf, "%d,%d,%d", &color_rgb[0], &color_rgb[1], &color_rgb[2]))
         memcpy(color_rgb, default_color_rgb, sizeof(color_rgb[0]) * 3);
     for (int i = 0; i < 3; i++)
@@ -103,18 +153,18 @@ static inline void GetColorInfo(const char *section, const char *keyname, int *c
 static inline void WritePrivateProfileInt(const char *section, const char *keyname, int value, const char *ini_file) {
     char tmp[22];
     sprintf_s(tmp, _countof(tmp), "%d", value);
-    WritePrivateProfileString(section, keyname, tmp, ini_file);
+    WritePrivateProfileStringIni(section, keyname, tmp, ini_file);
 }
 
 static inline void WritePrivateProfileIntWithDefault(const char *section, const char *keyname, int value, int _default, const char *ini_file) {
-    if (value != (int)GetPrivateProfileInt(section, keyname, _default, ini_file))
+    if (value != (int)GetPrivateProfileIntIni(section, keyname, _default, ini_file))
         WritePrivateProfileInt(section, keyname, value, ini_file);
 }
 
 static inline void WritePrivateProfileDouble(const char *section, const char *keyname, double value, const char *ini_file) {
     char tmp[32];
     sprintf_s(tmp, _countof(tmp), "%lf", value);
-    WritePrivateProfileString(section, keyname, tmp, ini_file);
+    WritePrivateProfileStringIni(section, keyname, tmp, ini_file);
 }
 
 static inline void WritePrivateProfileDoubleWithDefault(const char *section, const char *keyname, double value, double _default, const char *ini_file) {
@@ -134,7 +184,7 @@ static inline void WriteFontInfo(const char *section, const char *keyname_base,
     memcpy(key, keyname_base, sizeof(key[0]) * (keyname_base_len + 1));
     if (str_has_char(font_info->name)) {
         strcpy_s(key + keyname_base_len, _countof(key) - keyname_base_len, "_name");
-        WritePrivateProfileString(section, key, font_info->name, ini_file);
+        WritePrivateProfileStringIni(section, key, font_info->name, ini_file);
     }
     if (font_info->size > 0.0 || font_info->size != current_info.size) {
         strcpy_s(key + keyname_base_len, _countof(key) - keyname_base_len, "_size");
@@ -152,7 +202,7 @@ static inline void WriteColorInfo(const char *section, const char *keyname, int
     if (0 != memcmp(color_rgb, current_color, sizeof(color_rgb[0]) * 3)) {
         char buf[256];
         sprintf_s(buf, _countof(buf), "%d,%d,%d", color_rgb[0], color_rgb[1], color_rgb[2]);
-        WritePrivateProfileString(section, keyname, buf, ini_file);
+        WritePrivateProfileStringIni(section, keyname, buf, ini_file);
     }
 }
 
@@ -252,9 +302,11 @@ void guiEx_settings::initialize(BOOL disable_loading, const char *_auo_path, con
         if (!language_ini_selected) {
             apply_appendix(ini_fileName, _countof(ini_fileName), auo_path, INI_APPENDIX);
         }
+        g_ini_cache.load(ini_fileName);
         init = check_inifile() && !disable_loading;
-        GetPrivateProfileString(ini_section_main, "blog_url", "", blog_url, _countof(blog_url), ini_fileName);
+        GetPrivateProfileStringIni(ini_section_main, "blog_url", "", blog_url, _countof(blog_url), ini_fileName);
         convert_conf_if_necessary();
+        g_cnf_cache.load(conf_fileName);
         if (init) {
             load_encode_stg();
             load_fn_replace();
@@ -280,7 +332,7 @@ void guiEx_settings::clear_all() {
 }
 
 BOOL guiEx_settings::check_inifile() {
-    ini_ver = GetPrivateProfileInt(ini_section_main, "ini_ver", 0, ini_fileName);
+    ini_ver = GetPrivateProfileIntIni(ini_section_main, "ini_ver", 0, ini_fileName);
     BOOL ret = (ini_ver >= INI_VER_MIN);
     if (ret && !GetFileSizeDWORD(ini_fileName, &ini_filesize))
         ret = FALSE;
@@ -388,18 +440,19 @@ void guiEx_settings::load_encode_stg() {
 }
 
 void guiEx_settings::load_lang() {
-    GetPrivateProfileString(ini_section_main, "language", default_lang, language, _countof(language), conf_fileName);
+    GetPrivateProfileStringIni(ini_section_main, "language", default_lang, language, _countof(language), conf_fileName);
 }
 
 void guiEx_settings::load_last_out_stg() {
-    GetPrivateProfileString(ini_section_main, "last_out_stg", "", last_out_stg, _countof(last_out_stg), conf_fileName);
+    g_cnf_cache.reloadIfModified();
+    GetPrivateProfileStringIni(ini_section_main, "last_out_stg", "", last_out_stg, _countof(last_out_stg), conf_fileName);
 }
 
 void guiEx_settings::load_aud() {
     clear_aud();
 
-    s_aud_ext_count = GetPrivateProfileInt(INI_SECTION_AUD,          "count", 0, ini_fileName);
-    s_aud_int_count = GetPrivateProfileInt(INI_SECTION_AUD_INTERNAL, "count", 0, ini_fileName);
+    s_aud_ext_count = GetPrivateProfileIntIni(INI_SECTION_AUD,          "count", 0, ini_fileName);
+    s_aud_int_count = GetPrivateProfileIntIni(INI_SECTION_AUD_INTERNAL, "count", 0, ini_fileName);
     s_aud_mc.init(ini_filesize + (s_aud_ext_count + s_aud_int_count) * (sizeof(AUDIO_SETTINGS) + 1024));
     load_aud(TRUE);
     load_aud(FALSE);
@@ -428,13 +481,13 @@ void guiEx_settings::load_aud(BOOL internal) {
         s_aud[i].cmd_help     = s_aud_mc.SetPrivateProfileString(encoder_section, "help_cmd",     "", ini_fileName, codepage_ini);
         s_aud[i].cmd_ver      = s_aud_mc.SetPrivateProfileString(encoder_section, "ver_cmd",      "", ini_fileName, codepage_ini);
         s_aud[i].cmd_raw      = s_aud_mc.SetPrivateProfileString(encoder_section, "raw_cmd",      "", ini_fileName, codepage_ini);
-        s_aud[i].pipe_input   = GetPrivateProfileInt(            encoder_section, "pipe_input",    0, ini_fileName);
-        s_aud[i].disable_log  = GetPrivateProfileInt(            encoder_section, "disable_log",   0, ini_fileName);
-        s_aud[i].unsupported_mp4  = GetPrivateProfileInt(    encoder_section, "unsupported_mp4",   0, ini_fileName);
-        s_aud[i].enable_rf64      = GetPrivateProfileInt(    encoder_section, "enable_rf64",       0, ini_fileName);
+        s_aud[i].pipe_input   = GetPrivateProfileIntIni(         encoder_section, "pipe_input",    0, ini_fileName);
+        s_aud[i].disable_log  = GetPrivateProfileIntIni(         encoder_section, "disable_log",   0, ini_fileName);
+        s_aud[i].unsupported_mp4  = GetPrivateProfileIntIni( encoder_section, "unsupported_mp4",   0, ini_fileName);
+        s_aud[i].enable_rf64      = GetPrivateProfileIntIni( encoder_section, "enable_rf64",       0, ini_fileName);
 
         sprintf_s(encoder_section, sizeof(encoder_section), "%s%s", INI_SECTION_MODE, s_aud[i].keyName);
-        int tmp_count = GetPrivateProfileInt(encoder_section, "count", 0, ini_fileName);
+        int tmp_count = GetPrivateProfileIntIni(encoder_section, "count", 0, ini_fileName);
         //置き換えリストの影響で、この段階ではAUDIO_ENC_MODEが最終的に幾つになるのかわからない
         //とりあえず、一時的に読み込んでみる
         s_aud[i].mode_count = tmp_count;
@@ -446,24 +499,24 @@ void guiEx_settings::load_aud(BOOL internal) {
             strcpy_s(key + keybase_len, _countof(key) - keybase_len, "_cmd");
             tmp_mode[j].cmd = s_aud_mc.SetPrivateProfileString(encoder_section, key, "", ini_fileName, codepage_ini);
             strcpy_s(key + keybase_len, _countof(key) - keybase_len, "_2pass");
-            tmp_mode[j].enc_2pass = GetPrivateProfileInt(encoder_section, key, 0, ini_fileName);
+            tmp_mode[j].enc_2pass = GetPrivateProfileIntIni(encoder_section, key, 0, ini_fileName);
             strcpy_s(key + keybase_len, _countof(key) - keybase_len, "_convert8bit");
-            tmp_mode[j].use_8bit = GetPrivateProfileInt(encoder_section, key, 0, ini_fileName);
+            tmp_mode[j].use_8bit = GetPrivateProfileIntIni(encoder_section, key, 0, ini_fileName);
             strcpy_s(key + keybase_len, _countof(key) - keybase_len, "_use_remuxer");
-            tmp_mode[j].use_remuxer = GetPrivateProfileInt(encoder_section, key, 0, ini_fileName);
+            tmp_mode[j].use_remuxer = GetPrivateProfileIntIni(encoder_section, key, 0, ini_fileName);
             strcpy_s(key + keybase_len, _countof(key) - keybase_len, "_delay");
-            tmp_mode[j].delay = GetPrivateProfileInt(encoder_section, key, 0, ini_fileName);
+            tmp_mode[j].delay = GetPrivateProfileIntIni(encoder_section, key, 0, ini_fileName);
             strcpy_s(key + keybase_len, _countof(key) - keybase_len, "_bitrate");
-            tmp_mode[j].bitrate = GetPrivateProfileInt(encoder_section, key, 0, ini_fileName);
+            tmp_mode[j].bitrate = GetPrivateProfileIntIni(encoder_section, key, 0, ini_fileName);
             if (tmp_mode[j].bitrate) {
                 strcpy_s(key + keybase_len, _countof(key) - keybase_len, "_bitrate_min");
-                tmp_mode[j].bitrate_min = GetPrivateProfileInt(encoder_section, key, 0, ini_fileName);
+                tmp_mode[j].bitrate_min = GetPrivateProfileIntIni(encoder_section, key, 0, ini_fileName);
                 strcpy_s(key + keybase_len, _countof(key) - keybase_len, "_bitrate_max");
-                tmp_mode[j].bitrate_max = GetPrivateProfileInt(encoder_section, key, 0, ini_fileName);
+                tmp_mode[j].bitrate_max = GetPrivateProfileIntIni(encoder_section, key, 0, ini_fileName);
                 strcpy_s(key + keybase_len, _countof(key) - keybase_len, "_bitrate_step");
-                tmp_mode[j].bitrate_step = GetPrivateProfileInt(encoder_section, key, 0, ini_fileName);
+                tmp_mode[j].bitrate_step = GetPrivateProfileIntIni(encoder_section, key, 0, ini_fileName);
                 strcpy_s(key + keybase_len, _countof(key) - keybase_len, "_bitrate_default");
-                tmp_mode[j].bitrate_default = GetPrivateProfileInt(encoder_section, key, 0, ini_fileName);
+                tmp_mode[j].bitrate_default = GetPrivateProfileIntIni(encoder_section, key, 0, ini_fileName);
             } else {
                 strcpy_s(key + keybase_len, _countof(key) - keybase_len, "_dispList");
                 tmp_mode[j].disp_list = s_aud_mc.SetPrivateProfileWString(encoder_section, key, "", ini_fileName, codepage_ini);
@@ -560,10 +613,10 @@ void guiEx_settings::load_mux() {
         s_mux[i].tmp_cmd   = s_mux_mc.SetPrivateProfileString(muxer_section, "tmp_cmd",   "", ini_fileName, codepage_ini);
         s_mux[i].help_cmd  = s_mux_mc.SetPrivateProfileString(muxer_section, "help_cmd",  "", ini_fileName, codepage_ini);
         s_mux[i].ver_cmd   = s_mux_mc.SetPrivateProfileString(muxer_section, "ver_cmd",   "", ini_fileName, codepage_ini);
-        s_mux[i].post_mux  = GetPrivateProfileInt(muxer_section, "post_mux", MUXER_DISABLED,  ini_fileName);
+        s_mux[i].post_mux  = GetPrivateProfileIntIni(muxer_section, "post_mux", MUXER_DISABLED,  ini_fileName);
 
         sprintf_s(muxer_section, _countof(muxer_section), "%s%s", INI_SECTION_MODE, s_mux[i].keyName);
-        s_mux[i].ex_count = GetPrivateProfileInt(muxer_section, "count", 0, ini_fileName);
+        s_mux[i].ex_count = GetPrivateProfileIntIni(muxer_section, "count", 0, ini_fileName);
         s_mux[i].ex_cmd = (MUXER_CMD_EX *)s_mux_mc.CutMem(s_mux[i].ex_count * sizeof(MUXER_CMD_EX));
         for (j = 0; j < s_mux[i].ex_count; j++) {
             sprintf_s(key, _countof(key), "ex_cmd_%d", j+1);
@@ -613,36 +666,46 @@ void guiEx_settings::load_local() {
     make_default_stg_dir(default_stg_dir, _countof(default_stg_dir));
 
     clear_local();
-
-    //s_local.large_cmdbox              = GetPrivateProfileInt(   ini_section_main, "large_cmdbox",             DEFAULT_LARGE_CMD_BOX,         conf_fileName);
-    s_local.auto_afs_disable          = GetPrivateProfileInt(   ini_section_main, "auto_afs_disable",         DEFAULT_AUTO_AFS_DISABLE,      conf_fileName);
-    //s_local.default_output_ext        = GetPrivateProfileInt(   ini_section_main, "default_output_ext",        DEFAULT_OUTPUT_EXT,            conf_fileName);
-    //s_local.auto_del_stats            = GetPrivateProfileInt(   ini_section_main, "auto_del_stats",            DEFAULT_AUTO_DEL_STATS,        conf_fileName);
-    //s_local.auto_del_chap             = GetPrivateProfileInt(   ini_section_main, "auto_del_chap",             DEFAULT_AUTO_DEL_CHAP,         conf_fileName);
-    s_local.keep_qp_file              = GetPrivateProfileInt(   ini_section_main, "keep_qp_file",             DEFAULT_KEEP_QP_FILE,          conf_fileName);
-    s_local.disable_tooltip_help      = GetPrivateProfileInt(   ini_section_main, "disable_tooltip_help",     DEFAULT_DISABLE_TOOLTIP_HELP,  conf_fileName);
-    s_local.disable_visual_styles     = GetPrivateProfileInt(   ini_section_main, "disable_visual_styles",    DEFAULT_DISABLE_VISUAL_STYLES, conf_fileName);
-    s_local.enable_stg_esc_key        = GetPrivateProfileInt(   ini_section_main, "enable_stg_esc_key",       DEFAULT_ENABLE_STG_ESC_KEY,    conf_fileName);
-    //s_local.chap_nero_convert_to_utf8 = GetPrivateProfileInt(   ini_section_main, "chap_nero_convert_to_utf8", DEFAULT_CHAP_NERO_TO_UTF8,     conf_fileName);
-    s_local.get_relative_path         = GetPrivateProfileInt(   ini_section_main, "get_relative_path",        DEFAULT_SAVE_RELATIVE_PATH,    conf_fileName);
-    s_local.run_bat_minimized         = GetPrivateProfileInt(   ini_section_main, "run_bat_minimized",        DEFAULT_RUN_BAT_MINIMIZED,     conf_fileName);
-    //s_local.set_keyframe_as_afs_24fps = GetPrivateProfileInt(   ini_section_main, "set_keyframe_as_afs_24fps", DEFAULT_SET_KEYFRAME_AFS24FPS, conf_fileName);
-    //s_local.auto_ref_limit_by_level   = GetPrivateProfileInt(   ini_section_main, "auto_ref_limit_by_level",   DEFAULT_AUTO_REFLIMIT_BYLEVEL, conf_fileName);
-    s_local.default_audio_encoder_ext = GetPrivateProfileInt(   ini_section_main, "default_audio_encoder",     DEFAULT_AUDIO_ENCODER_EXT,    conf_fileName);
-    s_local.default_audio_encoder_in  = GetPrivateProfileInt(   ini_section_main, "default_audio_encoder_in",  DEFAULT_AUDIO_ENCODER_IN,     conf_fileName);
-    s_local.default_audenc_use_in     = GetPrivateProfileInt(   ini_section_main, "default_audenc_use_in",     DEFAULT_AUDIO_ENCODER_USE_IN,  conf_fileName);
-    s_local.av_length_threshold       = GetPrivateProfileDouble(ini_section_main, "av_length_threshold",       DEFAULT_AV_LENGTH_DIFF_THRESOLD, conf_fileName);
-    s_local.thread_pthrottling_mode   = GetPrivateProfileInt(   ini_section_main, "thread_pthrottling_mode",   DEFAULT_THREAD_PTHROTTLING,    conf_fileName);
-
-    //s_local.amp_retry_limit           = GetPrivateProfileInt(   INI_SECTION_AMP,  "amp_retry_limit",          DEFAULT_AMP_RETRY_LIMIT,       conf_fileName);
+    g_cnf_cache.reloadIfModified();
+
+    //s_local.large_cmdbox              = GetPrivateProfileIntIni(ini_section_main, "large_cmdbox",             DEFAULT_LARGE_CMD_BOX,         conf_fileName);
+    s_local.auto_afs_disable          = GetPrivateProfileIntIni(ini_section_main, "auto_afs_disable",         DEFAULT_AUTO_AFS_DISABLE,      conf_fileName);
+    //s_local.default_output_ext        = GetPrivateProfileIntIni(ini_section_main, "default_output_ext",        DEFAULT_OUTPUT_EXT,            conf_fileName);
+    //s_local.auto_del_stats            = GetPrivateProfileIntIni(ini_section_main, "auto_del_stats",            DEFAULT_AUTO_DEL_STATS,        conf_fileName);
+    //s_local.auto_del_chap             = GetPrivateProfileIntIni(ini_section_main, "auto_del_chap",             DEFAULT_AUTO_DEL_CHAP,         conf_fileName);
+    s_local.keep_qp_file              = GetPrivateProfileIntIni(ini_section_main, "keep_qp_file",             DEFAULT_KEEP_QP_FILE,          conf_fileName);
+    s_local.disable_tooltip_help      = GetPrivateProfileIntIni(ini_section_main, "disable_tooltip_help",     DEFAULT_DISABLE_TOOLTIP_HELP,  conf_fileName);
+    s_local.disable_visual_styles     = GetPrivateProfileIntIni(ini_section_main, "disable_visual_styles",    DEFAULT_DISABLE_VISUAL_STYLES, conf_fileName);
+    s_local.enable_stg_esc_key        = GetPrivateProfileIntIni(ini_section_main, "enable_stg_esc_key",       DEFAULT_ENABLE_STG_ESC_KEY,    conf_fileName);
+    //s_local.chap_nero_convert_to_utf8 = GetPrivateProfileIntIni(ini_section_main, "chap_nero_convert_to_utf8", DEFAULT_CHAP_NERO_TO_UTF8,     conf_fileName);
+    s_local.get_relative_path         = GetPrivateProfileIntIni(ini_section_main, "get_relative_path",        DEFAULT_SAVE_RELATIVE_PATH,    conf_fileName);
+    s_local.run_bat_minimized         = GetPrivateProfileIntIni(ini_section_main, "run_bat_minimized",        DEFAULT_RUN_BAT_MINIMIZED,     conf_fileName);
+    //s_local.set_keyframe_as_afs_24fps = GetPrivateProfileIntIni(ini_section_main, "set_keyframe_as_afs_24fps", DEFAULT_SET_KEYFRAME_AFS24FPS, conf_fileName);
+    //s_local.auto_ref_limit_by_level   = GetPrivateProfileIntIni(ini_section_main, "auto_ref_limit_by_level",   DEFAULT_AUTO_REFLIMIT_BYLEVEL, conf_fileName);
+    s_local.default_audio_encoder_ext = GetPrivateProfileIntIni(ini_section_main, "default_audio_encoder",     DEFAULT_AUDIO_ENCODER_EXT,    conf_fileName);
+    s_local.default_audio_encoder_in  = GetPrivateProfileIntIni(ini_section_main, "default_audio_encoder_in",  DEFAULT_AUDIO_ENCODER_IN,     conf_fileName);
+    s_local.default_audenc_use_in     = GetPrivateProfileIntIni(ini_section_main, "default_audenc_use_in",     DEFAULT_AUDIO_ENCODER_USE_IN,  conf_fileName);
+    s_local.av_length_threshold       = GetPrivateProfileDouble(   ini_section_main, "av_length_threshold",       DEFAULT_AV_LENGTH_DIFF_THRESOLD, conf_fileName);
+    s_local.thread_pthrottling_mode   = GetPrivateProfileIntIni(ini_section_main, "thread_pthrottling_mode",   DEFAULT_THREAD_PTHROTTLING,    conf_fileName);
+    s_local.audio_stream_to_videnc    = GetPrivateProfileIntIni(ini_section_main, "audio_stream_to_videnc",    DEFAULT_AUDIO_STREAM_TO_VIDENC, conf_fileName);
+    s_local.deferred_encode           = GetPrivateProfileIntIni(ini_section_main, "deferred_encode",           DEFAULT_DEFERRED_ENCODE,       conf_fileName);
+    s_local.tmp_dir_same_volume       = GetPrivateProfileIntIni(ini_section_main, "tmp_dir_same_volume",       DEFAULT_TMP_DIR_SAME_VOLUME,   conf_fileName);
+    s_local.output_dither             = GetPrivateProfileIntIni(ini_section_main, "output_dither",             DEFAULT_OUTPUT_DITHER,         conf_fileName);
+    s_local.rgba_unpremultiply        = GetPrivateProfileIntIni(ini_section_main, "rgba_unpremultiply",        DEFAULT_RGBA_UNPREMULTIPLY,    conf_fileName);
+
+    //s_local.amp_retry_limit           = GetPrivateProfileIntIni(INI_SECTION_AMP,  "amp_retry_limit",          DEFAULT_AMP_RETRY_LIMIT,       conf_fileName);
     //s_local.amp_bitrate_margin_multi  = GetPrivateProfileDouble(INI_SECTION_AMP,  "amp_bitrate_margin_multi", DEFAULT_AMP_MARGIN,            conf_fileName);
-    //s_local.amp_keep_old_file         = GetPrivateProfileInt(   INI_SECTION_AMP,  "amp_keep_old_file",        DEFAULT_AMP_KEEP_OLD_FILE,     conf_fileName);
+    //s_local.amp_keep_old_file         = GetPrivateProfileIntIni(INI_SECTION_AMP,  "amp_keep_old_file",        DEFAULT_AMP_KEEP_OLD_FILE,     conf_fileName);
     //s_local.amp_bitrate_margin_multi  = clamp(s_local.amp_bitrate_margin_multi, 0.0, 1.0);
     
     GetFontInfo(ini_section_main, "conf_font", &s_local.conf_font, conf_fileName);
 
-    GetPrivateProfileString(ini_section_main, "ffmpeg_filname",      "", s_local.ffmpeg_filname,      _countof(s_local.ffmpeg_filname),      ini_fileName);
-    GetPrivateProfileString(ini_section_main, "ffmpeg_help_cmd",     "", s_local.ffmpeg_help_cmd,     _countof(s_local.ffmpeg_help_cmd),     ini_fileName);
+    GetPrivateProfileStringIni(ini_section_main, "ffmpeg_filname",      "", s_local.ffmpeg_filname,      _countof(s_local.ffmpeg_filname),      ini_fileName);
+    GetPrivateProfileStringIni(ini_section_main, "ffmpeg_help_cmd",     "", s_local.ffmpeg_help_cmd,     _countof(s_local.ffmpeg_help_cmd),     ini_fileName);
+    GetPrivateProfileStringIni(ini_section_main, "deferred_intermediate_cmd", DEFAULT_DEFERRED_INTERMEDIATE_CMD, s_local.deferred_intermediate_cmd, _countof(s_local.deferred_intermediate_cmd), ini_fileName);
+    for (int i = 0; i < THREAD_PLACEMENT_COUNT; i++)
+        GetPrivateProfileStringIni(ini_section_main, THREAD_PLACEMENT_INI_KEY[i], DEFAULT_THREAD_PLACEMENT, s_local.thread_placement[i], _countof(s_local.thread_placement[i]), ini_fileName);
+    GetPrivateProfileStringIni(ini_section_main, "simd_limit", DEFAULT_SIMD_LIMIT, s_local.simd_limit, _countof(s_local.simd_limit), ini_fileName);
 
     GetPrivateProfileStringStg(ini_section_main, "ffmpeg_path",           "", s_local.ffmpeg_path,           _countof(s_local.ffmpeg_path),           conf_fileName, codepage_cnf);
     GetPrivateProfileStringStg(ini_section_main, "custom_tmp_dir",        "", s_local.custom_tmp_dir,        _countof(s_local.custom_tmp_dir),        conf_fileName, codepage_cnf);
@@ -656,7 +719,7 @@ void guiEx_settings::load_local() {
     if (!str_has_char(s_local.stg_dir) || !PathRootExists(s_local.stg_dir))
         strcpy_s(s_local.stg_dir, _countof(s_local.stg_dir), default_stg_dir);
 
-    s_local.audio_buffer_size   = std::min((decltype(s_local.audio_buffer_size))GetPrivateProfileInt(ini_section_main, "audio_buffer",        AUDIO_BUFFER_DEFAULT, conf_fileName), AUDIO_BUFFER_MAX);
+    s_local.audio_buffer_size   = std::min((decltype(s_local.audio_buffer_size))GetPrivateProfileIntIni(ini_section_main, "audio_buffer",        AUDIO_BUFFER_DEFAULT, conf_fileName), AUDIO_BUFFER_MAX);
 
     for (int i = 0; i < s_aud_ext_count; i++)
         GetPrivateProfileStringStg(INI_SECTION_AUD, s_aud_ext[i].keyName, "", s_aud_ext[i].fullpath, _countof(s_aud_ext[i].fullpath), conf_fileName, codepage_cnf);
@@ -666,20 +729,21 @@ void guiEx_settings::load_local() {
 
 void guiEx_settings::load_log_win() {
     clear_log_win();
-    s_log.minimized          = GetPrivateProfileInt(   ini_section_main, "log_start_minimized",  DEFAULT_LOG_START_MINIMIZED,  conf_fileName);
-    s_log.log_level          = GetPrivateProfileInt(   ini_section_main, "log_level",            DEFAULT_LOG_LEVEL,            conf_fileName);
-    s_log.transparent        = GetPrivateProfileInt(   ini_section_main, "log_transparent",      DEFAULT_LOG_TRANSPARENT,      conf_fileName);
-    s_log.transparency       = GetPrivateProfileInt(   ini_section_main, "log_transparency",     DEFAULT_LOG_TRANSPARENCY,     conf_fileName);
-    s_log.auto_save_log      = GetPrivateProfileInt(   ini_section_main, "log_auto_save",        DEFAULT_LOG_AUTO_SAVE,        conf_fileName);
-    s_log.auto_save_log_mode = GetPrivateProfileInt(   ini_section_main, "log_auto_save_mode",   DEFAULT_LOG_AUTO_SAVE_MODE,   conf_fileName);
+    g_cnf_cache.reloadIfModified();
+    s_log.minimized          = GetPrivateProfileIntIni(ini_section_main, "log_start_minimized",  DEFAULT_LOG_START_MINIMIZED,  conf_fileName);
+    s_log.log_level          = GetPrivateProfileIntIni(ini_section_main, "log_level",            DEFAULT_LOG_LEVEL,            conf_fileName);
+    s_log.transparent        = GetPrivateProfileIntIni(ini_section_main, "log_transparent",      DEFAULT_LOG_TRANSPARENT,      conf_fileName);
+    s_log.transparency       = GetPrivateProfileIntIni(ini_section_main, "log_transparency",     DEFAULT_LOG_TRANSPARENCY,     conf_fileName);
+    s_log.auto_save_log      = GetPrivateProfileIntIni(ini_section_main, "log_auto_save",        DEFAULT_LOG_AUTO_SAVE,        conf_fileName);
+    s_log.auto_save_log_mode = GetPrivateProfileIntIni(ini_section_main, "log_auto_save_mode",   DEFAULT_LOG_AUTO_SAVE_MODE,   conf_fileName);
     GetPrivateProfileStringStg(ini_section_main, "log_auto_save_path", "", s_log.auto_save_log_path, _countof(s_log.auto_save_log_path), conf_fileName, codepage_cnf);
-    s_log.show_status_bar    = GetPrivateProfileInt(   ini_section_main, "log_show_status_bar",  DEFAULT_LOG_SHOW_STATUS_BAR,  conf_fileName);
-    s_log.taskbar_progress   = GetPrivateProfileInt(   ini_section_main, "log_taskbar_progress", DEFAULT_LOG_TASKBAR_PROGRESS, conf_fileName);
-    s_log.save_log_size      = GetPrivateProfileInt(   ini_section_main, "save_log_size",        DEFAULT_LOG_SAVE_SIZE,        conf_fileName);
-    s_log.log_width          = GetPrivateProfileInt(   ini_section_main, "log_width",            DEFAULT_LOG_WIDTH,            conf_fileName);
-    s_log.log_height         = GetPrivateProfileInt(   ini_section_main, "log_height",           DEFAULT_LOG_HEIGHT,           conf_fileName);
-    s_log.log_pos[0]         = GetPrivateProfileInt(   ini_section_main, "log_pos_x",            DEFAULT_LOG_POS[0],           conf_fileName);
-    s_log.log_pos[1]         = GetPrivateProfileInt(   ini_section_main, "log_pos_y",            DEFAULT_LOG_POS[1],           conf_fileName);
+    s_log.show_status_bar    = GetPrivateProfileIntIni(ini_section_main, "log_show_status_bar",  DEFAULT_LOG_SHOW_STATUS_BAR,  conf_fileName);
+    s_log.taskbar_progress   = GetPrivateProfileIntIni(ini_section_main, "log_taskbar_progress", DEFAULT_LOG_TASKBAR_PROGRESS, conf_fileName);
+    s_log.save_log_size      = GetPrivateProfileIntIni(ini_section_main, "save_log_size",        DEFAULT_LOG_SAVE_SIZE,        conf_fileName);
+    s_log.log_width          = GetPrivateProfileIntIni(ini_section_main, "log_width",            DEFAULT_LOG_WIDTH,            conf_fileName);
+    s_log.log_height         = GetPrivateProfileIntIni(ini_section_main, "log_height",           DEFAULT_LOG_HEIGHT,           conf_fileName);
+    s_log.log_pos[0]         = GetPrivateProfileIntIni(ini_section_main, "log_pos_x",            DEFAULT_LOG_POS[0],           conf_fileName);
+    s_log.log_pos[1]         = GetPrivateProfileIntIni(ini_section_main, "log_pos_y",            DEFAULT_LOG_POS[1],           conf_fileName);
     GetColorInfo(ini_section_main, "log_color_background",   s_log.log_color_background, DEFAULT_LOG_COLOR_BACKGROUND, conf_fileName);
     GetColorInfo(ini_section_main, "log_color_text_info",    s_log.log_color_text[0],    DEFAULT_LOG_COLOR_TEXT[0],    conf_fileName);
     GetColorInfo(ini_section_main, "log_color_text_warning", s_log.log_color_text[1],    DEFAULT_LOG_COLOR_TEXT[1],    conf_fileName);
@@ -698,12 +762,13 @@ void guiEx_settings::load_append() {
 
 void guiEx_settings::load_fbc() {
     clear_fbc();
-    s_fbc.calc_bitrate         = GetPrivateProfileInt(   INI_SECTION_FBC, "calc_bitrate",         DEFAULT_FBC_CALC_BITRATE,         conf_fileName);
-    s_fbc.calc_time_from_frame = GetPrivateProfileInt(   INI_SECTION_FBC, "calc_time_from_frame", DEFAULT_FBC_CALC_TIME_FROM_FRAME, conf_fileName);
-    s_fbc.last_frame_num       = GetPrivateProfileInt(   INI_SECTION_FBC, "last_frame_num",       DEFAULT_FBC_LAST_FRAME_NUM,       conf_fileName);
-    s_fbc.last_fps             = GetPrivateProfileDouble(INI_SECTION_FBC, "last_fps",             DEFAULT_FBC_LAST_FPS,             conf_fileName);
-    s_fbc.last_time_in_sec     = GetPrivateProfileInt(   INI_SECTION_FBC, "last_time_in_sec",     DEFAULT_FBC_LAST_TIME_IN_SEC,     conf_fileName);
-    s_fbc.initial_size         = GetPrivateProfileDouble(INI_SECTION_FBC, "initial_size",         DEFAULT_FBC_INITIAL_SIZE,         conf_fileName);
+    g_cnf_cache.reloadIfModified();
+    s_fbc.calc_bitrate         = GetPrivateProfileIntIni(INI_SECTION_FBC, "calc_bitrate",         DEFAULT_FBC_CALC_BITRATE,         conf_fileName);
+    s_fbc.calc_time_from_frame = GetPrivateProfileIntIni(INI_SECTION_FBC, "calc_time_from_frame", DEFAULT_FBC_CALC_TIME_FROM_FRAME, conf_fileName);
+    s_fbc.last_frame_num       = GetPrivateProfileIntIni(INI_SECTION_FBC, "last_frame_num",       DEFAULT_FBC_LAST_FRAME_NUM,       conf_fileName);
+    s_fbc.last_fps             = GetPrivateProfileDouble(   INI_SECTION_FBC, "last_fps",             DEFAULT_FBC_LAST_FPS,             conf_fileName);
+    s_fbc.last_time_in_sec     = GetPrivateProfileIntIni(INI_SECTION_FBC, "last_time_in_sec",     DEFAULT_FBC_LAST_TIME_IN_SEC,     conf_fileName);
+    s_fbc.initial_size         = GetPrivateProfileDouble(   INI_SECTION_FBC, "initial_size",         DEFAULT_FBC_INITIAL_SIZE,         conf_fileName);
 }
 
 void guiEx_settings::save_local() {
@@ -726,6 +791,11 @@ void guiEx_settings::save_local() {
     WritePrivateProfileIntWithDefault(   ini_section_main, "default_audenc_use_in",     s_local.default_audenc_use_in,     DEFAULT_AUDIO_ENCODER_USE_IN,  conf_fileName);
     WritePrivateProfileDoubleWithDefault(ini_section_main, "av_length_threshold",       s_local.av_length_threshold,       DEFAULT_AV_LENGTH_DIFF_THRESOLD,conf_fileName);
     WritePrivateProfileIntWithDefault(   ini_section_main, "thread_pthrottling_mode",   s_local.thread_pthrottling_mode, DEFAULT_THREAD_PTHROTTLING,      conf_fileName);
+    WritePrivateProfileIntWithDefault(   ini_section_main, "audio_stream_to_videnc",    s_local.audio_stream_to_videnc,  DEFAULT_AUDIO_STREAM_TO_VIDENC,  conf_fileName);
+    WritePrivateProfileIntWithDefault(   ini_section_main, "deferred_encode",           s_local.deferred_encode,         DEFAULT_DEFERRED_ENCODE,         conf_fileName);
+    WritePrivateProfileIntWithDefault(   ini_section_main, "tmp_dir_same_volume",       s_local.tmp_dir_same_volume,     DEFAULT_TMP_DIR_SAME_VOLUME,     conf_fileName);
+    WritePrivateProfileIntWithDefault(   ini_section_main, "output_dither",             s_local.output_dither,           DEFAULT_OUTPUT_DITHER,           conf_fileName);
+    WritePrivateProfileIntWithDefault(   ini_section_main, "rgba_unpremultiply",        s_local.rgba_unpremultiply,      DEFAULT_RGBA_UNPREMULTIPLY,      conf_fileName);
 
     //WritePrivateProfileIntWithDefault(   INI_SECTION_AMP,  "amp_retry_limit",           s_local.amp_retry_limit,          DEFAULT_AMP_RETRY_LIMIT,       conf_fileName);
     //WritePrivateProfileDoubleWithDefault(INI_SECTION_AMP,  "amp_bitrate_margin_multi",  s_local.amp_bitrate_margin_multi, DEFAULT_AMP_MARGIN,            conf_fileName);
@@ -735,40 +805,41 @@ void guiEx_settings::save_local() {
 
     PathRemoveBlanks(s_local.ffmpeg_path);
     PathRemoveBackslash(s_local.ffmpeg_path);
-    WritePrivateProfileString(ini_section_main, "ffmpeg_path",         s_local.ffmpeg_path,         conf_fileName);
+    WritePrivateProfileStringIni(ini_section_main, "ffmpeg_path",         s_local.ffmpeg_path,         conf_fileName);
 
     PathRemoveBlanks(s_local.custom_tmp_dir);
     PathRemoveBackslash(s_local.custom_tmp_dir);
-    WritePrivateProfileString(ini_section_main, "custom_tmp_dir",        s_local.custom_tmp_dir,        conf_fileName);
+    WritePrivateProfileStringIni(ini_section_main, "custom_tmp_dir",        s_local.custom_tmp_dir,        conf_fileName);
 
     PathRemoveBlanks(s_local.custom_audio_tmp_dir);
     PathRemoveBackslash(s_local.custom_audio_tmp_dir);
-    WritePrivateProfileString(ini_section_main, "custom_audio_tmp_dir",  s_local.custom_audio_tmp_dir,  conf_fileName);
+    WritePrivateProfileStringIni(ini_section_main, "custom_audio_tmp_dir",  s_local.custom_audio_tmp_dir,  conf_fileName);
 /*
     PathRemoveBlanks(s_local.custom_mp4box_tmp_dir);
     PathRemoveBackslash(s_local.custom_mp4box_tmp_dir);
-    WritePrivateProfileString(ini_section_main, "custom_mp4box_tmp_dir", s_local.custom_mp4box_tmp_dir, conf_fileName);
+    WritePrivateProfileStringIni(ini_section_main, "custom_mp4box_tmp_dir", s_local.custom_mp4box_tmp_dir, conf_fileName);
 */
     PathRemoveBlanks(s_local.stg_dir);
     PathRemoveBackslash(s_local.stg_dir);
-    WritePrivateProfileString(ini_section_main, "stg_dir",               s_local.stg_dir,               conf_fileName);
+    WritePrivateProfileStringIni(ini_section_main, "stg_dir",               s_local.stg_dir,               conf_fileName);
 
     PathRemoveBlanks(s_local.app_dir);
     PathRemoveBackslash(s_local.app_dir);
-    WritePrivateProfileString(ini_section_main, "last_app_dir",          s_local.app_dir,               conf_fileName);
+    WritePrivateProfileStringIni(ini_section_main, "last_app_dir",          s_local.app_dir,               conf_fileName);
 
     PathRemoveBlanks(s_local.bat_dir);
     PathRemoveBackslash(s_local.bat_dir);
-    WritePrivateProfileString(ini_section_main, "last_bat_dir",          s_local.bat_dir,               conf_fileName);
+    WritePrivateProfileStringIni(ini_section_main, "last_bat_dir",          s_local.bat_dir,               conf_fileName);
 
     for (int i = 0; i < s_aud_ext_count; i++) {
         PathRemoveBlanks(s_aud_ext[i].fullpath);
-        WritePrivateProfileString(INI_SECTION_AUD, s_aud_ext[i].keyName, s_aud_ext[i].fullpath, conf_fileName);
+        WritePrivateProfileStringIni(INI_SECTION_AUD, s_aud_ext[i].keyName, s_aud_ext[i].fullpath, conf_fileName);
     }
     /*for (int i = 0; i < s_mux_count; i++) {
         PathRemoveBlanks(s_mux[i].fullpath);
-        WritePrivateProfileString(INI_SECTION_MUX, s_mux[i].keyName, s_mux[i].fullpath, conf_fileName);
+        WritePrivateProfileStringIni(INI_SECTION_MUX, s_mux[i].keyName, s_mux[i].fullpath, conf_fileName);
     }*/
+    g_cnf_cache.save();
 }
 
 void guiEx_settings::save_log_win() {
@@ -778,7 +849,7 @@ void guiEx_settings::save_log_win() {
     WritePrivateProfileIntWithDefault(   ini_section_main, "log_transparency",      s_log.transparency,       DEFAULT_LOG_TRANSPARENCY,     conf_fileName);
     WritePrivateProfileIntWithDefault(   ini_section_main, "log_auto_save",         s_log.auto_save_log,      DEFAULT_LOG_AUTO_SAVE,        conf_fileName);
     WritePrivateProfileIntWithDefault(   ini_section_main, "log_auto_save_mode",    s_log.auto_save_log_mode, DEFAULT_LOG_AUTO_SAVE_MODE,   conf_fileName);
-    WritePrivateProfileString(           ini_section_main, "log_auto_save_path",    s_log.auto_save_log_path,                               conf_fileName);
+    WritePrivateProfileStringIni(        ini_section_main, "log_auto_save_path",    s_log.auto_save_log_path,                               conf_fileName);
     WritePrivateProfileIntWithDefault(   ini_section_main, "log_show_status_bar",   s_log.show_status_bar,    DEFAULT_LOG_SHOW_STATUS_BAR,  conf_fileName);
     WritePrivateProfileIntWithDefault(   ini_section_main, "log_taskbar_progress",  s_log.taskbar_progress,   DEFAULT_LOG_TASKBAR_PROGRESS, conf_fileName);
     WritePrivateProfileIntWithDefault(   ini_section_main, "save_log_size",         s_log.save_log_size,      DEFAULT_LOG_SAVE_SIZE,        conf_fileName);
@@ -791,6 +862,7 @@ void guiEx_settings::save_log_win() {
     WriteColorInfo(ini_section_main, "log_color_text_warning", s_log.log_color_text[1],    DEFAULT_LOG_COLOR_TEXT[1],    conf_fileName);
     WriteColorInfo(ini_section_main, "log_color_text_error",   s_log.log_color_text[2],    DEFAULT_LOG_COLOR_TEXT[2],    conf_fileName);
     WriteFontInfo(ini_section_main,  "log_font", &s_log.log_font, conf_fileName);
+    g_cnf_cache.save();
 }
 
 void guiEx_settings::save_fbc() {
@@ -800,14 +872,17 @@ void guiEx_settings::save_fbc() {
     WritePrivateProfileDoubleWithDefault(INI_SECTION_FBC, "last_fps",             s_fbc.last_fps,             DEFAULT_FBC_LAST_FPS,             conf_fileName);
     WritePrivateProfileDoubleWithDefault(INI_SECTION_FBC, "last_time_in_sec",     s_fbc.last_time_in_sec,     DEFAULT_FBC_LAST_TIME_IN_SEC,     conf_fileName);
     WritePrivateProfileDoubleWithDefault(INI_SECTION_FBC, "initial_size",         s_fbc.initial_size,         DEFAULT_FBC_INITIAL_SIZE,         conf_fileName);
+    g_cnf_cache.save();
 }
 
 void guiEx_settings::save_lang() {
-    WritePrivateProfileString(ini_section_main, "language", language, conf_fileName);
+    WritePrivateProfileStringIni(ini_section_main, "language", language, conf_fileName);
+    g_cnf_cache.save();
 }
 
 void guiEx_settings::save_last_out_stg() {
-    WritePrivateProfileString(ini_section_main, "last_out_stg", last_out_stg, conf_fileName);
+    WritePrivateProfileStringIni(ini_section_main, "last_out_stg", last_out_stg, conf_fileName);
+    g_cnf_cache.save();
 }
 
 void guiEx_settings::clear_aud() {
@@ -54,6 +54,14 @@ static const BOOL   DEFAULT_AUDIO_ENCODER_EXT     = 0;
 static const BOOL   DEFAULT_AUDIO_ENCODER_IN      = 1;
 static const BOOL   DEFAULT_AUDIO_ENCODER_USE_IN  = 1;
 static const int    DEFAULT_THREAD_PTHROTTLING    = 0;
+static const BOOL   DEFAULT_AUDIO_STREAM_TO_VIDENC = 1;
+static const BOOL   DEFAULT_DEFERRED_ENCODE       = 0;
+static const BOOL   DEFAULT_TMP_DIR_SAME_VOLUME   = 0;
+static const int    DEFAULT_OUTPUT_DITHER         = 0;
+static const int    DEFAULT_RGBA_UNPREMULTIPLY    = 1;
+static const char  *DEFAULT_DEFERRED_INTERMEDIATE_CMD = "-c:v ffv1 -level 3 -g 1 -slices 16 -slicecrc 0";
+static const char  *DEFAULT_THREAD_PLACEMENT      = "auto";
+static const char  *DEFAULT_SIMD_LIMIT            = "auto";
 static const int    DEFAULT_AMP_RETRY_LIMIT       = 2;
 static const double DEFAULT_AMP_MARGIN            = 0.05;
 static const double DEFAULT_AMP_REENC_AUDIO_MULTI = 0.15;
@@ -122,11 +130,31 @@ enum {
     DISABLE_LOG_ALL        = DISABLE_LOG_PIPE_INPUT | DISABLE_LOG_NORMAL,
 };
 
+//スレッド・プロセスの配置の対象
+enum {
+    THREAD_PLACEMENT_FEED = 0, //フレーム取得・変換・書き出し (Aviutlのメインスレッド、書き出しスレッド、afsの先読みスレッド)
+    THREAD_PLACEMENT_VIDENC,   //映像エンコーダ (ffmpeg)
+    THREAD_PLACEMENT_AUDENC,   //外部音声エンコーダ
+    THREAD_PLACEMENT_AUDIO,    //音声の同時処理スレッド
+    THREAD_PLACEMENT_COUNT,
+};
+static const char *const THREAD_PLACEMENT_INI_KEY[THREAD_PLACEMENT_COUNT] = {
+    "thread_affinity_feed", "thread_affinity_videnc", "thread_affinity_audenc", "thread_affinity_audio"
+};
+static const int THREAD_PLACEMENT_STR_LEN = 64;
+
+//iniファイルの読み書き
+//guiEx_settingsで読み込み済みのファイル(ini/conf)はメモリ上のデータを使用し、それ以外はWin32 APIを使用する
+size_t GetPrivateProfileStringIni(const char *section, const char *keyname, const char *defaultString, char *buf, size_t bufSize, const char *ini_file);
+UINT   GetPrivateProfileIntIni(const char *section, const char *keyname, int defaultValue, const char *ini_file);
+size_t GetPrivateProfileSectionIni(const char *section, char *buf, size_t bufSize, const char *ini_file);
+BOOL   WritePrivateProfileStringIni(const char *section, const char *keyname, const char *value, const char *ini_file);
+
 static size_t GetPrivateProfileSectionStg(const char *section, char *buf, size_t bufSize, const char *ini_file, const DWORD codepage) {
     if (bufSize == 0) {
         return 0;
     }
-    size_t len = GetPrivateProfileSection(section, buf, (DWORD)bufSize, ini_file);
+    size_t len = GetPrivateProfileSectionIni(section, buf, bufSize, ini_file);
     if (codepage == CP_THREAD_ACP) {
         return len;
     }
@@ -138,7 +166,7 @@ static size_t GetPrivateProfileStringStg(const char *section, const char *keynam
     if (bufSize == 0) {
         return 0;
     }
-    size_t len = GetPrivateProfileString(section, keyname, defaultString, buf, (DWORD)bufSize, ini_file);
+    size_t len = GetPrivateProfileStringIni(section, keyname, defaultString, buf, bufSize, ini_file);
     if (codepage == CP_THREAD_ACP) {
         return len;
     }
@@ -150,7 +178,7 @@ static size_t GetPrivateProfileWStringStg(const char *section, const char *keyna
     if (bufSize == 0) {
         return 0;
     }
-    size_t len = GetPrivateProfileString(section, keyname, defaultString, buf, (DWORD)bufSize, ini_file);
+    size_t len = GetPrivateProfileStringIni(section, keyname, defaultString, buf, bufSize, ini_file);
     if (codepage == CP_THREAD_ACP) {
         return len;
     }
@@ -351,6 +379,11 @@ typedef struct LOCAL_SETTINGS {
     int    default_audio_encoder_in;            //デフォルトの内蔵音声エンコーダ
     double av_length_threshold;                 //音声と映像の長さの差の割合がこの値を超える場合、エラー・警告を表示する
     int    thread_pthrottling_mode;             //スレッドの電力スロットリングモード
+    BOOL   audio_stream_to_videnc;              //音声をffmpegに入力する場合、外部音声エンコーダの出力を映像処理と同時にffmpegに渡す
+    BOOL   deferred_encode;                     //可逆圧縮の中間ファイルに出力し、最終エンコードはバックグラウンドで行う
+    char   deferred_intermediate_cmd[MAX_PATH_LEN]; //中間ファイル出力用のffmpegのオプション
+    char   thread_placement[THREAD_PLACEMENT_COUNT][THREAD_PLACEMENT_STR_LEN]; //スレッド・プロセスのCPUへの配置 (auto, all, pcore, ecore, cachel3#0 など)
+    char   simd_limit[32];                      //使用するSIMDの上限 (auto, none, sse2, ssse3, sse41, avx, avx2, avx512 など)
     //int    amp_retry_limit;                     //自動マルチパス試行回数制限
     //double amp_bitrate_margin_multi;            //自動マルチパスで、上限ファイルサイズからビットレートを再計算するときの倍率
     //double amp_reenc_audio_multi;               //自動マルチパスで、音声側を再エンコしてビットレート調整をする上限倍率
@@ -360,6 +393,9 @@ typedef struct LOCAL_SETTINGS {
     BOOL   run_bat_minimized;                   //エンコ前後バッチ処理を最小化で実行
     //BOOL   set_keyframe_as_afs_24fps;           //自動フィールドシフト使用時にも24fps化としてキーフレーム設定を強制的に行う
     //BOOL   auto_ref_limit_by_level;             //参照フレーム数をLevelにより自動的に制限する
+    BOOL   tmp_dir_same_volume;                 //出力先のドライブに十分な空き容量があれば、出力先を一時フォルダとして使用する
+    int    output_dither;                       //8bit出力時、YC48からディザをかけて変換する (DITHER_xxx, 0ならYUY2を切り捨てで受け取る)
+    int    rgba_unpremultiply;                  //RGBA -> YUVA変換時、拡張編集の乗算済みアルファを元に戻す
     char   custom_tmp_dir[MAX_PATH_LEN];        //一時フォルダ
     char   custom_audio_tmp_dir[MAX_PATH_LEN];  //音声用一時フォルダ
     char   custom_mp4box_tmp_dir[MAX_PATH_LEN]; //mp4box用一時フォルダ
@@ -0,0 +1,279 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <string>
+#include <vector>
+#include <shlwapi.h>
+#pragma comment(lib, "shlwapi.lib")
+#include "auo_util.h"
+#include "auo_conf.h"
+#include "auo_stg_index.h"
+#include "rgy_ini.h"
+
+static const char *STG_INDEX_APPENDIX = ".index.ini";
+static const char *STG_FILE_EXT       = ".stg";
+
+static const char *STG_INDEX_KEY_DIR        = "dir";
+static const char *STG_INDEX_KEY_SIZE       = "size";
+static const char *STG_INDEX_KEY_TIME       = "time";
+static const char *STG_INDEX_KEY_VALID      = "valid";
+static const char *STG_INDEX_KEY_CODEC      = "codec";
+static const char *STG_INDEX_KEY_OUTPUT_CSP = "output_csp";
+static const char *STG_INDEX_KEY_HIGHBIT    = "use_highbit_depth";
+static const char *STG_INDEX_KEY_INTERLACED = "interlaced";
+static const char *STG_INDEX_KEY_OUTEXT     = "outext";
+static const char *STG_INDEX_KEY_NOTES      = "notes";
+
+typedef struct STG_FILE_STAT {
+    std::string path; //stgフォルダからの相対パス
+    bool is_dir;
+    std::string size;
+    std::string time;
+} STG_FILE_STAT;
+
+static std::string get_stg_index_path(const std::string& stg_dir) {
+    return stg_dir + STG_INDEX_APPENDIX;
+}
+
+static std::string get_stg_file_stat_str(DWORD high, DWORD low) {
+    return std::to_string(((UINT64)high << 32) | low);
+}
+
+//FindFirstFileExで列挙し、ファイルを開かずにサイズと更新日時を取得する
+//並びはフォルダが先、その後にstgファイル (Directory::GetDirectories/GetFilesと同じ)
+static void scan_stg_dir(const std::string& root, const std::string& rel_dir, std::vector<STG_FILE_STAT>& list) {
+    const std::string search = root + "\\" + ((rel_dir.length() > 0) ? rel_dir + "\\" : "") + "*";
+    WIN32_FIND_DATA fd;
+    HANDLE h_find = FindFirstFileEx(search.c_str(), FindExInfoBasic, &fd, FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+    if (h_find == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    std::vector<std::string> dirs;
+    std::vector<STG_FILE_STAT> files;
+    do {
+        const std::string rel_path = ((rel_dir.length() > 0) ? rel_dir + "\\" : "") + fd.cFileName;
+        if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+            if (strcmp(fd.cFileName, ".") != 0 && strcmp(fd.cFileName, "..") != 0) {
+                dirs.push_back(rel_path);
+            }
+        } else if (_stricmp(PathFindExtension(fd.cFileName), STG_FILE_EXT) == 0) {
+            STG_FILE_STAT stat;
+            stat.path = rel_path;
+            stat.is_dir = false;
+            stat.size = get_stg_file_stat_str(fd.nFileSizeHigh, fd.nFileSizeLow);
+            stat.time = get_stg_file_stat_str(fd.ftLastWriteTime.dwHighDateTime, fd.ftLastWriteTime.dwLowDateTime);
+            files.push_back(stat);
+        }
+    } while (FindNextFile(h_find, &fd));
+    FindClose(h_find);
+
+    for (const auto& dir : dirs) {
+        STG_FILE_STAT stat;
+        stat.path = dir;
+        stat.is_dir = true;
+        list.push_back(stat);
+        scan_stg_dir(root, dir, list);
+    }
+    list.insert(list.end(), files.begin(), files.end());
+}
+
+//追加コマンドから映像コーデックを取得する
+static std::string get_codec_from_cmdex(const char *cmdex) {
+    static const char *CODEC_OPTIONS[] = { "-c:v", "-codec:v", "-vcodec" };
+    for (const auto option : CODEC_OPTIONS) {
+        const size_t option_len = strlen(option);
+        for (const char *ptr = cmdex; (ptr = strstr(ptr, option)) != nullptr; ptr += option_len) {
+            //オプションの区切りかどうか
+            if ((ptr != cmdex && !isspace((unsigned char)ptr[-1])) || !isspace((unsigned char)ptr[option_len])) {
+                continue;
+            }
+            const char *codec = ptr + option_len;
+            while (isspace((unsigned char)*codec)) codec++;
+            const char *fin = codec;
+            while (*fin && !isspace((unsigned char)*fin)) fin++;
+            if (fin > codec) {
+                return std::string(codec, fin);
+            }
+        }
+    }
+    return "";
+}
+
+//iniに保存できるよう改行を除去する
+static std::string remove_newline(const char *str) {
+    std::string ret = str;
+    for (auto& c : ret) {
+        if (c == '\r' || c == '\n') c = ' ';
+    }
+    return ret;
+}
+
+static bool get_stg_file_stat(const std::string& stg_dir, const char *stg_file, STG_FILE_STAT *stat) {
+    WIN32_FILE_ATTRIBUTE_DATA fd = { 0 };
+    const std::string stg_path = stg_dir + "\\" + stg_file;
+    if (!GetFileAttributesEx(stg_path.c_str(), GetFileExInfoStandard, &fd)
+        || (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+        return false;
+    }
+    stat->path = stg_file;
+    stat->is_dir = false;
+    stat->size = get_stg_file_stat_str(fd.nFileSizeHigh, fd.nFileSizeLow);
+    stat->time = get_stg_file_stat_str(fd.ftLastWriteTime.dwHighDateTime, fd.ftLastWriteTime.dwLowDateTime);
+    return true;
+}
+
+//confがnullptrなら設定ファイルとして読み込めないものとして登録する
+static void set_stg_index(RGYIniFile& index, const STG_FILE_STAT& stat, const CONF_GUIEX *conf) {
+    const char *section = stat.path.c_str();
+    index.removeSection(section);
+    index.setString(section, STG_INDEX_KEY_SIZE, stat.size.c_str());
+    index.setString(section, STG_INDEX_KEY_TIME, stat.time.c_str());
+    index.setString(section, STG_INDEX_KEY_VALID, (conf) ? "1" : "0");
+    if (conf) {
+        index.setString(section, STG_INDEX_KEY_CODEC,      get_codec_from_cmdex(conf->vid.cmdex).c_str());
+        index.setString(section, STG_INDEX_KEY_OUTPUT_CSP, std::to_string(conf->enc.output_csp).c_str());
+        index.setString(section, STG_INDEX_KEY_HIGHBIT,    std::to_string(conf->enc.use_highbit_depth).c_str());
+        index.setString(section, STG_INDEX_KEY_INTERLACED, std::to_string(conf->enc.interlaced).c_str());
+        index.setString(section, STG_INDEX_KEY_OUTEXT,     remove_newline(conf->vid.outext).c_str());
+        index.setString(section, STG_INDEX_KEY_NOTES,      remove_newline(conf->oth.notes).c_str());
+    }
+}
+
+static void read_stg_file_to_index(RGYIniFile& index, const std::string& stg_dir, const STG_FILE_STAT& stat) {
+    CONF_GUIEX conf;
+    const std::string stg_path = stg_dir + "\\" + stat.path;
+    const bool valid = guiEx_config::load_guiEx_conf(&conf, stg_path.c_str()) == CONF_ERROR_NONE;
+    set_stg_index(index, stat, (valid) ? &conf : nullptr);
+}
+
+static std::string remove_last_separator(const char *dir) {
+    std::string ret = dir;
+    while (ret.length() > 0 && (ret.back() == '\\' || ret.back() == '/')) {
+        ret.pop_back();
+    }
+    return ret;
+}
+
+static bool stg_index_is_up_to_date(const RGYIniFile& index, const STG_FILE_STAT& stat) {
+    const char *section = stat.path.c_str();
+    return index.hasSection(section)
+        && index.getString(section, STG_INDEX_KEY_SIZE, "") == stat.size
+        && index.getString(section, STG_INDEX_KEY_TIME, "") == stat.time;
+}
+
+static STG_INDEX_ENTRY get_stg_index_entry(const RGYIniFile& index, const STG_FILE_STAT& stat) {
+    const char *section = stat.path.c_str();
+    STG_INDEX_ENTRY entry;
+    entry.path              = stat.path;
+    entry.is_dir            = stat.is_dir;
+    entry.valid             = !stat.is_dir && index.getInt(section, STG_INDEX_KEY_VALID, 0) != 0;
+    entry.codec             = index.getString(section, STG_INDEX_KEY_CODEC, "");
+    entry.output_csp        = index.getInt(section, STG_INDEX_KEY_OUTPUT_CSP, 0);
+    entry.use_highbit_depth = index.getInt(section, STG_INDEX_KEY_HIGHBIT, 0);
+    entry.interlaced        = index.getInt(section, STG_INDEX_KEY_INTERLACED, 0);
+    entry.outext            = index.getString(section, STG_INDEX_KEY_OUTEXT, "");
+    entry.notes             = index.getString(section, STG_INDEX_KEY_NOTES, "");
+    return entry;
+}
+
+guiEx_stg_index::guiEx_stg_index() : stg_dir(), entries() {
+}
+
+guiEx_stg_index::~guiEx_stg_index() {
+}
+
+int guiEx_stg_index::update(const char *_stg_dir) {
+    stg_dir = remove_last_separator(_stg_dir);
+    entries.clear();
+
+    std::vector<STG_FILE_STAT> list;
+    scan_stg_dir(stg_dir, "", list);
+
+    RGYIniFile index;
+    if (index.load(get_stg_index_path(stg_dir).c_str())) {
+        //読めないインデックスは作り直す
+        index.parse(nullptr, 0);
+    }
+    //削除されたファイルをインデックスから除く
+    for (const auto& section : index.getSectionNames()) {
+        bool found = false;
+        for (const auto& stat : list) {
+            if (_stricmp(stat.path.c_str(), section.c_str()) == 0) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            index.removeSection(section.c_str());
+        }
+    }
+    for (const auto& stat : list) {
+        if (stat.is_dir) {
+            if (!index.hasSection(stat.path.c_str())) {
+                index.setString(stat.path.c_str(), STG_INDEX_KEY_DIR, "1");
+            }
+        } else if (!stg_index_is_up_to_date(index, stat)) {
+            //変更のあったファイルのみ読み込む
+            read_stg_file_to_index(index, stg_dir, stat);
+        }
+        entries.push_back(get_stg_index_entry(index, stat));
+    }
+    return index.save();
+}
+
+bool guiEx_stg_index::check_stg_file(const char *_stg_dir, const char *stg_file) {
+    const auto dir = remove_last_separator(_stg_dir);
+    STG_FILE_STAT stat;
+    if (!get_stg_file_stat(dir, stg_file, &stat)) {
+        return false;
+    }
+    RGYIniFile index;
+    if (index.load(get_stg_index_path(dir).c_str())) {
+        //インデックスが使用できない場合は直接読み込んで確認する
+        CONF_GUIEX conf;
+        return guiEx_config::load_guiEx_conf(&conf, (dir + "\\" + stg_file).c_str()) == CONF_ERROR_NONE;
+    }
+    if (!stg_index_is_up_to_date(index, stat)) {
+        read_stg_file_to_index(index, dir, stat);
+        index.save();
+    }
+    return get_stg_index_entry(index, stat).valid;
+}
+
+void guiEx_stg_index::set_stg_file(const char *_stg_dir, const char *stg_file, const CONF_GUIEX *conf) {
+    const auto dir = remove_last_separator(_stg_dir);
+    STG_FILE_STAT stat;
+    RGYIniFile index;
+    if (get_stg_file_stat(dir, stg_file, &stat)
+        && index.load(get_stg_index_path(dir).c_str()) == 0) {
+        set_stg_index(index, stat, conf);
+        index.save();
+    }
+}
@@ -0,0 +1,71 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#ifndef _AUO_STG_INDEX_H_
+#define _AUO_STG_INDEX_H_
+
+#include <string>
+#include <vector>
+
+struct CONF_GUIEX;
+
+//stgファイルの一覧と、その主要な設定をまとめたもの
+typedef struct STG_INDEX_ENTRY {
+    std::string path;        //stgフォルダからの相対パス
+    bool        is_dir;      //フォルダかどうか
+    bool        valid;       //設定ファイルとして読み込めるか
+    std::string codec;       //追加コマンドで指定された映像コーデック
+    int         output_csp;
+    int         use_highbit_depth;
+    int         interlaced;
+    std::string outext;      //出力拡張子
+    std::string notes;       //メモ
+} STG_INDEX_ENTRY;
+
+//stgフォルダのインデックス
+//stgファイルの更新日時・サイズとともに主要な設定を"<stgフォルダ>.index.ini"に保存しておき、
+//一覧の作成時には変更のあったファイルのみを読み込む
+//CONF_GUIEX全体は、設定を適用する時にguiEx_config::load_guiEx_conf()で読み込む
+class guiEx_stg_index {
+private:
+    std::string stg_dir;
+    std::vector<STG_INDEX_ENTRY> entries;
+public:
+    guiEx_stg_index();
+    ~guiEx_stg_index();
+
+    //stgフォルダを走査して一覧を更新する
+    int update(const char *stg_dir);
+    //1つのstgファイルが設定ファイルとして読み込めるかを、インデックスを使って確認する
+    bool check_stg_file(const char *stg_dir, const char *stg_file);
+    //保存したstgファイルの情報を、ファイルを読み直さずにインデックスに反映する
+    void set_stg_file(const char *stg_dir, const char *stg_file, const CONF_GUIEX *conf);
+
+    const std::vector<STG_INDEX_ENTRY>& get_entries() const { return entries; }
+};
+
+#endif //_AUO_STG_INDEX_H_
@@ -65,8 +65,27 @@ typedef struct ALIGN_PTR {
     BOOL   abort;
 } AUD_PARALLEL_ENC;
 
+typedef struct {
+    BOOL   enable;            //音声の処理順を自動選択する
+    BOOL   decided;           //処理順が決定済み (同時処理に切り替えた)
+    BOOL   evaluated;         //映像の処理速度による最初の判定を行った
+    double aud_enc_ms;        //音声の処理時間の予測値 (音声エンコーダの計測から算出、「後」で処理する場合)
+    double aud_enc_cores;     //音声エンコーダの使用する論理コア数
+    int    calib_start_frame; //映像の計測開始フレーム
+    DWORD  tm_calib_start;    //映像の計測開始時刻
+    UINT64 videnc_cpu_time;   //映像の計測開始時のエンコーダのCPU時間 (100ns単位)
+    UINT64 aviutl_cpu_time;   //映像の計測開始時のAviutlのCPU時間 (100ns単位)
+    DWORD  tm_parallel_start; //同時処理の開始時刻
+    DWORD  vid_wait_ms;       //同時処理中に映像側が音声の待機に費やした時間
+    int    calib_chunks;      //同時処理の計測に使用した音声ブロック数
+    BOOL   nonblocking;       //音声を待機せずに映像を処理する
+} AUD_TIMING_AUTO;
+
 typedef struct {
     AUD_PARALLEL_ENC aud_parallel;         //音声並列処理の管理
+    AUD_TIMING_AUTO aud_timing_auto;       //音声処理順の自動選択の管理
+    BOOL aud_stream_to_videnc;             //外部音声エンコーダの出力を、映像処理と同時にffmpegに入力する
+    BOOL deferred_enc;                     //可逆圧縮の中間ファイルに出力し、最終エンコードはバックグラウンドで行う
     int video_out_type;                    //出力する動画のフォーマット(拡張子により判断)
     int muxer_to_be_used;                  //使用するmuxerのインデックス
     int current_x264_pass;                 //現在のx264パス数
@@ -47,6 +47,7 @@
 
 #include "auo.h"
 #include "auo_version.h"
+#include "rgy_simd.h"
 
 //日本語環境の一般的なコードページ一覧
 enum : DWORD {
@@ -94,6 +95,31 @@ enum {
     AUO_SIMD_AVX512BITALG    = 0x200000,
     AUO_SIMD_AVX512VPOPCNTDQ = 0x400000,
 };
+//SIMDの判定はrgy_simd.hのget_availableSIMD()で行うので、値を一致させておく
+static_assert((uint64_t)AUO_SIMD_NONE            == (uint64_t)RGY_SIMD::NONE,           "AUO_SIMD_NONE");
+static_assert((uint64_t)AUO_SIMD_SSE2            == (uint64_t)RGY_SIMD::SSE2,           "AUO_SIMD_SSE2");
+static_assert((uint64_t)AUO_SIMD_SSE3            == (uint64_t)RGY_SIMD::SSE3,           "AUO_SIMD_SSE3");
+static_assert((uint64_t)AUO_SIMD_SSSE3           == (uint64_t)RGY_SIMD::SSSE3,          "AUO_SIMD_SSSE3");
+static_assert((uint64_t)AUO_SIMD_SSE41           == (uint64_t)RGY_SIMD::SSE41,          "AUO_SIMD_SSE41");
+static_assert((uint64_t)AUO_SIMD_SSE42           == (uint64_t)RGY_SIMD::SSE42,          "AUO_SIMD_SSE42");
+static_assert((uint64_t)AUO_SIMD_POPCNT          == (uint64_t)RGY_SIMD::POPCNT,         "AUO_SIMD_POPCNT");
+static_assert((uint64_t)AUO_SIMD_AVX             == (uint64_t)RGY_SIMD::AVX,            "AUO_SIMD_AVX");
+static_assert((uint64_t)AUO_SIMD_AVX2            == (uint64_t)RGY_SIMD::AVX2,           "AUO_SIMD_AVX2");
+static_assert((uint64_t)AUO_SIMD_BMI1            == (uint64_t)RGY_SIMD::BMI1,           "AUO_SIMD_BMI1");
+static_assert((uint64_t)AUO_SIMD_BMI2            == (uint64_t)RGY_SIMD::BMI2,           "AUO_SIMD_BMI2");
+static_assert((uint64_t)AUO_SIMD_AVX512F         == (uint64_t)RGY_SIMD::AVX512F,        "AUO_SIMD_AVX512F");
+static_assert((uint64_t)AUO_SIMD_AVX512DQ        == (uint64_t)RGY_SIMD::AVX512DQ,       "AUO_SIMD_AVX512DQ");
+static_assert((uint64_t)AUO_SIMD_AVX512IFMA      == (uint64_t)RGY_SIMD::AVX512IFMA,     "AUO_SIMD_AVX512IFMA");
+static_assert((uint64_t)AUO_SIMD_AVX512PF        == (uint64_t)RGY_SIMD::AVX512PF,       "AUO_SIMD_AVX512PF");
+static_assert((uint64_t)AUO_SIMD_AVX512ER        == (uint64_t)RGY_SIMD::AVX512ER,       "AUO_SIMD_AVX512ER");
+static_assert((uint64_t)AUO_SIMD_AVX512CD        == (uint64_t)RGY_SIMD::AVX512CD,       "AUO_SIMD_AVX512CD");
+static_assert((uint64_t)AUO_SIMD_AVX512BW        == (uint64_t)RGY_SIMD::AVX512BW,       "AUO_SIMD_AVX512BW");
+static_assert((uint64_t)AUO_SIMD_AVX512VL        == (uint64_t)RGY_SIMD::AVX512VL,       "AUO_SIMD_AVX512VL");
+static_assert((uint64_t)AUO_SIMD_AVX512VBMI      == (uint64_t)RGY_SIMD::AVX512VBMI,     "AUO_SIMD_AVX512VBMI");
+static_assert((uint64_t)AUO_SIMD_AVX512VBMI2     == (uint64_t)RGY_SIMD::AVX512VBMI2,    "AUO_SIMD_AVX512VBMI2");
+static_assert((uint64_t)AUO_SIMD_AVX512VNNI      == (uint64_t)RGY_SIMD::AVX512VNNI,     "AUO_SIMD_AVX512VNNI");
+static_assert((uint64_t)AUO_SIMD_AVX512BITALG    == (uint64_t)RGY_SIMD::AVX512BITALG,   "AUO_SIMD_AVX512BITALG");
+static_assert((uint64_t)AUO_SIMD_AVX512VPOPCNTDQ == (uint64_t)RGY_SIMD::AVX512VPOPCNTDQ, "AUO_SIMD_AVX512VPOPCNTDQ");
 
 //関数マクロ
 #define clamp(x, low, high) (((x) <= (high)) ? (((x) >= (low)) ? (x) : (low)) : (high))
@@ -436,105 +462,7 @@ static size_t get_intlen(int i) {
     return strlen(str);
 }
 
-//mmx    cpuid_1 CPUInfo[3] & 0x00800000
-//sse    cpuid_1 CPUInfo[3] & 0x02000000
-//sse2   cpuid_1 CPUInfo[3] & 0x04000000
-//sse3   cpuid_1 CPUInfo[2] & 0x00000001
-//ssse3  cpuid_1 CPUInfo[2] & 0x00000200
-//sse4.1 cpuid_1 CPUInfo[2] & 0x00080000
-//sse4.2 cpuid_1 CPUInfo[2] & 0x00100000
-//avx    cpuid_1 CPUInfo[2] & 0x18000000 == 0x18000000 + OSチェック
-//avx2   cpuid_7 CPUInfo[1] & 0x00000020 + OSチェック
-static BOOL check_sse2() {
-    int CPUInfo[4];
-    __cpuid(CPUInfo, 1);
-    return (CPUInfo[3] & 0x04000000) != 0;
-}
-
-static BOOL check_ssse3() {
-    int CPUInfo[4];
-    __cpuid(CPUInfo, 1);
-    return (CPUInfo[2] & 0x00000200) != 0;
-}
-
-static BOOL check_sse3() {
-    int CPUInfo[4];
-    __cpuid(CPUInfo, 1);
-    return (CPUInfo[2] & 0x00000001) != 0;
-}
-
-static BOOL check_sse4_1() {
-    int CPUInfo[4];
-    __cpuid(CPUInfo, 1);
-    return (CPUInfo[2] & 0x00080000) != 0;
-}
-static BOOL check_avx() {
-    int CPUInfo[4];
-    __cpuid(CPUInfo, 1);
-    if ((CPUInfo[2] & 0x18000000) == 0x18000000) {
-        UINT64 XGETBV = _xgetbv(0);
-        if ((XGETBV & 0x06) == 0x06)
-            return TRUE;
-    }
-    return FALSE;
-}
-static BOOL check_avx2() {
-    int CPUInfo[4];
-    __cpuid(CPUInfo, 1);
-    if ((CPUInfo[2] & 0x18000000) == 0x18000000) {
-        UINT64 XGETBV = _xgetbv(0);
-        if ((XGETBV & 0x06) == 0x06) {
-            __cpuid(CPUInfo, 7);
-            if ((CPUInfo[1] & 0x00000020))
-                return TRUE;
-        }
-    }
-    return FALSE;
-}
-
 #if ENCODER_X264 || ENCODER_X265 || ENCODER_SVTAV1 || ENCODER_FFMPEG
-static DWORD get_availableSIMD() {
-    int CPUInfo[4];
-    __cpuid(CPUInfo, 1);
-    DWORD simd = AUO_SIMD_NONE;
-    if (CPUInfo[3] & 0x04000000) simd |= AUO_SIMD_SSE2;
-    if (CPUInfo[2] & 0x00000001) simd |= AUO_SIMD_SSE3;
-    if (CPUInfo[2] & 0x00000200) simd |= AUO_SIMD_SSSE3;
-    if (CPUInfo[2] & 0x00080000) simd |= AUO_SIMD_SSE41;
-    if (CPUInfo[2] & 0x00100000) simd |= AUO_SIMD_SSE42;
-    if (CPUInfo[2] & 0x00800000) simd |= AUO_SIMD_POPCNT;
-    uint64_t xgetbv = 0;
-    if ((CPUInfo[2] & 0x18000000) == 0x18000000) {
-        xgetbv = _xgetbv(0);
-        if ((xgetbv & 0x06) == 0x06)
-            simd |= AUO_SIMD_AVX;
-    }
-    __cpuid(CPUInfo, 7);
-    if (!!(simd & AUO_SIMD_AVX) && (CPUInfo[1] & 0x00000020)) {
-        simd |= AUO_SIMD_AVX2;
-    }
-    if (!!(simd & AUO_SIMD_AVX) && ((xgetbv >> 5) & 7) == 7) {
-        if (CPUInfo[1] & (1u << 3)) simd |= AUO_SIMD_BMI1;
-        if (CPUInfo[1] & (1u << 8)) simd |= AUO_SIMD_BMI2;
-        if (CPUInfo[1] & (1u << 16)) simd |= AUO_SIMD_AVX512F;
-        if (!!(simd & AUO_SIMD_AVX512F)) {
-            if (CPUInfo[1] & (1u << 17)) simd |= AUO_SIMD_AVX512DQ;
-            if (CPUInfo[1] & (1u << 21)) simd |= AUO_SIMD_AVX512IFMA;
-            if (CPUInfo[1] & (1u << 26)) simd |= AUO_SIMD_AVX512PF;
-            if (CPUInfo[1] & (1u << 27)) simd |= AUO_SIMD_AVX512ER;
-            if (CPUInfo[1] & (1u << 28)) simd |= AUO_SIMD_AVX512CD;
-            if (CPUInfo[1] & (1u << 30)) simd |= AUO_SIMD_AVX512BW;
-            if (CPUInfo[1] & (1u << 31)) simd |= AUO_SIMD_AVX512VL;
-            if (CPUInfo[2] & (1u <<  1)) simd |= AUO_SIMD_AVX512VBMI;
-            if (CPUInfo[2] & (1u <<  6)) simd |= AUO_SIMD_AVX512VBMI2;
-            if (CPUInfo[2] & (1u << 11)) simd |= AUO_SIMD_AVX512VNNI;
-            if (CPUInfo[2] & (1u << 12)) simd |= AUO_SIMD_AVX512BITALG;
-            if (CPUInfo[2] & (1u << 14)) simd |= AUO_SIMD_AVX512VPOPCNTDQ;
-        }
-    }
-    return simd;
-}
-
 std::string GetFullPathFrom(const char *path, const char *baseDir);
 std::wstring GetFullPathFrom(const wchar_t *path, const wchar_t *baseDir);
 #endif
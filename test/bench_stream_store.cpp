@@ -0,0 +1,182 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+// 映像変換でのNon-temporal storeと通常のstoreの速度を比較するベンチマーク
+// ctestには登録しない。書き出しスレッドと同様に、変換後に出力フレームを1回読み出すまでの時間を計測する
+//   cmake --build build --target bench_stream_store && ./build/bench_stream_store
+//
+// プラグインにはAVX2版の色変換の*_stream版 (YUY2->NV12, YC48->P016, YC48->YUV444 8/16bit) があったが、
+// すべてのフレームサイズで通常のstoreのほうが速く、使われることがないため削除した
+// そのため、ここではYUY2->NV12 (8bit/16bit出力) の変換を単独で実装して比較する
+//
+// 計測結果 (LLC 300 MB)
+//   削除した*_stream版
+//     yc48_to_nv12_16bit   3840x2160:  12.4 ms (store) vs 14.8 ms (stream)
+//     yc48_to_yuv444_16bit 7680x4320:  75.7 ms (store) vs 87.4 ms (stream)
+//   このベンチマーク
+//     yuy2_to_nv12         3840x2160:   2.3 ms (store) vs  4.4 ms (stream)
+//     yuy2_to_nv12         7680x4320:  10.8 ms (store) vs 17.3 ms (stream)
+//     yuy2_to_nv12_16bit   3840x2160:   3.6 ms (store) vs  5.8 ms (stream)
+//     yuy2_to_nv12_16bit   7680x4320:  22.7-24.5 ms (store) vs 21.8-22.2 ms (stream)
+//   出力が約95 MBになる8K 16bitでようやく同程度となり、それより小さいフレームでは通常のstoreのほうが明確に速い
+
+#include <chrono>
+#include <memory>
+#include <unistd.h>
+#include <immintrin.h>
+#include "test_util.h"
+
+template<bool use_stream>
+static inline void bench_store(void *ptr, __m256i y) {
+    if (use_stream) {
+        _mm256_stream_si256((__m256i *)ptr, y);
+    } else {
+        _mm256_storeu_si256((__m256i *)ptr, y);
+    }
+}
+
+//32画素分の8bit値を書き込む (highbitなら16bitに拡張する)
+template<bool use_stream, bool highbit>
+static inline void bench_store_pixels(uint8_t *dst, __m256i y) {
+    if (highbit) {
+        y = _mm256_permute4x64_epi64(y, _MM_SHUFFLE(3,1,2,0));
+        bench_store<use_stream>(dst +  0, _mm256_unpacklo_epi8(_mm256_setzero_si256(), y));
+        bench_store<use_stream>(dst + 32, _mm256_unpackhi_epi8(_mm256_setzero_si256(), y));
+    } else {
+        bench_store<use_stream>(dst, y);
+    }
+}
+
+//YUY2 -> NV12 (highbitなら上位8bitに詰めた16bit)、widthは32の倍数
+template<bool use_stream, bool highbit>
+static void bench_yuy2_to_nv12(const uint8_t *src, uint8_t *dst_y, uint8_t *dst_c, int width, int height) {
+    const int pixel_size = (highbit) ? 2 : 1;
+    const __m256i yMaskY = _mm256_set1_epi16(0x00ff);
+    for (int y = 0; y < height; y += 2) {
+        const uint8_t *p0 = src + (size_t)width * y * 2;
+        const uint8_t *p1 = p0 + width * 2;
+        uint8_t *Y = dst_y + (size_t)width * y * pixel_size;
+        uint8_t *C = dst_c + (size_t)width * (y >> 1) * pixel_size;
+        for (int x = 0; x < width; x += 32, p0 += 64, p1 += 64) {
+            if (use_stream) {
+                _mm_prefetch((const char *)p0 + 512, _MM_HINT_NTA);
+                _mm_prefetch((const char *)p1 + 512, _MM_HINT_NTA);
+            }
+            const __m256i y00 = _mm256_loadu_si256((const __m256i *)(p0 +  0));
+            const __m256i y01 = _mm256_loadu_si256((const __m256i *)(p0 + 32));
+            const __m256i y10 = _mm256_loadu_si256((const __m256i *)(p1 +  0));
+            const __m256i y11 = _mm256_loadu_si256((const __m256i *)(p1 + 32));
+            const __m256i yY0 = _mm256_permute4x64_epi64(_mm256_packus_epi16(_mm256_and_si256(y00, yMaskY), _mm256_and_si256(y01, yMaskY)), _MM_SHUFFLE(3,1,2,0));
+            const __m256i yY1 = _mm256_permute4x64_epi64(_mm256_packus_epi16(_mm256_and_si256(y10, yMaskY), _mm256_and_si256(y11, yMaskY)), _MM_SHUFFLE(3,1,2,0));
+            const __m256i yC0 = _mm256_permute4x64_epi64(_mm256_packus_epi16(_mm256_srli_epi16(y00, 8), _mm256_srli_epi16(y01, 8)), _MM_SHUFFLE(3,1,2,0));
+            const __m256i yC1 = _mm256_permute4x64_epi64(_mm256_packus_epi16(_mm256_srli_epi16(y10, 8), _mm256_srli_epi16(y11, 8)), _MM_SHUFFLE(3,1,2,0));
+            bench_store_pixels<use_stream, highbit>(Y + x * pixel_size, yY0);
+            bench_store_pixels<use_stream, highbit>(Y + (width + x) * pixel_size, yY1);
+            bench_store_pixels<use_stream, highbit>(C + x * pixel_size, _mm256_avg_epu8(yC0, yC1));
+        }
+    }
+    if (use_stream)
+        _mm_sfence();
+    _mm256_zeroupper();
+}
+
+typedef void (*func_bench_convert)(const uint8_t *src, uint8_t *dst_y, uint8_t *dst_c, int width, int height);
+
+struct StreamStoreBench {
+    const char *name;
+    func_bench_convert func;
+    func_bench_convert func_stream;
+    int pixelSize;
+};
+
+static const StreamStoreBench STREAM_STORE_BENCH_LIST[] = {
+    { "yuy2_to_nv12",       bench_yuy2_to_nv12<false, false>, bench_yuy2_to_nv12<true, false>, 1 },
+    { "yuy2_to_nv12_16bit", bench_yuy2_to_nv12<false, true>,  bench_yuy2_to_nv12<true, true>,  2 },
+};
+
+// 幅は32の倍数 (出力の各行が32byte境界から始まるように)
+static const int STREAM_STORE_BENCH_SIZE[][2] = {
+    {   640,  480 },
+    {  1280,  720 },
+    {  1920, 1080 },
+    {  2560, 1440 },
+    {  3840, 2160 },
+    {  5120, 2880 },
+    {  7680, 4320 },
+};
+
+// AviUtlからは毎フレーム別の入力が渡されるので、複数の入力フレームを順番に使う
+static const int STREAM_STORE_BENCH_INPUT_FRAMES = 4;
+
+static double bench_stream_store_run(func_bench_convert func, std::vector<std::unique_ptr<TestBuffer>>& inputs, TestBuffer& dst, size_t planeSizeY, int width, int height, int frames) {
+    volatile uint64_t sink = 0;
+    double best = 1e30;
+    for (int rep = 0; rep < 3; rep++) {
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < frames; i++) {
+            func(inputs[i % inputs.size()]->data(), dst.data(), dst.data() + planeSizeY, width, height);
+            //書き出しスレッドでの読み出し
+            uint64_t sum = 0;
+            const uint64_t *ptr = (const uint64_t *)dst.data();
+            for (size_t j = 0; j < dst.size() / sizeof(uint64_t); j++)
+                sum += ptr[j];
+            sink = sink + sum;
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+        best = (std::min)(best, std::chrono::duration<double, std::milli>(end - start).count() / frames);
+    }
+    return best;
+}
+
+int main() {
+    if (!test_simd_available(RGY_SIMD::AVX2)) {
+        printf("AVX2 not available.\n");
+        return 0;
+    }
+#if defined(_SC_LEVEL3_CACHE_SIZE)
+    printf("LLC: %.1f MB\n", sysconf(_SC_LEVEL3_CACHE_SIZE) / (1024.0 * 1024.0));
+#endif
+    printf("%-22s %11s %10s %10s %10s\n", "", "size", "out [MB]", "store [ms]", "stream [ms]");
+    std::mt19937 rng(0);
+    for (const auto& b : STREAM_STORE_BENCH_LIST) {
+        for (const auto& s : STREAM_STORE_BENCH_SIZE) {
+            const int width = s[0], height = s[1];
+            std::vector<std::unique_ptr<TestBuffer>> inputs;
+            for (int i = 0; i < STREAM_STORE_BENCH_INPUT_FRAMES; i++) {
+                inputs.push_back(std::make_unique<TestBuffer>((size_t)width * height * 2));
+                test_fill_random(rng, inputs.back()->data(), inputs.back()->size());
+            }
+            const size_t planeSizeY = (size_t)width * height * b.pixelSize;
+            TestBuffer dst(planeSizeY * 3 / 2);
+            memset(dst.data(), 0, dst.size());
+            const int frames = (std::max)(8, (int)((size_t)1000 * 1000 * 1000 / (dst.size() * 4)));
+            const double t_store  = bench_stream_store_run(b.func,        inputs, dst, planeSizeY, width, height, frames);
+            const double t_stream = bench_stream_store_run(b.func_stream, inputs, dst, planeSizeY, width, height, frames);
+            printf("%-22s %5dx%-5d %10.1f %10.2f %10.2f\n", b.name, width, height, dst.size() / (1024.0 * 1024.0), t_store, t_stream);
+        }
+    }
+    return 0;
+}
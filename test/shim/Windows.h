@@ -0,0 +1,70 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+// ffmpegOut/encode/convert*.cppをLinux(gcc/clang)でテスト用にビルドするための最小限のWindows.h
+// 色変換で使用する型とマクロのみを定義する
+#ifndef __AUO_TEST_SHIM_WINDOWS_H__
+#define __AUO_TEST_SHIM_WINDOWS_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+typedef unsigned char  BYTE;
+typedef unsigned short USHORT;
+typedef unsigned short WORD;
+typedef uint32_t       DWORD;
+typedef int            BOOL;
+typedef unsigned int   UINT;
+typedef int            INT;
+typedef short          SHORT;
+typedef uint32_t       ULONG;
+
+#ifndef TRUE
+#define TRUE  1
+#endif
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+#define __forceinline inline __attribute__((always_inline))
+
+// _declspec(align(n)) -> __attribute__((aligned(n)))
+#define _declspec(x) AUO_TEST_SHIM_DECLSPEC_##x
+#define __declspec(x) AUO_TEST_SHIM_DECLSPEC_##x
+#define AUO_TEST_SHIM_DECLSPEC_align(n) __attribute__((aligned(n)))
+
+static inline void *_aligned_malloc(size_t size, size_t alignment) {
+    return aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+static inline void _aligned_free(void *ptr) {
+    free(ptr);
+}
+#define ZeroMemory(ptr, size) memset((ptr), 0, (size))
+
+#endif //__AUO_TEST_SHIM_WINDOWS_H__
@@ -0,0 +1,68 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#include "test_convert_util.h"
+
+// 4:2:2出力 (nv16/yuv422p/yuv422p16/p216) のAVX512版をC/AVX2版と比較する
+static const RGY_SIMD AVX512BW   = RGY_SIMD::AVX512F | RGY_SIMD::AVX512BW | RGY_SIMD::AVX512VL | RGY_SIMD::AVX2;
+static const RGY_SIMD AVX512VBMI = AVX512BW | RGY_SIMD::AVX512VBMI;
+
+static const ConvertKernelTest CONVERT_422_LIST[] = {
+    { "yuy2_to_nv16_avx512bw",              AVX512BW,   convert_yuy2_to_nv16,              convert_yuy2_to_nv16_avx512bw,                  CONVERT_TEST_INPUT_RANDOM, 2,  2, 1, { 1, 1 } },
+    { "yuy2_to_nv16_avx512vbmi",            AVX512VBMI, convert_yuy2_to_nv16,              convert_yuy2_to_nv16_avx512vbmi,                CONVERT_TEST_INPUT_RANDOM, 2,  2, 1, { 1, 1 } },
+    { "yuy2_to_nv16_avx512bw_mod64",        AVX512BW,   convert_yuy2_to_nv16,              convert_yuy2_to_nv16_avx512bw_mod64,            CONVERT_TEST_INPUT_RANDOM, 2, 64, 1, { 1, 1 } },
+    { "yuy2_to_nv16_avx512vbmi_mod64",      AVX512VBMI, convert_yuy2_to_nv16,              convert_yuy2_to_nv16_avx512vbmi_mod64,          CONVERT_TEST_INPUT_RANDOM, 2, 64, 1, { 1, 1 } },
+    { "yuy2_to_nv16_16bit_avx512bw",        AVX512BW,   convert_yuy2_to_nv16_16bit_avx2,   convert_yuy2_to_nv16_16bit_avx512bw,            CONVERT_TEST_INPUT_RANDOM, 2,  2, 1, { 2, 2 } },
+    { "yuy2_to_nv16_16bit_avx512bw_mod32",  AVX512BW,   convert_yuy2_to_nv16_16bit_avx2,   convert_yuy2_to_nv16_16bit_avx512bw_mod32,      CONVERT_TEST_INPUT_RANDOM, 2, 32, 1, { 2, 2 } },
+    { "yc48_to_nv16_16bit_avx512bw",        AVX512BW,   convert_yc48_to_nv16_16bit,        convert_yc48_to_nv16_16bit_avx512bw,            CONVERT_TEST_INPUT_YC48,   6,  2, 1, { 2, 2 } },
+    { "yc48_to_nv16_16bit_avx512vbmi",      AVX512VBMI, convert_yc48_to_nv16_16bit,        convert_yc48_to_nv16_16bit_avx512vbmi,          CONVERT_TEST_INPUT_YC48,   6,  2, 1, { 2, 2 } },
+    { "yc48_to_nv16_16bit_avx512bw_mod32",  AVX512BW,   convert_yc48_to_nv16_16bit,        convert_yc48_to_nv16_16bit_avx512bw_mod32,      CONVERT_TEST_INPUT_YC48,   6, 32, 1, { 2, 2 } },
+    { "yc48_to_nv16_16bit_avx512vbmi_mod32",AVX512VBMI, convert_yc48_to_nv16_16bit,        convert_yc48_to_nv16_16bit_avx512vbmi_mod32,    CONVERT_TEST_INPUT_YC48,   6, 32, 1, { 2, 2 } },
+    { "yuy2_to_yuv422_avx512bw",            AVX512BW,   convert_yuy2_to_yuv422,            convert_yuy2_to_yuv422_avx512bw,                CONVERT_TEST_INPUT_RANDOM, 2,  2, 1, { 1, 0.5, 0.5 } },
+    { "yuy2_to_yuv422_avx512vbmi",          AVX512VBMI, convert_yuy2_to_yuv422,            convert_yuy2_to_yuv422_avx512vbmi,              CONVERT_TEST_INPUT_RANDOM, 2,  2, 1, { 1, 0.5, 0.5 } },
+    { "yuy2_to_yuv422_avx512bw_mod64",      AVX512BW,   convert_yuy2_to_yuv422,            convert_yuy2_to_yuv422_avx512bw_mod64,          CONVERT_TEST_INPUT_RANDOM, 2, 64, 1, { 1, 0.5, 0.5 } },
+    { "yuy2_to_yuv422_avx512vbmi_mod64",    AVX512VBMI, convert_yuy2_to_yuv422,            convert_yuy2_to_yuv422_avx512vbmi_mod64,        CONVERT_TEST_INPUT_RANDOM, 2, 64, 1, { 1, 0.5, 0.5 } },
+    { "yuy2_to_yuv422_16bit_avx512bw",      AVX512BW,   convert_yuy2_to_yuv422_16bit_avx2, convert_yuy2_to_yuv422_16bit_avx512bw,         CONVERT_TEST_INPUT_RANDOM, 2,  2, 1, { 2, 1, 1 } },
+    { "yuy2_to_yuv422_16bit_avx512vbmi",    AVX512VBMI, convert_yuy2_to_yuv422_16bit_avx2, convert_yuy2_to_yuv422_16bit_avx512vbmi,        CONVERT_TEST_INPUT_RANDOM, 2,  2, 1, { 2, 1, 1 } },
+    { "yc48_to_yuv422_16bit_avx512bw",      AVX512BW,   convert_yc48_to_yuv422_16bit,      convert_yc48_to_yuv422_16bit_avx512bw,          CONVERT_TEST_INPUT_YC48,   6,  2, 1, { 2, 1, 1 } },
+    { "yc48_to_yuv422_16bit_avx512vbmi",    AVX512VBMI, convert_yc48_to_yuv422_16bit,      convert_yc48_to_yuv422_16bit_avx512vbmi,        CONVERT_TEST_INPUT_YC48,   6,  2, 1, { 2, 1, 1 } },
+    { "yc48_to_yuv422_16bit_avx512bw_mod64",AVX512BW,   convert_yc48_to_yuv422_16bit,      convert_yc48_to_yuv422_16bit_avx512bw_mod64,    CONVERT_TEST_INPUT_YC48,   6, 64, 1, { 2, 1, 1 } },
+    { "lw48_to_nv16_avx512bw",              AVX512BW,   convert_lw48_to_nv16,              convert_lw48_to_nv16_avx512bw,                  CONVERT_TEST_INPUT_RANDOM, 6,  2, 1, { 1, 1 } },
+    { "lw48_to_nv16_avx512vbmi",            AVX512VBMI, convert_lw48_to_nv16,              convert_lw48_to_nv16_avx512vbmi,                CONVERT_TEST_INPUT_RANDOM, 6,  2, 1, { 1, 1 } },
+    { "lw48_to_nv16_avx512bw_mod64",        AVX512BW,   convert_lw48_to_nv16,              convert_lw48_to_nv16_avx512bw_mod64,            CONVERT_TEST_INPUT_RANDOM, 6, 64, 1, { 1, 1 } },
+    { "lw48_to_nv16_16bit_avx512bw",        AVX512BW,   convert_lw48_to_nv16_16bit,        convert_lw48_to_nv16_16bit_avx512bw,            CONVERT_TEST_INPUT_RANDOM, 6,  2, 1, { 2, 2 } },
+    { "lw48_to_nv16_16bit_avx512vbmi",      AVX512VBMI, convert_lw48_to_nv16_16bit,        convert_lw48_to_nv16_16bit_avx512vbmi,          CONVERT_TEST_INPUT_RANDOM, 6,  2, 1, { 2, 2 } },
+    { "lw48_to_nv16_16bit_avx512bw_mod32",  AVX512BW,   convert_lw48_to_nv16_16bit,        convert_lw48_to_nv16_16bit_avx512bw_mod32,      CONVERT_TEST_INPUT_RANDOM, 6, 32, 1, { 2, 2 } },
+};
+
+int main() {
+    std::mt19937 rng(4202);
+    for (const auto& t : CONVERT_422_LIST) {
+        convert_test_run(t, rng, 400);
+    }
+    return test_result("test_convert_422");
+}
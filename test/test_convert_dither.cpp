@@ -0,0 +1,102 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#include "test_convert_util.h"
+
+// YC48 -> nv12 / yuv444 (8bit) のディザ付き変換で、SIMD版がC版と一致することを検証する
+// 幅が16で割り切れない場合、SIMD版は最後の16画素を右端に合わせて計算しなおすので、偶数幅をすべて試す
+static const RGY_SIMD SSE2  = RGY_SIMD::SSE2;
+static const RGY_SIMD SSSE3 = SSE2 | RGY_SIMD::SSSE3;
+static const RGY_SIMD SSE41 = SSSE3 | RGY_SIMD::SSE41;
+static const RGY_SIMD AVX   = SSE41 | RGY_SIMD::AVX;
+static const RGY_SIMD AVX2  = AVX | RGY_SIMD::AVX2;
+
+enum DitherLayout {
+    DITHER_NV12,
+    DITHER_NV12_I,
+    DITHER_YUV444,
+};
+
+struct DitherKernel {
+    const char *name;
+    RGY_SIMD simd;
+    func_convert_frame func;
+    func_convert_frame ref; // C版
+    int dither;
+    DitherLayout layout;
+};
+
+#define DITHER_KERNEL_SIMD(out, type, dither, layout, simd_name, simd) \
+    { "yc48_to_" #out "_" #type "_" #simd_name, simd, convert_yc48_to_ ## out ## _ ## type ## _ ## simd_name, convert_yc48_to_ ## out ## _ ## type, dither, layout }
+#define DITHER_KERNEL(out, type, dither, layout) \
+    DITHER_KERNEL_SIMD(out, type, dither, layout, sse2,  SSE2), \
+    DITHER_KERNEL_SIMD(out, type, dither, layout, ssse3, SSSE3), \
+    DITHER_KERNEL_SIMD(out, type, dither, layout, sse41, SSE41), \
+    DITHER_KERNEL_SIMD(out, type, dither, layout, avx,   AVX), \
+    DITHER_KERNEL_SIMD(out, type, dither, layout, avx2,  AVX2)
+
+static const DitherKernel DITHER_KERNEL_LIST[] = {
+    DITHER_KERNEL(nv12,   ordered_dither, DITHER_ORDERED,         DITHER_NV12),
+    DITHER_KERNEL(nv12_i, ordered_dither, DITHER_ORDERED,         DITHER_NV12_I),
+    DITHER_KERNEL(yuv444, ordered_dither, DITHER_ORDERED,         DITHER_YUV444),
+    DITHER_KERNEL(nv12,   err_diffusion,  DITHER_ERROR_DIFFUSION, DITHER_NV12),
+    DITHER_KERNEL(nv12_i, err_diffusion,  DITHER_ERROR_DIFFUSION, DITHER_NV12_I),
+    DITHER_KERNEL(yuv444, err_diffusion,  DITHER_ERROR_DIFFUSION, DITHER_YUV444),
+};
+#undef DITHER_KERNEL
+#undef DITHER_KERNEL_SIMD
+
+int main() {
+    std::mt19937 rng(4401);
+    for (const auto& k : DITHER_KERNEL_LIST) {
+        ConvertKernelTest t = { k.name, k.simd, k.ref, k.func, CONVERT_TEST_INPUT_YC48, (int)sizeof(PIXEL_YC), 2, 1 };
+        switch (k.layout) {
+            case DITHER_NV12:
+                t.heightStep = 2;
+                t.planeBytesPerPixel[0] = 1; t.planeBytesPerPixel[1] = 0.5;
+                break;
+            case DITHER_NV12_I:
+                t.heightStep = 4;
+                t.planeBytesPerPixel[0] = 1; t.planeBytesPerPixel[1] = 0.5;
+                break;
+            case DITHER_YUV444:
+            default:
+                t.planeBytesPerPixel[0] = t.planeBytesPerPixel[1] = t.planeBytesPerPixel[2] = 1;
+                break;
+        }
+        t.dither = k.dither;
+        convert_test_run(t, rng);
+        //誤差拡散は前の行の誤差を使い、誤差バッファは8行ごとに使いまわすので、それを超える高さも試す
+        if (test_simd_available(k.simd)) {
+            for (int width : { 16, 18, 30, 46, 64, 198 }) {
+                if (!convert_test_run_size(t, rng, width, 24))
+                    break;
+            }
+        }
+    }
+    return test_result("test_convert_dither");
+}
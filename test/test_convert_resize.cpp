@@ -0,0 +1,240 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#include "test_convert_util.h"
+
+// 縮小 (convert_resize.cpp, 縮小しながら変換する関数) を検証する
+static const RGY_SIMD AVX2 = RGY_SIMD::SSE2 | RGY_SIMD::SSSE3 | RGY_SIMD::SSE41 | RGY_SIMD::AVX | RGY_SIMD::AVX2;
+
+// 縮小しながら変換する関数 (入力の幅は32、高さは縮小率*2で割り切れること)
+static void test_shrink() {
+    struct ShrinkKernel {
+        const char *name;
+        func_convert_frame ref;
+        func_convert_frame func;
+        bool yc48;
+        int ratio;
+    } list[] = {
+        { "yuy2_to_nv12_half_avx2",          convert_yuy2_to_nv12_half,          convert_yuy2_to_nv12_half_avx2,          false, 2 },
+        { "yuy2_to_nv12_quarter_avx2",       convert_yuy2_to_nv12_quarter,       convert_yuy2_to_nv12_quarter_avx2,       false, 4 },
+        { "yc48_to_nv12_16bit_half_avx2",    convert_yc48_to_nv12_16bit_half,    convert_yc48_to_nv12_16bit_half_avx2,    true,  2 },
+        { "yc48_to_nv12_16bit_quarter_avx2", convert_yc48_to_nv12_16bit_quarter, convert_yc48_to_nv12_16bit_quarter_avx2, true,  4 },
+    };
+    std::mt19937 rng(4701);
+    for (const auto& k : list) {
+        //出力の各planeの大きさを入力の1画素あたりで表す
+        const double bytesPerPixel = ((k.yc48) ? 2.0 : 1.0) / (k.ratio * k.ratio);
+        ConvertKernelTest t = { k.name, AVX2, k.ref, k.func,
+            (k.yc48) ? CONVERT_TEST_INPUT_YC48 : CONVERT_TEST_INPUT_RANDOM, (k.yc48) ? (int)sizeof(PIXEL_YC) : 2, 32, k.ratio * 2,
+            { bytesPerPixel, bytesPerPixel / 2 } };
+        convert_test_run(t, rng, 256);
+    }
+}
+
+// 縦方向の積和: AVX2版がC版と一致すること
+static void test_resize_vertical() {
+    struct {
+        const char *name;
+        func_resize_vertical ref, func;
+        int bytesPerPixel;
+    } list[] = {
+        { "resize_vertical_8bit_avx2",  resize_vertical_8bit,  resize_vertical_8bit_avx2,  1 },
+        { "resize_vertical_16bit_avx2", resize_vertical_16bit, resize_vertical_16bit_avx2, 2 },
+    };
+    std::mt19937 rng(4702);
+    for (const auto& k : list) {
+        if (!test_simd_available(AVX2)) {
+            printf("  %-40s skipped\n", k.name);
+            continue;
+        }
+        const int failCount = g_test_fail_count;
+        for (int taps = 1; taps <= 17 && failCount == g_test_fail_count; taps++) {
+            //合計が1<<RESIZE_WEIGHT_BITSになる重み (bicubicのように負の値も含む)
+            std::vector<short> weight(taps);
+            int sum = 0, k_max = 0;
+            for (int i = 0; i < taps; i++) {
+                weight[i] = (short)((int)(rng() % 4352) - 256);
+                sum += weight[i];
+                if (weight[i] > weight[k_max]) k_max = i;
+            }
+            weight[k_max] += (short)((1 << RESIZE_WEIGHT_BITS) - sum);
+            for (int count = 1; count <= 100; count++) {
+                const int pitch = (count + 7) * k.bytesPerPixel;
+                TestBuffer src((size_t)pitch * taps);
+                test_fill_random(rng, src.data(), src.size());
+                TestBuffer tmp[2] = { TestBuffer(sizeof(int) * count), TestBuffer(sizeof(int) * count) };
+                k.ref((int *)tmp[0].data(), src.data(), pitch, count, weight.data(), taps);
+                k.func((int *)tmp[1].data(), src.data(), pitch, count, weight.data(), taps);
+                if (!tmp[1].guard_ok()) {
+                    TEST_CHECK(false, "%s: taps %d, count %d: out of range write", k.name, taps, count);
+                    break;
+                }
+                if (memcmp(tmp[0].data(), tmp[1].data(), sizeof(int) * count) != 0) {
+                    TEST_CHECK(false, "%s: taps %d, count %d: mismatch", k.name, taps, count);
+                    break;
+                }
+            }
+        }
+        printf("  %-40s %s\n", k.name, (failCount == g_test_fail_count) ? "ok" : "NG");
+    }
+}
+
+// 重みの合計が1<<RESIZE_WEIGHT_BITSとなり、参照範囲が入力に収まること
+static void test_resize_weight() {
+    const int failCount = g_test_fail_count;
+    for (int filter = RESIZE_FILTER_BOX; filter <= RESIZE_FILTER_BICUBIC; filter++) {
+        for (int src_len = 1; src_len <= 96; src_len++) {
+            for (int dst_len = 1; dst_len <= src_len; dst_len++) {
+                RESIZE_PLANE plane;
+                if (!init_resize_plane(&plane, filter, src_len, src_len, dst_len, dst_len, 1)) {
+                    TEST_CHECK(false, "init_resize_plane(%d, %d -> %d) failed", filter, src_len, dst_len);
+                    free_resize_plane(&plane);
+                    continue;
+                }
+                const RESIZE_WEIGHT *w = &plane.wx;
+                bool ok = w->taps >= 1 && w->taps <= src_len;
+                for (int i = 0; ok && i < dst_len; i++) {
+                    int sum = 0;
+                    for (int k = 0; k < w->taps; k++)
+                        sum += w->weight[i * w->taps + k];
+                    ok = sum == (1 << RESIZE_WEIGHT_BITS) && 0 <= w->pos[i] && w->pos[i] + w->taps <= src_len;
+                }
+                TEST_CHECK(ok, "init_resize_plane(filter %d, %d -> %d): invalid weight", filter, src_len, dst_len);
+                free_resize_plane(&plane);
+            }
+        }
+    }
+    //ちょうど1/2の面積平均は、隣接する2画素の平均になる
+    RESIZE_PLANE plane;
+    if (init_resize_plane(&plane, RESIZE_FILTER_BOX, 8, 8, 4, 4, 1)) {
+        for (int i = 0; i < 4; i++) {
+            const short *weight = plane.wx.weight + i * plane.wx.taps;
+            int w0 = -1, w1 = -1;
+            for (int k = 0; k < plane.wx.taps; k++) {
+                const int x = plane.wx.pos[i] + k;
+                if (x == i * 2)     w0 = weight[k];
+                else if (x == i * 2 + 1) w1 = weight[k];
+                else TEST_CHECK(weight[k] == 0, "box 8 -> 4: pixel %d: weight for %d is %d", i, x, weight[k]);
+            }
+            TEST_CHECK(w0 == 8192 && w1 == 8192, "box 8 -> 4: pixel %d: %d, %d", i, w0, w1);
+        }
+    }
+    free_resize_plane(&plane);
+    printf("  %-40s %s\n", "init_resize_weight", (failCount == g_test_fail_count) ? "ok" : "NG");
+}
+
+// インタレ保持の縮小は、フィールドごとにプログレッシブとして縮小して織り込んだものと一致すること
+template<typename Type>
+static void test_resize_frame_interlaced(std::mt19937& rng, func_resize_vertical resize_v, int filter, const char *name) {
+    const int src_w = 64, src_h = 48, dst_w = 40, dst_h = 28; //フィールドの高さは 24 -> 14
+    const int max_value = (sizeof(Type) > 1) ? 1023 : 255;
+    const int ch[2] = { 1, 2 }; //nv12と同じく、輝度と色差 (UVが交互)
+    const int div[2] = { 1, 2 };
+    RESIZE_DATA resize[2] = { 0 }; // [インタレ / フィールド単位のプログレッシブ]
+    std::vector<int> tmp(src_w * 2);
+    for (int r = 0; r < 2; r++) {
+        resize[r].count = 2;
+        resize[r].byte_per_pixel = sizeof(Type);
+        resize[r].max_value = max_value;
+        resize[r].interlaced = (r == 0);
+        resize[r].tmp = tmp.data();
+        resize[r].resize_v = resize_v;
+        for (int i = 0; i < 2; i++) {
+            init_resize_plane(&resize[r].plane[i], filter, src_w / div[i], src_h / div[i] / 2, dst_w / div[i], dst_h / div[i] / 2, ch[i]);
+        }
+    }
+    //入力: 上のフィールドは暗め、下のフィールドは明るめのランダムな値
+    std::vector<Type> src[2], field_src[2][2];
+    for (int i = 0; i < 2; i++) {
+        const int w = src_w / div[i] * ch[i], h = src_h / div[i];
+        src[i].resize(w * h);
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                const int value = (y & 1) ? max_value - (int)(rng() % 64) : (int)(rng() % 64);
+                src[i][y * w + x] = (Type)value;
+                field_src[y & 1][i].push_back((Type)value);
+            }
+        }
+    }
+    std::vector<Type> dst[2];
+    std::vector<Type> field_dst[2][2];
+    CONVERT_CF_DATA src_data = { 0 }, dst_data = { 0 };
+    for (int i = 0; i < 2; i++) {
+        dst[i].resize(dst_w / div[i] * ch[i] * dst_h / div[i]);
+        src_data.data[i] = (BYTE *)src[i].data();
+        dst_data.data[i] = (BYTE *)dst[i].data();
+    }
+    resize_frame(&resize[0], &src_data, &dst_data);
+    for (int field = 0; field < 2; field++) {
+        CONVERT_CF_DATA field_src_data = { 0 }, field_dst_data = { 0 };
+        for (int i = 0; i < 2; i++) {
+            field_dst[field][i].resize(dst[i].size() / 2);
+            field_src_data.data[i] = (BYTE *)field_src[field][i].data();
+            field_dst_data.data[i] = (BYTE *)field_dst[field][i].data();
+        }
+        resize_frame(&resize[1], &field_src_data, &field_dst_data);
+    }
+    bool ok = true;
+    for (int i = 0; i < 2 && ok; i++) {
+        const int w = dst_w / div[i] * ch[i], h = dst_h / div[i];
+        for (int y = 0; y < h && ok; y++) {
+            const Type *expect = field_dst[y & 1][i].data() + (y / 2) * w;
+            for (int x = 0; x < w && ok; x++) {
+                ok = dst[i][y * w + x] == expect[x];
+                TEST_CHECK(ok, "%s: plane %d (%d, %d): %d, expected %d", name, i, x, y, (int)dst[i][y * w + x], (int)expect[x]);
+                //フィールドが混ざっていないこと
+                ok = ok && ((y & 1) ? dst[i][y * w + x] >= max_value - 80 : dst[i][y * w + x] <= 80);
+                TEST_CHECK(ok, "%s: plane %d (%d, %d): %d, fields are mixed", name, i, x, y, (int)dst[i][y * w + x]);
+            }
+        }
+    }
+    for (int r = 0; r < 2; r++)
+        for (int i = 0; i < 2; i++)
+            free_resize_plane(&resize[r].plane[i]);
+}
+
+static void test_resize_frame() {
+    std::mt19937 rng(4703);
+    const int failCount = g_test_fail_count;
+    for (int filter = RESIZE_FILTER_BOX; filter <= RESIZE_FILTER_BICUBIC; filter++) {
+        test_resize_frame_interlaced<BYTE>(rng, resize_vertical_8bit, filter, "resize_frame interlaced 8bit");
+        test_resize_frame_interlaced<USHORT>(rng, resize_vertical_16bit, filter, "resize_frame interlaced 16bit");
+        if (test_simd_available(AVX2)) {
+            test_resize_frame_interlaced<BYTE>(rng, resize_vertical_8bit_avx2, filter, "resize_frame interlaced 8bit avx2");
+            test_resize_frame_interlaced<USHORT>(rng, resize_vertical_16bit_avx2, filter, "resize_frame interlaced 16bit avx2");
+        }
+    }
+    printf("  %-40s %s\n", "resize_frame interlaced", (failCount == g_test_fail_count) ? "ok" : "NG");
+}
+
+int main() {
+    test_shrink();
+    test_resize_vertical();
+    test_resize_weight();
+    test_resize_frame();
+    return test_result("test_convert_resize");
+}
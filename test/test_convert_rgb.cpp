@@ -0,0 +1,153 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#include "test_convert_util.h"
+
+// RGB (AviUtlのDIB: BGR, 下から上, 行は4byte境界) -> YUV444 の変換を検証する
+static const RGY_SIMD SSE41      = RGY_SIMD::SSE2 | RGY_SIMD::SSSE3 | RGY_SIMD::SSE41;
+static const RGY_SIMD AVX        = SSE41 | RGY_SIMD::AVX;
+static const RGY_SIMD AVX2       = AVX | RGY_SIMD::AVX2;
+static const RGY_SIMD AVX512BW   = AVX2 | RGY_SIMD::AVX512F | RGY_SIMD::AVX512BW | RGY_SIMD::AVX512VL;
+static const RGY_SIMD AVX512VBMI = AVX512BW | RGY_SIMD::AVX512VBMI;
+
+struct RGBKernel {
+    const char *name;
+    RGY_SIMD simd;
+    func_convert_frame func;
+    int bitDepth;
+};
+
+static const RGBKernel RGB_TO_YUV444_LIST[] = {
+    { "rgb_to_yuv444",                  RGY_SIMD::NONE, convert_rgb_to_yuv444,                   8 },
+    { "rgb_to_yuv444_sse41",            SSE41,          convert_rgb_to_yuv444_sse41,             8 },
+    { "rgb_to_yuv444_avx",              AVX,            convert_rgb_to_yuv444_avx,               8 },
+    { "rgb_to_yuv444_avx2",             AVX2,           convert_rgb_to_yuv444_avx2,              8 },
+    { "rgb_to_yuv444_avx512bw",         AVX512BW,       convert_rgb_to_yuv444_avx512bw,          8 },
+    { "rgb_to_yuv444_avx512vbmi",       AVX512VBMI,     convert_rgb_to_yuv444_avx512vbmi,        8 },
+    { "rgb_to_yuv444_16bit",            RGY_SIMD::NONE, convert_rgb_to_yuv444_16bit,            16 },
+    { "rgb_to_yuv444_16bit_sse41",      SSE41,          convert_rgb_to_yuv444_16bit_sse41,      16 },
+    { "rgb_to_yuv444_16bit_avx",        AVX,            convert_rgb_to_yuv444_16bit_avx,        16 },
+    { "rgb_to_yuv444_16bit_avx2",       AVX2,           convert_rgb_to_yuv444_16bit_avx2,       16 },
+    { "rgb_to_yuv444_16bit_avx512bw",   AVX512BW,       convert_rgb_to_yuv444_16bit_avx512bw,   16 },
+    { "rgb_to_yuv444_16bit_avx512vbmi", AVX512VBMI,     convert_rgb_to_yuv444_16bit_avx512vbmi, 16 },
+};
+
+// 期待値はCOEFF_RGB2YUVの式 ((係数 * rgb + 16 or 128) * 2^(bit-8) を四捨五入) を倍精度で計算したもの
+// いずれも端数が0.5から十分に離れた値を選んでいる
+struct RGBGolden {
+    uint8_t r, g, b;
+    uint16_t yuv[2][2][3]; // [BT.601/BT.709][8bit/16bit][Y/U/V]
+};
+static const RGBGolden RGB_GOLDEN[] = {
+    {   0,   0,   0, { { {  16, 128, 128 }, {  4096, 32768, 32768 } }, { {  16, 128, 128 }, {  4096, 32768, 32768 } } } },
+    { 255, 255, 255, { { { 255, 128, 128 }, { 65535, 32768, 32768 } }, { { 255, 128, 128 }, { 65535, 32768, 32796 } } } },
+    { 255,   0,   0, { { {  92,  85, 255 }, { 23615, 21753, 65408 } }, { {  70,  99, 255 }, { 17975, 25289, 65408 } } } },
+    {   0, 255,   0, { { { 166,  44,  21 }, { 42415, 11143,  5436 } }, { { 198,  30,  12 }, { 50784,  7607,  3157 } } } },
+    {   0,   0, 255, { { {  45, 255, 107 }, { 11538, 65408, 27460 } }, { {  34, 255, 116 }, {  8809, 65408, 29767 } } } },
+    { 128, 128, 128, { { { 144, 128, 128 }, { 36864, 32768, 32768 } }, { { 144, 128, 128 }, { 36864, 32768, 32782 } } } },
+    { 200, 100,  50, { { { 140,  86, 182 }, { 35891, 22048, 46609 } }, { { 134,  92, 180 }, { 34214, 23435, 46167 } } } },
+    {  30,  60, 220, { { {  85, 213, 100 }, { 21829, 54544, 25597 } }, { {  81, 211, 106 }, { 20781, 54128, 27051 } } } },
+};
+static const int GOLDEN_COUNT = (int)(sizeof(RGB_GOLDEN) / sizeof(RGB_GOLDEN[0]));
+
+static const RGBGolden& golden_pixel(int x, int y) {
+    return RGB_GOLDEN[(x + y * 3) % GOLDEN_COUNT];
+}
+
+static void test_golden(const RGBKernel& k, int colormatrix) {
+    //行末の4byte境界の余白と、SIMDの端数処理の両方を通る幅にする
+    const int width = 135, height = 3;
+    const int srcStep = (width * 3 + 3) & ~3;
+    TestBuffer input((size_t)srcStep * height + 256);
+    memset(input.data(), 0, input.size());
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const auto& px = golden_pixel(x, y);
+            uint8_t *src = input.data() + y * srcStep + x * 3;
+            src[0] = px.b, src[1] = px.g, src[2] = px.r;
+        }
+    }
+    const int bytePerPixel = (k.bitDepth > 8) ? 2 : 1;
+    const size_t planeSize = (size_t)width * height * bytePerPixel;
+    std::unique_ptr<TestBuffer> planes[3];
+    CONVERT_CF_DATA data = { 0 };
+    for (int p = 0; p < 3; p++) {
+        planes[p] = std::make_unique<TestBuffer>(planeSize + CONVERT_TEST_OUTPUT_PAD);
+        data.data[p] = planes[p]->data();
+    }
+    data.colormatrix = colormatrix;
+    data.numa_node = -1;
+    k.func(input.data(), &data, width, height);
+
+    for (int y = 0; y < height; y++) {
+        //入力は下から上なので、出力は上下反転する
+        const int dstY = height - 1 - y;
+        for (int x = 0; x < width; x++) {
+            const auto& expect = golden_pixel(x, y).yuv[colormatrix ? 1 : 0][bytePerPixel - 1];
+            for (int p = 0; p < 3; p++) {
+                const uint8_t *ptr = planes[p]->data() + ((size_t)dstY * width + x) * bytePerPixel;
+                const int value = (bytePerPixel == 2) ? *(const uint16_t *)ptr : *ptr;
+                if (value != expect[p]) {
+                    TEST_CHECK(false, "%s (%s): (%d, %d) plane %d: %d, expected %d",
+                        k.name, colormatrix ? "BT.709" : "BT.601", x, y, p, value, expect[p]);
+                    return;
+                }
+            }
+        }
+    }
+    for (int p = 0; p < 3; p++) {
+        TEST_CHECK(planes[p]->guard_ok(), "%s: plane %d: out of range write", k.name, p);
+    }
+}
+
+int main() {
+    std::mt19937 rng(4303);
+    for (const auto& k : RGB_TO_YUV444_LIST) {
+        if (!test_simd_available(k.simd)) {
+            printf("  %-40s skipped\n", k.name);
+            continue;
+        }
+        const int failCount = g_test_fail_count;
+        for (int colormatrix = 0; colormatrix < 2; colormatrix++) {
+            test_golden(k, colormatrix);
+        }
+        printf("  %-40s golden %s\n", k.name, (failCount == g_test_fail_count) ? "ok" : "NG");
+    }
+
+    //C版と全画素一致すること (幅は1画素単位で変える)
+    for (const auto& k : RGB_TO_YUV444_LIST) {
+        const auto ref = (k.bitDepth > 8) ? convert_rgb_to_yuv444_16bit : convert_rgb_to_yuv444;
+        if (k.func == ref) continue;
+        const double bpp = (k.bitDepth > 8) ? 2.0 : 1.0;
+        for (int colormatrix = 0; colormatrix < 2; colormatrix++) {
+            const std::string name = std::string(k.name) + ((colormatrix) ? " (BT.709)" : " (BT.601)");
+            const ConvertKernelTest t = { name.c_str(), k.simd, ref, k.func, CONVERT_TEST_INPUT_RANDOM, 4, 1, 1, { bpp, bpp, bpp }, colormatrix };
+            convert_test_run(t, rng);
+        }
+    }
+    return test_result("test_convert_rgb");
+}
@@ -0,0 +1,277 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+#include "test_convert_util.h"
+
+// convert_tmpl.hから生成した p012 / yuv444p12 / p210 / y210 / yuv420p10le / yuv420p16le 出力の変換を検証する
+static const RGY_SIMD SSE41 = RGY_SIMD::SSE2 | RGY_SIMD::SSSE3 | RGY_SIMD::SSE41;
+static const RGY_SIMD AVX2  = SSE41 | RGY_SIMD::AVX | RGY_SIMD::AVX2;
+
+enum TmplLayout {
+    TMPL_P012,      // Y + UV (4:2:0)
+    TMPL_P012_I,    // Y + UV (4:2:0 インタレース)
+    TMPL_YUV444_12, // Y + U + V (4:4:4)
+    TMPL_P210,      // Y + UV (4:2:2)
+    TMPL_Y210,      // Y0 U Y1 V (4:2:2)
+    TMPL_YUV420_10,   // Y + U + V (4:2:0, 10bit)
+    TMPL_YUV420_10_I, // Y + U + V (4:2:0 インタレース, 10bit)
+    TMPL_YUV420_16,   // Y + U + V (4:2:0, 16bit)
+    TMPL_YUV420_16_I, // Y + U + V (4:2:0 インタレース, 16bit)
+};
+
+struct TmplKernel {
+    const char *name;
+    RGY_SIMD simd;
+    func_convert_frame func;
+    func_convert_frame ref; // C版
+    bool yc48;
+    TmplLayout layout;
+};
+
+#define TMPL_KERNEL(in, out, yc48, layout) \
+    { #in "_to_" #out,          RGY_SIMD::NONE, convert_ ## in ## _to_ ## out,          convert_ ## in ## _to_ ## out, yc48, layout }, \
+    { #in "_to_" #out "_sse41", SSE41,          convert_ ## in ## _to_ ## out ## _sse41, convert_ ## in ## _to_ ## out, yc48, layout }, \
+    { #in "_to_" #out "_avx2",  AVX2,           convert_ ## in ## _to_ ## out ## _avx2,  convert_ ## in ## _to_ ## out, yc48, layout }
+
+static const TmplKernel TMPL_KERNEL_LIST[] = {
+    TMPL_KERNEL(yc48, p012,         true,  TMPL_P012),
+    TMPL_KERNEL(yc48, p012_i,       true,  TMPL_P012_I),
+    TMPL_KERNEL(yc48, yuv444_12bit, true,  TMPL_YUV444_12),
+    TMPL_KERNEL(yc48, p210,         true,  TMPL_P210),
+    TMPL_KERNEL(yc48, y210,         true,  TMPL_Y210),
+    TMPL_KERNEL(yc48, yuv420_10bit,   true,  TMPL_YUV420_10),
+    TMPL_KERNEL(yc48, yuv420_i_10bit, true,  TMPL_YUV420_10_I),
+    TMPL_KERNEL(yc48, yuv420_16bit,   true,  TMPL_YUV420_16),
+    TMPL_KERNEL(yc48, yuv420_i_16bit, true,  TMPL_YUV420_16_I),
+    TMPL_KERNEL(yuy2, p012,         false, TMPL_P012),
+    TMPL_KERNEL(yuy2, p012_i,       false, TMPL_P012_I),
+    TMPL_KERNEL(yuy2, yuv444_12bit, false, TMPL_YUV444_12),
+    TMPL_KERNEL(yuy2, p210,         false, TMPL_P210),
+    TMPL_KERNEL(yuy2, y210,         false, TMPL_Y210),
+    TMPL_KERNEL(yuy2, yuv420_10bit,   false, TMPL_YUV420_10),
+    TMPL_KERNEL(yuy2, yuv420_i_10bit, false, TMPL_YUV420_10_I),
+    TMPL_KERNEL(yuy2, yuv420_16bit,   false, TMPL_YUV420_16),
+    TMPL_KERNEL(yuy2, yuv420_i_16bit, false, TMPL_YUV420_16_I),
+};
+#undef TMPL_KERNEL
+
+static int tmpl_bits(TmplLayout layout) {
+    switch (layout) {
+        case TMPL_P210:
+        case TMPL_Y210:
+        case TMPL_YUV420_10:
+        case TMPL_YUV420_10_I: return 10;
+        case TMPL_YUV420_16:
+        case TMPL_YUV420_16_I: return 16;
+        default: return 12;
+    }
+}
+// 16bitの上位に詰めて出力するか
+static bool tmpl_msb(TmplLayout layout) {
+    return layout == TMPL_P012 || layout == TMPL_P012_I || layout == TMPL_P210 || layout == TMPL_Y210;
+}
+// 4:2:0 (プログレッシブ / インタレース) か
+static bool tmpl_420(TmplLayout layout) {
+    return layout == TMPL_P012 || layout == TMPL_YUV420_10 || layout == TMPL_YUV420_16;
+}
+static bool tmpl_420i(TmplLayout layout) {
+    return layout == TMPL_P012_I || layout == TMPL_YUV420_10_I || layout == TMPL_YUV420_16_I;
+}
+// 色差が U, V 別々の平面か
+static bool tmpl_chroma_planar(TmplLayout layout) {
+    return layout == TMPL_YUV444_12 || layout >= TMPL_YUV420_10;
+}
+static int tmpl_chroma_div_w(TmplLayout layout) {
+    return (layout == TMPL_YUV444_12) ? 1 : 2;
+}
+static int tmpl_chroma_div_h(TmplLayout layout) {
+    return (tmpl_420(layout) || tmpl_420i(layout)) ? 2 : 1;
+}
+static void tmpl_plane_bytes(TmplLayout layout, double planeBytesPerPixel[4]) {
+    const double list[][4] = {
+        { 2, 1 },    // TMPL_P012
+        { 2, 1 },    // TMPL_P012_I
+        { 2, 2, 2 }, // TMPL_YUV444_12
+        { 2, 2 },    // TMPL_P210
+        { 4 },       // TMPL_Y210
+        { 2, 0.5, 0.5 }, // TMPL_YUV420_10
+        { 2, 0.5, 0.5 }, // TMPL_YUV420_10_I
+        { 2, 0.5, 0.5 }, // TMPL_YUV420_16
+        { 2, 0.5, 0.5 }, // TMPL_YUV420_16_I
+    };
+    memcpy(planeBytesPerPixel, list[layout], sizeof(list[layout]));
+}
+
+// 出力から (x, y) の輝度、(cx, cy) の色差 (c=0:U, 1:V) を取り出す
+static const USHORT *tmpl_sample(const CONVERT_CF_DATA& data, TmplLayout layout, int width, int plane, int x, int y, int c) {
+    const USHORT *const *ptr = (const USHORT *const *)data.data;
+    if (layout == TMPL_Y210) {
+        const USHORT *line = ptr[0] + y * width * 2;
+        return (plane == 0) ? line + (x / 2) * 4 + (x & 1) * 2 : line + x * 4 + 1 + c * 2;
+    }
+    if (plane == 0)
+        return ptr[0] + y * width + x;
+    if (tmpl_chroma_planar(layout))
+        return ptr[1 + c] + y * (width / tmpl_chroma_div_w(layout)) + x;
+    return ptr[1] + y * width + x * 2 + c;
+}
+
+// YC48の代表的な値と、12bit / 10bit / 16bitでの期待値
+// 0, 4096, 2048 はそれぞれ 16, 235, 125.5 (8bit) となり、範囲外は0, (1<<bit)-1 に丸められる
+struct TmplYC48Golden {
+    short y, cb, cr;
+    uint16_t yuv12[3];
+    uint16_t yuv10[3];
+    uint16_t yuv16[3];
+};
+static const TmplYC48Golden TMPL_YC48_GOLDEN[] = {
+    {     0,     0,     0, {  256, 2048, 2048 }, {   64,  512,  512 }, {  4096, 32768, 32768 } },
+    {  4096, -2048,  2048, { 3760,  256, 3840 }, {  940,   64,  960 }, { 60160,  4096, 61440 } },
+    {  2048,  2048, -2048, { 2008, 3840,  256 }, {  502,  960,   64 }, { 32128, 61440,  4096 } },
+    {  4800,     0,     0, { 4095, 2048, 2048 }, { 1023,  512,  512 }, { 65535, 32768, 32768 } },
+    {  -300,     0,     0, {    0, 2048, 2048 }, {    0,  512,  512 }, {     0, 32768, 32768 } },
+};
+static const int TMPL_YC48_GOLDEN_COUNT = (int)(sizeof(TMPL_YC48_GOLDEN) / sizeof(TMPL_YC48_GOLDEN[0]));
+
+// YUY2の入力値 (色差は2画素単位)
+static int tmpl_yuy2_y(int x, int y) { return (x * 37 + y * 59 + 3) & 255; }
+static int tmpl_yuy2_c(int cx, int y, int c) { return (c == 0) ? (cx * 23 + y * 71 + 10) & 255 : (cx * 41 + y * 13 + 200) & 255; }
+
+// YUY2の入力は色変換せず、ビット深度を合わせて色差を縦に補間するだけなので、そのまま期待値を計算する
+static int tmpl_yuy2_expect_chroma(TmplLayout layout, int cx, int cy, int c) {
+    const int bits = tmpl_bits(layout);
+    if (tmpl_420(layout)) { // 縦2行の平均
+        return (tmpl_yuy2_c(cx, cy * 2, c) + tmpl_yuy2_c(cx, cy * 2 + 1, c)) << (bits - 9);
+    }
+    if (tmpl_420i(layout)) { // 同じフィールドの2行を3:1で補間
+        const int y0 = (cy / 2) * 4 + (cy & 1);
+        return (cy & 1)
+            ? (tmpl_yuy2_c(cx, y0, c) + tmpl_yuy2_c(cx, y0 + 2, c) * 3) << (bits - 10)
+            : (tmpl_yuy2_c(cx, y0, c) * 3 + tmpl_yuy2_c(cx, y0 + 2, c)) << (bits - 10);
+    }
+    if (layout == TMPL_YUV444_12)
+        return tmpl_yuy2_c(cx / 2, cy, c) << (bits - 8);
+    return tmpl_yuy2_c(cx, cy, c) << (bits - 8);
+}
+
+static int tmpl_yc48_expect(const TmplYC48Golden& g, int bits, int i) {
+    return (bits == 16) ? g.yuv16[i] : ((bits == 12) ? g.yuv12[i] : g.yuv10[i]);
+}
+
+static void test_golden(const TmplKernel& k) {
+    // AVX2版は16画素単位で処理するので、残りの6画素がC版で処理される幅にする
+    const int width = 38, height = 8;
+    const int bits = tmpl_bits(k.layout);
+    const int shift = (tmpl_msb(k.layout)) ? 16 - bits : 0;
+    TestBuffer input((size_t)width * height * sizeof(PIXEL_YC));
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (k.yc48) {
+                // 色差の補間で値が変わらないよう、2画素ごとに同じ値とする
+                const auto& g = TMPL_YC48_GOLDEN[(x / 2) % TMPL_YC48_GOLDEN_COUNT];
+                PIXEL_YC *ycp = (PIXEL_YC *)input.data() + y * width + x;
+                ycp->y = g.y; ycp->cb = g.cb; ycp->cr = g.cr;
+            } else {
+                uint8_t *ptr = input.data() + (y * width + x) * 2;
+                ptr[0] = (uint8_t)tmpl_yuy2_y(x, y);
+                ptr[1] = (uint8_t)tmpl_yuy2_c(x / 2, y, x & 1);
+            }
+        }
+    }
+    double planeBytesPerPixel[4] = { 0 };
+    tmpl_plane_bytes(k.layout, planeBytesPerPixel);
+    std::unique_ptr<TestBuffer> planes[4];
+    CONVERT_CF_DATA data = { 0 };
+    for (int p = 0; p < 4; p++) {
+        const size_t size = (size_t)(planeBytesPerPixel[p] * width * height);
+        if (size > 0) {
+            planes[p] = std::make_unique<TestBuffer>(size);
+            memset(planes[p]->data(), 0, size);
+            data.data[p] = planes[p]->data();
+        }
+    }
+    k.func(input.data(), &data, width, height);
+
+    auto check = [&](int plane, int x, int y, int c, int expect) {
+        const int raw = *tmpl_sample(data, k.layout, width, plane, x, y, c);
+        if ((raw >> shift) != expect || (raw & ((1 << shift) - 1)) != 0) {
+            TEST_CHECK(false, "%s: (%d, %d) plane %d: 0x%04x, expected 0x%04x", k.name, x, y, plane + c, raw, expect << shift);
+            return false;
+        }
+        return true;
+    };
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const int expect = (k.yc48)
+                ? tmpl_yc48_expect(TMPL_YC48_GOLDEN[(x / 2) % TMPL_YC48_GOLDEN_COUNT], bits, 0)
+                : tmpl_yuy2_y(x, y) << (bits - 8);
+            if (!check(0, x, y, 0, expect)) return;
+        }
+    }
+    const int cw = width / tmpl_chroma_div_w(k.layout);
+    const int ch = height / tmpl_chroma_div_h(k.layout);
+    for (int cy = 0; cy < ch; cy++) {
+        for (int cx = 0; cx < cw; cx++) {
+            for (int c = 0; c < 2; c++) {
+                const int gx = cx * tmpl_chroma_div_w(k.layout) / 2;
+                const int expect = (k.yc48)
+                    ? tmpl_yc48_expect(TMPL_YC48_GOLDEN[gx % TMPL_YC48_GOLDEN_COUNT], bits, 1 + c)
+                    : tmpl_yuy2_expect_chroma(k.layout, cx, cy, c);
+                if (!check(1, cx, cy, c, expect)) return;
+            }
+        }
+    }
+    for (int p = 0; p < 4; p++) {
+        if (planes[p]) {
+            TEST_CHECK(planes[p]->guard_ok(), "%s: plane %d: out of range write", k.name, p);
+        }
+    }
+}
+
+int main() {
+    std::mt19937 rng(4801);
+    for (const auto& k : TMPL_KERNEL_LIST) {
+        if (!test_simd_available(k.simd)) {
+            printf("  %-40s skipped\n", k.name);
+            continue;
+        }
+        const int failCount = g_test_fail_count;
+        test_golden(k);
+        printf("  %-40s golden %s\n", k.name, (failCount == g_test_fail_count) ? "ok" : "NG");
+    }
+
+    //C版と全画素一致すること (YC48 -> yuv444p12は奇数幅にも対応する)
+    for (const auto& k : TMPL_KERNEL_LIST) {
+        if (k.func == k.ref) continue;
+        const int widthStep = (k.yc48 && k.layout == TMPL_YUV444_12) ? 1 : 2;
+        const int heightStep = (tmpl_420i(k.layout)) ? 4 : ((tmpl_420(k.layout)) ? 2 : 1);
+        ConvertKernelTest t = { k.name, k.simd, k.ref, k.func,
+            (k.yc48) ? CONVERT_TEST_INPUT_YC48 : CONVERT_TEST_INPUT_RANDOM, (k.yc48) ? (int)sizeof(PIXEL_YC) : 2, widthStep, heightStep };
+        tmpl_plane_bytes(k.layout, t.planeBytesPerPixel);
+        convert_test_run(t, rng);
+    }
+    return test_result("test_convert_tmpl");
+}
@@ -0,0 +1,148 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#ifndef __AUO_TEST_CONVERT_UTIL_H__
+#define __AUO_TEST_CONVERT_UTIL_H__
+
+#include <memory>
+#include <string>
+#include "convert.h"
+#include "test_util.h"
+
+enum ConvertTestInput {
+    CONVERT_TEST_INPUT_RANDOM = 0, // 任意のバイト列 (YUY2/RGB/LW48など)
+    CONVERT_TEST_INPUT_YC48,       // YC48 (範囲外の値も含む)
+};
+
+// refとfuncの出力が一致することを確認する色変換
+struct ConvertKernelTest {
+    const char *name;
+    RGY_SIMD simd;               // refとfuncの実行に必要なSIMD
+    func_convert_frame ref;
+    func_convert_frame func;
+    ConvertTestInput input;
+    int inputBytesPerPixel;
+    int widthStep;               // 対応する幅の単位 (_modXX版など)
+    int heightStep;              // 対応する高さの単位 (4:2:0は2、インタレースは4)
+    double planeBytesPerPixel[4]; // 各planeの1画素あたりのbyte数 (0なら使用しない)
+    int colormatrix;
+    int dither;
+    int unpremultiply;
+};
+
+// malloc_pixel_data()は各planeの後ろにalign_size * 2 (AVX512では128byte) の余白を確保しており、
+// SIMD版はそこまではみ出して書き込んでもよい
+static const size_t CONVERT_TEST_OUTPUT_PAD = 128;
+
+static void convert_test_fill_input(std::mt19937& rng, ConvertTestInput input, uint8_t *ptr, size_t size) {
+    if (input == CONVERT_TEST_INPUT_YC48) {
+        PIXEL_YC *ycp = (PIXEL_YC *)ptr;
+        for (size_t i = 0; i < size / sizeof(PIXEL_YC); i++) {
+            ycp[i].y  = (short)((int)(rng() % 5000) - 300);
+            ycp[i].cb = (short)((int)(rng() % 4400) - 2200);
+            ycp[i].cr = (short)((int)(rng() % 4400) - 2200);
+        }
+    } else {
+        test_fill_random(rng, ptr, size);
+    }
+}
+
+static bool convert_test_run_size(const ConvertKernelTest& t, std::mt19937& rng, int width, int height) {
+    //SIMD版の読み込みのはみ出し分を確保しておく
+    TestBuffer input((size_t)t.inputBytesPerPixel * width * height + 256);
+    convert_test_fill_input(rng, t.input, input.data(), input.size());
+
+    std::unique_ptr<TestBuffer> planes[2][4];
+    std::unique_ptr<TestBuffer> ditherErr[2];
+    CONVERT_CF_DATA data[2] = { 0 };
+    for (int i = 0; i < 2; i++) {
+        for (int p = 0; p < 4; p++) {
+            const size_t size = (size_t)(t.planeBytesPerPixel[p] * width * height);
+            if (size > 0) {
+                planes[i][p] = std::make_unique<TestBuffer>(size + CONVERT_TEST_OUTPUT_PAD);
+                memset(planes[i][p]->data(), 0, size + CONVERT_TEST_OUTPUT_PAD);
+                data[i].data[p] = planes[i][p]->data();
+            }
+        }
+        data[i].colormatrix = t.colormatrix;
+        data[i].dither = t.dither;
+        data[i].unpremultiply = t.unpremultiply;
+        data[i].numa_node = -1;
+        if (t.dither == DITHER_ERROR_DIFFUSION) {
+            ditherErr[i] = std::make_unique<TestBuffer>(get_dither_err_buf_size(width));
+            memset(ditherErr[i]->data(), 0, ditherErr[i]->size());
+            data[i].dither_err = (short *)ditherErr[i]->data();
+        }
+    }
+    t.ref(input.data(), &data[0], width, height);
+    t.func(input.data(), &data[1], width, height);
+
+    for (int i = 0; i < 2; i++) {
+        if (ditherErr[i] && !ditherErr[i]->guard_ok()) {
+            TEST_CHECK(false, "%s: %dx%d: out of range write to dither_err (%s)", t.name, width, height, (i == 0) ? "ref" : "func");
+            return false;
+        }
+    }
+
+    for (int p = 0; p < 4; p++) {
+        if (!planes[0][p]) continue;
+        const auto& ref = *planes[0][p];
+        const auto& out = *planes[1][p];
+        if (!out.guard_ok() || !ref.guard_ok()) {
+            TEST_CHECK(false, "%s: %dx%d plane %d: out of range write (%s)", t.name, width, height, p, (!out.guard_ok()) ? "func" : "ref");
+            return false;
+        }
+        const size_t size = (size_t)(t.planeBytesPerPixel[p] * width * height);
+        if (memcmp(ref.data(), out.data(), size) != 0) {
+            size_t pos = 0;
+            while (ref.data()[pos] == out.data()[pos]) pos++;
+            TEST_CHECK(false, "%s: %dx%d plane %d: mismatch at byte %d (ref 0x%02x, out 0x%02x)",
+                t.name, width, height, p, (int)pos, ref.data()[pos], out.data()[pos]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// 幅・高さを変えながらrefとfuncの出力を比較する (失敗したら以降のサイズはスキップ)
+static void convert_test_run(const ConvertKernelTest& t, std::mt19937& rng, int maxWidth = 200) {
+    if (!test_simd_available(t.simd)) {
+        printf("  %-40s skipped\n", t.name);
+        return;
+    }
+    const int failCount = g_test_fail_count;
+    for (int height = t.heightStep; height <= t.heightStep * 3; height += t.heightStep) {
+        for (int width = t.widthStep; width <= maxWidth; width += t.widthStep) {
+            if (!convert_test_run_size(t, rng, width, height)) {
+                return;
+            }
+        }
+    }
+    printf("  %-40s %s\n", t.name, (failCount == g_test_fail_count) ? "ok" : "NG");
+}
+
+#endif //__AUO_TEST_CONVERT_UTIL_H__
@@ -0,0 +1,182 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#include "test_convert_util.h"
+
+// 拡張編集のRGBA (BGRA, 下から上) -> YUVA420 / YUVA444 の変換を検証する
+static const RGY_SIMD SSE41 = RGY_SIMD::SSE2 | RGY_SIMD::SSSE3 | RGY_SIMD::SSE41;
+static const RGY_SIMD AVX   = SSE41 | RGY_SIMD::AVX;
+static const RGY_SIMD AVX2  = AVX | RGY_SIMD::AVX2;
+
+struct YUVAKernel {
+    const char *name;
+    RGY_SIMD simd;
+    func_convert_frame func;
+    func_convert_frame ref; // C版
+    bool yuv420;
+    int bitDepth;
+};
+
+#define YUVA_KERNEL(out, yuv420, bits) \
+    { "rgba_to_" #out,          RGY_SIMD::NONE, convert_rgba_to_ ## out,          convert_rgba_to_ ## out, yuv420, bits }, \
+    { "rgba_to_" #out "_sse41", SSE41,          convert_rgba_to_ ## out ## _sse41, convert_rgba_to_ ## out, yuv420, bits }, \
+    { "rgba_to_" #out "_avx",   AVX,            convert_rgba_to_ ## out ## _avx,   convert_rgba_to_ ## out, yuv420, bits }, \
+    { "rgba_to_" #out "_avx2",  AVX2,           convert_rgba_to_ ## out ## _avx2,  convert_rgba_to_ ## out, yuv420, bits }
+
+static const YUVAKernel YUVA_KERNEL_LIST[] = {
+    YUVA_KERNEL(yuva420,       true,   8),
+    YUVA_KERNEL(yuva420_10bit, true,  10),
+    YUVA_KERNEL(yuva420_16bit, true,  16),
+    YUVA_KERNEL(yuva444,       false,  8),
+    YUVA_KERNEL(yuva444_10bit, false, 10),
+    YUVA_KERNEL(yuva444_16bit, false, 16),
+};
+#undef YUVA_KERNEL
+
+// 期待値はBT.601の係数で ((係数 * rgb + 16 or 128) * 2^(bit-8) を四捨五入) を倍精度で計算したもの
+// unpremultiplyでは rgb * 255 / a (255で飽和) としてから変換し、a = 0 なら黒とする
+// アルファは上位ビットを下位に複製するので、255は1023, 65535になる
+struct YUVAGolden {
+    uint8_t b, g, r, a;
+    uint16_t yuv[2][3][3]; // [unpremultiply][8bit/10bit/16bit][Y/U/V]
+    uint16_t alpha[3];     // [8bit/10bit/16bit]
+};
+static const YUVAGolden YUVA_GOLDEN[] = {
+    {   0,   0,   0,   0, { { {  16, 128, 128 }, {   64, 512, 512 }, {  4096, 32768, 32768 } },
+                            { {  16, 128, 128 }, {   64, 512, 512 }, {  4096, 32768, 32768 } } }, {   0,    0,     0 } },
+    { 255, 255, 255, 255, { { { 255, 128, 128 }, { 1023, 512, 512 }, { 65535, 32768, 32768 } },
+                            { { 255, 128, 128 }, { 1023, 512, 512 }, { 65535, 32768, 32768 } } }, { 255, 1023, 65535 } },
+    {  25, 101,  52, 128, { { {  94,  98, 110 }, {  375, 393, 439 }, { 23983, 25157, 28078 } },
+                            { { 171,  69,  92 }, {  683, 275, 366 }, { 43715, 17605, 23425 } } }, { 128,  514, 32896 } },
+    {  60,  31, 200, 255, { { { 101, 114, 210 }, {  403, 456, 841 }, { 25814, 29180, 53796 } },
+                            { { 101, 114, 210 }, {  403, 456, 841 }, { 25814, 29180, 53796 } } }, { 255, 1023, 65535 } },
+    {  10,  20,  30,  64, { { {  38, 121, 134 }, {  151, 485, 535 }, {  9690, 31056, 34256 } },
+                            { { 103, 101, 151 }, {  412, 405, 605 }, { 26383, 25947, 38697 } } }, {  64,  257, 16448 } },
+    { 200,  10,  10, 100, { { {  48, 223, 113 }, {  191, 892, 450 }, { 12201, 57088, 28813 } }, // 乗算済みとしては不正な値 (rgb > a)
+                            { {  68, 243, 109 }, {  271, 971, 437 }, { 17322, 62144, 27991 } } }, { 100,  401, 25700 } },
+};
+static const int YUVA_GOLDEN_COUNT = (int)(sizeof(YUVA_GOLDEN) / sizeof(YUVA_GOLDEN[0]));
+
+// 入力の (x, y) の画素 (色差の平均で値が変わらないよう、2x2画素ごとに同じ値とする)
+static const YUVAGolden& yuva_golden_pixel(int x, int y) {
+    return YUVA_GOLDEN[(x / 2 + (y / 2) * 5) % YUVA_GOLDEN_COUNT];
+}
+
+static int yuva_bit_index(int bitDepth) {
+    return (bitDepth == 8) ? 0 : ((bitDepth == 10) ? 1 : 2);
+}
+
+static void test_golden(const YUVAKernel& k, int unpremultiply) {
+    // SIMD版の端数処理も通るよう、16で割り切れない幅にする
+    const int width = 38, height = 4;
+    const int bitIdx = yuva_bit_index(k.bitDepth);
+    const int bytesPerPixel = (k.bitDepth > 8) ? 2 : 1;
+    TestBuffer input((size_t)width * height * 4);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const auto& g = yuva_golden_pixel(x, y);
+            uint8_t *ptr = input.data() + (y * width + x) * 4;
+            ptr[0] = g.b; ptr[1] = g.g; ptr[2] = g.r; ptr[3] = g.a;
+        }
+    }
+    const int cw = (k.yuv420) ? width / 2 : width;
+    const int ch = (k.yuv420) ? height / 2 : height;
+    const size_t planeSize[4] = {
+        (size_t)width * height * bytesPerPixel, (size_t)cw * ch * bytesPerPixel, (size_t)cw * ch * bytesPerPixel, (size_t)width * height * bytesPerPixel
+    };
+    std::unique_ptr<TestBuffer> planes[4];
+    CONVERT_CF_DATA data = { 0 };
+    for (int p = 0; p < 4; p++) {
+        planes[p] = std::make_unique<TestBuffer>(planeSize[p] + CONVERT_TEST_OUTPUT_PAD);
+        memset(planes[p]->data(), 0, planes[p]->size());
+        data.data[p] = planes[p]->data();
+    }
+    data.unpremultiply = unpremultiply;
+    k.func(input.data(), &data, width, height);
+
+    auto sample = [&](int plane, int x, int y, int pitch) {
+        return (bytesPerPixel == 2) ? (int)((const uint16_t *)data.data[plane])[y * pitch + x] : (int)data.data[plane][y * pitch + x];
+    };
+    auto check = [&](int plane, int x, int y, int pitch, int expect) {
+        const int value = sample(plane, x, y, pitch);
+        if (value != expect) {
+            TEST_CHECK(false, "%s (unpremultiply=%d): plane %d (%d, %d): %d, expected %d", k.name, unpremultiply, plane, x, y, value, expect);
+            return false;
+        }
+        return true;
+    };
+    // 出力は上から下へ並べ替えられる
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const auto& g = yuva_golden_pixel(x, height - 1 - y);
+            if (!check(0, x, y, width, g.yuv[unpremultiply][bitIdx][0])) return;
+            if (!check(3, x, y, width, g.alpha[bitIdx])) return;
+        }
+    }
+    const int div = (k.yuv420) ? 2 : 1;
+    for (int cy = 0; cy < ch; cy++) {
+        for (int cx = 0; cx < cw; cx++) {
+            const auto& g = yuva_golden_pixel(cx * div, height - 1 - cy * div);
+            if (!check(1, cx, cy, cw, g.yuv[unpremultiply][bitIdx][1])) return;
+            if (!check(2, cx, cy, cw, g.yuv[unpremultiply][bitIdx][2])) return;
+        }
+    }
+    for (int p = 0; p < 4; p++) {
+        TEST_CHECK(planes[p]->guard_ok(), "%s: plane %d: out of range write", k.name, p);
+    }
+}
+
+int main() {
+    std::mt19937 rng(4601);
+    for (const auto& k : YUVA_KERNEL_LIST) {
+        if (!test_simd_available(k.simd)) {
+            printf("  %-40s skipped\n", k.name);
+            continue;
+        }
+        const int failCount = g_test_fail_count;
+        test_golden(k, 0);
+        test_golden(k, 1);
+        printf("  %-40s golden %s\n", k.name, (failCount == g_test_fail_count) ? "ok" : "NG");
+    }
+
+    //C版と全画素一致すること (YUVA420は偶数幅・偶数高さ、YUVA444は奇数幅・奇数高さにも対応する)
+    for (const auto& k : YUVA_KERNEL_LIST) {
+        if (k.func == k.ref) continue;
+        const double bytesPerPixel = (k.bitDepth > 8) ? 2 : 1;
+        const double chromaBytesPerPixel = (k.yuv420) ? bytesPerPixel / 4 : bytesPerPixel;
+        const int step = (k.yuv420) ? 2 : 1;
+        for (int unpremultiply = 0; unpremultiply < 2; unpremultiply++) {
+            for (int colormatrix = 0; colormatrix < 2; colormatrix++) {
+                const std::string name = std::string(k.name) + ((unpremultiply) ? " unpremul" : "") + ((colormatrix) ? " bt709" : "");
+                ConvertKernelTest t = { name.c_str(), k.simd, k.ref, k.func, CONVERT_TEST_INPUT_RANDOM, 4, step, step,
+                    { bytesPerPixel, chromaBytesPerPixel, chromaBytesPerPixel, bytesPerPixel }, colormatrix, DITHER_NONE, unpremultiply };
+                convert_test_run(t, rng);
+            }
+        }
+    }
+    return test_result("test_convert_yuva");
+}
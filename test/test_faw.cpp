@@ -0,0 +1,280 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#include <array>
+#include <algorithm>
+#include "rgy_faw.h"
+#include "test_util.h"
+
+// 削除前のfaw_read_half()と同じ変換 (16bit sampleの上位/下位byteから0x80を引く)
+template<bool upperhalf>
+static uint8_t faw_read_half_ref(const uint16_t v) {
+    uint8_t i = (upperhalf) ? (v & 0xff00) >> 8 : (v & 0xff);
+    return i - 0x80;
+}
+
+struct FAWKernelChecksum {
+    const char *name;
+    RGY_SIMD simd;
+    decltype(rgy_faw_checksum_c)* func;
+};
+struct FAWKernel16to8 {
+    const char *name;
+    RGY_SIMD simd;
+    decltype(rgy_convert_audio_16to8)* func;
+};
+struct FAWKernelSplit {
+    const char *name;
+    RGY_SIMD simd;
+    decltype(rgy_split_audio_16to8x2)* func;
+};
+
+static const FAWKernelChecksum FAW_CHECKSUM_LIST[] = {
+    { "checksum_avx2",     RGY_SIMD::AVX2,     rgy_faw_checksum_avx2 },
+    { "checksum_avx512bw", RGY_SIMD::AVX512BW, rgy_faw_checksum_avx512bw },
+};
+static const FAWKernel16to8 FAW_16TO8_LIST[] = {
+    { "16to8_c",           RGY_SIMD::NONE,     rgy_convert_audio_16to8 },
+    { "16to8_avx2",        RGY_SIMD::AVX2,     rgy_convert_audio_16to8_avx2 },
+    { "16to8_avx512bw",    RGY_SIMD::AVX512BW, rgy_convert_audio_16to8_avx512bw },
+};
+static const FAWKernelSplit FAW_SPLIT_LIST[] = {
+    { "split_c",           RGY_SIMD::NONE,     rgy_split_audio_16to8x2 },
+    { "split_avx2",        RGY_SIMD::AVX2,     rgy_split_audio_16to8x2_avx2 },
+    { "split_avx512bw",    RGY_SIMD::AVX512BW, rgy_split_audio_16to8x2_avx512bw },
+};
+
+// 長さと先頭のずれを変えて、SIMD版のchecksumがC版と一致するか
+static void test_checksum(const std::vector<uint8_t>& payload, const char *desc) {
+    for (const auto& k : FAW_CHECKSUM_LIST) {
+        if (!test_simd_available(k.simd)) continue;
+        const size_t maxlen = std::min<size_t>(payload.size(), 1100);
+        for (size_t misalign = 0; misalign < 64; misalign += 3) {
+            for (size_t len = 0; len <= maxlen; len += (len < 300) ? 1 : 37) {
+                TestBuffer buf(len, misalign);
+                memcpy(buf.data(), payload.data(), len);
+                const auto ref = rgy_faw_checksum_c(buf.data(), len);
+                const auto ret = k.func(buf.data(), len);
+                TEST_CHECK(ref == ret, "%s %s: len=%zu misalign=%zu: %08x != %08x", k.name, desc, len, misalign, ret, ref);
+            }
+        }
+        // 16bitの和があふれる長さ
+        TestBuffer buf(payload.size(), 1);
+        memcpy(buf.data(), payload.data(), payload.size());
+        const auto ref = rgy_faw_checksum_c(buf.data(), buf.size());
+        const auto ret = k.func(buf.data(), buf.size());
+        TEST_CHECK(ref == ret, "%s %s: len=%zu: %08x != %08x", k.name, desc, buf.size(), ret, ref);
+    }
+}
+
+// 16bit -> 8bitの変換と2ストリームへの分離がfaw_read_half()と一致し、範囲外に書き込まないか
+static void test_unpack(const std::vector<uint8_t>& payload, const char *desc) {
+    const size_t maxn = std::min<size_t>(payload.size() / sizeof(short), 700);
+    for (size_t misalign = 0; misalign < 64; misalign += 6) {
+        for (size_t n = 0; n <= maxn; n += (n < 260) ? 1 : 29) {
+            TestBuffer src(n * sizeof(short), misalign);
+            memcpy(src.data(), payload.data(), n * sizeof(short));
+            std::vector<uint8_t> ref0(n), ref1(n);
+            for (size_t i = 0; i < n; i++) {
+                uint16_t v;
+                memcpy(&v, src.data() + i * sizeof(short), sizeof(v));
+                ref0[i] = faw_read_half_ref<true>(v);
+                ref1[i] = faw_read_half_ref<false>(v);
+            }
+            for (const auto& k : FAW_16TO8_LIST) {
+                if (!test_simd_available(k.simd)) continue;
+                TestBuffer dst(n, misalign / 2);
+                k.func(dst.data(), (const short *)src.data(), n);
+                TEST_CHECK(memcmp(dst.data(), ref0.data(), n) == 0, "%s %s: n=%zu misalign=%zu: mismatch", k.name, desc, n, misalign);
+                TEST_CHECK(dst.guard_ok(), "%s %s: n=%zu misalign=%zu: out of range write", k.name, desc, n, misalign);
+            }
+            for (const auto& k : FAW_SPLIT_LIST) {
+                if (!test_simd_available(k.simd)) continue;
+                TestBuffer dst0(n, misalign / 2), dst1(n, misalign / 3);
+                k.func(dst0.data(), dst1.data(), (const short *)src.data(), n);
+                TEST_CHECK(memcmp(dst0.data(), ref0.data(), n) == 0, "%s %s: n=%zu misalign=%zu: dst0 mismatch", k.name, desc, n, misalign);
+                TEST_CHECK(memcmp(dst1.data(), ref1.data(), n) == 0, "%s %s: n=%zu misalign=%zu: dst1 mismatch", k.name, desc, n, misalign);
+                TEST_CHECK(dst0.guard_ok() && dst1.guard_ok(), "%s %s: n=%zu misalign=%zu: out of range write", k.name, desc, n, misalign);
+            }
+            TEST_CHECK(src.guard_ok(), "%s: n=%zu: source modified", desc, n);
+        }
+    }
+}
+
+// 無音のAACフレーム (rgy_faw.cppのaac_silent1/aac_silent2と同じ)
+static const std::array<uint8_t, 13> AAC_SILENT_MONO = {
+    0xFF, 0xF9, 0x4C, 0x40, 0x01, 0xBF, 0xFC, 0x00,
+    0xC8, 0x40, 0x80, 0x23, 0x80
+};
+static const std::array<uint8_t, 16> AAC_SILENT_STEREO = {
+    0xFF, 0xF9, 0x4C, 0x80, 0x02, 0x1F, 0xFC, 0x21,
+    0x00, 0x49, 0x90, 0x02, 0x19, 0x00, 0x23, 0x80
+};
+
+// ADTSのフレームを並べる
+// 実際の無音フレームと、ペイロードが乱数のフレームを混ぜる
+static std::vector<uint8_t> make_adts(std::mt19937& rng, int nframes) {
+    std::vector<uint8_t> out;
+    for (int i = 0; i < nframes; i++) {
+        if (rng() % 4 == 0) {
+            out.insert(out.end(), AAC_SILENT_STEREO.begin(), AAC_SILENT_STEREO.end());
+            continue;
+        }
+        const int len = 20 + rng() % 400;
+        std::vector<uint8_t> frame(len);
+        frame[0] = 0xFF;
+        frame[1] = 0xF9;
+        frame[2] = 0x4C;
+        frame[3] = (uint8_t)(0x80 | ((len >> 11) & 3));
+        frame[4] = (uint8_t)((len >> 3) & 0xff);
+        frame[5] = (uint8_t)(((len & 7) << 5) | 0x1f);
+        frame[6] = 0xFC;
+        for (int j = 7; j < len; j++) {
+            const auto r = rng() % 10;
+            frame[j] = (r < 3) ? 0x00 : (uint8_t)(rng() % 0xff); // 同期語(0xFF)は含めない
+        }
+        out.insert(out.end(), frame.begin(), frame.end());
+    }
+    return out;
+}
+
+static std::vector<uint8_t> faw_encode(const RGYWAVHeader& header, const std::vector<uint8_t>& adts) {
+    RGYFAWEncoder enc;
+    enc.init(&header, RGYFAWMode::Full, 0);
+    std::vector<uint8_t> pcm, out;
+    for (size_t pos = 0; pos < adts.size(); pos += 777) {
+        enc.encode(out, adts.data() + pos, std::min<size_t>(777, adts.size() - pos));
+        pcm.insert(pcm.end(), out.begin(), out.end());
+    }
+    enc.fin(out);
+    pcm.insert(pcm.end(), out.begin(), out.end());
+    return pcm;
+}
+
+static std::array<std::vector<uint8_t>, 2> faw_decode(const RGYWAVHeader& header, const std::vector<uint8_t>& pcm, const size_t chunk) {
+    RGYFAWDecoder dec;
+    dec.init(&header);
+    RGYFAWDecoderOutput output;
+    std::array<std::vector<uint8_t>, 2> result;
+    auto append = [&]() {
+        for (size_t i = 0; i < result.size(); i++) {
+            result[i].insert(result[i].end(), output[i].begin(), output[i].end());
+        }
+    };
+    for (size_t pos = 0; pos < pcm.size(); pos += chunk) {
+        dec.decode(output, pcm.data() + pos, std::min(chunk, pcm.size() - pos));
+        append();
+    }
+    dec.fin(output);
+    append();
+    return result;
+}
+
+static RGYWAVHeader make_wav_header(int bits) {
+    RGYWAVHeader header = { 0 };
+    header.audio_format = 1;
+    header.number_of_channels = 2;
+    header.sample_rate = 48000;
+    header.bits_per_sample = (uint16_t)bits;
+    header.block_align = (uint16_t)(header.number_of_channels * bits / 8);
+    header.byte_rate = header.sample_rate * header.block_align;
+    return header;
+}
+
+// 8bitのFAWを2つ、16bitの上位/下位byteに入れたもの (FAW Mix)
+static std::vector<uint8_t> make_faw_mix(const std::vector<uint8_t>& half0, const std::vector<uint8_t>& half1) {
+    const size_t n = (std::max(half0.size(), half1.size()) + 1) & ~(size_t)1;
+    std::vector<uint8_t> pcm(n * sizeof(short));
+    for (size_t i = 0; i < n; i++) {
+        const uint8_t v0 = (i < half0.size()) ? half0[i] : 0x80;
+        const uint8_t v1 = (i < half1.size()) ? half1[i] : 0x80;
+        pcm[i * 2 + 0] = (uint8_t)(v1 - 0x80);
+        pcm[i * 2 + 1] = (uint8_t)(v0 - 0x80);
+    }
+    return pcm;
+}
+
+static bool is_adts_with_silence(const std::vector<uint8_t>& decoded, const std::vector<uint8_t>& adts) {
+    if (decoded.size() < adts.size()
+        || !std::equal(adts.begin(), adts.end(), decoded.begin())
+        || (decoded.size() - adts.size()) % AAC_SILENT_STEREO.size() != 0) {
+        return false;
+    }
+    for (size_t pos = adts.size(); pos < decoded.size(); pos += AAC_SILENT_STEREO.size()) {
+        if (!std::equal(AAC_SILENT_STEREO.begin(), AAC_SILENT_STEREO.end(), decoded.begin() + pos)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// FAWのエンコード・デコードで元のADTSに戻り、SIMDの有無で結果が変わらないか
+static void test_roundtrip(std::mt19937& rng, std::vector<uint8_t>& fawFull, std::vector<uint8_t>& fawMix) {
+    const auto header16 = make_wav_header(16);
+    const auto header8 = make_wav_header(8);
+    const auto adts0 = make_adts(rng, 300);
+    const auto adts1 = make_adts(rng, 250);
+
+    fawFull = faw_encode(header16, adts0);
+    fawMix = make_faw_mix(faw_encode(header8, adts0), faw_encode(header8, adts1));
+
+    for (const size_t chunk : { (size_t)4096, (size_t)1000, (size_t)65536 }) {
+        set_simd_limit(RGY_SIMD::NONE);
+        const auto refFull = faw_decode(header16, fawFull, chunk);
+        const auto refMix = faw_decode(header16, fawMix, chunk);
+        set_simd_limit(RGY_SIMD::SIMD_ALL);
+        const auto simdFull = faw_decode(header16, fawFull, chunk);
+        const auto simdMix = faw_decode(header16, fawMix, chunk);
+
+        TEST_CHECK(refFull[0] == adts0, "full chunk=%zu: decoded %zu bytes, expected %zu", chunk, refFull[0].size(), adts0.size());
+        TEST_CHECK(refMix[0] == adts0, "mix chunk=%zu: decoded %zu bytes, expected %zu", chunk, refMix[0].size(), adts0.size());
+        // 短いほうのストリームは、長さを合わせるため末尾に無音が挿入される
+        TEST_CHECK(is_adts_with_silence(refMix[1], adts1), "mix chunk=%zu: decoded %zu bytes, expected %zu + silence", chunk, refMix[1].size(), adts1.size());
+        TEST_CHECK(simdFull == refFull, "full chunk=%zu: SIMD result differs", chunk);
+        TEST_CHECK(simdMix == refMix, "mix chunk=%zu: SIMD result differs", chunk);
+    }
+}
+
+int main() {
+    std::mt19937 rng(12345);
+
+    std::vector<uint8_t> fawFull, fawMix;
+    test_roundtrip(rng, fawFull, fawMix);
+
+    std::vector<uint8_t> random(1 << 20);
+    test_fill_random(rng, random.data(), random.size());
+    std::vector<uint8_t> ones(1 << 17, 0xff);
+
+    test_checksum(random, "random");
+    test_checksum(ones, "0xff");
+    test_checksum(fawFull, "faw");
+
+    test_unpack(random, "random");
+    test_unpack(fawFull, "faw full");
+    test_unpack(fawMix, "faw mix");
+    return test_result("test_faw");
+}
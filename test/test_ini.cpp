@@ -0,0 +1,206 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include "rgy_osdep.h"
+#include "rgy_ini.h"
+#include "test_util.h"
+
+static std::string read_file(const std::filesystem::path& path) {
+    std::ifstream ifs(path, std::ios::in | std::ios::binary);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    return ss.str();
+}
+
+static void write_file(const std::filesystem::path& path, const std::string& str) {
+    std::ofstream ofs(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    ofs.write(str.c_str(), str.length());
+}
+
+// 読み込んで変更せずに書き出すと、元と同じになること
+static void test_roundtrip() {
+    const char *inputs[] = {
+        "",
+        "[A]\r\nkey=value\r\n",
+        "\xEF\xBB\xBF; comment\n[A]\nkey = value \n\n[B]\nx=1\ny=2\n",
+        "orphan=1\r\n[A]\r\n  key=value\r\n; comment=1\r\n\r\n[A]\r\nkey=dup\r\n",
+        "[A]\nkey=value", // 最後の改行なし
+    };
+    const char *expects[] = {
+        "",
+        "[A]\r\nkey=value\r\n",
+        "\xEF\xBB\xBF; comment\n[A]\nkey = value \n\n[B]\nx=1\ny=2\n",
+        "orphan=1\r\n[A]\r\n  key=value\r\n; comment=1\r\n\r\n[A]\r\nkey=dup\r\n",
+        "[A]\nkey=value\n",
+    };
+    for (size_t i = 0; i < _countof(inputs); i++) {
+        RGYIniFile ini;
+        TEST_CHECK(ini.parse(inputs[i], strlen(inputs[i])) == 0, "roundtrip %d: parse failed", (int)i);
+        TEST_CHECK(ini.toString() == expects[i], "roundtrip %d: mismatch", (int)i);
+    }
+    const char utf16[] = "\xFF\xFE[\0A\0]\0";
+    RGYIniFile ini;
+    TEST_CHECK(ini.parse(utf16, sizeof(utf16) - 1) != 0 && !ini.isLoaded(), "utf16 should be rejected");
+}
+
+// GetPrivateProfileString/Int/Section互換の読み取り
+static void test_get() {
+    const std::string str =
+        "orphan=1\n"
+        "[Main]\n"
+        "Key = \"quoted\" \n"
+        "num=0x1F\n"
+        "neg=-12abc\n"
+        "; key=comment\n"
+        "key=dup\n"
+        "[main]\n"
+        "other=1\n";
+    RGYIniFile ini;
+    ini.parse(str.c_str(), str.length());
+    TEST_CHECK(ini.hasSection("MAIN"), "hasSection");
+    TEST_CHECK(ini.getSectionNames() == std::vector<std::string>{ "Main" }, "getSectionNames");
+    TEST_CHECK(ini.getString("main", "KEY", "") == "quoted", "getString quoted");
+    TEST_CHECK(ini.getString("main", "none", "def  ") == "def", "getString default");
+    TEST_CHECK(ini.getString("main", "other", "x") == "x", "duplicate section should be ignored");
+    TEST_CHECK(ini.getInt("main", "num", 0) == 31, "getInt hex");
+    TEST_CHECK(ini.getInt("main", "neg", 0) == -12, "getInt negative");
+    char buf[8];
+    TEST_CHECK(ini.getString("main", "key", "", buf, sizeof(buf)) == 6 && strcmp(buf, "quoted") == 0, "getString buf");
+    TEST_CHECK(ini.getString("main", "num", "", buf, 3) == 2 && strcmp(buf, "0x") == 0, "getString truncate");
+    char sec[256];
+    const size_t len = ini.getSection("main", sec, sizeof(sec));
+    const char expect[] = "Key=\"quoted\"\0num=0x1F\0neg=-12abc\0key=dup\0";
+    TEST_CHECK(len == sizeof(expect) - 1 && memcmp(sec, expect, sizeof(expect)) == 0, "getSection");
+}
+
+// キーの追加・更新・削除とセクションの削除
+static void test_set() {
+    const std::string str =
+        "[A]\r\n"
+        "a=1\r\n"
+        "b=2\r\n"
+        "\r\n"
+        "[B]\r\n"
+        "x=1\r\n"
+        "x=2\r\n"
+        "\r\n"
+        "[C]\r\n"
+        "c=1\r\n";
+    RGYIniFile ini;
+    ini.parse(str.c_str(), str.length());
+    ini.setString("A", "a", "1");
+    TEST_CHECK(!ini.isDirty(), "same value should not be dirty");
+    ini.setString("a", "b", "3");
+    ini.setString("A", "new", "4");
+    ini.setString("A", "a", nullptr);
+    ini.setString("B", "x", nullptr);
+    ini.setString("D", "d", "5");
+    ini.setString("D", "e", "6");
+    ini.setString("C", nullptr, nullptr);
+    TEST_CHECK(ini.isDirty(), "should be dirty");
+    TEST_CHECK(ini.getString("A", "new", "") == "4", "new key");
+    TEST_CHECK(ini.getString("B", "x", "") == "2", "duplicate key should be visible after remove");
+    TEST_CHECK(!ini.hasSection("C"), "removed section");
+    TEST_CHECK(ini.getString("D", "e", "") == "6", "new section");
+    const std::string expect =
+        "[A]\r\n"
+        "b=3\r\n"
+        "new=4\r\n"
+        "\r\n"
+        "[B]\r\n"
+        "x=2\r\n"
+        "\r\n"
+        "[D]\r\n"
+        "d=5\r\n"
+        "e=6\r\n";
+    TEST_CHECK(ini.toString() == expect, "set result mismatch:\n%s", ini.toString().c_str());
+
+    //全体を読み込みなおした場合と索引が一致すること
+    RGYIniFile reparsed;
+    const auto out = ini.toString();
+    reparsed.parse(out.c_str(), out.length());
+    for (const char *section : { "A", "B", "D" }) {
+        for (const char *key : { "a", "b", "new", "x", "d", "e" }) {
+            const auto v0 = ini.getValue(section, key);
+            const auto v1 = reparsed.getValue(section, key);
+            TEST_CHECK((v0 == nullptr) == (v1 == nullptr) && (!v0 || *v0 == *v1), "index mismatch [%s] %s", section, key);
+        }
+    }
+}
+
+// 保存時に他のプロセスによる変更を消さないこと
+static void test_save(const std::filesystem::path& dir) {
+    const auto path = dir / "test_ini.ini";
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    RGYIniFile ini;
+    TEST_CHECK(ini.load(path.string().c_str()) == 0, "load nonexistent file");
+    ini.setString("A", "a", "1");
+    TEST_CHECK(ini.save() == 0, "save new file");
+    TEST_CHECK(read_file(path) == "[A]\r\na=1\r\n", "saved new file mismatch");
+
+    //他のプロセスが書き込んだ後に保存する
+    ini.setString("A", "b", "2");
+    ini.setString("A", "a", "3");
+    write_file(path, "\xEF\xBB\xBF[A]\na=1\nother=x\n[Other]\ny=1\n");
+    //更新日時の分解能が粗い場合でも変更を検出できるよう、サイズも変えている
+    TEST_CHECK(ini.save() == 0, "save merged");
+    TEST_CHECK(read_file(path) == "\xEF\xBB\xBF[A]\na=3\nother=x\nb=2\n[Other]\ny=1\n", "merged file mismatch:\n%s", read_file(path).c_str());
+    TEST_CHECK(!ini.isDirty(), "should not be dirty after save");
+
+    //読み込みなおしでも未保存の変更は残ること
+    ini.setString("Other", nullptr, nullptr);
+    write_file(path, "[A]\na=0\n[Other]\ny=2\n[New]\nz=1\n");
+    ini.reloadIfModified();
+    TEST_CHECK(ini.getString("New", "z", "") == "1" && ini.getString("A", "a", "") == "0", "reload should read external change");
+    TEST_CHECK(!ini.hasSection("Other") && ini.isDirty(), "reload should keep pending change");
+    TEST_CHECK(ini.save() == 0, "save after reload");
+    TEST_CHECK(read_file(path) == "[A]\na=0\n[New]\nz=1\n", "saved file after reload mismatch");
+
+    //一時ファイルが残っていないこと
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        TEST_CHECK(entry.path().extension() != ".tmp", "temporary file left: %s", entry.path().string().c_str());
+    }
+    std::filesystem::remove(path, ec);
+}
+
+int main() {
+    test_roundtrip();
+    test_get();
+    test_set();
+    const auto dir = std::filesystem::temp_directory_path() / ("test_ini_" + std::to_string(GetCurrentProcessId()));
+    std::filesystem::create_directories(dir);
+    test_save(dir);
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+    return test_result("test_ini");
+}
@@ -0,0 +1,153 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#include <string>
+#include "rgy_osdep.h"
+#include "auo_timestamp.h"
+#include "test_util.h"
+
+static std::string fixed6(uint64_t num, uint64_t den, bool round_down) {
+    char buf[32];
+    const int len = format_fixed6(buf, num, den, round_down);
+    TEST_CHECK(len == (int)strlen(buf), "format_fixed6(%llu, %llu): length %d != %d", (unsigned long long)num, (unsigned long long)den, len, (int)strlen(buf));
+    return std::string(buf);
+}
+
+// "整数部.小数部6桁" を1e-6単位の整数にする
+static uint64_t parse_fixed6(const std::string& str) {
+    const size_t pos = str.find('.');
+    if (pos == std::string::npos || str.length() - pos - 1 != 6)
+        return UINT64_MAX;
+    return std::stoull(str.substr(0, pos)) * 1000000 + std::stoull(str.substr(pos + 1));
+}
+
+static void test_format_fixed6() {
+    struct {
+        uint64_t num, den;
+        const char *nearest, *down;
+    } list[] = {
+        {          0,          1, "0.000000",     "0.000000" },
+        {          1,          3, "0.333333",     "0.333333" },
+        {          2,          3, "0.666667",     "0.666666" },
+        {       1001,      30000, "0.033367",     "0.033366" },
+        {  999999999, 1000000000, "1.000000",     "0.999999" }, // 四捨五入で整数部に繰り上がる
+        {    1000001,    1000000, "1.000001",     "1.000001" },
+        { 12345000005ull, 1000000, "12345.000005", "12345.000005" },
+        {          5,   10000000, "0.000001",     "0.000000" }, // 0.0000005
+    };
+    for (const auto& t : list) {
+        const auto nearest = fixed6(t.num, t.den, false);
+        const auto down = fixed6(t.num, t.den, true);
+        TEST_CHECK(nearest == t.nearest, "format_fixed6(%llu, %llu, nearest): %s, expected %s", (unsigned long long)t.num, (unsigned long long)t.den, nearest.c_str(), t.nearest);
+        TEST_CHECK(down == t.down, "format_fixed6(%llu, %llu, down): %s, expected %s", (unsigned long long)t.num, (unsigned long long)t.den, down.c_str(), t.down);
+    }
+}
+
+static void test_build_frame_pts() {
+    // afsなし: フレーム番号そのまま
+    const auto pts = build_frame_pts(nullptr, 4, 0, 1);
+    TEST_CHECK(pts == std::vector<int64_t>({ 0, 1, 2, 3 }), "build_frame_pts: no afs");
+
+    // 音声ディレイカットで先頭に2フレーム追加
+    const auto pts_delay = build_frame_pts(nullptr, 3, 2, 1);
+    TEST_CHECK(pts_delay == std::vector<int64_t>({ 0, 1, 2, 3, 4 }), "build_frame_pts: delay cut");
+
+    // afs: 4倍精度で jitter を加え、DROP_FRAME_FLAG のフレームは除く
+    // 追加フレームは間隔5 (24fps相当) で、その分後ろにずれる
+    const int jitter[] = { 0, 1, DROP_FRAME_FLAG, -1, 0, DROP_FRAME_FLAG };
+    const auto pts_afs = build_frame_pts(jitter, (int)_countof(jitter), 2, 5);
+    TEST_CHECK(pts_afs == std::vector<int64_t>({ 0, 5, 10, 15, 21, 26 }), "build_frame_pts: afs");
+
+    const auto pts_afs_only = build_frame_pts(jitter, (int)_countof(jitter), 0, 4);
+    TEST_CHECK(pts_afs_only == std::vector<int64_t>({ 0, 5, 11, 16 }), "build_frame_pts: afs without delay cut");
+}
+
+static void test_build_timecode_v2() {
+    // NTSC (30000/1001)
+    const auto tc = build_timecode_v2({ 0, 1, 2, 3 }, 30000, 1001, 1);
+    TEST_CHECK(tc == "# timecode format v2\r\n0.000000\r\n33.366667\r\n66.733333\r\n100.100000\r\n", "build_timecode_v2: ntsc\n%s", tc.c_str());
+
+    // afs (4倍精度)
+    const auto tc_afs = build_timecode_v2({ 0, 5, 10, 15, 21, 26 }, 30000, 1001, 4);
+    TEST_CHECK(tc_afs == "# timecode format v2\r\n0.000000\r\n41.708333\r\n83.416667\r\n125.125000\r\n175.175000\r\n216.883333\r\n", "build_timecode_v2: afs\n%s", tc_afs.c_str());
+
+    const auto tc_24 = build_timecode_v2({ 0, 1, 86400 }, 24, 1, 1);
+    TEST_CHECK(tc_24 == "# timecode format v2\r\n0.000000\r\n41.666667\r\n3600000.000000\r\n", "build_timecode_v2: 24fps\n%s", tc_24.c_str());
+
+    const auto tc_empty = build_timecode_v2({}, 30000, 1001, 1);
+    TEST_CHECK(tc_empty == "# timecode format v2\r\n", "build_timecode_v2: empty");
+}
+
+static void test_build_keyframe_times() {
+    const std::vector<int> keyframes = { 1, 30, 300 };
+    const std::string expect = "0.033366,1.001000,10.010000";
+    int count = -1;
+    auto times = build_keyframe_times(keyframes, 30000, 1001, 1024, &count);
+    TEST_CHECK(times == expect && count == 3, "build_keyframe_times: %s (%d)", times.c_str(), count);
+
+    // max_len に収まる分だけ出力する
+    times = build_keyframe_times(keyframes, 30000, 1001, strlen("0.033366,1.001000"), &count);
+    TEST_CHECK(times == "0.033366,1.001000" && count == 2, "build_keyframe_times: truncate at boundary: %s (%d)", times.c_str(), count);
+    times = build_keyframe_times(keyframes, 30000, 1001, strlen("0.033366,1.001000") - 1, &count);
+    TEST_CHECK(times == "0.033366" && count == 1, "build_keyframe_times: truncate: %s (%d)", times.c_str(), count);
+    times = build_keyframe_times(keyframes, 30000, 1001, 0, &count);
+    TEST_CHECK(times.empty() && count == 0, "build_keyframe_times: no room: %s (%d)", times.c_str(), count);
+    times = build_keyframe_times({}, 30000, 1001, 1024, &count);
+    TEST_CHECK(times.empty() && count == 0, "build_keyframe_times: empty: %s (%d)", times.c_str(), count);
+
+    // ffmpegは指定時刻以降の最初のフレームをキーフレームにするので、
+    // 出力する時刻はそのフレームの時刻以下で、前のフレームの時刻より後でなければならない
+    const struct { int rate, scale; } fps[] = { { 30000, 1001 }, { 24000, 1001 }, { 60000, 1001 }, { 25, 1 }, { 120, 1 } };
+    for (const auto& f : fps) {
+        std::vector<int> frames;
+        for (int i = 1; i <= 200000; i += 7)
+            frames.push_back(i);
+        times = build_keyframe_times(frames, f.rate, f.scale, SIZE_MAX, &count);
+        TEST_CHECK(count == (int)frames.size(), "build_keyframe_times %d/%d: count %d", f.rate, f.scale, count);
+        size_t pos = 0;
+        for (const auto frame : frames) {
+            const size_t next = times.find(',', pos);
+            const auto str = times.substr(pos, (next == std::string::npos) ? std::string::npos : next - pos);
+            pos = next + 1;
+            const uint64_t us = parse_fixed6(str);
+            const uint64_t num = (uint64_t)frame * f.scale * 1000000;
+            const uint64_t prev = (uint64_t)(frame - 1) * f.scale * 1000000;
+            if (us == UINT64_MAX || us * f.rate > num || (us + 1) * f.rate <= num || us * f.rate <= prev) {
+                TEST_CHECK(false, "build_keyframe_times %d/%d: frame %d: %s", f.rate, f.scale, frame, str.c_str());
+                break;
+            }
+        }
+    }
+}
+
+int main() {
+    test_format_fixed6();
+    test_build_frame_pts();
+    test_build_timecode_v2();
+    test_build_keyframe_times();
+    return test_result("test_timestamp");
+}
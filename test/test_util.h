@@ -0,0 +1,100 @@
+﻿// -----------------------------------------------------------------------------------------
+// x264guiEx/x265guiEx/svtAV1guiEx/ffmpegOut/QSVEnc/NVEnc/VCEEnc by rigaya
+// -----------------------------------------------------------------------------------------
+// The MIT License
+//
+// Copyright (c) 2010-2022 rigaya
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// --------------------------------------------------------------------------------------------
+
+#ifndef __AUO_TEST_UTIL_H__
+#define __AUO_TEST_UTIL_H__
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "rgy_simd.h"
+
+// 各テストは失敗数を数え、最後にtest_result()で終了コードを返す
+static int g_test_fail_count = 0;
+
+#define TEST_CHECK(cond, ...) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: ", __FILE__, __LINE__); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+        g_test_fail_count++; \
+    } \
+} while (0)
+
+// 実行中のCPUで使用可能なSIMDか (使用できない関数のテストはスキップする)
+static bool test_simd_available(RGY_SIMD simd) {
+    return (get_availableSIMD() & simd) == simd;
+}
+
+// 先頭のずれを指定できる64byte境界のバッファ
+// 前後に番兵を置き、範囲外への書き込みを検出する
+class TestBuffer {
+private:
+    static constexpr size_t GUARD_SIZE = 128;
+    static constexpr uint8_t GUARD_BYTE = 0xA5;
+    std::vector<uint8_t> buf;
+    size_t offset;
+    size_t length;
+public:
+    TestBuffer(size_t size, size_t misalign = 0) : buf(), offset(0), length(size) {
+        buf.resize(size + misalign + GUARD_SIZE * 2 + 64, GUARD_BYTE);
+        const size_t addr = (size_t)buf.data() + GUARD_SIZE;
+        offset = ((addr + 63) & ~(size_t)63) - (size_t)buf.data() + misalign;
+    }
+    uint8_t *data() { return buf.data() + offset; }
+    const uint8_t *data() const { return buf.data() + offset; }
+    size_t size() const { return length; }
+    bool guard_ok() const {
+        for (size_t i = 0; i < offset; i++) {
+            if (buf[i] != GUARD_BYTE) return false;
+        }
+        for (size_t i = offset + length; i < buf.size(); i++) {
+            if (buf[i] != GUARD_BYTE) return false;
+        }
+        return true;
+    }
+};
+
+static void test_fill_random(std::mt19937& rng, uint8_t *ptr, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        ptr[i] = (uint8_t)rng();
+    }
+}
+
+static int test_result(const char *name) {
+    if (g_test_fail_count) {
+        fprintf(stderr, "%s: %d failure(s)\n", name, g_test_fail_count);
+        return 1;
+    }
+    printf("%s: ok\n", name);
+    return 0;
+}
+
+#endif //__AUO_TEST_UTIL_H__